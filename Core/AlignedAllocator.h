@@ -0,0 +1,50 @@
+//
+// Standard allocator which respects alignment of SIMD types.
+//
+
+#pragma once
+
+#include <malloc.h>
+#include <new>
+
+namespace DX12Samples
+{
+// Default allocator only guarantees 8 byte alignment in 32 bit builds, containers of types with XMVECTOR members need this one.
+template<typename T>
+class AlignedAllocator
+{
+public:
+    using value_type = T;
+
+    AlignedAllocator() = default;
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U>&)
+    {
+    }
+
+    T* allocate(size_t count)
+    {
+        void* memory = _aligned_malloc(count * sizeof(T), alignof(T));
+        if (memory == nullptr)
+            throw std::bad_alloc();
+        return static_cast<T*>(memory);
+    }
+
+    void deallocate(T* memory, size_t)
+    {
+        _aligned_free(memory);
+    }
+
+    template<typename U>
+    bool operator==(const AlignedAllocator<U>&) const
+    {
+        return true;
+    }
+
+    template<typename U>
+    bool operator!=(const AlignedAllocator<U>&) const
+    {
+        return false;
+    }
+};
+}
@@ -24,52 +24,92 @@ float BoneAnimation::GetEndTime() const
 }
 
 void BoneAnimation::Interpolate(float t, XMFLOAT4X4& M) const
+{
+    UINT cursor = 0;
+    Interpolate(t, M, cursor);
+}
+
+void BoneAnimation::Interpolate(float t, XMFLOAT4X4& M, UINT& cursor) const
+{
+    XMVECTOR S, P, Q;
+    Interpolate(t, S, P, Q, cursor);
+
+    XMVECTOR zero = XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f);
+    XMStoreFloat4x4(&M, XMMatrixAffineTransformation(S, zero, Q, P));
+}
+
+void BoneAnimation::Interpolate(float t, Keyframe& key, UINT& cursor) const
+{
+    XMVECTOR S, P, Q;
+    Interpolate(t, S, P, Q, cursor);
+
+    key.TimePos = t;
+    XMStoreFloat3(&key.Scale, S);
+    XMStoreFloat3(&key.Translation, P);
+    XMStoreFloat4(&key.RotationQuat, Q);
+}
+
+void BoneAnimation::Interpolate(float t, XMVECTOR& S, XMVECTOR& P, XMVECTOR& Q, UINT& cursor) const
 {
     if (t <= Keyframes.front().TimePos)
     {
-        XMVECTOR S = XMLoadFloat3(&Keyframes.front().Scale);
-        XMVECTOR P = XMLoadFloat3(&Keyframes.front().Translation);
-        XMVECTOR Q = XMLoadFloat4(&Keyframes.front().RotationQuat);
-
-        XMVECTOR zero = XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f);
-        XMStoreFloat4x4(&M, XMMatrixAffineTransformation(S, zero, Q, P));
+        S = XMLoadFloat3(&Keyframes.front().Scale);
+        P = XMLoadFloat3(&Keyframes.front().Translation);
+        Q = XMLoadFloat4(&Keyframes.front().RotationQuat);
+        cursor = 0;
     }
     else if (t >= Keyframes.back().TimePos)
     {
-        XMVECTOR S = XMLoadFloat3(&Keyframes.back().Scale);
-        XMVECTOR P = XMLoadFloat3(&Keyframes.back().Translation);
-        XMVECTOR Q = XMLoadFloat4(&Keyframes.back().RotationQuat);
-
-        XMVECTOR zero = XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f);
-        XMStoreFloat4x4(&M, XMMatrixAffineTransformation(S, zero, Q, P));
+        S = XMLoadFloat3(&Keyframes.back().Scale);
+        P = XMLoadFloat3(&Keyframes.back().Translation);
+        Q = XMLoadFloat4(&Keyframes.back().RotationQuat);
+        cursor = Keyframes.size() > 1 ? (UINT)Keyframes.size() - 2 : 0;
     }
     else
     {
-        for (UINT i = 0; i < Keyframes.size() - 1; i++)
-        {
-            if (t >= Keyframes[i].TimePos && t <= Keyframes[i + 1].TimePos)
-            {
-                float lerpPercent = (t - Keyframes[i].TimePos) / (Keyframes[i + 1].TimePos - Keyframes[i].TimePos);
-                XMVECTOR s0 = XMLoadFloat3(&Keyframes[i].Scale);
-                XMVECTOR s1 = XMLoadFloat3(&Keyframes[i + 1].Scale);
-                
-                XMVECTOR p0 = XMLoadFloat3(&Keyframes[i].Translation);
-                XMVECTOR p1 = XMLoadFloat3(&Keyframes[i + 1].Translation);
-
-
-                XMVECTOR q0 = XMLoadFloat4(&Keyframes[i].RotationQuat);
-                XMVECTOR q1 = XMLoadFloat4(&Keyframes[i + 1].RotationQuat);
-
-                XMVECTOR S = XMVectorLerp(s0, s1, lerpPercent);
-                XMVECTOR P = XMVectorLerp(p0, p1, lerpPercent);
-                XMVECTOR Q = XMQuaternionSlerp(q0, q1, lerpPercent);
-
-                XMVECTOR zero = XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f);
-                XMStoreFloat4x4(&M, XMMatrixAffineTransformation(S, zero, Q, P));
-
-                break;
-            }
-        }
+        cursor = FindKeyframe(t, cursor);
+        InterpolateSegment(t, cursor, S, P, Q);
     }
 }
+
+UINT BoneAnimation::FindKeyframe(float t) const
+{
+    // First keyframe with TimePos >= t, keyframe before it starts the segment.
+    auto it = std::lower_bound(Keyframes.begin(), Keyframes.end(), t, [](const Keyframe& k, float time) { return k.TimePos < time; });
+    return (UINT)(it - Keyframes.begin()) - 1;
+}
+
+UINT BoneAnimation::FindKeyframe(float t, UINT cursor) const
+{
+    // Animation usually moves forward by less than a keyframe per frame, so check a few segments after cursor before doing full search.
+    const UINT maxForwardSteps = 4;
+    const UINT lastSegment = (UINT)Keyframes.size() - 2;
+
+    if (cursor > lastSegment || Keyframes[cursor].TimePos >= t)
+        return FindKeyframe(t);
+
+    for (UINT step = 0; step < maxForwardSteps && cursor <= lastSegment; step++, cursor++)
+    {
+        if (t <= Keyframes[cursor + 1].TimePos)
+            return cursor;
+    }
+    return FindKeyframe(t);
+}
+
+void BoneAnimation::InterpolateSegment(float t, UINT i, XMVECTOR& S, XMVECTOR& P, XMVECTOR& Q) const
+{
+    float lerpPercent = (t - Keyframes[i].TimePos) / (Keyframes[i + 1].TimePos - Keyframes[i].TimePos);
+    XMVECTOR s0 = XMLoadFloat3(&Keyframes[i].Scale);
+    XMVECTOR s1 = XMLoadFloat3(&Keyframes[i + 1].Scale);
+
+    XMVECTOR p0 = XMLoadFloat3(&Keyframes[i].Translation);
+    XMVECTOR p1 = XMLoadFloat3(&Keyframes[i + 1].Translation);
+
+    XMVECTOR q0 = XMLoadFloat4(&Keyframes[i].RotationQuat);
+    XMVECTOR q1 = XMLoadFloat4(&Keyframes[i + 1].RotationQuat);
+
+    S = XMVectorLerp(s0, s1, lerpPercent);
+    P = XMVectorLerp(p0, p1, lerpPercent);
+    Q = XMQuaternionSlerp(q0, q1, lerpPercent);
+}
 }
\ No newline at end of file
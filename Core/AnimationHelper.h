@@ -36,7 +36,40 @@ struct BoneAnimation
      * \M ref to resulting matrix. Funciton will store result here.
      */
     void Interpolate(float t, DirectX::XMFLOAT4X4& M) const;
+    /**
+     * \brief Get transformation matrix at time using cached keyframe cursor.
+     * If time moves forward cursor is advanced from last found keyframe, otherwise falls back to binary search.
+     * \param t animation time.
+     * \param M ref to resulting matrix. Funciton will store result here.
+     * \param cursor index of the keyframe found on previous call. Updated by function.
+     */
+    void Interpolate(float t, DirectX::XMFLOAT4X4& M, UINT& cursor) const;
+    /**
+     * \brief Get interpolated scale, translation and rotation at time as keyframe.
+     * \param t animation time.
+     * \param key ref to resulting keyframe, TimePos is set to t.
+     * \param cursor index of the keyframe found on previous call. Updated by function.
+     */
+    void Interpolate(float t, Keyframe& key, UINT& cursor) const;
 
     std::vector<Keyframe> Keyframes;
+
+private:
+    /**
+     * \brief Find index i of keyframe such as Keyframes[i].TimePos < t <= Keyframes[i + 1].TimePos with binary search.
+     */
+    UINT FindKeyframe(float t) const;
+    /**
+     * \brief Find keyframe for time t starting from cursor. Walks forward a few keyframes before falling back to binary search.
+     */
+    UINT FindKeyframe(float t, UINT cursor) const;
+    /**
+     * \brief Interpolate between keyframe i and i + 1 at time t.
+     */
+    void InterpolateSegment(float t, UINT i, DirectX::XMVECTOR& S, DirectX::XMVECTOR& P, DirectX::XMVECTOR& Q) const;
+    /**
+     * \brief Interpolate scale, translation and rotation at time t.
+     */
+    void Interpolate(float t, DirectX::XMVECTOR& S, DirectX::XMVECTOR& P, DirectX::XMVECTOR& Q, UINT& cursor) const;
 };
 }
\ No newline at end of file
@@ -0,0 +1,255 @@
+#include "AssetStreamer.h"
+
+#include "MeshOptimizer.h"
+
+namespace DX12Samples
+{
+namespace
+{
+// DDS file is magic number, 124 byte header and optional 20 byte DX10 header, see DDSTextureLoader.
+const UINT DdsMagic = 0x20534444;
+const size_t DdsHeaderOffset = 4;
+const size_t DdsHeaderSize = 124;
+const size_t DdsPixelFormatSize = 32;
+const size_t DdsDx10HeaderSize = 20;
+
+const size_t DdsHeaderSizeField = 0;
+const size_t DdsFlagsField = 4;
+const size_t DdsHeightField = 8;
+const size_t DdsWidthField = 12;
+const size_t DdsDepthField = 20;
+const size_t DdsMipCountField = 24;
+const size_t DdsPixelFormatField = 72;
+const size_t DdsFourCCField = DdsPixelFormatField + 8;
+const size_t DdsCaps2Field = 108;
+const size_t DdsDx10MiscFlagField = 8;
+
+const UINT DdsFlagDepth = 0x800000;
+const UINT DdsPixelFormatFourCC = 0x4;
+const UINT DdsCaps2Cubemap = 0x200;
+const UINT DdsDx10MiscTextureCube = 0x4;
+// "DX10" four character code.
+const UINT DdsFourCCDx10 = 0x30315844;
+
+UINT ReadUint(const std::vector<uint8_t>& data, size_t offset)
+{
+    UINT value;
+    memcpy(&value, data.data() + offset, sizeof(UINT));
+    return value;
+}
+}
+
+AssetState AssetRequest::GetState() const
+{
+    return _state.load();
+}
+
+bool AssetRequest::IsDone() const
+{
+    AssetState state = GetState();
+    return state == AssetState::Ready || state == AssetState::Failed;
+}
+
+void AssetRequest::Wait() const
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _doneCondition.wait(lock, [this] { return IsDone(); });
+}
+
+void AssetRequest::SetState(AssetState state)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _state = state;
+    }
+    _doneCondition.notify_all();
+}
+
+AssetStreamer::AssetStreamer(UINT threadCount)
+{
+    threadCount = MathHelper::Max(threadCount, 1u);
+    for (UINT i = 0; i < threadCount; i++)
+        _threads.emplace_back(&AssetStreamer::WorkerLoop, this);
+}
+
+AssetStreamer::~AssetStreamer()
+{
+    std::vector<std::shared_ptr<AssetRequest>> cancelled;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+        for (; !_queue.empty(); _queue.pop())
+            cancelled.push_back(_queue.top());
+    }
+    _wakeCondition.notify_all();
+    for (auto& request : cancelled)
+        request->SetState(AssetState::Failed);
+    for (auto& thread : _threads)
+        thread.join();
+}
+
+AssetHandle<MeshAsset> AssetStreamer::LoadMesh(const std::string& filename, MeshVertexLayout layout, AssetPriority priority,
+    AssetHandle<MeshAsset>::Callback callback)
+{
+    return Request<MeshAsset>([filename, layout]
+    {
+        return MeshAssetCache::Instance().Load(filename, layout);
+    }, priority, std::move(callback));
+}
+
+AssetHandle<SkinnedModelAsset> AssetStreamer::LoadSkinnedModel(const std::string& filename, AssetPriority priority,
+    AssetHandle<SkinnedModelAsset>::Callback callback)
+{
+    return Request<SkinnedModelAsset>([filename]() -> std::shared_ptr<const SkinnedModelAsset>
+    {
+        auto model = std::make_shared<SkinnedModelAsset>();
+        M3dLoader loader;
+        if (!loader.LoadM3d(filename, model->Vertices, model->Indices, model->Subsets, model->Materials, model->SkinnedInfo))
+            return nullptr;
+
+        // Subsets are drawn separately, so triangles are reordered inside of them. Subset vertex ranges follow each
+        // other in face order, renumbering vertices by first use keeps every subset in its range.
+        UINT vertexCount = (UINT)model->Vertices.size();
+        for (const M3dLoader::Subset& subset : model->Subsets)
+        {
+            USHORT* indices = model->Indices.data() + (size_t)subset.FaceStart * 3;
+            MeshOptimizer::OptimizeVertexCache(indices, subset.FaceCount * 3, vertexCount);
+            MeshOptimizer::OptimizeOverdraw(indices, subset.FaceCount * 3, &model->Vertices[0].Pos, sizeof(M3dLoader::SkinnedVertex), vertexCount);
+        }
+        MeshOptimizer::RemapVertices(model->Vertices, MeshOptimizer::OptimizeVertexFetch(model->Indices.data(), model->Indices.size(), vertexCount));
+        return model;
+    }, priority, std::move(callback));
+}
+
+AssetHandle<TextureFileAsset> AssetStreamer::LoadTextureFile(const std::string& filename, AssetPriority priority,
+    AssetHandle<TextureFileAsset>::Callback callback)
+{
+    return Request<TextureFileAsset>([filename]
+    {
+        return ReadTextureFile(filename);
+    }, priority, std::move(callback));
+}
+
+UINT AssetStreamer::DispatchCompletions()
+{
+    std::vector<std::shared_ptr<AssetRequest>> completed;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        completed.swap(_completed);
+    }
+
+    for (auto& request : completed)
+        request->Complete();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _pendingCount -= (UINT)completed.size();
+    return (UINT)completed.size();
+}
+
+void AssetStreamer::Flush()
+{
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _completeCondition.wait(lock, [this] { return !_completed.empty() || _pendingCount == 0; });
+            if (_completed.empty())
+                return;
+        }
+        DispatchCompletions();
+    }
+}
+
+UINT AssetStreamer::PendingCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _pendingCount;
+}
+
+std::shared_ptr<const TextureFileAsset> AssetStreamer::ReadTextureFile(const std::string& filename)
+{
+    std::ifstream fin(filename, std::ios::binary);
+    if (!fin)
+        return nullptr;
+
+    auto texture = std::make_shared<TextureFileAsset>();
+    texture->Filename = filename;
+
+    fin.seekg(0, std::ios::end);
+    std::ifstream::pos_type size = fin.tellg();
+    fin.seekg(0, std::ios::beg);
+    texture->Data.resize((size_t)size);
+    if (!fin.read(reinterpret_cast<char*>(texture->Data.data()), size))
+        return nullptr;
+
+    const std::vector<uint8_t>& data = texture->Data;
+    if (data.size() < DdsHeaderOffset + DdsHeaderSize || ReadUint(data, 0) != DdsMagic)
+        return nullptr;
+
+    size_t header = DdsHeaderOffset;
+    if (ReadUint(data, header + DdsHeaderSizeField) != DdsHeaderSize || ReadUint(data, header + DdsPixelFormatField) != DdsPixelFormatSize)
+        return nullptr;
+
+    texture->Width = ReadUint(data, header + DdsWidthField);
+    texture->Height = ReadUint(data, header + DdsHeightField);
+    texture->Depth = (ReadUint(data, header + DdsFlagsField) & DdsFlagDepth) != 0 ? ReadUint(data, header + DdsDepthField) : 1;
+    texture->MipLevels = MathHelper::Max(ReadUint(data, header + DdsMipCountField), 1u);
+    texture->IsCubemap = (ReadUint(data, header + DdsCaps2Field) & DdsCaps2Cubemap) != 0;
+
+    bool fourCC = (ReadUint(data, header + DdsPixelFormatField + 4) & DdsPixelFormatFourCC) != 0;
+    if (fourCC && ReadUint(data, header + DdsFourCCField) == DdsFourCCDx10)
+    {
+        size_t dx10Header = header + DdsHeaderSize;
+        if (data.size() < dx10Header + DdsDx10HeaderSize)
+            return nullptr;
+        texture->IsCubemap = (ReadUint(data, dx10Header + DdsDx10MiscFlagField) & DdsDx10MiscTextureCube) != 0;
+    }
+    return texture;
+}
+
+bool AssetStreamer::QueueOrder::operator()(const std::shared_ptr<AssetRequest>& lhs, const std::shared_ptr<AssetRequest>& rhs) const
+{
+    // priority_queue pops largest element, so request which should go first compares greater.
+    if (lhs->_priority != rhs->_priority)
+        return lhs->_priority > rhs->_priority;
+    return lhs->_sequence > rhs->_sequence;
+}
+
+void AssetStreamer::Enqueue(std::shared_ptr<AssetRequest> request, AssetPriority priority)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        request->_priority = priority;
+        request->_sequence = _nextSequence++;
+        _queue.push(std::move(request));
+        _pendingCount++;
+    }
+    _wakeCondition.notify_one();
+}
+
+void AssetStreamer::WorkerLoop()
+{
+    while (true)
+    {
+        std::shared_ptr<AssetRequest> request;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wakeCondition.wait(lock, [this] { return _stop || !_queue.empty(); });
+            if (_stop)
+                return;
+            request = _queue.top();
+            _queue.pop();
+        }
+
+        request->SetState(AssetState::Loading);
+        bool loaded = request->Load();
+        request->SetState(loaded ? AssetState::Ready : AssetState::Failed);
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _completed.push_back(std::move(request));
+        }
+        _completeCondition.notify_all();
+    }
+}
+}
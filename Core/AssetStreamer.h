@@ -0,0 +1,238 @@
+//
+// Background loading of meshes and textures on I/O threads.
+//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+#include "D3DUtil.h"
+#include "M3dLoader.h"
+#include "MeshAsset.h"
+
+namespace DX12Samples
+{
+enum class AssetPriority
+{
+    High,
+    Normal,
+    Low
+};
+
+enum class AssetState
+{
+    Queued,
+    Loading,
+    Ready,
+    Failed
+};
+
+// Contents of .dds file read and validated off the render thread. Resource is created from Data on thread which owns
+// command list, see CreateDDSTextureFromMemory12.
+struct TextureFileAsset
+{
+    std::string Filename;
+    std::vector<uint8_t> Data;
+    UINT Width = 0;
+    UINT Height = 0;
+    UINT Depth = 0;
+    UINT MipLevels = 0;
+    bool IsCubemap = false;
+};
+
+struct SkinnedModelAsset
+{
+    std::vector<M3dLoader::SkinnedVertex> Vertices;
+    std::vector<USHORT> Indices;
+    std::vector<M3dLoader::Subset> Subsets;
+    std::vector<M3dLoader::M3dMaterial> Materials;
+    SkinnedData SkinnedInfo;
+};
+
+class AssetRequest
+{
+public:
+    virtual ~AssetRequest() = default;
+
+    AssetState GetState() const;
+    /**
+     * \brief True when asset is loaded or failed, its completion callback may be not dispatched yet.
+     */
+    bool IsDone() const;
+    /**
+     * \brief Block until asset is loaded or failed.
+     */
+    void Wait() const;
+
+protected:
+    /**
+     * \brief Read and decode asset, called on I/O thread. Returns false if asset can't be loaded.
+     */
+    virtual bool Load() = 0;
+    /**
+     * \brief Run completion callback, called on thread which dispatches completions.
+     */
+    virtual void Complete() = 0;
+
+private:
+    friend class AssetStreamer;
+
+    void SetState(AssetState state);
+
+    AssetPriority _priority = AssetPriority::Normal;
+    UINT64 _sequence = 0;
+    std::atomic<AssetState> _state{ AssetState::Queued };
+    mutable std::mutex _mutex;
+    mutable std::condition_variable _doneCondition;
+};
+
+// Handle of asset requested from AssetStreamer. Copies share the same request.
+template<typename T>
+class AssetHandle
+{
+public:
+    /**
+     * \brief Produces asset on I/O thread, returns nullptr if it can't be loaded.
+     */
+    using LoadFunction = std::function<std::shared_ptr<const T>()>;
+    /**
+     * \brief Receives loaded asset or nullptr if load failed.
+     */
+    using Callback = std::function<void(const std::shared_ptr<const T>& asset)>;
+
+    bool IsValid() const
+    {
+        return _request != nullptr;
+    }
+    AssetState GetState() const
+    {
+        return _request->GetState();
+    }
+    bool IsReady() const
+    {
+        return GetState() == AssetState::Ready;
+    }
+    /**
+     * \brief Wait for asset and get it, nullptr if load failed.
+     */
+    std::shared_ptr<const T> Get() const
+    {
+        _request->Wait();
+        return _request->Asset;
+    }
+
+private:
+    friend class AssetStreamer;
+
+    class LoadRequest : public AssetRequest
+    {
+    public:
+        LoadFunction LoadAsset;
+        Callback OnComplete;
+        std::shared_ptr<const T> Asset;
+
+    protected:
+        bool Load() override
+        {
+            Asset = LoadAsset();
+            return Asset != nullptr;
+        }
+        void Complete() override
+        {
+            if (OnComplete)
+                OnComplete(Asset);
+        }
+    };
+
+    std::shared_ptr<LoadRequest> _request;
+};
+
+// Bounded pool of I/O threads which load requested assets in priority order, requests of same priority are served
+// first come first served. Loading includes CPU side decode, e.g. mesh parsing and bounds, so only GPU upload is left
+// to render thread. Completion callbacks are not run on I/O threads, they are queued until owner calls
+// DispatchCompletions, typically once per frame or while it waits for assets in Init.
+class AssetStreamer
+{
+public:
+    explicit AssetStreamer(UINT threadCount = 2);
+    AssetStreamer(const AssetStreamer& rhs) = delete;
+    AssetStreamer& operator=(const AssetStreamer& rhs) = delete;
+    /**
+     * \brief Queued requests fail, loading ones finish. Callbacks which are not dispatched yet are dropped.
+     */
+    ~AssetStreamer();
+
+    /**
+     * \brief Queue custom load function.
+     */
+    template<typename T>
+    AssetHandle<T> Request(typename AssetHandle<T>::LoadFunction load, AssetPriority priority = AssetPriority::Normal,
+        typename AssetHandle<T>::Callback callback = nullptr)
+    {
+        auto request = std::make_shared<typename AssetHandle<T>::LoadRequest>();
+        request->LoadAsset = std::move(load);
+        request->OnComplete = std::move(callback);
+        Enqueue(request, priority);
+
+        AssetHandle<T> handle;
+        handle._request = std::move(request);
+        return handle;
+    }
+
+    /**
+     * \brief Load mesh through MeshAssetCache, files which are already cached complete without parsing.
+     */
+    AssetHandle<MeshAsset> LoadMesh(const std::string& filename, MeshVertexLayout layout, AssetPriority priority = AssetPriority::Normal,
+        AssetHandle<MeshAsset>::Callback callback = nullptr);
+    /**
+     * \brief Load .m3d model, triangles of every subset and vertices are reordered for GPU caches.
+     */
+    AssetHandle<SkinnedModelAsset> LoadSkinnedModel(const std::string& filename, AssetPriority priority = AssetPriority::Normal,
+        AssetHandle<SkinnedModelAsset>::Callback callback = nullptr);
+    AssetHandle<TextureFileAsset> LoadTextureFile(const std::string& filename, AssetPriority priority = AssetPriority::Normal,
+        AssetHandle<TextureFileAsset>::Callback callback = nullptr);
+
+    /**
+     * \brief Run callbacks of finished requests on calling thread. Returns amount of dispatched requests.
+     */
+    UINT DispatchCompletions();
+    /**
+     * \brief Wait until every request is finished and its callback dispatched. Callbacks may queue more requests.
+     */
+    void Flush();
+    /**
+     * \brief Amount of requests which are not finished or not dispatched yet.
+     */
+    UINT PendingCount() const;
+
+    /**
+     * \brief Read .dds file and validate its header. Returns nullptr if file can't be read or isn't a DDS texture.
+     */
+    static std::shared_ptr<const TextureFileAsset> ReadTextureFile(const std::string& filename);
+
+private:
+    struct QueueOrder
+    {
+        bool operator()(const std::shared_ptr<AssetRequest>& lhs, const std::shared_ptr<AssetRequest>& rhs) const;
+    };
+
+    void Enqueue(std::shared_ptr<AssetRequest> request, AssetPriority priority);
+    void WorkerLoop();
+
+    std::vector<std::thread> _threads;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _wakeCondition;
+    std::condition_variable _completeCondition;
+    std::priority_queue<std::shared_ptr<AssetRequest>, std::vector<std::shared_ptr<AssetRequest>>, QueueOrder> _queue;
+    std::vector<std::shared_ptr<AssetRequest>> _completed;
+    UINT64 _nextSequence = 0;
+    UINT _pendingCount = 0;
+    bool _stop = false;
+};
+}
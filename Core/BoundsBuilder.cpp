@@ -0,0 +1,641 @@
+#include "BoundsBuilder.h"
+
+#include "JobSystem.h"
+
+namespace DX12Samples
+{
+using namespace DirectX;
+
+namespace
+{
+const UINT ChunkSize = 16384;
+// Directions of extreme points which start minimal sphere, axes and cube diagonals padded to 2 groups of 4.
+const UINT DirectionGroupCount = 2;
+const UINT DirectionCount = 7;
+const float Directions[3][DirectionGroupCount * 4] =
+{
+    { 1.0f, 0.0f, 0.0f, 1.0f,   1.0f, 1.0f, 1.0f, 0.0f },
+    { 0.0f, 1.0f, 0.0f, 1.0f,   1.0f, -1.0f, -1.0f, 0.0f },
+    { 0.0f, 0.0f, 1.0f, 1.0f,   -1.0f, 1.0f, -1.0f, 0.0f }
+};
+// Passes which add farthest point to points of minimal sphere.
+const UINT MaxSphereIterations = 16;
+const UINT MaxJacobiSweeps = 32;
+
+XMVECTOR LoadPosition(const XMFLOAT3* positions, UINT stride, UINT index)
+{
+    return XMLoadFloat3(reinterpret_cast<const XMFLOAT3*>(reinterpret_cast<const BYTE*>(positions) + (size_t)index * stride));
+}
+
+struct BoxChunk
+{
+    XMFLOAT3 Min;
+    XMFLOAT3 Max;
+};
+
+struct ExtremeChunk
+{
+    float MinProjection[DirectionGroupCount * 4];
+    float MaxProjection[DirectionGroupCount * 4];
+    uint32_t MinIndex[DirectionGroupCount * 4];
+    uint32_t MaxIndex[DirectionGroupCount * 4];
+};
+
+struct FarthestChunk
+{
+    float DistanceSq = -1.0f;
+    UINT Index = 0;
+};
+
+struct MomentChunk
+{
+    XMFLOAT3 Sum;
+    // xx, yy, zz.
+    XMFLOAT3 SquareSum;
+    // xy, yz, zx.
+    XMFLOAT3 CrossSum;
+};
+
+struct PointD
+{
+    double X, Y, Z;
+};
+
+struct SphereD
+{
+    PointD Center;
+    double RadiusSq;
+};
+
+PointD ToPointD(FXMVECTOR v)
+{
+    XMFLOAT3 f;
+    XMStoreFloat3(&f, v);
+    return { f.x, f.y, f.z };
+}
+
+PointD Subtract(const PointD& a, const PointD& b)
+{
+    return { a.X - b.X, a.Y - b.Y, a.Z - b.Z };
+}
+
+double Dot(const PointD& a, const PointD& b)
+{
+    return a.X * b.X + a.Y * b.Y + a.Z * b.Z;
+}
+
+PointD Cross(const PointD& a, const PointD& b)
+{
+    return { a.Y * b.Z - a.Z * b.Y, a.Z * b.X - a.X * b.Z, a.X * b.Y - a.Y * b.X };
+}
+
+double DistanceSq(const PointD& a, const PointD& b)
+{
+    PointD d = Subtract(a, b);
+    return Dot(d, d);
+}
+
+bool IsOutside(const SphereD& sphere, const PointD& p)
+{
+    return DistanceSq(sphere.Center, p) > sphere.RadiusSq * (1.0 + 1e-9);
+}
+
+SphereD SphereThrough(const PointD& a, const PointD& b)
+{
+    PointD center = { 0.5 * (a.X + b.X), 0.5 * (a.Y + b.Y), 0.5 * (a.Z + b.Z) };
+    return { center, DistanceSq(center, a) };
+}
+
+// Smallest sphere with a, b and c on its surface, i.e. circumcircle of triangle.
+SphereD SphereThrough(const PointD& a, const PointD& b, const PointD& c)
+{
+    PointD u = Subtract(b, a);
+    PointD v = Subtract(c, a);
+    PointD n = Cross(u, v);
+    double nn = Dot(n, n);
+    if (nn <= 1e-24 * Dot(u, u) * Dot(v, v))
+    {
+        // Collinear points, sphere through most distant pair.
+        SphereD spheres[] = { SphereThrough(a, b), SphereThrough(a, c), SphereThrough(b, c) };
+        return *std::max_element(std::begin(spheres), std::end(spheres), [](const SphereD& l, const SphereD& r) { return l.RadiusSq < r.RadiusSq; });
+    }
+
+    double uu = Dot(u, u), vv = Dot(v, v);
+    PointD w = Cross({ uu * v.X - vv * u.X, uu * v.Y - vv * u.Y, uu * v.Z - vv * u.Z }, n);
+    PointD center = { a.X + w.X / (2.0 * nn), a.Y + w.Y / (2.0 * nn), a.Z + w.Z / (2.0 * nn) };
+    return { center, DistanceSq(center, a) };
+}
+
+SphereD SphereThrough(const PointD& a, const PointD& b, const PointD& c, const PointD& d)
+{
+    // Center x solves 2 (p - a) . x = |p|^2 - |a|^2 for p = b, c, d, written relative to a.
+    PointD u = Subtract(b, a);
+    PointD v = Subtract(c, a);
+    PointD w = Subtract(d, a);
+    PointD vw = Cross(v, w);
+    double det = Dot(u, vw);
+    if (fabs(det) <= 1e-12 * sqrt(Dot(u, u) * Dot(v, v) * Dot(w, w)))
+    {
+        // Coplanar points, smallest circumsphere of 3 points which contains fourth one.
+        SphereD spheres[] = { SphereThrough(a, b, c), SphereThrough(a, b, d), SphereThrough(a, c, d), SphereThrough(b, c, d) };
+        const PointD* others[] = { &d, &c, &b, &a };
+        SphereD best = { a, -1.0 };
+        for (int i = 0; i < 4; i++)
+        {
+            if (!IsOutside(spheres[i], *others[i]) && (best.RadiusSq < 0.0 || spheres[i].RadiusSq < best.RadiusSq))
+                best = spheres[i];
+        }
+        return best.RadiusSq < 0.0 ? spheres[0] : best;
+    }
+
+    double uu = 0.5 * Dot(u, u), vv = 0.5 * Dot(v, v), ww = 0.5 * Dot(w, w);
+    PointD wu = Cross(w, u);
+    PointD uv = Cross(u, v);
+    PointD x = { (uu * vw.X + vv * wu.X + ww * uv.X) / det, (uu * vw.Y + vv * wu.Y + ww * uv.Y) / det, (uu * vw.Z + vv * wu.Z + ww * uv.Z) / det };
+    PointD center = { a.X + x.X, a.Y + x.Y, a.Z + x.Z };
+    return { center, DistanceSq(center, a) };
+}
+
+// Welzl's minimal sphere unrolled into loops, point which is outside of sphere of previous points is on its surface.
+// Meant for few tens of points.
+SphereD ComputeMinimalSphere(const std::vector<PointD>& points)
+{
+    SphereD sphere = { points[0], 0.0 };
+    for (size_t i = 1; i < points.size(); i++)
+    {
+        if (!IsOutside(sphere, points[i]))
+            continue;
+        sphere = { points[i], 0.0 };
+        for (size_t j = 0; j < i; j++)
+        {
+            if (!IsOutside(sphere, points[j]))
+                continue;
+            sphere = SphereThrough(points[i], points[j]);
+            for (size_t k = 0; k < j; k++)
+            {
+                if (!IsOutside(sphere, points[k]))
+                    continue;
+                sphere = SphereThrough(points[i], points[j], points[k]);
+                for (size_t l = 0; l < k; l++)
+                {
+                    if (IsOutside(sphere, points[l]))
+                        sphere = SphereThrough(points[i], points[j], points[k], points[l]);
+                }
+            }
+        }
+    }
+    return sphere;
+}
+
+// Eigenvectors of symmetric 3x3 matrix with cyclic Jacobi rotations, vectors are columns of v.
+void ComputeEigenvectors(double a[3][3], double v[3][3])
+{
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            v[i][j] = i == j ? 1.0 : 0.0;
+
+    for (UINT sweep = 0; sweep < MaxJacobiSweeps; sweep++)
+    {
+        double offDiagonal = fabs(a[0][1]) + fabs(a[0][2]) + fabs(a[1][2]);
+        if (offDiagonal < 1e-30)
+            break;
+
+        for (int p = 0; p < 2; p++)
+        {
+            for (int q = p + 1; q < 3; q++)
+            {
+                if (a[p][q] == 0.0)
+                    continue;
+
+                double theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+                double t = (theta >= 0.0 ? 1.0 : -1.0) / (fabs(theta) + sqrt(theta * theta + 1.0));
+                double c = 1.0 / sqrt(t * t + 1.0);
+                double s = t * c;
+
+                for (int k = 0; k < 3; k++)
+                {
+                    double akp = a[k][p];
+                    double akq = a[k][q];
+                    a[k][p] = c * akp - s * akq;
+                    a[k][q] = s * akp + c * akq;
+                }
+                for (int k = 0; k < 3; k++)
+                {
+                    double apk = a[p][k];
+                    double aqk = a[q][k];
+                    a[p][k] = c * apk - s * aqk;
+                    a[q][k] = s * apk + c * aqk;
+                }
+                for (int k = 0; k < 3; k++)
+                {
+                    double vkp = v[k][p];
+                    double vkq = v[k][q];
+                    v[k][p] = c * vkp - s * vkq;
+                    v[k][q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+}
+
+float Volume(const XMFLOAT3& extents)
+{
+    return 8.0f * extents.x * extents.y * extents.z;
+}
+}
+
+void MeshBounds::Fill(SubmeshGeometry& submesh) const
+{
+    submesh.Bounds = Box;
+    submesh.SphereBounds = Sphere;
+    submesh.OrientedBounds = OrientedBox;
+}
+
+SubmeshGeometry MeshBounds::CreateSubmesh(UINT indexCount, UINT startIndexLocation, INT baseVertexLocation) const
+{
+    SubmeshGeometry submesh;
+    submesh.IndexCount = indexCount;
+    submesh.StartIndexLocation = startIndexLocation;
+    submesh.BaseVertexLocation = baseVertexLocation;
+    Fill(submesh);
+    return submesh;
+}
+
+BoundsBuilder::BoundsBuilder(JobSystem& jobs) : _jobs(&jobs)
+{
+}
+
+BoundingBox BoundsBuilder::ComputeBox(const XMFLOAT3* positions, UINT count, UINT stride) const
+{
+    if (count == 0)
+        return BoundingBox(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(0.0f, 0.0f, 0.0f));
+
+    auto chunks = ForEachChunk<BoxChunk>(count, [positions, stride](UINT begin, UINT end)
+    {
+        // Independent accumulators for every of 4 consecutive points, so min and max don't wait on each other.
+        XMVECTOR min[4], max[4];
+        for (UINT k = 0; k < 4; k++)
+            min[k] = max[k] = LoadPosition(positions, stride, begin);
+
+        UINT i = begin;
+        for (; i + 4 <= end; i += 4)
+        {
+            for (UINT k = 0; k < 4; k++)
+            {
+                XMVECTOR p = LoadPosition(positions, stride, i + k);
+                min[k] = XMVectorMin(min[k], p);
+                max[k] = XMVectorMax(max[k], p);
+            }
+        }
+        for (; i < end; i++)
+        {
+            XMVECTOR p = LoadPosition(positions, stride, i);
+            min[0] = XMVectorMin(min[0], p);
+            max[0] = XMVectorMax(max[0], p);
+        }
+
+        BoxChunk chunk;
+        XMStoreFloat3(&chunk.Min, XMVectorMin(XMVectorMin(min[0], min[1]), XMVectorMin(min[2], min[3])));
+        XMStoreFloat3(&chunk.Max, XMVectorMax(XMVectorMax(max[0], max[1]), XMVectorMax(max[2], max[3])));
+        return chunk;
+    });
+
+    XMVECTOR min = XMLoadFloat3(&chunks[0].Min);
+    XMVECTOR max = XMLoadFloat3(&chunks[0].Max);
+    for (const BoxChunk& chunk : chunks)
+    {
+        min = XMVectorMin(min, XMLoadFloat3(&chunk.Min));
+        max = XMVectorMax(max, XMLoadFloat3(&chunk.Max));
+    }
+
+    BoundingBox box;
+    BoundingBox::CreateFromPoints(box, min, max);
+    return box;
+}
+
+BoundingSphere BoundsBuilder::ComputeSphere(const XMFLOAT3* positions, UINT count, UINT stride) const
+{
+    if (count == 0)
+        return BoundingSphere(XMFLOAT3(0.0f, 0.0f, 0.0f), 0.0f);
+
+    //
+    // Extreme points along directions, projections of one point on 4 directions at once.
+    //
+
+    auto extremeChunks = ForEachChunk<ExtremeChunk>(count, [positions, stride](UINT begin, UINT end)
+    {
+        XMVECTOR dx[DirectionGroupCount], dy[DirectionGroupCount], dz[DirectionGroupCount];
+        XMVECTOR minProjection[DirectionGroupCount], maxProjection[DirectionGroupCount];
+        XMVECTOR minIndex[DirectionGroupCount], maxIndex[DirectionGroupCount];
+        for (UINT g = 0; g < DirectionGroupCount; g++)
+        {
+            dx[g] = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&Directions[0][g * 4]));
+            dy[g] = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&Directions[1][g * 4]));
+            dz[g] = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&Directions[2][g * 4]));
+            minProjection[g] = XMVectorReplicate(+MathHelper::Infinity);
+            maxProjection[g] = XMVectorReplicate(-MathHelper::Infinity);
+            minIndex[g] = maxIndex[g] = XMVectorReplicateInt(begin);
+        }
+
+        for (UINT i = begin; i < end; i++)
+        {
+            XMVECTOR p = LoadPosition(positions, stride, i);
+            XMVECTOR x = XMVectorSplatX(p);
+            XMVECTOR y = XMVectorSplatY(p);
+            XMVECTOR z = XMVectorSplatZ(p);
+            XMVECTOR index = XMVectorReplicateInt(i);
+            for (UINT g = 0; g < DirectionGroupCount; g++)
+            {
+                XMVECTOR projection = XMVectorMultiplyAdd(z, dz[g], XMVectorMultiplyAdd(y, dy[g], XMVectorMultiply(x, dx[g])));
+                XMVECTOR less = XMVectorLess(projection, minProjection[g]);
+                XMVECTOR greater = XMVectorGreater(projection, maxProjection[g]);
+                minProjection[g] = XMVectorSelect(minProjection[g], projection, less);
+                minIndex[g] = XMVectorSelect(minIndex[g], index, less);
+                maxProjection[g] = XMVectorSelect(maxProjection[g], projection, greater);
+                maxIndex[g] = XMVectorSelect(maxIndex[g], index, greater);
+            }
+        }
+
+        ExtremeChunk chunk;
+        for (UINT g = 0; g < DirectionGroupCount; g++)
+        {
+            XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&chunk.MinProjection[g * 4]), minProjection[g]);
+            XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&chunk.MaxProjection[g * 4]), maxProjection[g]);
+            XMStoreInt4(&chunk.MinIndex[g * 4], minIndex[g]);
+            XMStoreInt4(&chunk.MaxIndex[g * 4], maxIndex[g]);
+        }
+        return chunk;
+    });
+
+    ExtremeChunk extremes = extremeChunks[0];
+    for (size_t c = 1; c < extremeChunks.size(); c++)
+    {
+        for (UINT d = 0; d < DirectionCount; d++)
+        {
+            if (extremeChunks[c].MinProjection[d] < extremes.MinProjection[d])
+            {
+                extremes.MinProjection[d] = extremeChunks[c].MinProjection[d];
+                extremes.MinIndex[d] = extremeChunks[c].MinIndex[d];
+            }
+            if (extremeChunks[c].MaxProjection[d] > extremes.MaxProjection[d])
+            {
+                extremes.MaxProjection[d] = extremeChunks[c].MaxProjection[d];
+                extremes.MaxIndex[d] = extremeChunks[c].MaxIndex[d];
+            }
+        }
+    }
+
+    // Farthest point from center, 4 points are transposed into x, y, z vectors.
+    auto findFarthest = [this, positions, stride, count](FXMVECTOR from)
+    {
+        auto chunks = ForEachChunk<FarthestChunk>(count, [positions, stride, from](UINT begin, UINT end)
+        {
+            XMVECTOR cx = XMVectorSplatX(from);
+            XMVECTOR cy = XMVectorSplatY(from);
+            XMVECTOR cz = XMVectorSplatZ(from);
+            XMVECTOR maxDistanceSq = XMVectorReplicate(-1.0f);
+            XMVECTOR maxIndex = XMVectorReplicateInt(begin);
+
+            UINT i = begin;
+            for (; i + 4 <= end; i += 4)
+            {
+                XMMATRIX points(LoadPosition(positions, stride, i), LoadPosition(positions, stride, i + 1),
+                    LoadPosition(positions, stride, i + 2), LoadPosition(positions, stride, i + 3));
+                points = XMMatrixTranspose(points);
+                XMVECTOR dx = points.r[0] - cx;
+                XMVECTOR dy = points.r[1] - cy;
+                XMVECTOR dz = points.r[2] - cz;
+                XMVECTOR distanceSq = XMVectorMultiplyAdd(dz, dz, XMVectorMultiplyAdd(dy, dy, XMVectorMultiply(dx, dx)));
+                XMVECTOR greater = XMVectorGreater(distanceSq, maxDistanceSq);
+                maxDistanceSq = XMVectorSelect(maxDistanceSq, distanceSq, greater);
+                maxIndex = XMVectorSelect(maxIndex, XMVectorSetInt(i, i + 1, i + 2, i + 3), greater);
+            }
+
+            FarthestChunk chunk;
+            XMFLOAT4 distances;
+            uint32_t indices[4];
+            XMStoreFloat4(&distances, maxDistanceSq);
+            XMStoreInt4(indices, maxIndex);
+            const float* lanes = &distances.x;
+            for (UINT k = 0; k < 4; k++)
+            {
+                if (lanes[k] > chunk.DistanceSq || (lanes[k] == chunk.DistanceSq && indices[k] < chunk.Index))
+                {
+                    chunk.DistanceSq = lanes[k];
+                    chunk.Index = indices[k];
+                }
+            }
+            for (; i < end; i++)
+            {
+                float distanceSq = XMVectorGetX(XMVector3LengthSq(LoadPosition(positions, stride, i) - from));
+                if (distanceSq > chunk.DistanceSq)
+                {
+                    chunk.DistanceSq = distanceSq;
+                    chunk.Index = i;
+                }
+            }
+            return chunk;
+        });
+
+        FarthestChunk farthest;
+        for (const FarthestChunk& chunk : chunks)
+        {
+            if (chunk.DistanceSq > farthest.DistanceSq)
+                farthest = chunk;
+        }
+        return farthest;
+    };
+
+    //
+    // Minimal sphere of extreme points, then farthest point from its center joins them until it is inside. Few points
+    // far from center decide minimal sphere, so it takes few passes over all points.
+    //
+
+    std::vector<UINT> coreIndices;
+    for (UINT d = 0; d < DirectionCount; d++)
+    {
+        for (UINT index : { extremes.MinIndex[d], extremes.MaxIndex[d] })
+        {
+            if (std::find(coreIndices.begin(), coreIndices.end(), index) == coreIndices.end())
+                coreIndices.push_back(index);
+        }
+    }
+
+    std::vector<PointD> core;
+    for (UINT index : coreIndices)
+        core.push_back(ToPointD(LoadPosition(positions, stride, index)));
+
+    XMVECTOR center = XMVectorZero();
+    FarthestChunk farthest;
+    for (UINT iteration = 0; iteration < MaxSphereIterations; iteration++)
+    {
+        SphereD coreSphere = ComputeMinimalSphere(core);
+        center = XMVectorSet((float)coreSphere.Center.X, (float)coreSphere.Center.Y, (float)coreSphere.Center.Z, 0.0f);
+        farthest = findFarthest(center);
+
+        PointD p = ToPointD(LoadPosition(positions, stride, farthest.Index));
+        if (!IsOutside(coreSphere, p) || std::find(coreIndices.begin(), coreIndices.end(), farthest.Index) != coreIndices.end())
+            break;
+        coreIndices.push_back(farthest.Index);
+        core.push_back(p);
+    }
+
+    // Radius is distance to farthest point in float, so every point is inside regardless of rounding of center.
+    BoundingSphere sphere;
+    XMStoreFloat3(&sphere.Center, center);
+    sphere.Radius = sqrtf(farthest.DistanceSq);
+    return sphere;
+}
+
+BoundingOrientedBox BoundsBuilder::ComputeOrientedBox(const XMFLOAT3* positions, UINT count, UINT stride) const
+{
+    return ComputeOrientedBox(positions, count, stride, ComputeBox(positions, count, stride));
+}
+
+BoundingOrientedBox BoundsBuilder::ComputeOrientedBox(const XMFLOAT3* positions, UINT count, UINT stride, const BoundingBox& box) const
+{
+    BoundingOrientedBox axisAligned(box.Center, box.Extents, XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f));
+    if (count < 3)
+        return axisAligned;
+
+    //
+    // Covariance of points relative to box center, which keeps sums small for meshes far from origin.
+    //
+
+    XMVECTOR origin = XMLoadFloat3(&box.Center);
+    auto momentChunks = ForEachChunk<MomentChunk>(count, [positions, stride, origin](UINT begin, UINT end)
+    {
+        XMVECTOR sum = XMVectorZero();
+        XMVECTOR squareSum = XMVectorZero();
+        XMVECTOR crossSum = XMVectorZero();
+        for (UINT i = begin; i < end; i++)
+        {
+            XMVECTOR p = LoadPosition(positions, stride, i) - origin;
+            sum += p;
+            squareSum = XMVectorMultiplyAdd(p, p, squareSum);
+            crossSum = XMVectorMultiplyAdd(p, XMVectorSwizzle<1, 2, 0, 3>(p), crossSum);
+        }
+
+        MomentChunk chunk;
+        XMStoreFloat3(&chunk.Sum, sum);
+        XMStoreFloat3(&chunk.SquareSum, squareSum);
+        XMStoreFloat3(&chunk.CrossSum, crossSum);
+        return chunk;
+    });
+
+    double sum[3] = {}, squareSum[3] = {}, crossSum[3] = {};
+    for (const MomentChunk& chunk : momentChunks)
+    {
+        sum[0] += chunk.Sum.x; sum[1] += chunk.Sum.y; sum[2] += chunk.Sum.z;
+        squareSum[0] += chunk.SquareSum.x; squareSum[1] += chunk.SquareSum.y; squareSum[2] += chunk.SquareSum.z;
+        crossSum[0] += chunk.CrossSum.x; crossSum[1] += chunk.CrossSum.y; crossSum[2] += chunk.CrossSum.z;
+    }
+
+    double mean[3] = { sum[0] / count, sum[1] / count, sum[2] / count };
+    double covariance[3][3];
+    for (int k = 0; k < 3; k++)
+        covariance[k][k] = squareSum[k] / count - mean[k] * mean[k];
+    covariance[0][1] = covariance[1][0] = crossSum[0] / count - mean[0] * mean[1];
+    covariance[1][2] = covariance[2][1] = crossSum[1] / count - mean[1] * mean[2];
+    covariance[2][0] = covariance[0][2] = crossSum[2] / count - mean[2] * mean[0];
+
+    double eigenvectors[3][3];
+    ComputeEigenvectors(covariance, eigenvectors);
+
+    // Rows of rotation are box axes, third one is cross product of first two so rotation is never a reflection.
+    XMVECTOR axis0 = XMVector3Normalize(XMVectorSet((float)eigenvectors[0][0], (float)eigenvectors[1][0], (float)eigenvectors[2][0], 0.0f));
+    XMVECTOR axis1 = XMVector3Normalize(XMVectorSet((float)eigenvectors[0][1], (float)eigenvectors[1][1], (float)eigenvectors[2][1], 0.0f));
+    axis1 = XMVector3Normalize(axis1 - axis0 * XMVector3Dot(axis0, axis1));
+    XMVECTOR axis2 = XMVector3Cross(axis0, axis1);
+    XMMATRIX rotation(axis0, axis1, axis2, XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f));
+    XMMATRIX toLocal = XMMatrixTranspose(rotation);
+
+    //
+    // Extents along axes.
+    //
+
+    auto boxChunks = ForEachChunk<BoxChunk>(count, [positions, stride, origin, &toLocal](UINT begin, UINT end)
+    {
+        XMVECTOR min = XMVectorReplicate(+MathHelper::Infinity);
+        XMVECTOR max = XMVectorReplicate(-MathHelper::Infinity);
+        for (UINT i = begin; i < end; i++)
+        {
+            XMVECTOR p = LoadPosition(positions, stride, i) - origin;
+            XMVECTOR local = XMVectorMultiplyAdd(XMVectorSplatZ(p), toLocal.r[2],
+                XMVectorMultiplyAdd(XMVectorSplatY(p), toLocal.r[1], XMVectorMultiply(XMVectorSplatX(p), toLocal.r[0])));
+            min = XMVectorMin(min, local);
+            max = XMVectorMax(max, local);
+        }
+
+        BoxChunk chunk;
+        XMStoreFloat3(&chunk.Min, min);
+        XMStoreFloat3(&chunk.Max, max);
+        return chunk;
+    });
+
+    XMVECTOR min = XMLoadFloat3(&boxChunks[0].Min);
+    XMVECTOR max = XMLoadFloat3(&boxChunks[0].Max);
+    for (const BoxChunk& chunk : boxChunks)
+    {
+        min = XMVectorMin(min, XMLoadFloat3(&chunk.Min));
+        max = XMVectorMax(max, XMLoadFloat3(&chunk.Max));
+    }
+
+    BoundingOrientedBox oriented;
+    XMVECTOR localCenter = 0.5f * (min + max);
+    XMStoreFloat3(&oriented.Center, origin + XMVector3TransformNormal(localCenter, rotation));
+    XMStoreFloat3(&oriented.Extents, 0.5f * (max - min));
+    XMStoreFloat4(&oriented.Orientation, XMQuaternionNormalize(XMQuaternionRotationMatrix(rotation)));
+
+    return Volume(oriented.Extents) < Volume(box.Extents) ? oriented : axisAligned;
+}
+
+MeshBounds BoundsBuilder::Compute(const XMFLOAT3* positions, UINT count, UINT stride) const
+{
+    MeshBounds bounds;
+    bounds.Box = ComputeBox(positions, count, stride);
+    bounds.Sphere = ComputeSphere(positions, count, stride);
+    bounds.OrientedBox = ComputeOrientedBox(positions, count, stride, bounds.Box);
+    return bounds;
+}
+
+MeshBounds BoundsBuilder::Compute(const GeometryGenerator::MeshData& meshData) const
+{
+    return Compute(&meshData.Vertices.data()->Position, (UINT)meshData.Vertices.size(), sizeof(GeometryGenerator::Vertex));
+}
+
+SubmeshGeometry BoundsBuilder::CreateSubmesh(const XMFLOAT3* positions, UINT vertexCount, UINT stride,
+    UINT indexCount, UINT startIndexLocation, INT baseVertexLocation) const
+{
+    return Compute(positions, vertexCount, stride).CreateSubmesh(indexCount, startIndexLocation, baseVertexLocation);
+}
+
+SubmeshGeometry BoundsBuilder::CreateSubmesh(const GeometryGenerator::MeshData& meshData, UINT startIndexLocation, INT baseVertexLocation) const
+{
+    return Compute(meshData).CreateSubmesh((UINT)meshData.Indices32.size(), startIndexLocation, baseVertexLocation);
+}
+
+template<typename Result, typename ChunkJob>
+std::vector<Result> BoundsBuilder::ForEachChunk(UINT count, const ChunkJob& job) const
+{
+    UINT chunkCount = (count + ChunkSize - 1) / ChunkSize;
+    std::vector<Result> results(chunkCount);
+    auto run = [&results, &job, count](UINT begin, UINT end)
+    {
+        for (UINT c = begin; c < end; c++)
+            results[c] = job(c * ChunkSize, (std::min)(count, (c + 1) * ChunkSize));
+    };
+
+    if (_jobs == nullptr)
+    {
+        run(0, chunkCount);
+        return results;
+    }
+
+    _jobs->ParallelFor(chunkCount, 1, [&run](UINT begin, UINT end, UINT workerIndex)
+    {
+        run(begin, end);
+    });
+    return results;
+}
+}
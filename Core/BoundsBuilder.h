@@ -0,0 +1,75 @@
+//
+// Bounding boxes, spheres and oriented boxes of position streams.
+//
+
+#pragma once
+
+#include "D3DUtil.h"
+#include "GeometryGenerator.h"
+
+namespace DX12Samples
+{
+class JobSystem;
+
+// Bounding volumes of same points.
+struct MeshBounds
+{
+    DirectX::BoundingBox Box;
+    DirectX::BoundingSphere Sphere;
+    DirectX::BoundingOrientedBox OrientedBox;
+
+    void Fill(SubmeshGeometry& submesh) const;
+    /**
+     * \brief Submesh of indexCount indices at given locations of shared buffers, with these bounds.
+     */
+    SubmeshGeometry CreateSubmesh(UINT indexCount, UINT startIndexLocation, INT baseVertexLocation) const;
+};
+
+// Every volume is computed with few passes over points, each pass splits points into chunks which are processed on job
+// system workers if builder has it and merged in chunk order, so result doesn't depend on number of workers.
+// Empty point set gets zero size volumes at origin.
+class BoundsBuilder
+{
+public:
+    BoundsBuilder() = default;
+    explicit BoundsBuilder(JobSystem& jobs);
+
+    /**
+     * \brief Axis aligned box of count positions which are stride bytes apart.
+     */
+    DirectX::BoundingBox ComputeBox(const DirectX::XMFLOAT3* positions, UINT count, UINT stride) const;
+    /**
+     * \brief Minimal sphere of extreme points along axes and cube diagonals and of farthest points outside of it, which is minimal
+     * sphere of all points unless pass limit is hit first. Radius always reaches farthest point.
+     */
+    DirectX::BoundingSphere ComputeSphere(const DirectX::XMFLOAT3* positions, UINT count, UINT stride) const;
+    /**
+     * \brief Box along principal axes of points, or axis aligned box if it has smaller volume.
+     */
+    DirectX::BoundingOrientedBox ComputeOrientedBox(const DirectX::XMFLOAT3* positions, UINT count, UINT stride) const;
+
+    MeshBounds Compute(const DirectX::XMFLOAT3* positions, UINT count, UINT stride) const;
+    MeshBounds Compute(const GeometryGenerator::MeshData& meshData) const;
+
+    /**
+     * \brief Submesh of indexCount indices at given locations of shared buffers, with bounds of its vertexCount positions.
+     */
+    SubmeshGeometry CreateSubmesh(const DirectX::XMFLOAT3* positions, UINT vertexCount, UINT stride,
+        UINT indexCount, UINT startIndexLocation, INT baseVertexLocation) const;
+    /**
+     * \brief Submesh of all indices of meshData at given locations of shared buffers, with bounds of its vertices.
+     */
+    SubmeshGeometry CreateSubmesh(const GeometryGenerator::MeshData& meshData, UINT startIndexLocation, INT baseVertexLocation) const;
+
+private:
+    /**
+     * \brief Run job(begin, end) for chunks of points and return per chunk results in chunk order.
+     */
+    template<typename Result, typename ChunkJob>
+    std::vector<Result> ForEachChunk(UINT count, const ChunkJob& job) const;
+
+    DirectX::BoundingOrientedBox ComputeOrientedBox(const DirectX::XMFLOAT3* positions, UINT count, UINT stride, const DirectX::BoundingBox& box) const;
+
+    JobSystem* _jobs = nullptr;
+};
+}
@@ -148,6 +148,8 @@ struct SubmeshGeometry
     INT BaseVertexLocation = 0;
 
     DirectX::BoundingBox Bounds;
+    DirectX::BoundingSphere SphereBounds;
+    DirectX::BoundingOrientedBox OrientedBounds;
 };
 
 // Describes single blob of mesh geometry and all possible submeshes for this geometry.
@@ -0,0 +1,87 @@
+#include "FrameArena.h"
+
+namespace DX12Samples
+{
+FrameArena::FrameArena(size_t capacity)
+{
+    _blocks.reserve(4);
+    if (capacity > 0)
+        AddBlock(capacity);
+}
+
+void FrameArena::Reset()
+{
+    if (_blocks.size() > 1)
+    {
+        size_t capacity = Capacity();
+        _blocks.clear();
+        AddBlock(capacity);
+    }
+    _offset = 0;
+    _used = 0;
+}
+
+void FrameArena::Reserve(size_t byteSize)
+{
+    if (Capacity() >= byteSize)
+        return;
+    assert(_used == 0 && "FrameArena::Reserve must be called right after Reset.");
+    _blocks.clear();
+    AddBlock(byteSize);
+    _offset = 0;
+}
+
+size_t FrameArena::Capacity() const
+{
+    size_t capacity = 0;
+    for (const Block& block : _blocks)
+        capacity += block.Size;
+    return capacity;
+}
+
+size_t FrameArena::Used() const
+{
+    return _used;
+}
+
+UINT FrameArena::HeapAllocationCount() const
+{
+    return _heapAllocationCount;
+}
+
+void* FrameArena::AllocateBytes(size_t byteSize, size_t alignment)
+{
+    if (!_blocks.empty())
+    {
+        Block& block = _blocks.back();
+        uintptr_t base = reinterpret_cast<uintptr_t>(block.Memory.get());
+        uintptr_t aligned = (base + _offset + alignment - 1) & ~(uintptr_t)(alignment - 1);
+        size_t newOffset = (aligned - base) + byteSize;
+        if (newOffset <= block.Size)
+        {
+            _used += newOffset - _offset;
+            _offset = newOffset;
+            return reinterpret_cast<void*>(aligned);
+        }
+    }
+    // Current block is full. Previous allocations must stay valid, so add block instead of reallocating.
+    size_t lastSize = _blocks.empty() ? 0 : _blocks.back().Size;
+    AddBlock(MathHelper::Max(byteSize + alignment, lastSize * 2));
+
+    Block& block = _blocks.back();
+    uintptr_t base = reinterpret_cast<uintptr_t>(block.Memory.get());
+    uintptr_t aligned = (base + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    _offset = (aligned - base) + byteSize;
+    _used += _offset;
+    return reinterpret_cast<void*>(aligned);
+}
+
+void FrameArena::AddBlock(size_t byteSize)
+{
+    Block block;
+    block.Memory = std::make_unique<BYTE[]>(byteSize);
+    block.Size = byteSize;
+    _blocks.push_back(std::move(block));
+    _heapAllocationCount++;
+}
+}
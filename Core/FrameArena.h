@@ -0,0 +1,65 @@
+//
+// Linear allocator for per frame scratch memory.
+//
+
+#pragma once
+
+#include "D3DUtil.h"
+
+namespace DX12Samples
+{
+class FrameArena
+{
+public:
+    /**
+     * \brief Creates arena with initial capacity in bytes.
+     */
+    explicit FrameArena(size_t capacity = 0);
+    FrameArena(const FrameArena& rhs) = delete;
+    FrameArena& operator=(const FrameArena& rhs) = delete;
+
+    /**
+     * \brief Allocate uninitialized memory for count elements of type T. Memory is valid until next Reset.
+     */
+    template<typename T>
+    T* Allocate(size_t count)
+    {
+        return reinterpret_cast<T*>(AllocateBytes(count * sizeof(T), alignof(T) > 16 ? alignof(T) : 16));
+    }
+    /**
+     * \brief Release all allocations made since last reset. If arena had to grow during the frame blocks are merged into single one.
+     */
+    void Reset();
+    /**
+     * \brief Make sure arena can hold at least byteSize bytes without growing.
+     */
+    void Reserve(size_t byteSize);
+    /**
+     * \brief Total capacity of arena in bytes.
+     */
+    size_t Capacity() const;
+    /**
+     * \brief Bytes allocated since last reset.
+     */
+    size_t Used() const;
+    /**
+     * \brief How many times arena allocated memory from heap. Stays constant in steady state.
+     */
+    UINT HeapAllocationCount() const;
+
+private:
+    struct Block
+    {
+        std::unique_ptr<BYTE[]> Memory;
+        size_t Size = 0;
+    };
+
+    void* AllocateBytes(size_t byteSize, size_t alignment);
+    void AddBlock(size_t byteSize);
+
+    std::vector<Block> _blocks;
+    size_t _offset = 0;
+    size_t _used = 0;
+    UINT _heapAllocationCount = 0;
+};
+}
@@ -6,10 +6,119 @@
 
 #include <algorithm>
 
+#include "D3DUtil.h"
+#include "JobSystem.h"
+
 namespace DX12Samples
 {
+std::vector<GeometryGenerator::uint16>& GeometryGenerator::MeshData::GetIndices16()
+{
+    // Truncated indices would silently draw wrong triangles, so this is checked in release builds too.
+    if (Vertices.size() > 65536)
+        throw DxException(E_INVALIDARG, L"MeshData::GetIndices16, use MeshPartitioner::Split", AnsiToWString(__FILE__), __LINE__);
+
+    if (_indices16.empty())
+    {
+        _indices16.resize(Indices32.size());
+        for (size_t i = 0; i < Indices32.size(); i++)
+        {
+            _indices16[i] = static_cast<uint16>(Indices32[i]);
+        }
+    }
+    return _indices16;
+}
+
 using namespace DirectX;
 
+namespace
+{
+// Open addressing hash map from undirected edge to value, sized for expected edge count up front.
+class EdgeMap
+{
+public:
+    explicit EdgeMap(size_t edgeCount)
+    {
+        size_t capacity = 16;
+        while (capacity < edgeCount * 2)
+            capacity *= 2;
+        _keys.assign(capacity, EmptyKey);
+        _values.resize(capacity);
+        _mask = capacity - 1;
+    }
+
+    /**
+     * \brief Get value of edge, inserted is set if edge was added by this call.
+     */
+    uint32_t& Insert(uint32_t i0, uint32_t i1, bool& inserted)
+    {
+        if (_count * 2 >= _keys.size())
+            Grow();
+
+        uint64_t key = i0 < i1 ? (uint64_t)i0 << 32 | i1 : (uint64_t)i1 << 32 | i0;
+        size_t slot = Find(key);
+        inserted = _keys[slot] == EmptyKey;
+        if (inserted)
+        {
+            _keys[slot] = key;
+            _count++;
+        }
+        return _values[slot];
+    }
+
+private:
+    static const uint64_t EmptyKey = ~0ull;
+
+    size_t Find(uint64_t key) const
+    {
+        size_t slot = (size_t)((key * 0x9E3779B97F4A7C15ull) >> 32) & _mask;
+        while (_keys[slot] != key && _keys[slot] != EmptyKey)
+            slot = (slot + 1) & _mask;
+        return slot;
+    }
+
+    void Grow()
+    {
+        std::vector<uint64_t> keys(_keys.size() * 2, EmptyKey);
+        std::vector<uint32_t> values(keys.size());
+        keys.swap(_keys);
+        values.swap(_values);
+        _mask = _keys.size() - 1;
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            if (keys[i] == EmptyKey)
+                continue;
+            size_t slot = Find(keys[i]);
+            _keys[slot] = keys[i];
+            _values[slot] = values[i];
+        }
+    }
+
+    std::vector<uint64_t> _keys;
+    std::vector<uint32_t> _values;
+    size_t _mask = 0;
+    size_t _count = 0;
+};
+
+// Vertices per chunk of rows which is processed by one job.
+const uint32_t RowGrainVertices = 4096;
+
+// Sines and cosines of j * step for j in [0, sliceCount]. Same for every ring, so computed once instead of per vertex.
+void ComputeRingAngles(uint32_t sliceCount, float step, std::vector<float>& sines, std::vector<float>& cosines)
+{
+    sines.resize(sliceCount + 1);
+    cosines.resize(sliceCount + 1);
+    for (uint32_t j = 0; j <= sliceCount; ++j)
+    {
+        sines[j] = sinf(j*step);
+        cosines[j] = cosf(j*step);
+    }
+}
+}
+
+GeometryGenerator::GeometryGenerator(JobSystem& jobs) : _jobs(&jobs)
+{
+}
+
 GeometryGenerator::MeshData GeometryGenerator::CreateBox(float width, float height, float depth, uint32 numSubdivisions)
 {
     MeshData meshData;
@@ -107,6 +216,12 @@ GeometryGenerator::MeshData GeometryGenerator::CreateSphere(float radius, uint32
 {
     MeshData meshData;
 
+    // Rings between poles, every ring duplicates its first vertex for texture seam.
+    uint32 ringVertexCount = sliceCount + 1;
+    uint32 innerRingCount = stackCount - 1;
+    meshData.Vertices.resize(innerRingCount*ringVertexCount + 2);
+    meshData.Indices32.resize(sliceCount * 6 + (stackCount - 2)*sliceCount * 6);
+
     //
     // Compute the vertices stating at the top pole and moving down the stacks.
     //
@@ -117,58 +232,67 @@ GeometryGenerator::MeshData GeometryGenerator::CreateSphere(float radius, uint32
     Vertex topVertex(0.0f, +radius, 0.0f, 0.0f, +1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f);
     Vertex bottomVertex(0.0f, -radius, 0.0f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f);
 
-    meshData.Vertices.push_back(topVertex);
+    meshData.Vertices.front() = topVertex;
 
     float phiStep = XM_PI / stackCount;
     float thetaStep = 2.0f*XM_PI / sliceCount;
 
+    std::vector<float> sinTheta;
+    std::vector<float> cosTheta;
+    ComputeRingAngles(sliceCount, thetaStep, sinTheta, cosTheta);
+
     // Compute vertices for each stack ring (do not count the poles as rings).
-    for (uint32 i = 1; i <= stackCount - 1; ++i)
+    ForEachRow(innerRingCount, ringVertexCount, [&](uint32 begin, uint32 end)
     {
-        float phi = i*phiStep;
-
-        // Vertices of ring.
-        for (uint32 j = 0; j <= sliceCount; ++j)
+        for (uint32 i = begin + 1; i <= end; ++i)
         {
-            float theta = j*thetaStep;
+            float phi = i*phiStep;
+            float sinPhi = sinf(phi);
+            float cosPhi = cosf(phi);
 
-            Vertex v;
+            // Vertices of ring.
+            Vertex* ring = &meshData.Vertices[1 + (i - 1)*ringVertexCount];
+            for (uint32 j = 0; j <= sliceCount; ++j)
+            {
+                float theta = j*thetaStep;
 
-            // spherical to cartesian
-            v.Position.x = radius*sinf(phi)*cosf(theta);
-            v.Position.y = radius*cosf(phi);
-            v.Position.z = radius*sinf(phi)*sinf(theta);
+                Vertex& v = ring[j];
 
-            // Partial derivative of P with respect to theta
-            v.Tangent.x = -radius*sinf(phi)*sinf(theta);
-            v.Tangent.y = 0.0f;
-            v.Tangent.z = +radius*sinf(phi)*cosf(theta);
+                // spherical to cartesian
+                v.Position.x = radius*sinPhi*cosTheta[j];
+                v.Position.y = radius*cosPhi;
+                v.Position.z = radius*sinPhi*sinTheta[j];
 
-            XMVECTOR T = XMLoadFloat3(&v.Tangent);
-            XMStoreFloat3(&v.Tangent, XMVector3Normalize(T));
+                // Partial derivative of P with respect to theta
+                v.Tangent.x = -radius*sinPhi*sinTheta[j];
+                v.Tangent.y = 0.0f;
+                v.Tangent.z = +radius*sinPhi*cosTheta[j];
 
-            XMVECTOR p = XMLoadFloat3(&v.Position);
-            XMStoreFloat3(&v.Normal, XMVector3Normalize(p));
+                XMVECTOR T = XMLoadFloat3(&v.Tangent);
+                XMStoreFloat3(&v.Tangent, XMVector3Normalize(T));
 
-            v.TexCoord.x = theta / XM_2PI;
-            v.TexCoord.y = phi / XM_PI;
+                XMVECTOR p = XMLoadFloat3(&v.Position);
+                XMStoreFloat3(&v.Normal, XMVector3Normalize(p));
 
-            meshData.Vertices.push_back(v);
+                v.TexCoord.x = theta / XM_2PI;
+                v.TexCoord.y = phi / XM_PI;
+            }
         }
-    }
+    });
 
-    meshData.Vertices.push_back(bottomVertex);
+    meshData.Vertices.back() = bottomVertex;
 
     //
     // Compute indices for top stack.  The top stack was written first to the vertex buffer
     // and connects the top pole to the first ring.
     //
 
+    uint32* indices = meshData.Indices32.data();
     for (uint32 i = 1; i <= sliceCount; ++i)
     {
-        meshData.Indices32.push_back(0);
-        meshData.Indices32.push_back(i + 1);
-        meshData.Indices32.push_back(i);
+        *indices++ = 0;
+        *indices++ = i + 1;
+        *indices++ = i;
     }
 
     //
@@ -178,20 +302,24 @@ GeometryGenerator::MeshData GeometryGenerator::CreateSphere(float radius, uint32
     // Offset the indices to the index of the first vertex in the first ring.
     // This is just skipping the top pole vertex.
     uint32 baseIndex = 1;
-    uint32 ringVertexCount = sliceCount + 1;
-    for (uint32 i = 0; i < stackCount - 2; ++i)
+    ForEachRow(stackCount - 2, sliceCount * 2, [&](uint32 begin, uint32 end)
     {
-        for (uint32 j = 0; j < sliceCount; ++j)
+        for (uint32 i = begin; i < end; ++i)
         {
-            meshData.Indices32.push_back(baseIndex + i*ringVertexCount + j);
-            meshData.Indices32.push_back(baseIndex + i*ringVertexCount + j + 1);
-            meshData.Indices32.push_back(baseIndex + (i + 1)*ringVertexCount + j);
-
-            meshData.Indices32.push_back(baseIndex + (i + 1)*ringVertexCount + j);
-            meshData.Indices32.push_back(baseIndex + i*ringVertexCount + j + 1);
-            meshData.Indices32.push_back(baseIndex + (i + 1)*ringVertexCount + j + 1);
+            uint32* stack = indices + i*sliceCount * 6;
+            for (uint32 j = 0; j < sliceCount; ++j)
+            {
+                *stack++ = baseIndex + i*ringVertexCount + j;
+                *stack++ = baseIndex + i*ringVertexCount + j + 1;
+                *stack++ = baseIndex + (i + 1)*ringVertexCount + j;
+
+                *stack++ = baseIndex + (i + 1)*ringVertexCount + j;
+                *stack++ = baseIndex + i*ringVertexCount + j + 1;
+                *stack++ = baseIndex + (i + 1)*ringVertexCount + j + 1;
+            }
         }
-    }
+    });
+    indices += (stackCount - 2)*sliceCount * 6;
 
     //
     // Compute indices for bottom stack.  The bottom stack was written last to the vertex buffer
@@ -206,9 +334,9 @@ GeometryGenerator::MeshData GeometryGenerator::CreateSphere(float radius, uint32
 
     for (uint32 i = 0; i < sliceCount; ++i)
     {
-        meshData.Indices32.push_back(southPoleIndex);
-        meshData.Indices32.push_back(baseIndex + i);
-        meshData.Indices32.push_back(baseIndex + i + 1);
+        *indices++ = southPoleIndex;
+        *indices++ = baseIndex + i;
+        *indices++ = baseIndex + i + 1;
     }
 
     return meshData;
@@ -216,13 +344,6 @@ GeometryGenerator::MeshData GeometryGenerator::CreateSphere(float radius, uint32
 
 void GeometryGenerator::Subdivide(MeshData& meshData)
 {
-    // Save a copy of the input geometry.
-    MeshData inputCopy = meshData;
-
-
-    meshData.Vertices.resize(0);
-    meshData.Indices32.resize(0);
-
     //       v1
     //       *
     //      / \
@@ -233,48 +354,55 @@ void GeometryGenerator::Subdivide(MeshData& meshData)
 	// *-----*-----*
 // v0    m2     v2
 
-    uint32 numTris = (uint32)inputCopy.Indices32.size() / 3;
+    // Every edge is split once, triangles which share edge share its midpoint. Closed mesh has 3/2 edges per triangle,
+    // meshes with borders grow vertices past reserved count.
+    uint32 numTris = (uint32)meshData.Indices32.size() / 3;
+    uint32 numEdges = numTris * 3 / 2;
+    meshData.Vertices.reserve(meshData.Vertices.size() + numEdges);
+
+    EdgeMap midPoints(numEdges);
+    auto getMidPoint = [this, &meshData, &midPoints](uint32 i0, uint32 i1)
+    {
+        bool inserted = false;
+        uint32& midPoint = midPoints.Insert(i0, i1, inserted);
+        if (inserted)
+        {
+            midPoint = (uint32)meshData.Vertices.size();
+            Vertex v = MidPoint(meshData.Vertices[i0], meshData.Vertices[i1]);
+            meshData.Vertices.push_back(v);
+        }
+        return midPoint;
+    };
+
+    std::vector<uint32> indices(numTris * 12);
     for (uint32 i = 0; i < numTris; ++i)
     {
-        Vertex v0 = inputCopy.Vertices[inputCopy.Indices32[i * 3 + 0]];
-        Vertex v1 = inputCopy.Vertices[inputCopy.Indices32[i * 3 + 1]];
-        Vertex v2 = inputCopy.Vertices[inputCopy.Indices32[i * 3 + 2]];
-
-        //
-        // Generate the midpoints.
-        //
-
-        Vertex m0 = MidPoint(v0, v1);
-        Vertex m1 = MidPoint(v1, v2);
-        Vertex m2 = MidPoint(v0, v2);
-
-        //
-        // Add new geometry.
-        //
-
-        meshData.Vertices.push_back(v0); // 0
-        meshData.Vertices.push_back(v1); // 1
-        meshData.Vertices.push_back(v2); // 2
-        meshData.Vertices.push_back(m0); // 3
-        meshData.Vertices.push_back(m1); // 4
-        meshData.Vertices.push_back(m2); // 5
-
-        meshData.Indices32.push_back(i * 6 + 0);
-        meshData.Indices32.push_back(i * 6 + 3);
-        meshData.Indices32.push_back(i * 6 + 5);
-
-        meshData.Indices32.push_back(i * 6 + 3);
-        meshData.Indices32.push_back(i * 6 + 4);
-        meshData.Indices32.push_back(i * 6 + 5);
-
-        meshData.Indices32.push_back(i * 6 + 5);
-        meshData.Indices32.push_back(i * 6 + 4);
-        meshData.Indices32.push_back(i * 6 + 2);
-
-        meshData.Indices32.push_back(i * 6 + 3);
-        meshData.Indices32.push_back(i * 6 + 1);
-        meshData.Indices32.push_back(i * 6 + 4);
+        uint32 v0 = meshData.Indices32[i * 3 + 0];
+        uint32 v1 = meshData.Indices32[i * 3 + 1];
+        uint32 v2 = meshData.Indices32[i * 3 + 2];
+
+        uint32 m0 = getMidPoint(v0, v1);
+        uint32 m1 = getMidPoint(v1, v2);
+        uint32 m2 = getMidPoint(v0, v2);
+
+        uint32* triangles = &indices[i * 12];
+        triangles[0] = v0;
+        triangles[1] = m0;
+        triangles[2] = m2;
+
+        triangles[3] = m0;
+        triangles[4] = m1;
+        triangles[5] = m2;
+
+        triangles[6] = m2;
+        triangles[7] = m1;
+        triangles[8] = v2;
+
+        triangles[9] = m0;
+        triangles[10] = v1;
+        triangles[11] = m1;
     }
+    meshData.Indices32.swap(indices);
 }
 
 GeometryGenerator::Vertex GeometryGenerator::MidPoint(const Vertex& v0, const Vertex& v1)
@@ -312,7 +440,7 @@ GeometryGenerator::MeshData GeometryGenerator::CreateGeosphere(float radius, uin
     MeshData meshData;
 
     // Put a cap on the number of subdivisions.
-    numSubdivisions = std::min<uint32>(numSubdivisions, 6u);
+    numSubdivisions = std::min<uint32>(numSubdivisions, 8u);
 
     // Approximate a sphere by tessellating an icosahedron.
 
@@ -337,6 +465,8 @@ GeometryGenerator::MeshData GeometryGenerator::CreateGeosphere(float radius, uin
         10,1,6, 11,0,9, 2,11,9, 5,2,9,  11,2,7
     };
 
+    // Every subdivision adds vertex per edge, so sphere ends up with 10 * 4^n + 2 vertices.
+    meshData.Vertices.reserve(10 * ((size_t)1 << (2 * numSubdivisions)) + 2);
     meshData.Vertices.resize(12);
     meshData.Indices32.assign(&k[0], &k[60]);
 
@@ -397,78 +527,94 @@ GeometryGenerator::MeshData GeometryGenerator::CreateCylinder(float bottomRadius
 
     uint32 ringCount = stackCount + 1;
 
+    // Add one because we duplicate the first and last vertex per ring
+    // since the texture coordinates are different.
+    uint32 ringVertexCount = sliceCount + 1;
+
+    // Caps have ring and center vertex each and are appended after stacks.
+    meshData.Vertices.resize(ringCount*ringVertexCount);
+    meshData.Vertices.reserve(meshData.Vertices.size() + 2 * (ringVertexCount + 1));
+    meshData.Indices32.resize(stackCount*sliceCount * 6);
+    meshData.Indices32.reserve(meshData.Indices32.size() + 2 * sliceCount * 3);
+
+    float dTheta = 2.0f*XM_PI / sliceCount;
+    std::vector<float> sines;
+    std::vector<float> cosines;
+    ComputeRingAngles(sliceCount, dTheta, sines, cosines);
+
     // Compute vertices for each stack ring starting at the bottom and moving up.
-    for (uint32 i = 0; i < ringCount; ++i)
+    ForEachRow(ringCount, ringVertexCount, [&](uint32 begin, uint32 end)
     {
-        float y = -0.5f*height + i*stackHeight;
-        float r = bottomRadius + i*radiusStep;
-
-        // vertices of ring
-        float dTheta = 2.0f*XM_PI / sliceCount;
-        for (uint32 j = 0; j <= sliceCount; ++j)
+        for (uint32 i = begin; i < end; ++i)
         {
-            Vertex vertex;
-
-            float c = cosf(j*dTheta);
-            float s = sinf(j*dTheta);
-
-            vertex.Position = XMFLOAT3(r*c, y, r*s);
-
-            vertex.TexCoord.x = (float)j / sliceCount;
-            vertex.TexCoord.y = 1.0f - (float)i / stackCount;
-
-            // Cylinder can be parameterized as follows, where we introduce v
-            // parameter that goes in the same direction as the v tex-coord
-            // so that the bitangent goes in the same direction as the v tex-coord.
-            //   Let r0 be the bottom radius and let r1 be the top radius.
-            //   y(v) = h - hv for v in [0,1].
-            //   r(v) = r1 + (r0-r1)v
-            //
-            //   x(t, v) = r(v)*cos(t)
-            //   y(t, v) = h - hv
-            //   z(t, v) = r(v)*sin(t)
-            // 
-            //  dx/dt = -r(v)*sin(t)
-            //  dy/dt = 0
-            //  dz/dt = +r(v)*cos(t)
-            //
-            //  dx/dv = (r0-r1)*cos(t)
-            //  dy/dv = -h
-            //  dz/dv = (r0-r1)*sin(t)
-
-            // This is unit length.
-            vertex.Tangent = XMFLOAT3(-s, 0.0f, c);
-
-            float dr = bottomRadius - topRadius;
-            XMFLOAT3 bitangent(dr*c, -height, dr*s);
-
-            XMVECTOR T = XMLoadFloat3(&vertex.Tangent);
-            XMVECTOR B = XMLoadFloat3(&bitangent);
-            XMVECTOR N = XMVector3Normalize(XMVector3Cross(T, B));
-            XMStoreFloat3(&vertex.Normal, N);
-
-            meshData.Vertices.push_back(vertex);
+            float y = -0.5f*height + i*stackHeight;
+            float r = bottomRadius + i*radiusStep;
+
+            // vertices of ring
+            Vertex* ring = &meshData.Vertices[i*ringVertexCount];
+            for (uint32 j = 0; j <= sliceCount; ++j)
+            {
+                Vertex& vertex = ring[j];
+
+                float c = cosines[j];
+                float s = sines[j];
+
+                vertex.Position = XMFLOAT3(r*c, y, r*s);
+
+                vertex.TexCoord.x = (float)j / sliceCount;
+                vertex.TexCoord.y = 1.0f - (float)i / stackCount;
+
+                // Cylinder can be parameterized as follows, where we introduce v
+                // parameter that goes in the same direction as the v tex-coord
+                // so that the bitangent goes in the same direction as the v tex-coord.
+                //   Let r0 be the bottom radius and let r1 be the top radius.
+                //   y(v) = h - hv for v in [0,1].
+                //   r(v) = r1 + (r0-r1)v
+                //
+                //   x(t, v) = r(v)*cos(t)
+                //   y(t, v) = h - hv
+                //   z(t, v) = r(v)*sin(t)
+                // 
+                //  dx/dt = -r(v)*sin(t)
+                //  dy/dt = 0
+                //  dz/dt = +r(v)*cos(t)
+                //
+                //  dx/dv = (r0-r1)*cos(t)
+                //  dy/dv = -h
+                //  dz/dv = (r0-r1)*sin(t)
+
+                // This is unit length.
+                vertex.Tangent = XMFLOAT3(-s, 0.0f, c);
+
+                float dr = bottomRadius - topRadius;
+                XMFLOAT3 bitangent(dr*c, -height, dr*s);
+
+                XMVECTOR T = XMLoadFloat3(&vertex.Tangent);
+                XMVECTOR B = XMLoadFloat3(&bitangent);
+                XMVECTOR N = XMVector3Normalize(XMVector3Cross(T, B));
+                XMStoreFloat3(&vertex.Normal, N);
+            }
         }
-    }
-
-    // Add one because we duplicate the first and last vertex per ring
-    // since the texture coordinates are different.
-    uint32 ringVertexCount = sliceCount + 1;
+    });
 
     // Compute indices for each stack.
-    for (uint32 i = 0; i < stackCount; ++i)
+    ForEachRow(stackCount, sliceCount * 2, [&](uint32 begin, uint32 end)
     {
-        for (uint32 j = 0; j < sliceCount; ++j)
+        for (uint32 i = begin; i < end; ++i)
         {
-            meshData.Indices32.push_back(i*ringVertexCount + j);
-            meshData.Indices32.push_back((i + 1)*ringVertexCount + j);
-            meshData.Indices32.push_back((i + 1)*ringVertexCount + j + 1);
-
-            meshData.Indices32.push_back(i*ringVertexCount + j);
-            meshData.Indices32.push_back((i + 1)*ringVertexCount + j + 1);
-            meshData.Indices32.push_back(i*ringVertexCount + j + 1);
+            uint32* stack = &meshData.Indices32[i*sliceCount * 6];
+            for (uint32 j = 0; j < sliceCount; ++j)
+            {
+                *stack++ = i*ringVertexCount + j;
+                *stack++ = (i + 1)*ringVertexCount + j;
+                *stack++ = (i + 1)*ringVertexCount + j + 1;
+
+                *stack++ = i*ringVertexCount + j;
+                *stack++ = (i + 1)*ringVertexCount + j + 1;
+                *stack++ = i*ringVertexCount + j + 1;
+            }
         }
-    }
+    });
 
     BuildCylinderTopCap(bottomRadius, topRadius, height, sliceCount, stackCount, meshData);
     BuildCylinderBottomCap(bottomRadius, topRadius, height, sliceCount, stackCount, meshData);
@@ -572,22 +718,26 @@ GeometryGenerator::MeshData GeometryGenerator::CreateGrid(float width, float dep
     float dv = 1.0f / (m - 1);
 
     meshData.Vertices.resize(vertexCount);
-    for (uint32 i = 0; i < m; ++i)
+    ForEachRow(m, n, [&](uint32 begin, uint32 end)
     {
-        float z = halfDepth - i*dz;
-        for (uint32 j = 0; j < n; ++j)
+        for (uint32 i = begin; i < end; ++i)
         {
-            float x = -halfWidth + j*dx;
-
-            meshData.Vertices[i*n + j].Position = XMFLOAT3(x, 0.0f, z);
-            meshData.Vertices[i*n + j].Normal = XMFLOAT3(0.0f, 1.0f, 0.0f);
-            meshData.Vertices[i*n + j].Tangent = XMFLOAT3(1.0f, 0.0f, 0.0f);
-
-            // Stretch texture over grid.
-            meshData.Vertices[i*n + j].TexCoord.x = j*du;
-            meshData.Vertices[i*n + j].TexCoord.y = i*dv;
+            float z = halfDepth - i*dz;
+            Vertex* row = &meshData.Vertices[i*n];
+            for (uint32 j = 0; j < n; ++j)
+            {
+                float x = -halfWidth + j*dx;
+
+                row[j].Position = XMFLOAT3(x, 0.0f, z);
+                row[j].Normal = XMFLOAT3(0.0f, 1.0f, 0.0f);
+                row[j].Tangent = XMFLOAT3(1.0f, 0.0f, 0.0f);
+
+                // Stretch texture over grid.
+                row[j].TexCoord.x = j*du;
+                row[j].TexCoord.y = i*dv;
+            }
         }
-    }
+    });
 
     //
     // Create the indices.
@@ -595,22 +745,25 @@ GeometryGenerator::MeshData GeometryGenerator::CreateGrid(float width, float dep
 
     meshData.Indices32.resize(faceCount * 3); // 3 indices per face
     // Iterate over each quad and compute indices.
-    uint32 k = 0;
-    for (uint32 i = 0; i < m - 1; ++i)
+    ForEachRow(m - 1, (n - 1) * 2, [&](uint32 begin, uint32 end)
     {
-        for (uint32 j = 0; j < n - 1; ++j)
+        for (uint32 i = begin; i < end; ++i)
         {
-            meshData.Indices32[k] = i*n + j;
-            meshData.Indices32[k + 1] = i*n + j + 1;
-            meshData.Indices32[k + 2] = (i + 1)*n + j;
-
-            meshData.Indices32[k + 3] = (i + 1)*n + j;
-            meshData.Indices32[k + 4] = i*n + j + 1;
-            meshData.Indices32[k + 5] = (i + 1)*n + j + 1;
-
-            k += 6; // next quad
+            uint32 k = i*(n - 1) * 6;
+            for (uint32 j = 0; j < n - 1; ++j)
+            {
+                meshData.Indices32[k] = i*n + j;
+                meshData.Indices32[k + 1] = i*n + j + 1;
+                meshData.Indices32[k + 2] = (i + 1)*n + j;
+
+                meshData.Indices32[k + 3] = (i + 1)*n + j;
+                meshData.Indices32[k + 4] = i*n + j + 1;
+                meshData.Indices32[k + 5] = (i + 1)*n + j + 1;
+
+                k += 6; // next quad
+            }
         }
-    }
+    });
 
     return meshData;
 }
@@ -657,4 +810,18 @@ GeometryGenerator::MeshData GeometryGenerator::CreateQuad(float x, float y, floa
 
     return meshData;
 }
+void GeometryGenerator::ForEachRow(uint32 rowCount, uint32 rowSize, const std::function<void(uint32 begin, uint32 end)>& job) const
+{
+    if (_jobs == nullptr || rowCount == 0)
+    {
+        job(0, rowCount);
+        return;
+    }
+
+    uint32 grainSize = std::max<uint32>(RowGrainVertices / std::max<uint32>(rowSize, 1u), 1u);
+    _jobs->ParallelFor(rowCount, grainSize, [&job](UINT begin, UINT end, UINT workerIndex)
+    {
+        job(begin, end);
+    });
+}
 }
\ No newline at end of file
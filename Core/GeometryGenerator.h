@@ -4,11 +4,15 @@
 
 #pragma once
 
+#include <cassert>
 #include <DirectXMath.h>
+#include <functional>
 #include <vector>
 
 namespace DX12Samples
 {
+class JobSystem;
+
 class GeometryGenerator
 {
 public:
@@ -44,21 +48,22 @@ public:
         std::vector<Vertex> Vertices;
         std::vector<uint32> Indices32;
 
-        std::vector<uint16>& GetIndices16()
-        {
-            if (_indices16.empty())
-            {
-                _indices16.resize(Indices32.size());
-                for (size_t i = 0; i < Indices32.size(); i++)
-                {
-                    _indices16[i] = static_cast<uint16>(Indices32[i]);
-                }
-            }
-            return _indices16;
-        }
+        /**
+         * \brief Indices converted to 16 bit. Throws DxException if mesh has more than 65536 vertices, split larger meshes
+         * with MeshPartitioner::Split.
+         */
+        std::vector<uint16>& GetIndices16();
     private:
         std::vector<uint16> _indices16;
     };
+
+    GeometryGenerator() = default;
+    /**
+     * \brief Generator which fills rows of grids and rings of spheres and cylinders in parallel on job system workers.
+     * Output is the same as of serial generator.
+     */
+    explicit GeometryGenerator(JobSystem& jobs);
+
      /**
      * \brief Struct which describes single vertex. Creates a box centered at the origin with the given dimensions, where each
      * face has m rows and n columns of vertices.
@@ -71,7 +76,9 @@ public:
     MeshData CreateSphere(float radius, uint32 sliceCount, uint32 stackCount);
     /**
      * \brief Creates a geosphere centered at the origin with the given radius.  The
-     * depth controls the level of tessellation.
+     * depth controls the level of tessellation, at most 8. Vertices are shared, so depth n has 10 * 4^n + 2 of them.
+     * Depth 6 is the deepest one with 16 bit indices, depth 7 and 8 have to be drawn with Indices32 or split by
+     * MeshPartitioner::Split, GetIndices16 throws for them.
      */
     MeshData CreateGeosphere(float radius, uint32 numSubdivisions);
     /**
@@ -91,9 +98,18 @@ public:
     MeshData CreateQuad(float x, float y, float w, float h, float depth);
 
 private:
+    /**
+     * \brief Split every triangle into four. Midpoint of edge is created once and shared by triangles of that edge.
+     */
     void Subdivide(MeshData& meshData);
     Vertex MidPoint(const Vertex& v0, const Vertex& v1);
     void BuildCylinderTopCap(float bottomRadius, float topRadius, float height, uint32 sliceCount, uint32 stackCount, MeshData& meshData);
     void BuildCylinderBottomCap(float bottomRadius, float topRadius, float height, uint32 sliceCount, uint32 stackCount, MeshData& meshData);
+    /**
+     * \brief Run job over rows [0, rowCount) of rowSize elements, in chunks on job system workers if generator has it.
+     */
+    void ForEachRow(uint32 rowCount, uint32 rowSize, const std::function<void(uint32 begin, uint32 end)>& job) const;
+
+    JobSystem* _jobs = nullptr;
 };
 }
\ No newline at end of file
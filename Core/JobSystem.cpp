@@ -0,0 +1,148 @@
+#include "JobSystem.h"
+
+namespace DX12Samples
+{
+JobSystem::JobSystem(int threadCount)
+{
+    if (threadCount < 0)
+        threadCount = MathHelper::Max((int)std::thread::hardware_concurrency() - 1, 0);
+
+    for (int i = 0; i < threadCount + 1; i++)
+        _queues.push_back(std::make_unique<WorkerQueue>());
+
+    for (int i = 0; i < threadCount; i++)
+        _threads.emplace_back(&JobSystem::WorkerLoop, this, (UINT)i + 1);
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(_wakeMutex);
+        _stop = true;
+    }
+    _wakeCondition.notify_all();
+    for (auto& thread : _threads)
+        thread.join();
+}
+
+UINT JobSystem::WorkerCount() const
+{
+    return (UINT)_queues.size();
+}
+
+void JobSystem::ParallelFor(UINT count, UINT grainSize, const RangeJob& job)
+{
+    if (count == 0)
+        return;
+    grainSize = MathHelper::Max(grainSize, 1u);
+    UINT taskCount = (count + grainSize - 1) / grainSize;
+
+    if (taskCount == 1 || _threads.empty())
+    {
+        job(0, count, 0);
+        return;
+    }
+
+    _unfinishedTasks += taskCount;
+    // Count tasks before publishing them, otherwise worker can take a task and decrement counter before it was incremented.
+    {
+        std::lock_guard<std::mutex> lock(_wakeMutex);
+        _queuedTasks += taskCount;
+    }
+    // Deal contiguous runs of chunks to each queue so workers touch neighbouring data, idle workers steal the rest.
+    UINT workerCount = WorkerCount();
+    UINT tasksPerWorker = (taskCount + workerCount - 1) / workerCount;
+    for (UINT i = 0; i < taskCount; i++)
+    {
+        Task task;
+        task.Job = &job;
+        task.Begin = i * grainSize;
+        task.End = MathHelper::Min(task.Begin + grainSize, count);
+
+        WorkerQueue& queue = *_queues[i / tasksPerWorker];
+        std::lock_guard<std::mutex> lock(queue.Mutex);
+        queue.Tasks.push_back(task);
+    }
+    _wakeCondition.notify_all();
+
+    Task task;
+    while (_unfinishedTasks.load() > 0)
+    {
+        if (TryGetTask(0, task))
+            RunTask(task, 0);
+        else
+            std::this_thread::yield();
+    }
+
+    std::exception_ptr exception;
+    {
+        std::lock_guard<std::mutex> lock(_exceptionMutex);
+        std::swap(exception, _firstException);
+    }
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
+void JobSystem::WorkerLoop(UINT workerIndex)
+{
+    Task task;
+    while (true)
+    {
+        if (TryGetTask(workerIndex, task))
+        {
+            RunTask(task, workerIndex);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_wakeMutex);
+        _wakeCondition.wait(lock, [this] { return _stop || _queuedTasks.load() > 0; });
+        if (_stop)
+            return;
+    }
+}
+
+bool JobSystem::TryGetTask(UINT workerIndex, Task& task)
+{
+    {
+        WorkerQueue& queue = *_queues[workerIndex];
+        std::lock_guard<std::mutex> lock(queue.Mutex);
+        if (!queue.Tasks.empty())
+        {
+            task = queue.Tasks.back();
+            queue.Tasks.pop_back();
+            _queuedTasks--;
+            return true;
+        }
+    }
+    UINT workerCount = WorkerCount();
+    for (UINT i = 1; i < workerCount; i++)
+    {
+        WorkerQueue& victim = *_queues[(workerIndex + i) % workerCount];
+        std::lock_guard<std::mutex> lock(victim.Mutex);
+        if (!victim.Tasks.empty())
+        {
+            task = victim.Tasks.front();
+            victim.Tasks.pop_front();
+            _queuedTasks--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::RunTask(const Task& task, UINT workerIndex)
+{
+    try
+    {
+        (*task.Job)(task.Begin, task.End, workerIndex);
+    }
+    catch (...)
+    {
+        // Caller waits for counter to reach zero, so it has to be decremented even if job fails.
+        std::lock_guard<std::mutex> lock(_exceptionMutex);
+        if (!_firstException)
+            _firstException = std::current_exception();
+    }
+    _unfinishedTasks--;
+}
+}
@@ -0,0 +1,79 @@
+//
+// Simple work stealing job system on top of std::thread.
+//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "D3DUtil.h"
+
+namespace DX12Samples
+{
+class JobSystem
+{
+public:
+    /**
+     * \brief Job function which processes range [begin, end). workerIndex is in [0, WorkerCount()) and can be used to pick per thread scratch data.
+     */
+    using RangeJob = std::function<void(UINT begin, UINT end, UINT workerIndex)>;
+
+    /**
+     * \brief Creates job system with threadCount background threads. Calling thread also participates as worker 0.
+     * If threadCount is -1 uses hardware concurrency minus one.
+     */
+    explicit JobSystem(int threadCount = -1);
+    JobSystem(const JobSystem& rhs) = delete;
+    JobSystem& operator=(const JobSystem& rhs) = delete;
+    ~JobSystem();
+
+    /**
+     * \brief Total amount of workers including calling thread.
+     */
+    UINT WorkerCount() const;
+    /**
+     * \brief Split [0, count) into chunks of grainSize and process them on all workers. Returns when all chunks are done.
+     * Must be called from one thread at a time and not from inside of a job.
+     * If a job throws, remaining chunks still run and the first exception is rethrown on the calling thread.
+     */
+    void ParallelFor(UINT count, UINT grainSize, const RangeJob& job);
+
+private:
+    struct Task
+    {
+        const RangeJob* Job = nullptr;
+        UINT Begin = 0;
+        UINT End = 0;
+    };
+
+    struct WorkerQueue
+    {
+        std::mutex Mutex;
+        std::deque<Task> Tasks;
+    };
+
+    void WorkerLoop(UINT workerIndex);
+    /**
+     * \brief Pop task from own queue back or steal one from front of other queues.
+     */
+    bool TryGetTask(UINT workerIndex, Task& task);
+    void RunTask(const Task& task, UINT workerIndex);
+
+    std::vector<std::thread> _threads;
+    std::vector<std::unique_ptr<WorkerQueue>> _queues;
+
+    std::mutex _wakeMutex;
+    std::condition_variable _wakeCondition;
+    std::atomic<UINT> _queuedTasks{ 0 };
+    std::atomic<UINT> _unfinishedTasks{ 0 };
+    std::mutex _exceptionMutex;
+    std::exception_ptr _firstException;
+    bool _stop = false;
+};
+}
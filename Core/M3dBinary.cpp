@@ -0,0 +1,166 @@
+#include "M3dBinary.h"
+
+namespace DX12Samples
+{
+namespace
+{
+UINT64 AlignOffset(UINT64 offset)
+{
+    return (offset + M3dBinaryFile::Alignment - 1) & ~UINT64(M3dBinaryFile::Alignment - 1);
+}
+}
+
+M3dBinaryFile::~M3dBinaryFile()
+{
+    Close();
+}
+
+bool M3dBinaryFile::Open(const std::string& filename)
+{
+    Close();
+
+    _file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (_file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(_file, &fileSize) || (UINT64)fileSize.QuadPart < sizeof(M3dBinaryHeader))
+    {
+        Close();
+        return false;
+    }
+    _size = (UINT64)fileSize.QuadPart;
+
+    _mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (_mapping != nullptr)
+        _data = static_cast<const BYTE*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (_data == nullptr)
+    {
+        Close();
+        return false;
+    }
+
+    const M3dBinaryHeader* header = reinterpret_cast<const M3dBinaryHeader*>(_data);
+    UINT64 tableEnd = sizeof(M3dBinaryHeader) + (UINT64)header->SectionCount * sizeof(M3dBinarySection);
+    if (header->Magic != Magic || header->Version != Version || tableEnd > _size)
+    {
+        Close();
+        return false;
+    }
+
+    _sections = reinterpret_cast<const M3dBinarySection*>(_data + sizeof(M3dBinaryHeader));
+    _sectionCount = header->SectionCount;
+    for (UINT i = 0; i < _sectionCount; i++)
+    {
+        const M3dBinarySection& section = _sections[i];
+        bool inside = section.Offset >= tableEnd && section.ByteSize <= _size && section.Offset <= _size - section.ByteSize;
+        if (!inside || section.Offset % Alignment != 0)
+        {
+            Close();
+            return false;
+        }
+    }
+
+    // String lookups rely on terminating zero at the end of section.
+    UINT stringsSize = 0;
+    const char* strings = GetSection<char>(M3dSectionType::Strings, stringsSize);
+    if (strings != nullptr && stringsSize > 0 && strings[stringsSize - 1] != '\0')
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void M3dBinaryFile::Close()
+{
+    if (_data != nullptr)
+        UnmapViewOfFile(_data);
+    if (_mapping != nullptr)
+        CloseHandle(_mapping);
+    if (_file != INVALID_HANDLE_VALUE)
+        CloseHandle(_file);
+
+    _file = INVALID_HANDLE_VALUE;
+    _mapping = nullptr;
+    _data = nullptr;
+    _size = 0;
+    _sections = nullptr;
+    _sectionCount = 0;
+}
+
+bool M3dBinaryFile::IsOpen() const
+{
+    return _data != nullptr;
+}
+
+const char* M3dBinaryFile::GetString(UINT offset) const
+{
+    UINT stringsSize = 0;
+    const char* strings = GetSection<char>(M3dSectionType::Strings, stringsSize);
+    if (strings == nullptr || offset >= stringsSize)
+        return "";
+    return strings + offset;
+}
+
+const M3dBinarySection* M3dBinaryFile::FindSection(M3dSectionType type) const
+{
+    for (UINT i = 0; i < _sectionCount; i++)
+    {
+        if (_sections[i].Type == type)
+            return &_sections[i];
+    }
+    return nullptr;
+}
+
+UINT M3dBinaryWriter::AddString(const std::string& str)
+{
+    UINT offset = (UINT)_strings.size();
+    _strings.insert(_strings.end(), str.begin(), str.end());
+    _strings.push_back('\0');
+    return offset;
+}
+
+bool M3dBinaryWriter::Write(const std::string& filename) const
+{
+    std::vector<M3dBinarySection> table(_sections.size() + 1);
+    table[0].Type = M3dSectionType::Strings;
+    table[0].Count = (UINT)_strings.size();
+    table[0].ByteSize = _strings.size();
+    for (size_t i = 0; i < _sections.size(); i++)
+    {
+        table[i + 1].Type = _sections[i].Type;
+        table[i + 1].Count = _sections[i].Count;
+        table[i + 1].ByteSize = _sections[i].Data.size();
+    }
+
+    UINT64 offset = sizeof(M3dBinaryHeader) + table.size() * sizeof(M3dBinarySection);
+    for (M3dBinarySection& section : table)
+    {
+        section.Offset = AlignOffset(offset);
+        offset = section.Offset + section.ByteSize;
+    }
+
+    std::ofstream fout(filename, std::ios::binary | std::ios::trunc);
+    if (!fout)
+        return false;
+
+    M3dBinaryHeader header;
+    header.Magic = M3dBinaryFile::Magic;
+    header.Version = M3dBinaryFile::Version;
+    header.SectionCount = (UINT)table.size();
+    fout.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    fout.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(M3dBinarySection));
+
+    const char padding[M3dBinaryFile::Alignment] = {};
+    UINT64 written = sizeof(M3dBinaryHeader) + table.size() * sizeof(M3dBinarySection);
+    for (size_t i = 0; i < table.size(); i++)
+    {
+        const std::vector<char>& data = i == 0 ? _strings : _sections[i - 1].Data;
+        fout.write(padding, table[i].Offset - written);
+        fout.write(data.data(), data.size());
+        written = table[i].Offset + data.size();
+    }
+    return (bool)fout;
+}
+}
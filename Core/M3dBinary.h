@@ -0,0 +1,164 @@
+//
+// Binary container for M3D meshes, memory mapped and used without parsing.
+//
+
+#pragma once
+
+#include "D3DUtil.h"
+
+namespace DX12Samples
+{
+// File is M3dBinaryHeader, table of SectionCount M3dBinarySection entries and section blobs. Every blob starts at
+// M3dBinaryFile::Alignment aligned offset and is an array of Count fixed size records, so vertices, indices and bone
+// matrices can be used straight from mapped memory. Strings are zero terminated and referenced by offset in Strings.
+enum class M3dSectionType : UINT
+{
+    Strings,
+    Materials,
+    Subsets,
+    Vertices,
+    SkinnedVertices,
+    Indices,
+    BoneOffsets,
+    BoneHierarchy,
+    Clips,
+    BoneTracks,
+    Keyframes
+};
+
+struct M3dBinaryHeader
+{
+    UINT Magic = 0;
+    UINT Version = 0;
+    UINT SectionCount = 0;
+    UINT Reserved = 0;
+};
+
+struct M3dBinarySection
+{
+    M3dSectionType Type = M3dSectionType::Strings;
+    UINT Count = 0;
+    UINT64 Offset = 0;
+    UINT64 ByteSize = 0;
+};
+
+struct M3dBinaryMaterial
+{
+    UINT NameOffset = 0;
+    UINT MaterialTypeNameOffset = 0;
+    UINT DiffuseMapNameOffset = 0;
+    UINT NormalMapNameOffset = 0;
+    DirectX::XMFLOAT4 DiffuseAlbedo;
+    DirectX::XMFLOAT3 FresnelR0;
+    float Roughness = 0.0f;
+    UINT AlphaClip = 0;
+};
+
+// Clip owns BoneCount consecutive tracks starting from FirstTrack, one per bone.
+struct M3dBinaryClip
+{
+    UINT NameOffset = 0;
+    UINT FirstTrack = 0;
+};
+
+struct M3dBinaryTrack
+{
+    UINT FirstKeyframe = 0;
+    UINT KeyframeCount = 0;
+};
+
+struct M3dBinaryKeyframe
+{
+    float TimePos;
+    DirectX::XMFLOAT3 Translation;
+    DirectX::XMFLOAT3 Scale;
+    DirectX::XMFLOAT4 RotationQuat;
+};
+
+class M3dBinaryFile
+{
+public:
+    static const UINT Magic = 0x4244334D; // "M3DB"
+    static const UINT Version = 1;
+    static const UINT Alignment = 16;
+
+    M3dBinaryFile() = default;
+    M3dBinaryFile(const M3dBinaryFile& rhs) = delete;
+    M3dBinaryFile& operator=(const M3dBinaryFile& rhs) = delete;
+    ~M3dBinaryFile();
+
+    /**
+     * \brief Map file to memory and validate header and section table. Returns false if file is missing, has other
+     * version or is corrupted.
+     */
+    bool Open(const std::string& filename);
+    void Close();
+    bool IsOpen() const;
+
+    /**
+     * \brief Get records of section. Returns nullptr and count 0 if there is no such section or its record size isn't sizeof(T).
+     * Pointer is valid until file is closed.
+     */
+    template<typename T>
+    const T* GetSection(M3dSectionType type, UINT& count) const
+    {
+        const M3dBinarySection* section = FindSection(type);
+        if (section == nullptr || section->ByteSize != (UINT64)section->Count * sizeof(T))
+        {
+            count = 0;
+            return nullptr;
+        }
+        count = section->Count;
+        return reinterpret_cast<const T*>(_data + section->Offset);
+    }
+    /**
+     * \brief Get string by offset in Strings section, empty string if offset is out of range.
+     */
+    const char* GetString(UINT offset) const;
+
+private:
+    const M3dBinarySection* FindSection(M3dSectionType type) const;
+
+    HANDLE _file = INVALID_HANDLE_VALUE;
+    HANDLE _mapping = nullptr;
+    const BYTE* _data = nullptr;
+    UINT64 _size = 0;
+    const M3dBinarySection* _sections = nullptr;
+    UINT _sectionCount = 0;
+};
+
+class M3dBinaryWriter
+{
+public:
+    template<typename T>
+    void AddSection(M3dSectionType type, const T* records, UINT count)
+    {
+        Section section;
+        section.Type = type;
+        section.Count = count;
+        section.Data.resize(count * sizeof(T));
+        if (count > 0)
+            memcpy(section.Data.data(), records, section.Data.size());
+        _sections.push_back(std::move(section));
+    }
+    /**
+     * \brief Add string to Strings section, which is written automatically. Returns its offset.
+     */
+    UINT AddString(const std::string& str);
+    /**
+     * \brief Write header, section table and aligned sections. Returns false if file can't be written.
+     */
+    bool Write(const std::string& filename) const;
+
+private:
+    struct Section
+    {
+        M3dSectionType Type;
+        UINT Count;
+        std::vector<char> Data;
+    };
+
+    std::vector<Section> _sections;
+    std::vector<char> _strings;
+};
+}
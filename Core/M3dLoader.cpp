@@ -4,58 +4,367 @@ namespace DX12Samples
 {
 using namespace DirectX;
 
+namespace
+{
+// Tokens per record including labels, used to split sections between parallel chunks.
+const UINT VertexTokens = 16;
+const UINT SkinnedVertexTokens = 26;
+const UINT TriangleTokens = 3;
+const UINT TextModelVertexTokens = 6;
+// Every M3D section starts with line of asterisks, lists of text models end with closing brace.
+const char SectionHeaderChar = '*';
+const char TextModelListEnd = '}';
+
+/**
+ * \brief Copy section out of mapped file. LoadM3d returns owning vectors, so records are copied once with single memcpy,
+ * callers which want to use records in place read them with M3dBinaryFile::GetSection.
+ */
+template<typename T>
+bool CopySection(const M3dBinaryFile& file, M3dSectionType type, std::vector<T>& records)
+{
+    UINT count = 0;
+    const T* data = file.GetSection<T>(type, count);
+    if (data == nullptr)
+        return false;
+    records.assign(data, data + count);
+    return true;
+}
+
+template<typename TVertex>
+void AddMeshSections(M3dBinaryWriter& writer, M3dSectionType vertexType, const std::vector<TVertex>& vertices,
+    const std::vector<USHORT>& indices, const std::vector<M3dLoader::Subset>& subsets, const std::vector<M3dLoader::M3dMaterial>& mats)
+{
+    std::vector<M3dBinaryMaterial> binaryMats(mats.size());
+    for (size_t i = 0; i < mats.size(); i++)
+    {
+        binaryMats[i].NameOffset = writer.AddString(mats[i].Name);
+        binaryMats[i].MaterialTypeNameOffset = writer.AddString(mats[i].MaterialTypeName);
+        binaryMats[i].DiffuseMapNameOffset = writer.AddString(mats[i].DiffuseMapName);
+        binaryMats[i].NormalMapNameOffset = writer.AddString(mats[i].NormalMapName);
+        binaryMats[i].DiffuseAlbedo = mats[i].DiffuseAlbedo;
+        binaryMats[i].FresnelR0 = mats[i].FresnelR0;
+        binaryMats[i].Roughness = mats[i].Roughness;
+        binaryMats[i].AlphaClip = mats[i].AlphaClip ? 1 : 0;
+    }
+
+    writer.AddSection(M3dSectionType::Materials, binaryMats.data(), (UINT)binaryMats.size());
+    writer.AddSection(M3dSectionType::Subsets, subsets.data(), (UINT)subsets.size());
+    writer.AddSection(vertexType, vertices.data(), (UINT)vertices.size());
+    writer.AddSection(M3dSectionType::Indices, indices.data(), (UINT)indices.size());
+}
+
+void AddSkeletonSections(M3dBinaryWriter& writer, const std::vector<XMFLOAT4X4>& boneOffsets, const std::vector<int>& boneIndexToParentIndex,
+    const std::unordered_map<std::string, AnimationClip>& animations)
+{
+    std::vector<M3dBinaryClip> clips;
+    std::vector<M3dBinaryTrack> tracks;
+    std::vector<M3dBinaryKeyframe> keyframes;
+    for (const auto& animation : animations)
+    {
+        M3dBinaryClip clip;
+        clip.NameOffset = writer.AddString(animation.first);
+        clip.FirstTrack = (UINT)tracks.size();
+        clips.push_back(clip);
+
+        for (const BoneAnimation& boneAnimation : animation.second.BoneAnimations)
+        {
+            M3dBinaryTrack track;
+            track.FirstKeyframe = (UINT)keyframes.size();
+            track.KeyframeCount = (UINT)boneAnimation.Keyframes.size();
+            tracks.push_back(track);
+
+            for (const Keyframe& keyframe : boneAnimation.Keyframes)
+                keyframes.push_back({ keyframe.TimePos, keyframe.Translation, keyframe.Scale, keyframe.RotationQuat });
+        }
+    }
+
+    writer.AddSection(M3dSectionType::BoneOffsets, boneOffsets.data(), (UINT)boneOffsets.size());
+    writer.AddSection(M3dSectionType::BoneHierarchy, boneIndexToParentIndex.data(), (UINT)boneIndexToParentIndex.size());
+    writer.AddSection(M3dSectionType::Clips, clips.data(), (UINT)clips.size());
+    writer.AddSection(M3dSectionType::BoneTracks, tracks.data(), (UINT)tracks.size());
+    writer.AddSection(M3dSectionType::Keyframes, keyframes.data(), (UINT)keyframes.size());
+}
+
+template<typename TVertex>
+bool ReadBinaryMesh(const M3dBinaryFile& file, M3dSectionType vertexType, std::vector<TVertex>& vertices,
+    std::vector<USHORT>& indices, std::vector<M3dLoader::Subset>& subsets, std::vector<M3dLoader::M3dMaterial>& mats)
+{
+    UINT matCount = 0;
+    const M3dBinaryMaterial* binaryMats = file.GetSection<M3dBinaryMaterial>(M3dSectionType::Materials, matCount);
+    if (binaryMats == nullptr || !CopySection(file, M3dSectionType::Subsets, subsets) ||
+        !CopySection(file, vertexType, vertices) || !CopySection(file, M3dSectionType::Indices, indices) || indices.size() % 3 != 0)
+    {
+        return false;
+    }
+
+    // Text loader reads ranges as they are, but corrupted binary file falls back to text instead of drawing out of buffers.
+    UINT vertexCount = (UINT)vertices.size();
+    UINT faceCount = (UINT)indices.size() / 3;
+    for (const M3dLoader::Subset& subset : subsets)
+    {
+        if ((UINT64)subset.VertexStart + subset.VertexCount > vertexCount || (UINT64)subset.FaceStart + subset.FaceCount > faceCount)
+            return false;
+    }
+    for (USHORT index : indices)
+    {
+        if (index >= vertexCount)
+            return false;
+    }
+
+    mats.resize(matCount);
+    for (UINT i = 0; i < matCount; i++)
+    {
+        mats[i].Name = file.GetString(binaryMats[i].NameOffset);
+        mats[i].MaterialTypeName = file.GetString(binaryMats[i].MaterialTypeNameOffset);
+        mats[i].DiffuseMapName = file.GetString(binaryMats[i].DiffuseMapNameOffset);
+        mats[i].NormalMapName = file.GetString(binaryMats[i].NormalMapNameOffset);
+        mats[i].DiffuseAlbedo = binaryMats[i].DiffuseAlbedo;
+        mats[i].FresnelR0 = binaryMats[i].FresnelR0;
+        mats[i].Roughness = binaryMats[i].Roughness;
+        mats[i].AlphaClip = binaryMats[i].AlphaClip != 0;
+    }
+    return true;
+}
+
+bool ReadBinarySkeleton(const M3dBinaryFile& file, std::vector<XMFLOAT4X4>& boneOffsets, std::vector<int>& boneIndexToParentIndex,
+    std::unordered_map<std::string, AnimationClip>& animations)
+{
+    UINT clipCount = 0;
+    UINT trackCount = 0;
+    UINT keyframeCount = 0;
+    const M3dBinaryClip* clips = file.GetSection<M3dBinaryClip>(M3dSectionType::Clips, clipCount);
+    const M3dBinaryTrack* tracks = file.GetSection<M3dBinaryTrack>(M3dSectionType::BoneTracks, trackCount);
+    const M3dBinaryKeyframe* keyframes = file.GetSection<M3dBinaryKeyframe>(M3dSectionType::Keyframes, keyframeCount);
+    if (clips == nullptr || tracks == nullptr || keyframes == nullptr ||
+        !CopySection(file, M3dSectionType::BoneOffsets, boneOffsets) || !CopySection(file, M3dSectionType::BoneHierarchy, boneIndexToParentIndex) ||
+        boneOffsets.size() != boneIndexToParentIndex.size())
+    {
+        return false;
+    }
+
+    UINT boneCount = (UINT)boneOffsets.size();
+    for (UINT clipIndex = 0; clipIndex < clipCount; clipIndex++)
+    {
+        if ((UINT64)clips[clipIndex].FirstTrack + boneCount > trackCount)
+            return false;
+
+        AnimationClip& clip = animations[file.GetString(clips[clipIndex].NameOffset)];
+        clip.BoneAnimations.resize(boneCount);
+        for (UINT boneIndex = 0; boneIndex < boneCount; boneIndex++)
+        {
+            const M3dBinaryTrack& track = tracks[clips[clipIndex].FirstTrack + boneIndex];
+            if ((UINT64)track.FirstKeyframe + track.KeyframeCount > keyframeCount)
+                return false;
+
+            std::vector<Keyframe>& boneKeyframes = clip.BoneAnimations[boneIndex].Keyframes;
+            boneKeyframes.resize(track.KeyframeCount);
+            for (UINT i = 0; i < track.KeyframeCount; i++)
+            {
+                const M3dBinaryKeyframe& keyframe = keyframes[track.FirstKeyframe + i];
+                boneKeyframes[i].TimePos = keyframe.TimePos;
+                boneKeyframes[i].Translation = keyframe.Translation;
+                boneKeyframes[i].Scale = keyframe.Scale;
+                boneKeyframes[i].RotationQuat = keyframe.RotationQuat;
+            }
+        }
+    }
+    return true;
+}
+}
+
+M3dLoader::M3dLoader(JobSystem& jobs) : _jobs(&jobs)
+{
+}
+
 bool M3dLoader::LoadM3d(const std::string& filename, std::vector<Vertex>& vertices, std::vector<USHORT>& indices, std::vector<Subset>& subsets, std::vector<M3dMaterial>& mats)
 {
-    std::ifstream fin(filename);
+    M3dBinaryFile binary;
+    if (IsBinaryUpToDate(filename) && binary.Open(GetBinaryFilename(filename)) &&
+        ReadBinaryMesh(binary, M3dSectionType::Vertices, vertices, indices, subsets, mats))
+    {
+        return true;
+    }
+
+    return LoadM3dText(filename, vertices, indices, subsets, mats);
+}
+
+bool M3dLoader::LoadM3d(const std::string& filename, std::vector<SkinnedVertex>& vertices, std::vector<USHORT>& indices, std::vector<Subset>& subsets, std::vector<M3dMaterial>& mats, SkinnedData& skinInfo)
+{
+    std::vector<XMFLOAT4X4> boneOffsets;
+    std::vector<int> boneIndexToParentIndex;
+    std::unordered_map<std::string, AnimationClip> animations;
+
+    M3dBinaryFile binary;
+    if (IsBinaryUpToDate(filename) && binary.Open(GetBinaryFilename(filename)) &&
+        ReadBinaryMesh(binary, M3dSectionType::SkinnedVertices, vertices, indices, subsets, mats) &&
+        ReadBinarySkeleton(binary, boneOffsets, boneIndexToParentIndex, animations))
+    {
+        return skinInfo.Set(boneIndexToParentIndex, boneOffsets, animations);
+    }
+
+    animations.clear();
+    if (!LoadM3dText(filename, vertices, indices, subsets, mats, boneOffsets, boneIndexToParentIndex, animations))
+        return false;
+    return skinInfo.Set(boneIndexToParentIndex, boneOffsets, animations);
+}
+
+bool M3dLoader::ConvertM3d(const std::string& filename, const std::string& binaryFilename)
+{
+    UINT numBones = 0;
+    {
+        TextParser fin;
+        if (!fin.Open(filename))
+            return false;
+
+        UINT count = 0;
+        fin.Skip();
+        fin.Skip() >> count;
+        fin.Skip() >> count;
+        fin.Skip() >> count;
+        fin.Skip() >> numBones;
+        if (!fin)
+            return false;
+    }
+
+    std::vector<USHORT> indices;
+    std::vector<Subset> subsets;
+    std::vector<M3dMaterial> mats;
+    M3dBinaryWriter writer;
+    if (numBones > 0)
+    {
+        std::vector<SkinnedVertex> vertices;
+        std::vector<XMFLOAT4X4> boneOffsets;
+        std::vector<int> boneIndexToParentIndex;
+        std::unordered_map<std::string, AnimationClip> animations;
+        // Skeleton is validated before it's written, so binary file never holds what text loader would reject.
+        SkinnedData skinInfo;
+        if (!LoadM3dText(filename, vertices, indices, subsets, mats, boneOffsets, boneIndexToParentIndex, animations) ||
+            !skinInfo.Set(boneIndexToParentIndex, boneOffsets, animations))
+        {
+            return false;
+        }
+
+        AddMeshSections(writer, M3dSectionType::SkinnedVertices, vertices, indices, subsets, mats);
+        AddSkeletonSections(writer, boneOffsets, boneIndexToParentIndex, animations);
+    }
+    else
+    {
+        std::vector<Vertex> vertices;
+        if (!LoadM3dText(filename, vertices, indices, subsets, mats))
+            return false;
+
+        AddMeshSections(writer, M3dSectionType::Vertices, vertices, indices, subsets, mats);
+    }
+
+    // Loaders never see partially written file: it is written next to the target and renamed over it.
+    std::string tempFilename = binaryFilename + ".tmp";
+    if (!writer.Write(tempFilename) || !MoveFileExA(tempFilename.c_str(), binaryFilename.c_str(), MOVEFILE_REPLACE_EXISTING))
+    {
+        DeleteFileA(tempFilename.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool M3dLoader::IsBinaryUpToDate(const std::string& filename)
+{
+    WIN32_FILE_ATTRIBUTE_DATA binaryAttributes;
+    if (!GetFileAttributesExA(GetBinaryFilename(filename).c_str(), GetFileExInfoStandard, &binaryAttributes))
+        return false;
+
+    WIN32_FILE_ATTRIBUTE_DATA textAttributes;
+    if (!GetFileAttributesExA(filename.c_str(), GetFileExInfoStandard, &textAttributes))
+        return true;
+    return CompareFileTime(&binaryAttributes.ftLastWriteTime, &textAttributes.ftLastWriteTime) >= 0;
+}
+
+std::string M3dLoader::GetBinaryFilename(const std::string& filename)
+{
+    size_t extension = filename.find_last_of('.');
+    size_t directory = filename.find_last_of("\\/");
+    if (extension == std::string::npos || (directory != std::string::npos && extension < directory))
+        return filename + ".m3db";
+    return filename.substr(0, extension) + ".m3db";
+}
+
+bool M3dLoader::LoadTextModel(const std::string& filename, std::vector<XMFLOAT3>& positions, std::vector<XMFLOAT3>& normals, std::vector<UINT>& indices)
+{
+    TextParser fin;
+    if (!fin.Open(filename))
+        return false;
+
+    UINT vcount = 0;
+    UINT tcount = 0;
+    fin.Skip() >> vcount;
+    fin.Skip() >> tcount;
+    fin.Skip(4);
+
+    positions.resize(vcount);
+    normals.resize(vcount);
+    ReadRecords(fin, vcount, TextModelVertexTokens, TextModelListEnd, [&positions, &normals](TextParser& records, UINT first, UINT count)
+    {
+        for (UINT i = first; i < first + count; i++)
+        {
+            records >> positions[i].x >> positions[i].y >> positions[i].z;
+            records >> normals[i].x >> normals[i].y >> normals[i].z;
+        }
+    });
+    fin.Skip(3);
+
+    indices.resize(3 * tcount);
+    ReadRecords(fin, tcount, TriangleTokens, TextModelListEnd, [&indices](TextParser& records, UINT first, UINT count)
+    {
+        for (UINT i = first; i < first + count; i++)
+            records >> indices[i * 3 + 0] >> indices[i * 3 + 1] >> indices[i * 3 + 2];
+    });
+    return (bool)fin;
+}
+
+bool M3dLoader::LoadM3dText(const std::string& filename, std::vector<Vertex>& vertices, std::vector<USHORT>& indices, std::vector<Subset>& subsets, std::vector<M3dMaterial>& mats)
+{
+    TextParser fin;
     UINT numMaterials = 0;
     UINT numVertices = 0;
     UINT numTriangles = 0;
     UINT numBones = 0;
     UINT numAnimationClips = 0;
 
-    std::string ignore;
-
-    if (fin)
+    if (fin.Open(filename))
     {
-        fin >> ignore;
-        fin >> ignore >> numMaterials;
-        fin >> ignore >> numVertices;
-        fin >> ignore >> numTriangles;
-        fin >> ignore >> numBones;
-        fin >> ignore >> numAnimationClips;
+        fin.Skip();
+        fin.Skip() >> numMaterials;
+        fin.Skip() >> numVertices;
+        fin.Skip() >> numTriangles;
+        fin.Skip() >> numBones;
+        fin.Skip() >> numAnimationClips;
 
         ReadMaterials(fin, numMaterials, mats);
         ReadSubsetTable(fin, numMaterials, subsets);
         ReadVertices(fin, numVertices, vertices);
         ReadTriangles(fin, numTriangles, indices);
-        return true;
+        return (bool)fin;
     }
     return false;
 }
 
-bool M3dLoader::LoadM3d(const std::string& filename, std::vector<SkinnedVertex>& vertices, std::vector<USHORT>& indices, std::vector<Subset>& subsets, std::vector<M3dMaterial>& mats, SkinnedData& skinInfo)
+bool M3dLoader::LoadM3dText(const std::string& filename, std::vector<SkinnedVertex>& vertices, std::vector<USHORT>& indices, std::vector<Subset>& subsets, std::vector<M3dMaterial>& mats,
+    std::vector<XMFLOAT4X4>& boneOffsets, std::vector<int>& boneIndexToParentIndex, std::unordered_map<std::string, AnimationClip>& animations)
 {
-    std::ifstream fin(filename);
+    TextParser fin;
     UINT numMaterials = 0;
     UINT numVertices = 0;
     UINT numTriangles = 0;
     UINT numBones = 0;
     UINT numAnimationClips = 0;
 
-    std::string ignore;
-
-    if (fin)
+    if (fin.Open(filename))
     {
-        fin >> ignore;
-        fin >> ignore >> numMaterials;
-        fin >> ignore >> numVertices;
-        fin >> ignore >> numTriangles;
-        fin >> ignore >> numBones;
-        fin >> ignore >> numAnimationClips;
-
-        std::vector<XMFLOAT4X4> boneOffsets;
-        std::vector<int> boneIndexToParentIndex;
-        std::unordered_map<std::string, AnimationClip> animations;
+        fin.Skip();
+        fin.Skip() >> numMaterials;
+        fin.Skip() >> numVertices;
+        fin.Skip() >> numTriangles;
+        fin.Skip() >> numBones;
+        fin.Skip() >> numAnimationClips;
 
         ReadMaterials(fin, numMaterials, mats);
         ReadSubsetTable(fin, numMaterials, subsets);
@@ -64,116 +373,126 @@ bool M3dLoader::LoadM3d(const std::string& filename, std::vector<SkinnedVertex>&
         ReadBoneOffsets(fin, numBones, boneOffsets);
         ReadBoneHierarchy(fin, numBones, boneIndexToParentIndex);
         ReadAnimationClips(fin, numBones, numAnimationClips, animations);
-
-        skinInfo.Set(boneIndexToParentIndex, boneOffsets, animations);
-        return true;
+        return (bool)fin;
     }
     return false;
 }
 
-void M3dLoader::ReadMaterials(std::ifstream& fin, UINT numMaterials, std::vector<M3dMaterial>& mats)
+bool M3dLoader::ReadRecords(TextParser& fin, UINT count, UINT recordTokens, char terminator, const TextParser::ChunkParser& parseChunk)
+{
+    if (_jobs != nullptr)
+        return fin.ParseRecords(count, recordTokens, terminator, *_jobs, parseChunk);
+
+    parseChunk(fin, 0, count);
+    return (bool)fin;
+}
+
+void M3dLoader::ReadMaterials(TextParser& fin, UINT numMaterials, std::vector<M3dMaterial>& mats)
 {
-    std::string ignore;
     mats.resize(numMaterials);
 
     std::string diffuseMapName;
     std::string normalMapName;
 
-    fin >> ignore;
+    fin.Skip();
     for (UINT i = 0; i < numMaterials; ++i)
     {
-        fin >> ignore >> mats[i].Name;
-        fin >> ignore >> mats[i].DiffuseAlbedo.x >> mats[i].DiffuseAlbedo.y >> mats[i].DiffuseAlbedo.z;
-        fin >> ignore >> mats[i].FresnelR0.x >> mats[i].FresnelR0.y >> mats[i].FresnelR0.z;
-        fin >> ignore >> mats[i].Roughness;
-        fin >> ignore >> mats[i].AlphaClip;
-        fin >> ignore >> mats[i].MaterialTypeName;
-        fin >> ignore >> mats[i].DiffuseMapName;
-        fin >> ignore >> mats[i].NormalMapName;
+        fin.Skip() >> mats[i].Name;
+        fin.Skip() >> mats[i].DiffuseAlbedo.x >> mats[i].DiffuseAlbedo.y >> mats[i].DiffuseAlbedo.z;
+        fin.Skip() >> mats[i].FresnelR0.x >> mats[i].FresnelR0.y >> mats[i].FresnelR0.z;
+        fin.Skip() >> mats[i].Roughness;
+        fin.Skip() >> mats[i].AlphaClip;
+        fin.Skip() >> mats[i].MaterialTypeName;
+        fin.Skip() >> mats[i].DiffuseMapName;
+        fin.Skip() >> mats[i].NormalMapName;
     }
 }
 
-void M3dLoader::ReadSubsetTable(std::ifstream& fin, UINT numSubsets, std::vector<Subset>& subsets)
+void M3dLoader::ReadSubsetTable(TextParser& fin, UINT numSubsets, std::vector<Subset>& subsets)
 {
-    std::string ignore;
     subsets.resize(numSubsets);
 
-    fin >> ignore;
+    fin.Skip();
     for (UINT i = 0; i < numSubsets; ++i)
     {
-        fin >> ignore >> subsets[i].Id;
-        fin >> ignore >> subsets[i].VertexStart;
-        fin >> ignore >> subsets[i].VertexCount;
-        fin >> ignore >> subsets[i].FaceStart;
-        fin >> ignore >> subsets[i].FaceCount;
+        fin.Skip() >> subsets[i].Id;
+        fin.Skip() >> subsets[i].VertexStart;
+        fin.Skip() >> subsets[i].VertexCount;
+        fin.Skip() >> subsets[i].FaceStart;
+        fin.Skip() >> subsets[i].FaceCount;
     }
 }
 
-void M3dLoader::ReadVertices(std::ifstream& fin, UINT numVertices, std::vector<Vertex>& vertices)
+void M3dLoader::ReadVertices(TextParser& fin, UINT numVertices, std::vector<Vertex>& vertices)
 {
-    std::string ignore;
     vertices.resize(numVertices);
 
-    fin >> ignore; // vertices header text
-    for (UINT i = 0; i < numVertices; ++i)
+    fin.Skip(); // vertices header text
+    ReadRecords(fin, numVertices, VertexTokens, SectionHeaderChar, [&vertices](TextParser& records, UINT first, UINT count)
     {
-        fin >> ignore >> vertices[i].Pos.x >> vertices[i].Pos.y >> vertices[i].Pos.z;
-        fin >> ignore >> vertices[i].TangentU.x >> vertices[i].TangentU.y >> vertices[i].TangentU.z >> vertices[i].TangentU.w;
-        fin >> ignore >> vertices[i].Normal.x >> vertices[i].Normal.y >> vertices[i].Normal.z;
-        fin >> ignore >> vertices[i].Uv.x >> vertices[i].Uv.y;
-    }
+        for (UINT i = first; i < first + count; ++i)
+        {
+            records.Skip() >> vertices[i].Pos.x >> vertices[i].Pos.y >> vertices[i].Pos.z;
+            records.Skip() >> vertices[i].TangentU.x >> vertices[i].TangentU.y >> vertices[i].TangentU.z >> vertices[i].TangentU.w;
+            records.Skip() >> vertices[i].Normal.x >> vertices[i].Normal.y >> vertices[i].Normal.z;
+            records.Skip() >> vertices[i].Uv.x >> vertices[i].Uv.y;
+        }
+    });
 }
 
-void M3dLoader::ReadSkinnedVertices(std::ifstream& fin, UINT numVertices, std::vector<SkinnedVertex>& vertices)
+void M3dLoader::ReadSkinnedVertices(TextParser& fin, UINT numVertices, std::vector<SkinnedVertex>& vertices)
 {
-    std::string ignore;
     vertices.resize(numVertices);
 
-    fin >> ignore; // vertices header text
-    int boneIndices[4];
-    float weights[4];
-    for (UINT i = 0; i < numVertices; ++i)
+    fin.Skip(); // vertices header text
+    ReadRecords(fin, numVertices, SkinnedVertexTokens, SectionHeaderChar, [&vertices](TextParser& records, UINT first, UINT count)
     {
-        float blah;
-        fin >> ignore >> vertices[i].Pos.x >> vertices[i].Pos.y >> vertices[i].Pos.z;
-        fin >> ignore >> vertices[i].TangentU.x >> vertices[i].TangentU.y >> vertices[i].TangentU.z >> blah /*vertices[i].TangentU.w*/;
-        fin >> ignore >> vertices[i].Normal.x >> vertices[i].Normal.y >> vertices[i].Normal.z;
-        fin >> ignore >> vertices[i].Uv.x >> vertices[i].Uv.y;
-        fin >> ignore >> weights[0] >> weights[1] >> weights[2] >> weights[3];
-        fin >> ignore >> boneIndices[0] >> boneIndices[1] >> boneIndices[2] >> boneIndices[3];
-
-        vertices[i].BoneWeights.x = weights[0];
-        vertices[i].BoneWeights.y = weights[1];
-        vertices[i].BoneWeights.z = weights[2];
-
-        vertices[i].BoneIndices[0] = (BYTE)boneIndices[0];
-        vertices[i].BoneIndices[1] = (BYTE)boneIndices[1];
-        vertices[i].BoneIndices[2] = (BYTE)boneIndices[2];
-        vertices[i].BoneIndices[3] = (BYTE)boneIndices[3];
-    }
+        int boneIndices[4];
+        float weights[4];
+        for (UINT i = first; i < first + count; ++i)
+        {
+            float blah;
+            records.Skip() >> vertices[i].Pos.x >> vertices[i].Pos.y >> vertices[i].Pos.z;
+            records.Skip() >> vertices[i].TangentU.x >> vertices[i].TangentU.y >> vertices[i].TangentU.z >> blah /*vertices[i].TangentU.w*/;
+            records.Skip() >> vertices[i].Normal.x >> vertices[i].Normal.y >> vertices[i].Normal.z;
+            records.Skip() >> vertices[i].Uv.x >> vertices[i].Uv.y;
+            records.Skip() >> weights[0] >> weights[1] >> weights[2] >> weights[3];
+            records.Skip() >> boneIndices[0] >> boneIndices[1] >> boneIndices[2] >> boneIndices[3];
+
+            vertices[i].BoneWeights.x = weights[0];
+            vertices[i].BoneWeights.y = weights[1];
+            vertices[i].BoneWeights.z = weights[2];
+
+            vertices[i].BoneIndices[0] = (BYTE)boneIndices[0];
+            vertices[i].BoneIndices[1] = (BYTE)boneIndices[1];
+            vertices[i].BoneIndices[2] = (BYTE)boneIndices[2];
+            vertices[i].BoneIndices[3] = (BYTE)boneIndices[3];
+        }
+    });
 }
 
-void M3dLoader::ReadTriangles(std::ifstream& fin, UINT numTriangles, std::vector<USHORT>& indices)
+void M3dLoader::ReadTriangles(TextParser& fin, UINT numTriangles, std::vector<USHORT>& indices)
 {
-    std::string ignore;
     indices.resize(numTriangles * 3);
 
-    fin >> ignore;
-    for (UINT i = 0; i < numTriangles; ++i)
+    fin.Skip();
+    ReadRecords(fin, numTriangles, TriangleTokens, SectionHeaderChar, [&indices](TextParser& records, UINT first, UINT count)
     {
-        fin >> indices[i * 3 + 0] >> indices[i * 3 + 1] >> indices[i * 3 + 2];
-    }
+        for (UINT i = first; i < first + count; ++i)
+        {
+            records >> indices[i * 3 + 0] >> indices[i * 3 + 1] >> indices[i * 3 + 2];
+        }
+    });
 }
 
-void M3dLoader::ReadBoneOffsets(std::ifstream& fin, UINT numBones, std::vector<DirectX::XMFLOAT4X4>& boneOffsets)
+void M3dLoader::ReadBoneOffsets(TextParser& fin, UINT numBones, std::vector<DirectX::XMFLOAT4X4>& boneOffsets)
 {
-    std::string ignore;
     boneOffsets.resize(numBones);
 
-    fin >> ignore;
+    fin.Skip();
     for (UINT i = 0; i < numBones; ++i)
     {
-        fin >> ignore >>
+        fin.Skip() >>
             boneOffsets[i](0, 0) >> boneOffsets[i](0, 1) >> boneOffsets[i](0, 2) >> boneOffsets[i](0, 3) >>
             boneOffsets[i](1, 0) >> boneOffsets[i](1, 1) >> boneOffsets[i](1, 2) >> boneOffsets[i](1, 3) >>
             boneOffsets[i](2, 0) >> boneOffsets[i](2, 1) >> boneOffsets[i](2, 2) >> boneOffsets[i](2, 3) >>
@@ -181,27 +500,25 @@ void M3dLoader::ReadBoneOffsets(std::ifstream& fin, UINT numBones, std::vector<D
     }
 }
 
-void M3dLoader::ReadBoneHierarchy(std::ifstream& fin, UINT numBones, std::vector<int>& boneIndexToParentIndex)
+void M3dLoader::ReadBoneHierarchy(TextParser& fin, UINT numBones, std::vector<int>& boneIndexToParentIndex)
 {
-    std::string ignore;
     boneIndexToParentIndex.resize(numBones);
 
-    fin >> ignore;
+    fin.Skip();
     for (UINT i = 0; i < numBones; ++i)
     {
-        fin >> ignore >> boneIndexToParentIndex[i];
+        fin.Skip() >> boneIndexToParentIndex[i];
     }
 }
 
-void M3dLoader::ReadAnimationClips(std::ifstream& fin, UINT numBones, UINT numAnimationClips, std::unordered_map<std::string, AnimationClip>& animations)
+void M3dLoader::ReadAnimationClips(TextParser& fin, UINT numBones, UINT numAnimationClips, std::unordered_map<std::string, AnimationClip>& animations)
 {
-    std::string ignore;
-    fin >> ignore;
+    fin.Skip();
     for (UINT clipIndex = 0; clipIndex < numAnimationClips; ++clipIndex)
     {
         std::string clipName;
-        fin >> ignore >> clipName;
-        fin >> ignore;
+        fin.Skip() >> clipName;
+        fin.Skip();
 
         AnimationClip clip;
         clip.BoneAnimations.resize(numBones);
@@ -210,18 +527,17 @@ void M3dLoader::ReadAnimationClips(std::ifstream& fin, UINT numBones, UINT numAn
         {
             ReadBoneKeyframes(fin, numBones, clip.BoneAnimations[boneIndex]);
         }
-        fin >> ignore;
+        fin.Skip();
 
         animations[clipName] = clip;
     }
 }
 
-void M3dLoader::ReadBoneKeyframes(std::ifstream& fin, UINT numBones, BoneAnimation& boneAnimation)
+void M3dLoader::ReadBoneKeyframes(TextParser& fin, UINT numBones, BoneAnimation& boneAnimation)
 {
-    std::string ignore;
     UINT numKeyframes = 0;
-    fin >> ignore >> ignore >> numKeyframes;
-    fin >> ignore;
+    fin.Skip(2) >> numKeyframes;
+    fin.Skip();
 
     boneAnimation.Keyframes.resize(numKeyframes);
     for (UINT i = 0; i < numKeyframes; ++i)
@@ -230,10 +546,10 @@ void M3dLoader::ReadBoneKeyframes(std::ifstream& fin, UINT numBones, BoneAnimati
         XMFLOAT3 p(0.0f, 0.0f, 0.0f);
         XMFLOAT3 s(1.0f, 1.0f, 1.0f);
         XMFLOAT4 q(0.0f, 0.0f, 0.0f, 1.0f);
-        fin >> ignore >> t;
-        fin >> ignore >> p.x >> p.y >> p.z;
-        fin >> ignore >> s.x >> s.y >> s.z;
-        fin >> ignore >> q.x >> q.y >> q.z >> q.w;
+        fin.Skip() >> t;
+        fin.Skip() >> p.x >> p.y >> p.z;
+        fin.Skip() >> s.x >> s.y >> s.z;
+        fin.Skip() >> q.x >> q.y >> q.z >> q.w;
 
         boneAnimation.Keyframes[i].TimePos = t;
         boneAnimation.Keyframes[i].Translation = p;
@@ -241,6 +557,6 @@ void M3dLoader::ReadBoneKeyframes(std::ifstream& fin, UINT numBones, BoneAnimati
         boneAnimation.Keyframes[i].RotationQuat = q;
     }
 
-    fin >> ignore;
+    fin.Skip();
 }
 }
\ No newline at end of file
@@ -5,6 +5,9 @@
 #pragma once
 
 #include "D3DUtil.h"
+#include "M3dBinary.h"
+#include "TextParser.h"
+#include "JobSystem.h"
 #include "../Source/Scenes/SkinnedAnimation/SkinnedData.h"
 
 namespace DX12Samples
@@ -55,17 +58,54 @@ public:
         std::string NormalMapName;
     };
 
+    M3dLoader() = default;
+    /**
+     * \brief Loader which parses vertex and triangle sections of text files in parallel on job system workers.
+     */
+    explicit M3dLoader(JobSystem& jobs);
+
+    /**
+     * \brief Load mesh. Binary file from GetBinaryFilename is loaded instead of text one if it exists and isn't older,
+     * otherwise text file is parsed. Binary file with out of range subsets or indices is ignored as well.
+     * Loading never writes binary files, they are made by ConvertM3d, e.g. SkinnedAnimation converts its model on first run.
+     */
     bool LoadM3d(const std::string& filename, std::vector<Vertex>& vertices, std::vector<USHORT>& indices, std::vector<Subset>& subsets, std::vector<M3dMaterial>& mats);
     bool LoadM3d(const std::string& filename, std::vector<SkinnedVertex>& vertices, std::vector<USHORT>& indices, std::vector<Subset>& subsets, std::vector<M3dMaterial>& mats, SkinnedData& skinInfo);
+    /**
+     * \brief Convert text file to binary container, see M3dBinaryFile. Binary file is written to temporary file first and
+     * renamed into place. Returns false if text can't be read, skeleton is invalid or binary can't be written.
+     */
+    bool ConvertM3d(const std::string& filename, const std::string& binaryFilename);
+    /**
+     * \brief True if binary file exists and text file is missing or not newer than it, LoadM3d uses binary file then.
+     */
+    static bool IsBinaryUpToDate(const std::string& filename);
+    /**
+     * \brief Binary file for text file: same path with .m3db extension.
+     */
+    static std::string GetBinaryFilename(const std::string& filename);
+    /**
+     * \brief Load model in text format with VertexCount/TriangleCount header and position, normal vertices, e.g. skull.txt.
+     */
+    bool LoadTextModel(const std::string& filename, std::vector<DirectX::XMFLOAT3>& positions, std::vector<DirectX::XMFLOAT3>& normals, std::vector<UINT>& indices);
 private:
-    void ReadMaterials(std::ifstream& fin, UINT numMaterials, std::vector<M3dMaterial>& mats);
-    void ReadSubsetTable(std::ifstream& fin, UINT numSubsets, std::vector<Subset>& subsets);
-    void ReadVertices(std::ifstream& fin, UINT numVertices, std::vector<Vertex>& vertices);
-    void ReadSkinnedVertices(std::ifstream& fin, UINT numVertices, std::vector<SkinnedVertex>& vertices);
-    void ReadTriangles(std::ifstream& fin, UINT numTriangles, std::vector<USHORT>& indices);
-    void ReadBoneOffsets(std::ifstream& fin, UINT numBones, std::vector<DirectX::XMFLOAT4X4>& boneOffsets);
-    void ReadBoneHierarchy(std::ifstream& fin, UINT numBones, std::vector<int>& boneIndexToParentIndex);
-    void ReadAnimationClips(std::ifstream& fin, UINT numBones, UINT numAnimationClips, std::unordered_map<std::string, AnimationClip>& animations);
-    void ReadBoneKeyframes(std::ifstream& fin, UINT numBones, BoneAnimation& boneAnimation);
+    bool LoadM3dText(const std::string& filename, std::vector<Vertex>& vertices, std::vector<USHORT>& indices, std::vector<Subset>& subsets, std::vector<M3dMaterial>& mats);
+    bool LoadM3dText(const std::string& filename, std::vector<SkinnedVertex>& vertices, std::vector<USHORT>& indices, std::vector<Subset>& subsets, std::vector<M3dMaterial>& mats,
+        std::vector<DirectX::XMFLOAT4X4>& boneOffsets, std::vector<int>& boneIndexToParentIndex, std::unordered_map<std::string, AnimationClip>& animations);
+    /**
+     * \brief Parse count records of recordTokens tokens, in parallel chunks if loader has job system.
+     */
+    bool ReadRecords(TextParser& fin, UINT count, UINT recordTokens, char terminator, const TextParser::ChunkParser& parseChunk);
+    void ReadMaterials(TextParser& fin, UINT numMaterials, std::vector<M3dMaterial>& mats);
+    void ReadSubsetTable(TextParser& fin, UINT numSubsets, std::vector<Subset>& subsets);
+    void ReadVertices(TextParser& fin, UINT numVertices, std::vector<Vertex>& vertices);
+    void ReadSkinnedVertices(TextParser& fin, UINT numVertices, std::vector<SkinnedVertex>& vertices);
+    void ReadTriangles(TextParser& fin, UINT numTriangles, std::vector<USHORT>& indices);
+    void ReadBoneOffsets(TextParser& fin, UINT numBones, std::vector<DirectX::XMFLOAT4X4>& boneOffsets);
+    void ReadBoneHierarchy(TextParser& fin, UINT numBones, std::vector<int>& boneIndexToParentIndex);
+    void ReadAnimationClips(TextParser& fin, UINT numBones, UINT numAnimationClips, std::unordered_map<std::string, AnimationClip>& animations);
+    void ReadBoneKeyframes(TextParser& fin, UINT numBones, BoneAnimation& boneAnimation);
+
+    JobSystem* _jobs = nullptr;
 };
 }
\ No newline at end of file
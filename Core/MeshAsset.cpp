@@ -0,0 +1,233 @@
+#include "MeshAsset.h"
+
+#include "JobSystem.h"
+#include "M3dLoader.h"
+#include "MeshOptimizer.h"
+#include "TangentGenerator.h"
+
+namespace DX12Samples
+{
+using namespace DirectX;
+
+namespace
+{
+const UINT PositionOffset = 0;
+const UINT NormalOffset = 12;
+const UINT UvOffset = 24;
+const UINT TangentOffset = 32;
+// Vertices interleaved per block, Uvs of the block are computed right before so they are still in cache.
+const UINT UvBlockSize = 256;
+
+template<typename T>
+void WriteAttribute(BYTE* vertex, UINT offset, const T& value)
+{
+    memcpy(vertex + offset, &value, sizeof(T));
+}
+}
+
+const XMFLOAT3& MeshAsset::GetPosition(UINT index) const
+{
+    return *reinterpret_cast<const XMFLOAT3*>(Vertices.data() + (size_t)index * VertexStride + PositionOffset);
+}
+
+UINT MeshAsset::VertexBufferByteSize() const
+{
+    return (UINT)Vertices.size();
+}
+
+UINT MeshAsset::IndexBufferByteSize() const
+{
+    return (UINT)(Indices.size() * sizeof(UINT));
+}
+
+SubmeshGeometry MeshAsset::CreateSubmesh(UINT startIndexLocation, INT baseVertexLocation) const
+{
+    return Bounds.CreateSubmesh((UINT)Indices.size(), startIndexLocation, baseVertexLocation);
+}
+
+MeshAssetCache::MeshAssetCache() = default;
+
+MeshAssetCache::~MeshAssetCache() = default;
+
+MeshAssetCache& MeshAssetCache::Instance()
+{
+    static MeshAssetCache cache;
+    return cache;
+}
+
+std::shared_ptr<const MeshAsset> MeshAssetCache::Load(const std::string& filename, MeshVertexLayout layout)
+{
+    // Entries are published before loading, so file is parsed once while other files load concurrently.
+    auto key = std::make_pair(filename, layout);
+    std::promise<std::shared_ptr<const SourceMesh>> sourcePromise;
+    std::promise<std::shared_ptr<const MeshAsset>> assetPromise;
+    std::shared_future<std::shared_ptr<const SourceMesh>> sourceFuture;
+    std::shared_future<std::shared_ptr<const MeshAsset>> cachedAsset;
+    bool loadSource = false;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto asset = _assets.find(key);
+        if (asset != _assets.end())
+        {
+            cachedAsset = asset->second;
+        }
+        else
+        {
+            _assets[key] = assetPromise.get_future().share();
+            auto source = _sources.find(filename);
+            loadSource = source == _sources.end();
+            if (loadSource)
+                _sources[filename] = sourcePromise.get_future().share();
+            sourceFuture = _sources[filename];
+        }
+    }
+    if (cachedAsset.valid())
+        return cachedAsset.get();
+
+    if (loadSource)
+    {
+        auto mesh = std::make_shared<SourceMesh>();
+        M3dLoader loader;
+        if (loader.LoadTextModel(filename, mesh->Positions, mesh->Normals, mesh->Indices))
+            Optimize(*mesh);
+        else
+            mesh = nullptr;
+        sourcePromise.set_value(mesh);
+    }
+
+    std::shared_ptr<const SourceMesh> source = sourceFuture.get();
+    std::shared_ptr<const MeshAsset> result = source != nullptr ? BuildAsset(*source, layout) : nullptr;
+    if (result == nullptr)
+    {
+        // Failed files aren't cached, later calls try again.
+        std::lock_guard<std::mutex> lock(_mutex);
+        _assets.erase(key);
+        if (loadSource)
+            _sources.erase(filename);
+    }
+    assetPromise.set_value(result);
+    return result;
+}
+
+void MeshAssetCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _sources.clear();
+    _assets.clear();
+}
+
+UINT MeshAssetCache::GetVertexStride(MeshVertexLayout layout)
+{
+    switch (layout)
+    {
+    case MeshVertexLayout::PosNormal:
+        return UvOffset;
+    case MeshVertexLayout::PosNormalUv:
+        return TangentOffset;
+    case MeshVertexLayout::PosNormalUvTangent:
+        return TangentOffset + sizeof(XMFLOAT3);
+    }
+    return 0;
+}
+
+void MeshAssetCache::ComputeSphericalUvs(const XMFLOAT3* positions, UINT count, XMFLOAT2* uvs)
+{
+    const XMVECTOR zero = XMVectorZero();
+    const XMVECTOR one = XMVectorReplicate(1.0f);
+    const XMVECTOR twoPi = XMVectorReplicate(XM_2PI);
+    const XMVECTOR invTwoPi = XMVectorReplicate(XM_1DIV2PI);
+    const XMVECTOR invPi = XMVectorReplicate(XM_1DIVPI);
+
+    for (UINT first = 0; first < count; first += 4)
+    {
+        // Tail lanes repeat first position of the group and aren't stored.
+        UINT laneCount = MathHelper::Min(4u, count - first);
+        XMMATRIX lanes;
+        for (UINT i = 0; i < 4; i++)
+            lanes.r[i] = XMLoadFloat3(&positions[first + (i < laneCount ? i : 0)]);
+        lanes = XMMatrixTranspose(lanes);
+        XMVECTOR x = lanes.r[0];
+        XMVECTOR y = lanes.r[1];
+        XMVECTOR z = lanes.r[2];
+
+        // atan2 doesn't depend on length, only y is normalized. Zero length positions get y = 0 like XMVector3Normalize.
+        XMVECTOR lengthSq = XMVectorMultiplyAdd(x, x, XMVectorMultiplyAdd(y, y, XMVectorMultiply(z, z)));
+        XMVECTOR invLength = XMVectorSelect(XMVectorReciprocalSqrt(lengthSq), zero, XMVectorEqual(lengthSq, zero));
+        XMVECTOR sphereY = XMVectorClamp(XMVectorMultiply(y, invLength), XMVectorNegate(one), one);
+
+        XMVECTOR theta = XMVectorATan2(z, x);
+        theta = XMVectorSelect(theta, XMVectorAdd(theta, twoPi), XMVectorLess(theta, zero));
+        XMVECTOR u = XMVectorMultiply(theta, invTwoPi);
+        XMVECTOR v = XMVectorMultiply(XMVectorACos(sphereY), invPi);
+
+        XMFLOAT2 lanesUv[4];
+        XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&lanesUv[0]), XMVectorMergeXY(u, v));
+        XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&lanesUv[2]), XMVectorMergeZW(u, v));
+        memcpy(uvs + first, lanesUv, laneCount * sizeof(XMFLOAT2));
+    }
+}
+
+void MeshAssetCache::Optimize(SourceMesh& source)
+{
+    UINT vertexCount = (UINT)source.Positions.size();
+    UINT* indices = source.Indices.data();
+    size_t indexCount = source.Indices.size();
+    MeshOptimizer::OptimizeVertexCache(indices, indexCount, vertexCount);
+    MeshOptimizer::OptimizeOverdraw(indices, indexCount, source.Positions.data(), sizeof(XMFLOAT3), vertexCount);
+
+    std::vector<UINT> remap = MeshOptimizer::OptimizeVertexFetch(indices, indexCount, vertexCount);
+    MeshOptimizer::RemapVertices(source.Positions, remap);
+    MeshOptimizer::RemapVertices(source.Normals, remap);
+}
+
+std::shared_ptr<const MeshAsset> MeshAssetCache::BuildAsset(const SourceMesh& source, MeshVertexLayout layout)
+{
+    auto asset = std::make_shared<MeshAsset>();
+    asset->Layout = layout;
+    asset->VertexStride = GetVertexStride(layout);
+    asset->VertexCount = (UINT)source.Positions.size();
+    asset->Vertices.resize((size_t)asset->VertexCount * asset->VertexStride);
+    asset->Indices = source.Indices;
+
+    bool writeUv = layout != MeshVertexLayout::PosNormal;
+    bool writeTangent = layout == MeshVertexLayout::PosNormalUvTangent;
+
+    std::vector<XMFLOAT2> uvs(writeUv ? asset->VertexCount : 0);
+    for (UINT block = 0; block < asset->VertexCount; block += UvBlockSize)
+    {
+        UINT blockCount = MathHelper::Min(UvBlockSize, asset->VertexCount - block);
+        if (writeUv)
+            ComputeSphericalUvs(&source.Positions[block], blockCount, &uvs[block]);
+
+        for (UINT i = block; i < block + blockCount; i++)
+        {
+            BYTE* vertex = asset->Vertices.data() + (size_t)i * asset->VertexStride;
+            WriteAttribute(vertex, PositionOffset, source.Positions[i]);
+            WriteAttribute(vertex, NormalOffset, source.Normals[i]);
+            if (writeUv)
+                WriteAttribute(vertex, UvOffset, uvs[i]);
+        }
+    }
+
+    if (writeTangent)
+    {
+        std::vector<XMFLOAT4> tangents(asset->VertexCount);
+        {
+            std::lock_guard<std::mutex> lock(_jobsMutex);
+            if (_jobs == nullptr)
+                _jobs = std::make_unique<JobSystem>();
+            TangentGenerator(*_jobs).Generate(source.Indices.data(), source.Indices.size(), asset->VertexCount,
+                source.Positions.data(), sizeof(XMFLOAT3), source.Normals.data(), sizeof(XMFLOAT3), uvs.data(), sizeof(XMFLOAT2), tangents.data());
+        }
+
+        for (UINT i = 0; i < asset->VertexCount; i++)
+        {
+            BYTE* vertex = asset->Vertices.data() + (size_t)i * asset->VertexStride;
+            WriteAttribute(vertex, TangentOffset, XMFLOAT3(tangents[i].x, tangents[i].y, tangents[i].z));
+        }
+    }
+
+    asset->Bounds = BoundsBuilder().Compute(source.Positions.data(), asset->VertexCount, sizeof(XMFLOAT3));
+    return asset;
+}
+}
@@ -0,0 +1,110 @@
+//
+// Process wide cache of meshes loaded from text model files.
+//
+
+#pragma once
+
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "BoundsBuilder.h"
+#include "D3DUtil.h"
+
+namespace DX12Samples
+{
+class JobSystem;
+
+// Interleaved vertex layouts of scene Vertex structs. Every layout starts with position and normal, Uv is spherical
+// projection of position and Tangent follows u of that projection, see TangentGenerator.
+enum class MeshVertexLayout
+{
+    PosNormal,
+    PosNormalUv,
+    PosNormalUvTangent
+};
+
+// Immutable mesh shared between all scenes which load same file with same layout.
+struct MeshAsset
+{
+    MeshVertexLayout Layout = MeshVertexLayout::PosNormal;
+    UINT VertexStride = 0;
+    UINT VertexCount = 0;
+    std::vector<BYTE> Vertices;
+    std::vector<UINT> Indices;
+    MeshBounds Bounds;
+
+    /**
+     * \brief Get vertices as scene vertex struct, its size must match layout stride.
+     */
+    template<typename TVertex>
+    const TVertex* GetVertices() const
+    {
+        assert(sizeof(TVertex) == VertexStride);
+        return reinterpret_cast<const TVertex*>(Vertices.data());
+    }
+    const DirectX::XMFLOAT3& GetPosition(UINT index) const;
+    UINT VertexBufferByteSize() const;
+    UINT IndexBufferByteSize() const;
+    /**
+     * \brief Submesh of whole mesh at given locations of shared buffers, with bounds computed at load.
+     */
+    SubmeshGeometry CreateSubmesh(UINT startIndexLocation = 0, INT baseVertexLocation = 0) const;
+};
+
+class MeshAssetCache
+{
+public:
+    static MeshAssetCache& Instance();
+
+    /**
+     * \brief Get mesh from file with VertexCount/TriangleCount header, e.g. skull.txt. File is parsed and optimized once and every
+     * layout is built once, later calls return same data. Returns nullptr if file can't be read. Thread safe, different
+     * files are parsed concurrently and callers of file which is being loaded wait for it.
+     */
+    std::shared_ptr<const MeshAsset> Load(const std::string& filename, MeshVertexLayout layout);
+    /**
+     * \brief Drop cached meshes. Meshes which are still referenced stay alive until released.
+     */
+    void Clear();
+
+    static UINT GetVertexStride(MeshVertexLayout layout);
+    /**
+     * \brief Spherical projection Uvs of positions, four vertices per DirectXMath vector: positions are transposed to
+     * x, y and z lanes, then u is atan2(z, x) and v is acos of normalized y.
+     */
+    static void ComputeSphericalUvs(const DirectX::XMFLOAT3* positions, UINT count, DirectX::XMFLOAT2* uvs);
+
+private:
+    struct SourceMesh
+    {
+        std::vector<DirectX::XMFLOAT3> Positions;
+        std::vector<DirectX::XMFLOAT3> Normals;
+        std::vector<UINT> Indices;
+    };
+
+    MeshAssetCache();
+    ~MeshAssetCache();
+    MeshAssetCache(const MeshAssetCache& rhs) = delete;
+    MeshAssetCache& operator=(const MeshAssetCache& rhs) = delete;
+
+    /**
+     * \brief Reorder triangles and vertices of parsed mesh for GPU caches, see MeshOptimizer.
+     */
+    static void Optimize(SourceMesh& source);
+    /**
+     * \brief Interleave vertices and compute Uvs in single pass over blocks of four vertices, then generate tangents from Uvs
+     * on cache job system and bounds.
+     */
+    std::shared_ptr<const MeshAsset> BuildAsset(const SourceMesh& source, MeshVertexLayout layout);
+
+    std::mutex _mutex;
+    std::map<std::string, std::shared_future<std::shared_ptr<const SourceMesh>>> _sources;
+    std::map<std::pair<std::string, MeshVertexLayout>, std::shared_future<std::shared_ptr<const MeshAsset>>> _assets;
+
+    // Created with first tangent layout. Job system runs one ParallelFor at a time, so concurrent loads take turns on it.
+    std::mutex _jobsMutex;
+    std::unique_ptr<JobSystem> _jobs;
+};
+}
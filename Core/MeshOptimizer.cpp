@@ -0,0 +1,276 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <climits>
+
+namespace DX12Samples
+{
+using namespace DirectX;
+
+namespace
+{
+const XMFLOAT3& GetPosition(const XMFLOAT3* positions, UINT positionStride, UINT index)
+{
+    return *reinterpret_cast<const XMFLOAT3*>(reinterpret_cast<const BYTE*>(positions) + (size_t)index * positionStride);
+}
+
+// FIFO cache where vertex is cached while less than cacheSize other vertices were transformed after it.
+class FifoCache
+{
+public:
+    FifoCache(UINT vertexCount, UINT cacheSize) : _timestamps(vertexCount, 0), _time(cacheSize + 1), _cacheSize(cacheSize)
+    {
+    }
+
+    /**
+     * \brief Returns true if vertex was transformed.
+     */
+    bool Access(UINT vertex)
+    {
+        if (_time - _timestamps[vertex] <= _cacheSize)
+            return false;
+        _timestamps[vertex] = _time++;
+        return true;
+    }
+
+private:
+    std::vector<UINT> _timestamps;
+    UINT _time;
+    UINT _cacheSize;
+};
+}
+
+template<typename TIndex>
+void MeshOptimizer::OptimizeVertexCache(TIndex* indices, size_t indexCount, UINT vertexCount, UINT cacheSize)
+{
+    UINT triangleCount = (UINT)(indexCount / 3);
+    if (triangleCount < 2)
+        return;
+
+    // Triangles of every vertex and how many of them are not emitted yet.
+    std::vector<UINT> triangleOffsets(vertexCount + 1, 0);
+    for (size_t i = 0; i < (size_t)triangleCount * 3; i++)
+        triangleOffsets[indices[i] + 1]++;
+    for (UINT v = 0; v < vertexCount; v++)
+        triangleOffsets[v + 1] += triangleOffsets[v];
+
+    std::vector<UINT> liveTriangles(vertexCount, 0);
+    std::vector<UINT> vertexTriangles((size_t)triangleCount * 3);
+    for (UINT t = 0; t < triangleCount; t++)
+    {
+        for (UINT k = 0; k < 3; k++)
+        {
+            UINT v = indices[t * 3 + k];
+            vertexTriangles[triangleOffsets[v] + liveTriangles[v]++] = t;
+        }
+    }
+
+    // Tipsify: emit all remaining triangles around fanning vertex, then move to vertex of those triangles which stays
+    // in cache longest after its own triangles are emitted. Dead ends go to recently used vertices first.
+    std::vector<TIndex> result;
+    result.reserve((size_t)triangleCount * 3);
+    std::vector<UINT> timestamps(vertexCount, 0);
+    std::vector<char> emitted(triangleCount, 0);
+    std::vector<UINT> deadEnds;
+    std::vector<UINT> candidates;
+    UINT time = cacheSize + 1;
+    UINT nextVertex = 0;
+    int fanning = indices[0];
+    while (fanning >= 0)
+    {
+        candidates.clear();
+        for (UINT i = triangleOffsets[fanning]; i < triangleOffsets[fanning + 1]; i++)
+        {
+            UINT t = vertexTriangles[i];
+            if (emitted[t])
+                continue;
+            emitted[t] = 1;
+            for (UINT k = 0; k < 3; k++)
+            {
+                UINT v = indices[t * 3 + k];
+                result.push_back((TIndex)v);
+                deadEnds.push_back(v);
+                candidates.push_back(v);
+                liveTriangles[v]--;
+                if (time - timestamps[v] > cacheSize)
+                    timestamps[v] = time++;
+            }
+        }
+
+        fanning = -1;
+        int bestPriority = -1;
+        for (UINT v : candidates)
+        {
+            if (liveTriangles[v] == 0)
+                continue;
+            // Fanning around v transforms up to 2 vertices per triangle, v must survive that to be worth it.
+            int age = (int)(time - timestamps[v]);
+            int priority = age + 2 * (int)liveTriangles[v] <= (int)cacheSize ? age : 0;
+            if (priority > bestPriority)
+            {
+                bestPriority = priority;
+                fanning = (int)v;
+            }
+        }
+
+        while (fanning < 0 && !deadEnds.empty())
+        {
+            UINT v = deadEnds.back();
+            deadEnds.pop_back();
+            if (liveTriangles[v] > 0)
+                fanning = (int)v;
+        }
+        for (; fanning < 0 && nextVertex < vertexCount; nextVertex++)
+        {
+            if (liveTriangles[nextVertex] > 0)
+                fanning = (int)nextVertex;
+        }
+    }
+
+    // Authoring tools often export cache optimized meshes already, keep their order if it's better.
+    if (AnalyzeVertexCache(result.data(), result.size(), vertexCount, cacheSize).TransformedCount <
+        AnalyzeVertexCache(indices, result.size(), vertexCount, cacheSize).TransformedCount)
+    {
+        memcpy(indices, result.data(), result.size() * sizeof(TIndex));
+    }
+}
+
+template<typename TIndex>
+void MeshOptimizer::OptimizeOverdraw(TIndex* indices, size_t indexCount, const XMFLOAT3* positions, UINT positionStride, UINT vertexCount)
+{
+    UINT triangleCount = (UINT)(indexCount / 3);
+    if (triangleCount < 2)
+        return;
+
+    // Cluster starts at triangle which transforms all its vertices, order of clusters doesn't matter for cache there.
+    std::vector<UINT> clusterStarts;
+    FifoCache cache(vertexCount, DefaultCacheSize);
+    for (UINT t = 0; t < triangleCount; t++)
+    {
+        UINT transformed = 0;
+        for (UINT k = 0; k < 3; k++)
+            transformed += cache.Access(indices[t * 3 + k]) ? 1 : 0;
+        if (t == 0 || transformed == 3)
+            clusterStarts.push_back(t);
+    }
+    UINT clusterCount = (UINT)clusterStarts.size();
+    if (clusterCount < 2)
+        return;
+    clusterStarts.push_back(triangleCount);
+
+    // Area weighted centroids and normals of clusters and whole range.
+    std::vector<XMFLOAT3> clusterCentroids(clusterCount);
+    std::vector<XMFLOAT3> clusterNormals(clusterCount);
+    XMVECTOR meshCentroid = XMVectorZero();
+    float meshArea = 0.0f;
+    for (UINT c = 0; c < clusterCount; c++)
+    {
+        XMVECTOR centroid = XMVectorZero();
+        XMVECTOR normal = XMVectorZero();
+        float area = 0.0f;
+        for (UINT t = clusterStarts[c]; t < clusterStarts[c + 1]; t++)
+        {
+            XMVECTOR p0 = XMLoadFloat3(&GetPosition(positions, positionStride, indices[t * 3 + 0]));
+            XMVECTOR p1 = XMLoadFloat3(&GetPosition(positions, positionStride, indices[t * 3 + 1]));
+            XMVECTOR p2 = XMLoadFloat3(&GetPosition(positions, positionStride, indices[t * 3 + 2]));
+            XMVECTOR cross = XMVector3Cross(p1 - p0, p2 - p0);
+            float triangleArea = XMVectorGetX(XMVector3Length(cross));
+
+            centroid += (p0 + p1 + p2) * (triangleArea / 3.0f);
+            normal += cross;
+            area += triangleArea;
+        }
+        meshCentroid += centroid;
+        meshArea += area;
+        XMStoreFloat3(&clusterCentroids[c], area > 0.0f ? centroid / area : centroid);
+        XMStoreFloat3(&clusterNormals[c], XMVector3Normalize(normal));
+    }
+    if (meshArea > 0.0f)
+        meshCentroid /= meshArea;
+
+    // Clusters far out along their normal are likely to be in front of the rest of mesh.
+    std::vector<float> sortKeys(clusterCount);
+    std::vector<UINT> clusterOrder(clusterCount);
+    for (UINT c = 0; c < clusterCount; c++)
+    {
+        XMVECTOR offset = XMLoadFloat3(&clusterCentroids[c]) - meshCentroid;
+        sortKeys[c] = XMVectorGetX(XMVector3Dot(offset, XMLoadFloat3(&clusterNormals[c])));
+        clusterOrder[c] = c;
+    }
+    std::stable_sort(clusterOrder.begin(), clusterOrder.end(), [&sortKeys](UINT lhs, UINT rhs)
+    {
+        return sortKeys[lhs] > sortKeys[rhs];
+    });
+
+    std::vector<TIndex> result((size_t)triangleCount * 3);
+    size_t resultSize = 0;
+    for (UINT c : clusterOrder)
+    {
+        size_t begin = (size_t)clusterStarts[c] * 3;
+        size_t end = (size_t)clusterStarts[c + 1] * 3;
+        memcpy(&result[resultSize], indices + begin, (end - begin) * sizeof(TIndex));
+        resultSize += end - begin;
+    }
+    memcpy(indices, result.data(), result.size() * sizeof(TIndex));
+}
+
+template<typename TIndex>
+std::vector<UINT> MeshOptimizer::OptimizeVertexFetch(TIndex* indices, size_t indexCount, UINT vertexCount)
+{
+    std::vector<UINT> newIndices(vertexCount, UINT_MAX);
+    UINT nextIndex = 0;
+    for (size_t i = 0; i < indexCount; i++)
+    {
+        UINT& newIndex = newIndices[indices[i]];
+        if (newIndex == UINT_MAX)
+            newIndex = nextIndex++;
+        indices[i] = (TIndex)newIndex;
+    }
+
+    std::vector<UINT> remap(vertexCount);
+    for (UINT v = 0; v < vertexCount; v++)
+    {
+        if (newIndices[v] == UINT_MAX)
+            newIndices[v] = nextIndex++;
+        remap[newIndices[v]] = v;
+    }
+    return remap;
+}
+
+template<typename TIndex>
+VertexCacheStats MeshOptimizer::AnalyzeVertexCache(const TIndex* indices, size_t indexCount, UINT vertexCount, UINT cacheSize)
+{
+    VertexCacheStats stats;
+    stats.TriangleCount = (UINT)(indexCount / 3);
+
+    FifoCache cache(vertexCount, cacheSize);
+    std::vector<char> referenced(vertexCount, 0);
+    for (size_t i = 0; i < (size_t)stats.TriangleCount * 3; i++)
+    {
+        UINT v = indices[i];
+        stats.TransformedCount += cache.Access(v) ? 1 : 0;
+        stats.VertexCount += referenced[v] ? 0 : 1;
+        referenced[v] = 1;
+    }
+
+    if (stats.TriangleCount > 0)
+        stats.Acmr = (float)stats.TransformedCount / stats.TriangleCount;
+    if (stats.VertexCount > 0)
+        stats.Atvr = (float)stats.TransformedCount / stats.VertexCount;
+    return stats;
+}
+
+void MeshOptimizer::Optimize(GeometryGenerator::MeshData& meshData)
+{
+    Optimize(meshData.Vertices, meshData.Indices32.data(), meshData.Indices32.size());
+}
+
+template void MeshOptimizer::OptimizeVertexCache<UINT>(UINT*, size_t, UINT, UINT);
+template void MeshOptimizer::OptimizeVertexCache<USHORT>(USHORT*, size_t, UINT, UINT);
+template void MeshOptimizer::OptimizeOverdraw<UINT>(UINT*, size_t, const XMFLOAT3*, UINT, UINT);
+template void MeshOptimizer::OptimizeOverdraw<USHORT>(USHORT*, size_t, const XMFLOAT3*, UINT, UINT);
+template std::vector<UINT> MeshOptimizer::OptimizeVertexFetch<UINT>(UINT*, size_t, UINT);
+template std::vector<UINT> MeshOptimizer::OptimizeVertexFetch<USHORT>(USHORT*, size_t, UINT);
+template VertexCacheStats MeshOptimizer::AnalyzeVertexCache<UINT>(const UINT*, size_t, UINT, UINT);
+template VertexCacheStats MeshOptimizer::AnalyzeVertexCache<USHORT>(const USHORT*, size_t, UINT, UINT);
+}
@@ -0,0 +1,86 @@
+//
+// Index and vertex reordering for post transform vertex cache, overdraw and vertex fetch.
+//
+
+#pragma once
+
+#include "D3DUtil.h"
+#include "GeometryGenerator.h"
+
+namespace DX12Samples
+{
+/**
+ * \brief Post transform cache statistics of index buffer. ACMR is transformed vertices per triangle, 0.5 is the best
+ * case for regular grids and 3 the worst. ATVR is transformed vertices per referenced vertex, 1 is optimal.
+ */
+struct VertexCacheStats
+{
+    UINT TriangleCount = 0;
+    UINT VertexCount = 0;
+    UINT TransformedCount = 0;
+    float Acmr = 0.0f;
+    float Atvr = 0.0f;
+};
+
+// Run OptimizeVertexCache, then OptimizeOverdraw, then OptimizeVertexFetch. Index functions work on any index range,
+// e.g. single subset, as long as indices are less than vertexCount. Index types are UINT and USHORT.
+class MeshOptimizer
+{
+public:
+    /**
+     * \brief FIFO cache size used for analysis and cluster splitting, close to what current GPUs reuse.
+     */
+    static const UINT DefaultCacheSize = 16;
+
+    /**
+     * \brief Reorder triangles to reuse transformed vertices in FIFO cache of cacheSize, Tipsify algorithm. Triangles keep
+     * winding. Input order is kept if it's better already.
+     */
+    template<typename TIndex>
+    static void OptimizeVertexCache(TIndex* indices, size_t indexCount, UINT vertexCount, UINT cacheSize = DefaultCacheSize);
+    /**
+     * \brief Reorder clusters of cache optimized triangles so that outward facing ones go first and occlude the rest.
+     * Clusters are split where cache is cold anyway, so ACMR barely changes.
+     * \param positionStride distance between positions in bytes, e.g. sizeof of vertex struct.
+     */
+    template<typename TIndex>
+    static void OptimizeOverdraw(TIndex* indices, size_t indexCount, const DirectX::XMFLOAT3* positions, UINT positionStride, UINT vertexCount);
+    /**
+     * \brief Renumber vertices in order of first use and rewrite indices. Returns old vertex index for every new one,
+     * unreferenced vertices are moved to the end. Apply it to vertex data with RemapVertices.
+     */
+    template<typename TIndex>
+    static std::vector<UINT> OptimizeVertexFetch(TIndex* indices, size_t indexCount, UINT vertexCount);
+    /**
+     * \brief Simulate FIFO post transform cache of cacheSize entries.
+     */
+    template<typename TIndex>
+    static VertexCacheStats AnalyzeVertexCache(const TIndex* indices, size_t indexCount, UINT vertexCount, UINT cacheSize = DefaultCacheSize);
+
+    template<typename TVertex>
+    static void RemapVertices(std::vector<TVertex>& vertices, const std::vector<UINT>& remap)
+    {
+        std::vector<TVertex> remapped(vertices.size());
+        for (size_t i = 0; i < remap.size(); i++)
+            remapped[i] = vertices[remap[i]];
+        vertices.swap(remapped);
+    }
+
+    /**
+     * \brief Run all passes on vertices which have position at positionOffset.
+     */
+    template<typename TVertex, typename TIndex>
+    static void Optimize(std::vector<TVertex>& vertices, TIndex* indices, size_t indexCount, UINT positionOffset = 0)
+    {
+        UINT vertexCount = (UINT)vertices.size();
+        const DirectX::XMFLOAT3* positions = reinterpret_cast<const DirectX::XMFLOAT3*>(reinterpret_cast<const BYTE*>(vertices.data()) + positionOffset);
+        OptimizeVertexCache(indices, indexCount, vertexCount);
+        OptimizeOverdraw(indices, indexCount, positions, sizeof(TVertex), vertexCount);
+        RemapVertices(vertices, OptimizeVertexFetch(indices, indexCount, vertexCount));
+    }
+    /**
+     * \brief Optimize generated mesh. Call it before MeshData::GetIndices16, which caches converted indices.
+     */
+    static void Optimize(GeometryGenerator::MeshData& meshData);
+};
+}
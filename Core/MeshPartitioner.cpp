@@ -0,0 +1,105 @@
+#include "MeshPartitioner.h"
+
+#include <climits>
+
+#include "BoundsBuilder.h"
+
+namespace DX12Samples
+{
+UINT IndexPartition16::IndexBufferByteSize() const
+{
+    return (UINT)(Indices.size() * sizeof(uint16_t));
+}
+
+void IndexPartition16::ComputeBounds(const DirectX::XMFLOAT3* positions, UINT positionStride)
+{
+    // Vertices of every part are a contiguous range of VertexSources starting at its BaseVertexLocation.
+    const BYTE* source = reinterpret_cast<const BYTE*>(positions);
+    std::vector<DirectX::XMFLOAT3> partPositions;
+    for (size_t part = 0; part < Submeshes.size(); part++)
+    {
+        SubmeshGeometry& submesh = Submeshes[part];
+        size_t end = part + 1 < Submeshes.size() ? (size_t)Submeshes[part + 1].BaseVertexLocation : VertexSources.size();
+        partPositions.clear();
+        for (size_t i = (size_t)submesh.BaseVertexLocation; i < end; i++)
+            partPositions.push_back(*reinterpret_cast<const DirectX::XMFLOAT3*>(source + (size_t)VertexSources[i] * positionStride));
+        BoundsBuilder().Compute(partPositions.data(), (UINT)partPositions.size(), sizeof(DirectX::XMFLOAT3)).Fill(submesh);
+    }
+}
+
+IndexPartition16 MeshPartitioner::Split(const UINT* indices, size_t indexCount, UINT vertexCount, UINT maxPartVertices)
+{
+    assert(maxPartVertices >= 3 && maxPartVertices <= IndexPartition16::MaxVertices);
+
+    IndexPartition16 partition;
+    size_t triangleIndexCount = indexCount / 3 * 3;
+    partition.Indices.resize(triangleIndexCount);
+    if (triangleIndexCount == 0)
+        return partition;
+
+    if (vertexCount <= maxPartVertices)
+    {
+        partition.VertexSources.resize(vertexCount);
+        for (UINT v = 0; v < vertexCount; v++)
+            partition.VertexSources[v] = v;
+        for (size_t i = 0; i < triangleIndexCount; i++)
+            partition.Indices[i] = static_cast<uint16_t>(indices[i]);
+
+        SubmeshGeometry submesh;
+        submesh.IndexCount = (UINT)triangleIndexCount;
+        partition.Submeshes.push_back(submesh);
+        return partition;
+    }
+
+    // Local index of vertex is valid while vertexParts says it belongs to current part.
+    std::vector<UINT> vertexParts(vertexCount, UINT_MAX);
+    std::vector<uint16_t> localIndices(vertexCount);
+    SubmeshGeometry part;
+    UINT partVertexCount = 0;
+    for (size_t i = 0; i < triangleIndexCount; i += 3)
+    {
+        UINT partIndex = (UINT)partition.Submeshes.size();
+        UINT newVertices = 0;
+        for (UINT k = 0; k < 3; k++)
+        {
+            UINT v = indices[i + k];
+            bool repeated = (k > 0 && v == indices[i]) || (k > 1 && v == indices[i + 1]);
+            newVertices += vertexParts[v] != partIndex && !repeated ? 1 : 0;
+        }
+
+        if (partVertexCount + newVertices > maxPartVertices)
+        {
+            part.IndexCount = (UINT)i - part.StartIndexLocation;
+            partition.Submeshes.push_back(part);
+
+            partIndex++;
+            part.StartIndexLocation = (UINT)i;
+            part.BaseVertexLocation = (INT)partition.VertexSources.size();
+            partVertexCount = 0;
+        }
+
+        for (UINT k = 0; k < 3; k++)
+        {
+            UINT v = indices[i + k];
+            if (vertexParts[v] != partIndex)
+            {
+                vertexParts[v] = partIndex;
+                localIndices[v] = static_cast<uint16_t>(partVertexCount++);
+                partition.VertexSources.push_back(v);
+            }
+            partition.Indices[i + k] = localIndices[v];
+        }
+    }
+    part.IndexCount = (UINT)triangleIndexCount - part.StartIndexLocation;
+    partition.Submeshes.push_back(part);
+    return partition;
+}
+
+IndexPartition16 MeshPartitioner::Split(const GeometryGenerator::MeshData& meshData, UINT maxPartVertices)
+{
+    IndexPartition16 partition = Split(meshData.Indices32.data(), meshData.Indices32.size(), (UINT)meshData.Vertices.size(), maxPartVertices);
+    if (!meshData.Vertices.empty())
+        partition.ComputeBounds(&meshData.Vertices[0].Position, sizeof(GeometryGenerator::Vertex));
+    return partition;
+}
+}
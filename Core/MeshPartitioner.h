@@ -0,0 +1,57 @@
+//
+// Splitting of meshes with 32 bit indices into parts which can be drawn with 16 bit indices.
+//
+
+#pragma once
+
+#include "D3DUtil.h"
+#include "GeometryGenerator.h"
+
+namespace DX12Samples
+{
+// Mesh split into submeshes of at most MaxVertices vertices each. Submesh indices are local to its BaseVertexLocation,
+// vertices shared by several submeshes are duplicated.
+struct IndexPartition16
+{
+    static const UINT MaxVertices = 65536;
+
+    /**
+     * \brief Source vertex of every output vertex.
+     */
+    std::vector<UINT> VertexSources;
+    std::vector<uint16_t> Indices;
+    std::vector<SubmeshGeometry> Submeshes;
+
+    /**
+     * \brief Build output vertex buffer from source vertices.
+     */
+    template<typename TVertex>
+    std::vector<TVertex> GatherVertices(const std::vector<TVertex>& vertices) const
+    {
+        std::vector<TVertex> gathered(VertexSources.size());
+        for (size_t i = 0; i < VertexSources.size(); i++)
+            gathered[i] = vertices[VertexSources[i]];
+        return gathered;
+    }
+    UINT IndexBufferByteSize() const;
+    /**
+     * \brief Fill bounds of every submesh from source positions which are positionStride bytes apart.
+     */
+    void ComputeBounds(const DirectX::XMFLOAT3* positions, UINT positionStride);
+};
+
+class MeshPartitioner
+{
+public:
+    /**
+     * \brief Split triangles into consecutive runs which reference at most maxPartVertices vertices. Triangle order is
+     * kept, so cache optimized meshes stay optimized and parts are spatially coherent. Meshes which fit already come
+     * back as single submesh with unchanged vertices. Submesh bounds are left empty, see IndexPartition16::ComputeBounds.
+     */
+    static IndexPartition16 Split(const UINT* indices, size_t indexCount, UINT vertexCount, UINT maxPartVertices = IndexPartition16::MaxVertices);
+    /**
+     * \brief Split generated mesh and fill submesh bounds from its positions.
+     */
+    static IndexPartition16 Split(const GeometryGenerator::MeshData& meshData, UINT maxPartVertices = IndexPartition16::MaxVertices);
+};
+}
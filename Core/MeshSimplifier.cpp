@@ -0,0 +1,475 @@
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+
+#include "MeshOptimizer.h"
+
+namespace DX12Samples
+{
+using namespace DirectX;
+
+namespace
+{
+const UINT MaxDimension = 3 + MeshSimplifier::MaxAttributes;
+
+// Border planes keep open edges in place, they are weighted much heavier than surface ones.
+const float BorderWeight = 10.0f;
+// Collapse is rejected if it rotates any triangle by more than ~75 degrees.
+const float MinNormalCos = 0.25f;
+
+const float NormalWeight = 0.5f;
+const float TexCoordWeight = 0.5f;
+const float TangentWeight = 0.1f;
+
+// Garland-Heckbert quadric x^T A x + 2 b^T x + c of squared distances to triangle planes, weighted by triangle areas.
+// A is symmetric and stored as upper triangle by rows. Dimension of points can be less than MaxSize.
+template<UINT MaxSize>
+struct Quadric
+{
+    double A[MaxSize * (MaxSize + 1) / 2] = {};
+    double B[MaxSize] = {};
+    double C = 0.0;
+    double Weight = 0.0;
+
+    void Add(const Quadric<MaxSize>& q, UINT dimension)
+    {
+        for (UINT i = 0; i < dimension * (dimension + 1) / 2; i++)
+            A[i] += q.A[i];
+        for (UINT i = 0; i < dimension; i++)
+            B[i] += q.B[i];
+        C += q.C;
+        Weight += q.Weight;
+    }
+
+    double Evaluate(const double* x, UINT dimension) const
+    {
+        double result = C;
+        const double* a = A;
+        for (UINT i = 0; i < dimension; i++)
+        {
+            double row = *a++ * x[i];
+            for (UINT j = i + 1; j < dimension; j++)
+                row += 2.0 * *a++ * x[j];
+            result += (row + 2.0 * B[i]) * x[i];
+        }
+        return result;
+    }
+};
+
+using AttributeQuadric = Quadric<MaxDimension>;
+using PositionQuadric = Quadric<3>;
+
+// Quadric of plane through points p, q and r in dimension space, zero if they are on one line.
+template<UINT MaxSize>
+Quadric<MaxSize> MakeTriangleQuadric(const double* p, const double* q, const double* r, UINT dimension, double weight)
+{
+    double e1[MaxSize];
+    double e2[MaxSize];
+    double length1 = 0.0;
+    for (UINT i = 0; i < dimension; i++)
+    {
+        e1[i] = q[i] - p[i];
+        length1 += e1[i] * e1[i];
+    }
+
+    Quadric<MaxSize> quadric;
+    if (length1 <= 0.0)
+        return quadric;
+    length1 = sqrt(length1);
+    double projection = 0.0;
+    for (UINT i = 0; i < dimension; i++)
+    {
+        e1[i] /= length1;
+        projection += e1[i] * (r[i] - p[i]);
+    }
+    double length2 = 0.0;
+    for (UINT i = 0; i < dimension; i++)
+    {
+        e2[i] = r[i] - p[i] - projection * e1[i];
+        length2 += e2[i] * e2[i];
+    }
+    if (length2 <= 0.0)
+        return quadric;
+    length2 = sqrt(length2);
+
+    double pe1 = 0.0;
+    double pe2 = 0.0;
+    double pp = 0.0;
+    for (UINT i = 0; i < dimension; i++)
+    {
+        e2[i] /= length2;
+        pe1 += p[i] * e1[i];
+        pe2 += p[i] * e2[i];
+        pp += p[i] * p[i];
+    }
+
+    double* a = quadric.A;
+    for (UINT i = 0; i < dimension; i++)
+    {
+        for (UINT j = i; j < dimension; j++)
+            *a++ = weight * ((i == j ? 1.0 : 0.0) - e1[i] * e1[j] - e2[i] * e2[j]);
+        quadric.B[i] = weight * (pe1 * e1[i] + pe2 * e2[i] - p[i]);
+    }
+    quadric.C = weight * (pp - pe1 * pe1 - pe2 * pe2);
+    quadric.Weight = weight;
+    return quadric;
+}
+
+// Quadric of position plane n.x + d = 0 with unit normal, attributes are free.
+template<UINT MaxSize>
+Quadric<MaxSize> MakePlaneQuadric(const XMFLOAT3& normal, double d, UINT dimension, double weight)
+{
+    Quadric<MaxSize> quadric;
+    const double n[3] = { normal.x, normal.y, normal.z };
+    double* a = quadric.A;
+    for (UINT i = 0; i < dimension; i++)
+    {
+        for (UINT j = i; j < dimension; j++)
+            *a++ = i < 3 && j < 3 ? weight * n[i] * n[j] : 0.0;
+        quadric.B[i] = i < 3 ? weight * n[i] * d : 0.0;
+    }
+    quadric.C = weight * d * d;
+    quadric.Weight = weight;
+    return quadric;
+}
+
+struct Collapse
+{
+    UINT From;
+    UINT To;
+    double Cost;
+};
+
+bool HasVertex(const UINT* triangle, UINT vertex)
+{
+    return triangle[0] == vertex || triangle[1] == vertex || triangle[2] == vertex;
+}
+}
+
+UINT MeshLodChain::SelectLod(const Camera& camera, FXMMATRIX world, float viewportHeight, float pixelError) const
+{
+    BoundingSphere worldBounds;
+    Bounds.Transform(worldBounds, world);
+    float scale = Bounds.Radius > 0.0f ? worldBounds.Radius / Bounds.Radius : 1.0f;
+
+    float distance = XMVectorGetX(XMVector3Length(XMLoadFloat3(&worldBounds.Center) - camera.GetPosition())) - worldBounds.Radius;
+    if (distance <= 0.0f)
+        return 0;
+
+    float pixelsPerUnit = GetPixelsPerUnit(camera, distance, viewportHeight) * scale;
+    for (UINT level = (UINT)Levels.size() - 1; level > 0; level--)
+    {
+        if (Levels[level].Error * pixelsPerUnit <= pixelError)
+            return level;
+    }
+    return 0;
+}
+
+float MeshLodChain::GetPixelsPerUnit(const Camera& camera, float distance, float viewportHeight)
+{
+    return viewportHeight / (2.0f * distance * tanf(0.5f * camera.GetFovY()));
+}
+
+std::vector<UINT> MeshSimplifier::Simplify(const UINT* indices, size_t indexCount, const float* vertices, UINT vertexStride, UINT vertexCount,
+    const float* attributeWeights, UINT attributeCount, size_t targetIndexCount, float maxError, float* error)
+{
+    assert(attributeCount <= MaxAttributes);
+
+    std::vector<UINT> result(indices, indices + indexCount / 3 * 3);
+    if (error != nullptr)
+        *error = 0.0f;
+    if (result.size() <= targetIndexCount || vertexCount == 0)
+        return result;
+
+    auto getVertex = [&](UINT v)
+    {
+        return reinterpret_cast<const float*>(reinterpret_cast<const BYTE*>(vertices) + (size_t)v * vertexStride);
+    };
+    auto getPosition = [&](UINT v)
+    {
+        return XMLoadFloat3(reinterpret_cast<const XMFLOAT3*>(getVertex(v)));
+    };
+
+    // Quadrics are built in unit sphere around mesh, so that errors and attribute weights don't depend on mesh size.
+    BoundingSphere bounds;
+    BoundingSphere::CreateFromPoints(bounds, vertexCount, reinterpret_cast<const XMFLOAT3*>(vertices), vertexStride);
+    double scale = bounds.Radius > 0.0f ? bounds.Radius : 1.0;
+    UINT dimension = 3 + attributeCount;
+    std::vector<double> points((size_t)vertexCount * dimension);
+    for (UINT v = 0; v < vertexCount; v++)
+    {
+        const float* vertex = getVertex(v);
+        double* point = &points[(size_t)v * dimension];
+        point[0] = (vertex[0] - bounds.Center.x) / scale;
+        point[1] = (vertex[1] - bounds.Center.y) / scale;
+        point[2] = (vertex[2] - bounds.Center.z) / scale;
+        for (UINT i = 0; i < attributeCount; i++)
+            point[3 + i] = vertex[3 + i] * attributeWeights[i];
+    }
+
+    // Vertices which share position with other ones can't move without opening cracks.
+    std::vector<char> locked(vertexCount, 0);
+    std::vector<UINT> sorted(vertexCount);
+    for (UINT v = 0; v < vertexCount; v++)
+        sorted[v] = v;
+    auto lessPosition = [&](UINT a, UINT b)
+    {
+        const float* pa = getVertex(a);
+        const float* pb = getVertex(b);
+        return std::lexicographical_compare(pa, pa + 3, pb, pb + 3);
+    };
+    std::sort(sorted.begin(), sorted.end(), lessPosition);
+    for (UINT i = 1; i < vertexCount; i++)
+    {
+        if (!lessPosition(sorted[i - 1], sorted[i]))
+            locked[sorted[i - 1]] = locked[sorted[i]] = 1;
+    }
+
+    // Vertex triangles in current index buffer, rebuilt after every pass.
+    std::vector<UINT> triangleOffsets(vertexCount + 1);
+    std::vector<UINT> vertexTriangles;
+    auto buildAdjacency = [&]()
+    {
+        std::fill(triangleOffsets.begin(), triangleOffsets.end(), 0);
+        for (UINT index : result)
+            triangleOffsets[index + 1]++;
+        for (UINT v = 0; v < vertexCount; v++)
+            triangleOffsets[v + 1] += triangleOffsets[v];
+        vertexTriangles.resize(result.size());
+        std::vector<UINT> filled(triangleOffsets.begin(), triangleOffsets.end() - 1);
+        for (size_t i = 0; i < result.size(); i++)
+            vertexTriangles[filled[result[i]]++] = (UINT)(i / 3);
+    };
+    auto countSharedTriangles = [&](UINT u, UINT v)
+    {
+        UINT count = 0;
+        for (UINT j = triangleOffsets[u]; j < triangleOffsets[u + 1]; j++)
+            count += HasVertex(&result[vertexTriangles[j] * 3], v) ? 1 : 0;
+        return count;
+    };
+
+    buildAdjacency();
+    std::vector<AttributeQuadric> quadrics(vertexCount);
+    std::vector<PositionQuadric> positionQuadrics(vertexCount);
+    std::vector<char> border(vertexCount, 0);
+    for (size_t i = 0; i < result.size(); i += 3)
+    {
+        const UINT* triangle = &result[i];
+        XMVECTOR p0 = getPosition(triangle[0]);
+        XMVECTOR p1 = getPosition(triangle[1]);
+        XMVECTOR p2 = getPosition(triangle[2]);
+        XMVECTOR normal = XMVector3Cross(p1 - p0, p2 - p0);
+        double area = 0.5 * XMVectorGetX(XMVector3Length(normal)) / (scale * scale);
+
+        const double* p[3];
+        for (UINT k = 0; k < 3; k++)
+            p[k] = &points[(size_t)triangle[k] * dimension];
+        AttributeQuadric quadric = MakeTriangleQuadric<MaxDimension>(p[0], p[1], p[2], dimension, area);
+        PositionQuadric positionQuadric = MakeTriangleQuadric<3>(p[0], p[1], p[2], 3, area);
+        for (UINT k = 0; k < 3; k++)
+        {
+            quadrics[triangle[k]].Add(quadric, dimension);
+            positionQuadrics[triangle[k]].Add(positionQuadric, 3);
+        }
+
+        // Edge without opposite triangle is on border, it gets plane perpendicular to triangle.
+        for (UINT k = 0; k < 3; k++)
+        {
+            UINT a = triangle[k];
+            UINT b = triangle[(k + 1) % 3];
+            if (countSharedTriangles(a, b) != 1)
+                continue;
+            border[a] = border[b] = 1;
+
+            const double* pa = &points[(size_t)a * dimension];
+            const double* pb = &points[(size_t)b * dimension];
+            XMVECTOR edge = XMVectorSet((float)(pb[0] - pa[0]), (float)(pb[1] - pa[1]), (float)(pb[2] - pa[2]), 0.0f);
+            XMFLOAT3 planeNormal;
+            XMStoreFloat3(&planeNormal, XMVector3Normalize(XMVector3Cross(edge, normal)));
+            double d = -(planeNormal.x * pa[0] + planeNormal.y * pa[1] + planeNormal.z * pa[2]);
+            double edgeLength2 = XMVectorGetX(XMVector3LengthSq(edge));
+            AttributeQuadric plane = MakePlaneQuadric<MaxDimension>(planeNormal, d, dimension, BorderWeight * edgeLength2);
+            PositionQuadric positionPlane = MakePlaneQuadric<3>(planeNormal, d, 3, BorderWeight * edgeLength2);
+            quadrics[a].Add(plane, dimension);
+            quadrics[b].Add(plane, dimension);
+            positionQuadrics[a].Add(positionPlane, 3);
+            positionQuadrics[b].Add(positionPlane, 3);
+        }
+    }
+
+    // Collapses are ordered by attribute quadrics, errors are measured by position ones.
+    auto getCost = [&](UINT from, UINT to)
+    {
+        const double* x = &points[(size_t)to * dimension];
+        double weight = quadrics[from].Weight + quadrics[to].Weight;
+        double cost = quadrics[from].Evaluate(x, dimension) + quadrics[to].Evaluate(x, dimension);
+        return weight > 0.0 ? std::max(cost / weight, 0.0) : 0.0;
+    };
+    auto getError = [&](UINT from, UINT to)
+    {
+        const double* x = &points[(size_t)to * dimension];
+        double weight = positionQuadrics[from].Weight + positionQuadrics[to].Weight;
+        double error = positionQuadrics[from].Evaluate(x, 3) + positionQuadrics[to].Evaluate(x, 3);
+        return weight > 0.0 ? std::max(error / weight, 0.0) : 0.0;
+    };
+    // Border vertex may slide only along border edge.
+    auto canCollapse = [&](UINT from, UINT to)
+    {
+        return !locked[from] && (!border[from] || countSharedTriangles(from, to) == 1);
+    };
+    // Moving from onto to must not flip or collapse triangles which don't contain edge.
+    auto keepsOrientation = [&](UINT from, UINT to, const std::vector<UINT>& remap)
+    {
+        XMVECTOR target = getPosition(to);
+        for (UINT j = triangleOffsets[from]; j < triangleOffsets[from + 1]; j++)
+        {
+            const UINT* triangle = &result[vertexTriangles[j] * 3];
+            if (HasVertex(triangle, to))
+                continue;
+
+            XMVECTOR p[3];
+            for (UINT k = 0; k < 3; k++)
+                p[k] = getPosition(remap[triangle[k]]);
+            XMVECTOR before = XMVector3Cross(p[1] - p[0], p[2] - p[0]);
+            for (UINT k = 0; k < 3; k++)
+                p[k] = triangle[k] == from ? target : p[k];
+            XMVECTOR after = XMVector3Cross(p[1] - p[0], p[2] - p[0]);
+
+            float lengths = XMVectorGetX(XMVector3Length(before)) * XMVectorGetX(XMVector3Length(after));
+            if (XMVectorGetX(XMVector3LengthSq(before)) > 0.0f && XMVectorGetX(XMVector3Dot(before, after)) <= MinNormalCos * lengths)
+                return false;
+        }
+        return true;
+    };
+
+    double maxSquaredError = maxError == FLT_MAX ? DBL_MAX : (maxError / scale) * (maxError / scale);
+    double resultSquaredError = 0.0;
+    size_t targetTriangleCount = targetIndexCount / 3;
+    std::vector<Collapse> collapses;
+    std::vector<UINT> remap(vertexCount);
+    std::vector<char> touched(vertexCount);
+    // Every pass collapses cheapest edges which don't touch each other, then triangles are rebuilt.
+    while (result.size() / 3 > targetTriangleCount)
+    {
+        collapses.clear();
+        for (size_t i = 0; i < result.size(); i += 3)
+        {
+            for (UINT k = 0; k < 3; k++)
+            {
+                UINT a = result[i + k];
+                UINT b = result[i + (k + 1) % 3];
+                // Interior edges are seen from both triangles, visit them once.
+                if (a > b && countSharedTriangles(a, b) > 1)
+                    continue;
+
+                Collapse collapse = { a, b, DBL_MAX };
+                if (canCollapse(a, b))
+                    collapse.Cost = getCost(a, b);
+                if (canCollapse(b, a))
+                {
+                    double cost = getCost(b, a);
+                    if (cost < collapse.Cost)
+                        collapse = { b, a, cost };
+                }
+                if (collapse.Cost < DBL_MAX && getError(collapse.From, collapse.To) <= maxSquaredError)
+                    collapses.push_back(collapse);
+            }
+        }
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.Cost < b.Cost; });
+
+        for (UINT v = 0; v < vertexCount; v++)
+            remap[v] = v;
+        std::fill(touched.begin(), touched.end(), 0);
+        size_t removeGoal = result.size() / 3 - targetTriangleCount;
+        size_t removed = 0;
+        for (const Collapse& collapse : collapses)
+        {
+            if (removed >= removeGoal)
+                break;
+            if (touched[collapse.From] || touched[collapse.To] || !keepsOrientation(collapse.From, collapse.To, remap))
+                continue;
+
+            remap[collapse.From] = collapse.To;
+            touched[collapse.From] = touched[collapse.To] = 1;
+            resultSquaredError = std::max(resultSquaredError, getError(collapse.From, collapse.To));
+            quadrics[collapse.To].Add(quadrics[collapse.From], dimension);
+            positionQuadrics[collapse.To].Add(positionQuadrics[collapse.From], 3);
+            removed += countSharedTriangles(collapse.From, collapse.To);
+        }
+        if (removed == 0)
+            break;
+
+        size_t writeIndex = 0;
+        for (size_t i = 0; i < result.size(); i += 3)
+        {
+            UINT i0 = remap[result[i]];
+            UINT i1 = remap[result[i + 1]];
+            UINT i2 = remap[result[i + 2]];
+            if (i0 == i1 || i1 == i2 || i2 == i0)
+                continue;
+            result[writeIndex++] = i0;
+            result[writeIndex++] = i1;
+            result[writeIndex++] = i2;
+        }
+        result.resize(writeIndex);
+        buildAdjacency();
+    }
+
+    if (error != nullptr)
+        *error = (float)(sqrt(resultSquaredError) * scale);
+    return result;
+}
+
+std::vector<UINT> MeshSimplifier::Simplify(const GeometryGenerator::MeshData& meshData, size_t targetIndexCount, float maxError, float* error)
+{
+    // Vertex has normal, tangent and texture coordinates after position.
+    const float weights[] = { NormalWeight, NormalWeight, NormalWeight, TangentWeight, TangentWeight, TangentWeight, TexCoordWeight, TexCoordWeight };
+    return Simplify(meshData.Indices32.data(), meshData.Indices32.size(), reinterpret_cast<const float*>(meshData.Vertices.data()), sizeof(GeometryGenerator::Vertex),
+        (UINT)meshData.Vertices.size(), weights, _countof(weights), targetIndexCount, maxError, error);
+}
+
+MeshLodChain MeshSimplifier::BuildLodChain(const GeometryGenerator::MeshData& meshData, UINT maxLevels)
+{
+    const float weights[] = { NormalWeight, NormalWeight, NormalWeight, TangentWeight, TangentWeight, TangentWeight, TexCoordWeight, TexCoordWeight };
+    return BuildLodChain(meshData.Indices32.data(), meshData.Indices32.size(), reinterpret_cast<const float*>(meshData.Vertices.data()), sizeof(GeometryGenerator::Vertex),
+        (UINT)meshData.Vertices.size(), weights, _countof(weights), maxLevels);
+}
+
+MeshLodChain MeshSimplifier::BuildLodChain(const MeshAsset& mesh, UINT maxLevels)
+{
+    // Layouts add normal, then texture coordinates, then tangent.
+    const float weights[] = { NormalWeight, NormalWeight, NormalWeight, TexCoordWeight, TexCoordWeight, TangentWeight, TangentWeight, TangentWeight };
+    UINT attributeCount = mesh.VertexStride / sizeof(float) - 3;
+    return BuildLodChain(mesh.Indices.data(), mesh.Indices.size(), reinterpret_cast<const float*>(mesh.Vertices.data()), mesh.VertexStride,
+        mesh.VertexCount, weights, attributeCount, maxLevels);
+}
+
+MeshLodChain MeshSimplifier::BuildLodChain(const UINT* indices, size_t indexCount, const float* vertices, UINT vertexStride, UINT vertexCount,
+    const float* attributeWeights, UINT attributeCount, UINT maxLevels)
+{
+    MeshLodChain chain;
+    chain.Bounds = BoundsBuilder().ComputeSphere(reinterpret_cast<const XMFLOAT3*>(vertices), vertexCount, vertexStride);
+
+    MeshLod source;
+    source.Indices.assign(indices, indices + indexCount);
+    chain.Levels.push_back(std::move(source));
+
+    // Every level is simplified from source mesh, so that its error is measured against source surface.
+    while (chain.Levels.size() < maxLevels)
+    {
+        size_t previousCount = chain.Levels.back().Indices.size();
+        size_t targetCount = previousCount / 6 * 3;
+        if (targetCount == 0)
+            break;
+
+        MeshLod level;
+        level.Indices = Simplify(indices, indexCount, vertices, vertexStride, vertexCount, attributeWeights, attributeCount, targetCount, FLT_MAX, &level.Error);
+        if (level.Indices.size() > previousCount * 3 / 4)
+            break;
+
+        MeshOptimizer::OptimizeVertexCache(level.Indices.data(), level.Indices.size(), vertexCount);
+        chain.Levels.push_back(std::move(level));
+    }
+    return chain;
+}
+}
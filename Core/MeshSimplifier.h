@@ -0,0 +1,76 @@
+//
+// Quadric error metric simplification and level of detail chains.
+//
+
+#pragma once
+
+#include <cfloat>
+
+#include "Camera.h"
+#include "D3DUtil.h"
+#include "GeometryGenerator.h"
+#include "MeshAsset.h"
+
+namespace DX12Samples
+{
+// Indices of one level of detail. Levels reference source vertices, so all of them share single vertex buffer.
+struct MeshLod
+{
+    std::vector<UINT> Indices;
+    /**
+     * \brief Estimated deviation from source surface in mesh units, 0 for source mesh. Square root of the largest quadric error
+     * of collapses, which is area weighted mean of squared distances from collapsed vertex to planes of triangles it replaced,
+     * so it's an average rather than bound of distance.
+     */
+    float Error = 0.0f;
+};
+
+// Levels from source mesh to coarsest one, each with about half triangles of previous one.
+struct MeshLodChain
+{
+    std::vector<MeshLod> Levels;
+    DirectX::BoundingSphere Bounds;
+
+    /**
+     * \brief Pick coarsest level which error projects to at most pixelError pixels on screen for mesh placed with
+     * world transform. Error is projected at nearest point of bounds, camera inside of bounds gets level 0.
+     */
+    UINT SelectLod(const Camera& camera, DirectX::FXMMATRIX world, float viewportHeight, float pixelError = 1.0f) const;
+    /**
+     * \brief Size in pixels of one mesh unit seen at distance from camera.
+     */
+    static float GetPixelsPerUnit(const Camera& camera, float distance, float viewportHeight);
+};
+
+// Edge collapse simplification with Garland-Heckbert quadrics built over position and vertex attributes, so that
+// collapses which stretch normals or texture coordinates cost more. Every collapse moves vertex into its neighbour,
+// so vertices are never created or changed. Vertices on open borders slide only along them and vertices which share
+// position with other ones, e.g. on texture seams, are kept.
+class MeshSimplifier
+{
+public:
+    static const UINT MaxAttributes = 8;
+
+    /**
+     * \brief Simplify triangles down to targetIndexCount indices or until error would exceed maxError.
+     * \param vertices position followed by attributeCount floats in each vertex.
+     * \param vertexStride distance between vertices in bytes.
+     * \param attributeWeights importance of each attribute relative to position, which is scaled to unit sphere.
+     * \param error square root of the largest area weighted mean squared plane distance of collapses in mesh units, can be nullptr.
+     */
+    static std::vector<UINT> Simplify(const UINT* indices, size_t indexCount, const float* vertices, UINT vertexStride, UINT vertexCount,
+        const float* attributeWeights, UINT attributeCount, size_t targetIndexCount, float maxError = FLT_MAX, float* error = nullptr);
+    static std::vector<UINT> Simplify(const GeometryGenerator::MeshData& meshData, size_t targetIndexCount, float maxError = FLT_MAX, float* error = nullptr);
+
+    /**
+     * \brief Halve triangles of each next level until maxLevels levels are built or mesh can't be simplified further.
+     * Indices of every level are optimized for vertex cache.
+     */
+    static MeshLodChain BuildLodChain(const GeometryGenerator::MeshData& meshData, UINT maxLevels = 4);
+    static MeshLodChain BuildLodChain(const MeshAsset& mesh, UINT maxLevels = 4);
+
+private:
+    static MeshLodChain BuildLodChain(const UINT* indices, size_t indexCount, const float* vertices, UINT vertexStride, UINT vertexCount,
+        const float* attributeWeights, UINT attributeCount, UINT maxLevels);
+};
+}
@@ -0,0 +1,281 @@
+#include "MeshStreams.h"
+
+namespace DX12Samples
+{
+using namespace DirectX;
+
+namespace
+{
+XMVECTOR LoadGroup(const float* stream)
+{
+    return XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(stream));
+}
+
+void StoreGroup(float* stream, FXMVECTOR v)
+{
+    XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(stream), v);
+}
+
+// Run kernel(x, y, z) over groups of 4 vectors and store results back. Last partial group goes through same kernel
+// with zero padding, so all elements get exactly same math.
+template<typename Kernel>
+void ForEachGroup(const Stream3& stream, Kernel kernel)
+{
+    UINT groupEnd = stream.Count & ~3u;
+    for (UINT i = 0; i < groupEnd; i += 4)
+    {
+        XMVECTOR x = LoadGroup(stream.X + i);
+        XMVECTOR y = LoadGroup(stream.Y + i);
+        XMVECTOR z = LoadGroup(stream.Z + i);
+        kernel(x, y, z);
+        StoreGroup(stream.X + i, x);
+        StoreGroup(stream.Y + i, y);
+        StoreGroup(stream.Z + i, z);
+    }
+
+    UINT tail = stream.Count - groupEnd;
+    if (tail == 0)
+        return;
+
+    float tx[4] = {}, ty[4] = {}, tz[4] = {};
+    std::copy_n(stream.X + groupEnd, tail, tx);
+    std::copy_n(stream.Y + groupEnd, tail, ty);
+    std::copy_n(stream.Z + groupEnd, tail, tz);
+    XMVECTOR x = LoadGroup(tx);
+    XMVECTOR y = LoadGroup(ty);
+    XMVECTOR z = LoadGroup(tz);
+    kernel(x, y, z);
+    StoreGroup(tx, x);
+    StoreGroup(ty, y);
+    StoreGroup(tz, z);
+    std::copy_n(tx, tail, stream.X + groupEnd);
+    std::copy_n(ty, tail, stream.Y + groupEnd);
+    std::copy_n(tz, tail, stream.Z + groupEnd);
+}
+
+void TransformStream(const Stream3& stream, FXMMATRIX m, bool translate)
+{
+    XMFLOAT4X4 f;
+    XMStoreFloat4x4(&f, m);
+    XMVECTOR m00 = XMVectorReplicate(f._11), m01 = XMVectorReplicate(f._12), m02 = XMVectorReplicate(f._13);
+    XMVECTOR m10 = XMVectorReplicate(f._21), m11 = XMVectorReplicate(f._22), m12 = XMVectorReplicate(f._23);
+    XMVECTOR m20 = XMVectorReplicate(f._31), m21 = XMVectorReplicate(f._32), m22 = XMVectorReplicate(f._33);
+    XMVECTOR m30 = translate ? XMVectorReplicate(f._41) : XMVectorZero();
+    XMVECTOR m31 = translate ? XMVectorReplicate(f._42) : XMVectorZero();
+    XMVECTOR m32 = translate ? XMVectorReplicate(f._43) : XMVectorZero();
+
+    // Row vector convention of DirectXMath: v' = x * r0 + y * r1 + z * r2 + r3.
+    ForEachGroup(stream, [&](XMVECTOR& x, XMVECTOR& y, XMVECTOR& z)
+    {
+        XMVECTOR rx = XMVectorMultiplyAdd(z, m20, XMVectorMultiplyAdd(y, m10, XMVectorMultiplyAdd(x, m00, m30)));
+        XMVECTOR ry = XMVectorMultiplyAdd(z, m21, XMVectorMultiplyAdd(y, m11, XMVectorMultiplyAdd(x, m01, m31)));
+        XMVECTOR rz = XMVectorMultiplyAdd(z, m22, XMVectorMultiplyAdd(y, m12, XMVectorMultiplyAdd(x, m02, m32)));
+        x = rx;
+        y = ry;
+        z = rz;
+    });
+}
+}
+
+Stream3 Stream3::Sub(UINT first, UINT count) const
+{
+    assert(first + count <= Count);
+    return { X + first, Y + first, Z + first, count };
+}
+
+ConstStream3 ConstStream3::Sub(UINT first, UINT count) const
+{
+    assert(first + count <= Count);
+    return ConstStream3(X + first, Y + first, Z + first, count);
+}
+
+MeshStreams::MeshStreams(const GeometryGenerator::MeshData& meshData) : Indices32(meshData.Indices32)
+{
+    Resize((UINT)meshData.Vertices.size());
+    for (UINT i = 0; i < _vertexCount; i++)
+        SetVertex(i, meshData.Vertices[i]);
+}
+
+void MeshStreams::Resize(UINT vertexCount)
+{
+    _vertexCount = vertexCount;
+    _streamLength = (vertexCount + 3) & ~3u;
+    _data.resize(ComponentCount * _streamLength / 4);
+}
+
+UINT MeshStreams::VertexCount() const
+{
+    return _vertexCount;
+}
+
+Stream3 MeshStreams::Positions()
+{
+    return { GetStream(PositionX), GetStream(PositionY), GetStream(PositionZ), _vertexCount };
+}
+
+ConstStream3 MeshStreams::Positions() const
+{
+    return const_cast<MeshStreams*>(this)->Positions();
+}
+
+Stream3 MeshStreams::Normals()
+{
+    return { GetStream(NormalX), GetStream(NormalY), GetStream(NormalZ), _vertexCount };
+}
+
+ConstStream3 MeshStreams::Normals() const
+{
+    return const_cast<MeshStreams*>(this)->Normals();
+}
+
+Stream3 MeshStreams::Tangents()
+{
+    return { GetStream(TangentX), GetStream(TangentY), GetStream(TangentZ), _vertexCount };
+}
+
+ConstStream3 MeshStreams::Tangents() const
+{
+    return const_cast<MeshStreams*>(this)->Tangents();
+}
+
+Stream2 MeshStreams::TexCoords()
+{
+    return { GetStream(TexCoordU), GetStream(TexCoordV), _vertexCount };
+}
+
+GeometryGenerator::Vertex MeshStreams::GetVertex(UINT index) const
+{
+    assert(index < _vertexCount);
+    return GeometryGenerator::Vertex(
+        GetStream(PositionX)[index], GetStream(PositionY)[index], GetStream(PositionZ)[index],
+        GetStream(NormalX)[index], GetStream(NormalY)[index], GetStream(NormalZ)[index],
+        GetStream(TangentX)[index], GetStream(TangentY)[index], GetStream(TangentZ)[index],
+        GetStream(TexCoordU)[index], GetStream(TexCoordV)[index]);
+}
+
+void MeshStreams::SetVertex(UINT index, const GeometryGenerator::Vertex& vertex)
+{
+    assert(index < _vertexCount);
+    GetStream(PositionX)[index] = vertex.Position.x;
+    GetStream(PositionY)[index] = vertex.Position.y;
+    GetStream(PositionZ)[index] = vertex.Position.z;
+    GetStream(NormalX)[index] = vertex.Normal.x;
+    GetStream(NormalY)[index] = vertex.Normal.y;
+    GetStream(NormalZ)[index] = vertex.Normal.z;
+    GetStream(TangentX)[index] = vertex.Tangent.x;
+    GetStream(TangentY)[index] = vertex.Tangent.y;
+    GetStream(TangentZ)[index] = vertex.Tangent.z;
+    GetStream(TexCoordU)[index] = vertex.TexCoord.x;
+    GetStream(TexCoordV)[index] = vertex.TexCoord.y;
+}
+
+GeometryGenerator::MeshData MeshStreams::ToMeshData() const
+{
+    GeometryGenerator::MeshData meshData;
+    meshData.Vertices.resize(_vertexCount);
+    for (UINT i = 0; i < _vertexCount; i++)
+        meshData.Vertices[i] = GetVertex(i);
+    meshData.Indices32 = Indices32;
+    return meshData;
+}
+
+void MeshStreams::Transform(FXMMATRIX world)
+{
+    TransformPoints(Positions(), world);
+
+    TransformDirections(Normals(), MathHelper::InverseTranspose(world));
+    Normalize(Normals());
+
+    TransformDirections(Tangents(), world);
+    Normalize(Tangents());
+}
+
+BoundingBox MeshStreams::ComputeBounds() const
+{
+    return ComputeBounds(Positions());
+}
+
+BoundingBox MeshStreams::ComputeBounds(const ConstStream3& points)
+{
+    if (points.Count == 0)
+        return BoundingBox(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(0.0f, 0.0f, 0.0f));
+
+    XMVECTOR minX = XMVectorReplicate(points.X[0]), minY = XMVectorReplicate(points.Y[0]), minZ = XMVectorReplicate(points.Z[0]);
+    XMVECTOR maxX = minX, maxY = minY, maxZ = minZ;
+
+    UINT groupEnd = points.Count & ~3u;
+    for (UINT i = 0; i < groupEnd; i += 4)
+    {
+        XMVECTOR x = LoadGroup(points.X + i);
+        XMVECTOR y = LoadGroup(points.Y + i);
+        XMVECTOR z = LoadGroup(points.Z + i);
+        minX = XMVectorMin(minX, x);
+        minY = XMVectorMin(minY, y);
+        minZ = XMVectorMin(minZ, z);
+        maxX = XMVectorMax(maxX, x);
+        maxY = XMVectorMax(maxY, y);
+        maxZ = XMVectorMax(maxZ, z);
+    }
+
+    XMFLOAT4 lo[3], hi[3];
+    XMStoreFloat4(&lo[0], minX);
+    XMStoreFloat4(&lo[1], minY);
+    XMStoreFloat4(&lo[2], minZ);
+    XMStoreFloat4(&hi[0], maxX);
+    XMStoreFloat4(&hi[1], maxY);
+    XMStoreFloat4(&hi[2], maxZ);
+
+    float boxMin[3], boxMax[3];
+    for (UINT c = 0; c < 3; c++)
+    {
+        boxMin[c] = (std::min)((std::min)(lo[c].x, lo[c].y), (std::min)(lo[c].z, lo[c].w));
+        boxMax[c] = (std::max)((std::max)(hi[c].x, hi[c].y), (std::max)(hi[c].z, hi[c].w));
+    }
+    const float* streams[3] = { points.X, points.Y, points.Z };
+    for (UINT i = groupEnd; i < points.Count; i++)
+    {
+        for (UINT c = 0; c < 3; c++)
+        {
+            boxMin[c] = (std::min)(boxMin[c], streams[c][i]);
+            boxMax[c] = (std::max)(boxMax[c], streams[c][i]);
+        }
+    }
+
+    BoundingBox bounds;
+    BoundingBox::CreateFromPoints(bounds, XMVectorSet(boxMin[0], boxMin[1], boxMin[2], 0.0f), XMVectorSet(boxMax[0], boxMax[1], boxMax[2], 0.0f));
+    return bounds;
+}
+
+void MeshStreams::TransformPoints(const Stream3& points, FXMMATRIX m)
+{
+    TransformStream(points, m, true);
+}
+
+void MeshStreams::TransformDirections(const Stream3& directions, FXMMATRIX m)
+{
+    TransformStream(directions, m, false);
+}
+
+void MeshStreams::Normalize(const Stream3& vectors)
+{
+    XMVECTOR zero = XMVectorZero();
+    ForEachGroup(vectors, [zero](XMVECTOR& x, XMVECTOR& y, XMVECTOR& z)
+    {
+        XMVECTOR lengthSq = XMVectorMultiplyAdd(z, z, XMVectorMultiplyAdd(y, y, XMVectorMultiply(x, x)));
+        XMVECTOR invLength = XMVectorSelect(zero, XMVectorReciprocalSqrt(lengthSq), XMVectorGreater(lengthSq, zero));
+        x = XMVectorMultiply(x, invLength);
+        y = XMVectorMultiply(y, invLength);
+        z = XMVectorMultiply(z, invLength);
+    });
+}
+
+float* MeshStreams::GetStream(Component component)
+{
+    return reinterpret_cast<float*>(_data.data()) + component * _streamLength;
+}
+
+const float* MeshStreams::GetStream(Component component) const
+{
+    return reinterpret_cast<const float*>(_data.data()) + component * _streamLength;
+}
+}
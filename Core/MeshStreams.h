@@ -0,0 +1,119 @@
+//
+// Mesh vertices in structure of arrays layout with kernels which work on 4 vertices at once.
+//
+
+#pragma once
+
+#include "AlignedAllocator.h"
+#include "D3DUtil.h"
+#include "GeometryGenerator.h"
+
+namespace DX12Samples
+{
+// View of 3 component stream, e.g. positions of MeshStreams or part of them. Doesn't own memory.
+struct Stream3
+{
+    float* X;
+    float* Y;
+    float* Z;
+    UINT Count;
+
+    /**
+     * \brief View of count elements starting from first.
+     */
+    Stream3 Sub(UINT first, UINT count) const;
+};
+
+struct ConstStream3
+{
+    ConstStream3(const float* x, const float* y, const float* z, UINT count) : X(x), Y(y), Z(z), Count(count)
+    {}
+    ConstStream3(const Stream3& stream) : X(stream.X), Y(stream.Y), Z(stream.Z), Count(stream.Count)
+    {}
+
+    const float* X;
+    const float* Y;
+    const float* Z;
+    UINT Count;
+
+    ConstStream3 Sub(UINT first, UINT count) const;
+};
+
+struct Stream2
+{
+    float* X;
+    float* Y;
+    UINT Count;
+};
+
+// Every vertex component lives in its own array, so passes which need only positions read only them and 4 consecutive
+// vertices load into one XMVECTOR per component. All arrays are in single buffer, each of them starts at 16 byte boundary.
+class MeshStreams
+{
+public:
+    MeshStreams() = default;
+    explicit MeshStreams(const GeometryGenerator::MeshData& meshData);
+
+    /**
+     * \brief Resize all streams, content of new vertices is undefined.
+     */
+    void Resize(UINT vertexCount);
+    UINT VertexCount() const;
+
+    Stream3 Positions();
+    ConstStream3 Positions() const;
+    Stream3 Normals();
+    ConstStream3 Normals() const;
+    Stream3 Tangents();
+    ConstStream3 Tangents() const;
+    Stream2 TexCoords();
+
+    GeometryGenerator::Vertex GetVertex(UINT index) const;
+    void SetVertex(UINT index, const GeometryGenerator::Vertex& vertex);
+    GeometryGenerator::MeshData ToMeshData() const;
+
+    /**
+     * \brief Transform positions by world matrix, normals by its inverse transpose and tangents by its upper 3x3,
+     * then renormalize normals and tangents.
+     */
+    void Transform(DirectX::FXMMATRIX world);
+    DirectX::BoundingBox ComputeBounds() const;
+
+    /**
+     * \brief Axis aligned box of points, empty box at origin for empty stream.
+     */
+    static DirectX::BoundingBox ComputeBounds(const ConstStream3& points);
+    /**
+     * \brief Transform points in place with w = 1, no perspective divide.
+     */
+    static void TransformPoints(const Stream3& points, DirectX::FXMMATRIX m);
+    /**
+     * \brief Transform directions in place with w = 0.
+     */
+    static void TransformDirections(const Stream3& directions, DirectX::FXMMATRIX m);
+    /**
+     * \brief Normalize vectors in place, zero vectors stay zero.
+     */
+    static void Normalize(const Stream3& vectors);
+
+    std::vector<GeometryGenerator::uint32> Indices32;
+
+private:
+    enum Component
+    {
+        PositionX, PositionY, PositionZ,
+        NormalX, NormalY, NormalZ,
+        TangentX, TangentY, TangentZ,
+        TexCoordU, TexCoordV,
+        ComponentCount
+    };
+
+    float* GetStream(Component component);
+    const float* GetStream(Component component) const;
+
+    UINT _vertexCount = 0;
+    // Length of each stream rounded up to 4 vertices.
+    UINT _streamLength = 0;
+    std::vector<DirectX::XMVECTOR, AlignedAllocator<DirectX::XMVECTOR>> _data;
+};
+}
@@ -0,0 +1,349 @@
+#include "MeshletBuilder.h"
+
+#include <cfloat>
+#include <climits>
+
+namespace DX12Samples
+{
+using namespace DirectX;
+
+namespace
+{
+const UINT MeshletMagic = 0x4C48534D; // "MSHL"
+const UINT MeshletVersion = 1;
+const UINT PrimitiveIndexBits = 10;
+const UINT PrimitiveIndexMask = (1 << PrimitiveIndexBits) - 1;
+// Cones wider than about 84 degrees almost never cull, they are dropped.
+const float MinConeDot = 0.1f;
+
+struct MeshletBlobHeader
+{
+    UINT Magic = MeshletMagic;
+    UINT Version = MeshletVersion;
+    UINT MeshletCount = 0;
+    UINT VertexIndexCount = 0;
+    UINT PrimitiveCount = 0;
+};
+
+const XMFLOAT3& GetPosition(const XMFLOAT3* positions, UINT positionStride, UINT index)
+{
+    return *reinterpret_cast<const XMFLOAT3*>(reinterpret_cast<const BYTE*>(positions) + (size_t)index * positionStride);
+}
+
+template<typename T>
+void WriteArray(std::vector<BYTE>& blob, const std::vector<T>& values)
+{
+    const BYTE* data = reinterpret_cast<const BYTE*>(values.data());
+    blob.insert(blob.end(), data, data + values.size() * sizeof(T));
+}
+
+template<typename T>
+const BYTE* ReadArray(const BYTE* data, std::vector<T>& values, UINT count)
+{
+    values.resize(count);
+    memcpy(values.data(), data, (size_t)count * sizeof(T));
+    return data + (size_t)count * sizeof(T);
+}
+}
+
+UINT MeshletData::PackPrimitive(UINT i0, UINT i1, UINT i2)
+{
+    return i0 | (i1 << PrimitiveIndexBits) | (i2 << (PrimitiveIndexBits * 2));
+}
+
+void MeshletData::UnpackPrimitive(UINT primitive, UINT& i0, UINT& i1, UINT& i2)
+{
+    i0 = primitive & PrimitiveIndexMask;
+    i1 = (primitive >> PrimitiveIndexBits) & PrimitiveIndexMask;
+    i2 = (primitive >> (PrimitiveIndexBits * 2)) & PrimitiveIndexMask;
+}
+
+std::vector<UINT> MeshletData::GetTriangleIndices() const
+{
+    std::vector<UINT> indices(PrimitiveIndices.size() * 3);
+    for (const Meshlet& meshlet : Meshlets)
+    {
+        for (UINT p = meshlet.PrimitiveOffset; p < meshlet.PrimitiveOffset + meshlet.PrimitiveCount; p++)
+        {
+            UINT local[3];
+            UnpackPrimitive(PrimitiveIndices[p], local[0], local[1], local[2]);
+            for (UINT k = 0; k < 3; k++)
+                indices[(size_t)p * 3 + k] = VertexIndices[meshlet.VertexOffset + local[k]];
+        }
+    }
+    return indices;
+}
+
+void MeshletData::Clear()
+{
+    Meshlets.clear();
+    Bounds.clear();
+    VertexIndices.clear();
+    PrimitiveIndices.clear();
+}
+
+std::vector<BYTE> MeshletData::Serialize() const
+{
+    MeshletBlobHeader header;
+    header.MeshletCount = (UINT)Meshlets.size();
+    header.VertexIndexCount = (UINT)VertexIndices.size();
+    header.PrimitiveCount = (UINT)PrimitiveIndices.size();
+
+    std::vector<BYTE> blob(reinterpret_cast<const BYTE*>(&header), reinterpret_cast<const BYTE*>(&header) + sizeof(header));
+    WriteArray(blob, Meshlets);
+    WriteArray(blob, Bounds);
+    WriteArray(blob, VertexIndices);
+    WriteArray(blob, PrimitiveIndices);
+    return blob;
+}
+
+bool MeshletData::Deserialize(const BYTE* data, size_t size)
+{
+    Clear();
+
+    MeshletBlobHeader header;
+    if (size < sizeof(header))
+        return false;
+    memcpy(&header, data, sizeof(header));
+
+    UINT64 expectedSize = sizeof(header) + (UINT64)header.MeshletCount * (sizeof(Meshlet) + sizeof(MeshletBounds)) +
+        (UINT64)header.VertexIndexCount * sizeof(UINT) + (UINT64)header.PrimitiveCount * sizeof(UINT);
+    if (header.Magic != MeshletMagic || header.Version != MeshletVersion || expectedSize != size)
+        return false;
+
+    data += sizeof(header);
+    data = ReadArray(data, Meshlets, header.MeshletCount);
+    data = ReadArray(data, Bounds, header.MeshletCount);
+    data = ReadArray(data, VertexIndices, header.VertexIndexCount);
+    ReadArray(data, PrimitiveIndices, header.PrimitiveCount);
+
+    for (const Meshlet& meshlet : Meshlets)
+    {
+        bool inside = meshlet.VertexOffset <= VertexIndices.size() && meshlet.VertexCount <= VertexIndices.size() - meshlet.VertexOffset &&
+            meshlet.PrimitiveOffset <= PrimitiveIndices.size() && meshlet.PrimitiveCount <= PrimitiveIndices.size() - meshlet.PrimitiveOffset;
+        for (UINT p = 0; inside && p < meshlet.PrimitiveCount; p++)
+        {
+            UINT i0, i1, i2;
+            UnpackPrimitive(PrimitiveIndices[meshlet.PrimitiveOffset + p], i0, i1, i2);
+            inside = i0 < meshlet.VertexCount && i1 < meshlet.VertexCount && i2 < meshlet.VertexCount;
+        }
+        if (!inside)
+        {
+            Clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+MeshletData MeshletBuilder::Build(const UINT* indices, size_t indexCount, const XMFLOAT3* positions, UINT positionStride, UINT vertexCount)
+{
+    MeshletData data;
+    UINT triangleCount = (UINT)(indexCount / 3);
+
+    // Triangles of every vertex and unit triangle normals, zero for degenerate triangles.
+    std::vector<UINT> triangleOffsets(vertexCount + 1, 0);
+    for (size_t i = 0; i < (size_t)triangleCount * 3; i++)
+        triangleOffsets[indices[i] + 1]++;
+    for (UINT v = 0; v < vertexCount; v++)
+        triangleOffsets[v + 1] += triangleOffsets[v];
+
+    std::vector<UINT> vertexTriangles((size_t)triangleCount * 3);
+    std::vector<UINT> filled(vertexCount, 0);
+    std::vector<XMFLOAT3> normals(triangleCount);
+    for (UINT t = 0; t < triangleCount; t++)
+    {
+        for (UINT k = 0; k < 3; k++)
+        {
+            UINT v = indices[t * 3 + k];
+            vertexTriangles[triangleOffsets[v] + filled[v]++] = t;
+        }
+
+        XMVECTOR p0 = XMLoadFloat3(&GetPosition(positions, positionStride, indices[t * 3 + 0]));
+        XMVECTOR p1 = XMLoadFloat3(&GetPosition(positions, positionStride, indices[t * 3 + 1]));
+        XMVECTOR p2 = XMLoadFloat3(&GetPosition(positions, positionStride, indices[t * 3 + 2]));
+        XMVECTOR normal = XMVector3Cross(p1 - p0, p2 - p0);
+        float length = XMVectorGetX(XMVector3Length(normal));
+        XMStoreFloat3(&normals[t], length > 0.0f ? normal / length : XMVectorZero());
+    }
+
+    // Local index of vertex is valid while vertexMeshlets says it belongs to current meshlet.
+    std::vector<UINT> vertexMeshlets(vertexCount, UINT_MAX);
+    std::vector<BYTE> localIndices(vertexCount);
+    std::vector<char> emitted(triangleCount, 0);
+    Meshlet meshlet;
+    XMVECTOR meshletNormal = XMVectorZero();
+    UINT nextTriangle = 0;
+    for (UINT emittedCount = 0; emittedCount < triangleCount; emittedCount++)
+    {
+        UINT meshletIndex = (UINT)data.Meshlets.size();
+        auto countNewVertices = [&](UINT t)
+        {
+            const UINT* triangle = indices + (size_t)t * 3;
+            UINT newVertices = 0;
+            for (UINT k = 0; k < 3; k++)
+            {
+                bool repeated = (k > 0 && triangle[k] == triangle[0]) || (k > 1 && triangle[k] == triangle[1]);
+                newVertices += vertexMeshlets[triangle[k]] != meshletIndex && !repeated ? 1 : 0;
+            }
+            return newVertices;
+        };
+
+        // Grow meshlet by triangle around its vertices which adds least vertices, then which bends its normals least.
+        UINT best = UINT_MAX;
+        UINT bestNewVertices = 4;
+        float bestDeviation = FLT_MAX;
+        if (meshlet.PrimitiveCount < MaxPrimitives)
+        {
+            XMVECTOR axis = XMVector3Normalize(meshletNormal);
+            for (UINT i = 0; i < meshlet.VertexCount; i++)
+            {
+                UINT v = data.VertexIndices[meshlet.VertexOffset + i];
+                for (UINT j = triangleOffsets[v]; j < triangleOffsets[v + 1]; j++)
+                {
+                    UINT t = vertexTriangles[j];
+                    if (emitted[t])
+                        continue;
+                    UINT newVertices = countNewVertices(t);
+                    if (meshlet.VertexCount + newVertices > MaxVertices || newVertices > bestNewVertices)
+                        continue;
+
+                    float deviation = 1.0f - XMVectorGetX(XMVector3Dot(axis, XMLoadFloat3(&normals[t])));
+                    if (newVertices < bestNewVertices || deviation < bestDeviation)
+                    {
+                        best = t;
+                        bestNewVertices = newVertices;
+                        bestDeviation = deviation;
+                    }
+                }
+            }
+        }
+
+        // No adjacent triangle fits, continue with next free triangle in input order, in new meshlet if it's full.
+        if (best == UINT_MAX)
+        {
+            while (emitted[nextTriangle])
+                nextTriangle++;
+            best = nextTriangle;
+
+            if (meshlet.PrimitiveCount == MaxPrimitives || meshlet.VertexCount + countNewVertices(best) > MaxVertices)
+            {
+                data.Meshlets.push_back(meshlet);
+                meshletIndex++;
+                meshlet.VertexOffset = (UINT)data.VertexIndices.size();
+                meshlet.VertexCount = 0;
+                meshlet.PrimitiveOffset = (UINT)data.PrimitiveIndices.size();
+                meshlet.PrimitiveCount = 0;
+                meshletNormal = XMVectorZero();
+            }
+        }
+
+        const UINT* triangle = indices + (size_t)best * 3;
+        for (UINT k = 0; k < 3; k++)
+        {
+            UINT v = triangle[k];
+            if (vertexMeshlets[v] != meshletIndex)
+            {
+                vertexMeshlets[v] = meshletIndex;
+                localIndices[v] = (BYTE)meshlet.VertexCount++;
+                data.VertexIndices.push_back(v);
+            }
+        }
+        data.PrimitiveIndices.push_back(MeshletData::PackPrimitive(localIndices[triangle[0]], localIndices[triangle[1]], localIndices[triangle[2]]));
+        meshlet.PrimitiveCount++;
+        meshletNormal += XMLoadFloat3(&normals[best]);
+        emitted[best] = 1;
+    }
+    if (meshlet.PrimitiveCount > 0)
+        data.Meshlets.push_back(meshlet);
+
+    data.Bounds.reserve(data.Meshlets.size());
+    for (const Meshlet& m : data.Meshlets)
+        data.Bounds.push_back(ComputeBounds(data, m, positions, positionStride));
+    return data;
+}
+
+MeshletData MeshletBuilder::Build(const GeometryGenerator::MeshData& meshData)
+{
+    const XMFLOAT3* positions = meshData.Vertices.empty() ? nullptr : &meshData.Vertices[0].Position;
+    return Build(meshData.Indices32.data(), meshData.Indices32.size(), positions, sizeof(GeometryGenerator::Vertex), (UINT)meshData.Vertices.size());
+}
+
+MeshletData MeshletBuilder::Build(const MeshAsset& mesh)
+{
+    const XMFLOAT3* positions = mesh.VertexCount == 0 ? nullptr : &mesh.GetPosition(0);
+    return Build(mesh.Indices.data(), mesh.Indices.size(), positions, mesh.VertexStride, mesh.VertexCount);
+}
+
+bool MeshletBuilder::IsVisible(const MeshletBounds& bounds, const BoundingFrustum& frustum, const XMFLOAT3& cameraPosition)
+{
+    BoundingSphere sphere(bounds.Center, bounds.Radius);
+    return frustum.Contains(sphere) != DISJOINT && !IsBackfacing(bounds, cameraPosition);
+}
+
+bool MeshletBuilder::IsBackfacing(const MeshletBounds& bounds, const XMFLOAT3& cameraPosition)
+{
+    XMVECTOR view = XMVector3Normalize(XMLoadFloat3(&bounds.ConeApex) - XMLoadFloat3(&cameraPosition));
+    return XMVectorGetX(XMVector3Dot(view, XMLoadFloat3(&bounds.ConeAxis))) >= bounds.ConeCutoff;
+}
+
+MeshletBounds MeshletBuilder::ComputeBounds(const MeshletData& data, const Meshlet& meshlet, const XMFLOAT3* positions, UINT positionStride)
+{
+    MeshletBounds bounds;
+
+    XMFLOAT3 points[MaxVertices];
+    for (UINT i = 0; i < meshlet.VertexCount; i++)
+        points[i] = GetPosition(positions, positionStride, data.VertexIndices[meshlet.VertexOffset + i]);
+    BoundingSphere sphere;
+    BoundingSphere::CreateFromPoints(sphere, meshlet.VertexCount, points, sizeof(XMFLOAT3));
+    bounds.Center = sphere.Center;
+    bounds.Radius = sphere.Radius;
+
+    // Front faces are clockwise, so cross(p1 - p0, p2 - p0) points to viewer.
+    XMVECTOR normals[MaxPrimitives];
+    XMVECTOR corners[MaxPrimitives];
+    UINT normalCount = 0;
+    XMVECTOR axis = XMVectorZero();
+    for (UINT i = 0; i < meshlet.PrimitiveCount; i++)
+    {
+        UINT i0, i1, i2;
+        MeshletData::UnpackPrimitive(data.PrimitiveIndices[meshlet.PrimitiveOffset + i], i0, i1, i2);
+        XMVECTOR p0 = XMLoadFloat3(&points[i0]);
+        XMVECTOR normal = XMVector3Cross(XMLoadFloat3(&points[i1]) - p0, XMLoadFloat3(&points[i2]) - p0);
+        float length = XMVectorGetX(XMVector3Length(normal));
+        if (length <= 0.0f)
+            continue;
+
+        normals[normalCount] = normal / length;
+        corners[normalCount] = p0;
+        axis += normals[normalCount];
+        normalCount++;
+    }
+
+    float axisLength = XMVectorGetX(XMVector3Length(axis));
+    if (normalCount == 0 || axisLength <= 0.0f)
+        return bounds;
+    axis /= axisLength;
+
+    float minDot = 1.0f;
+    for (UINT i = 0; i < normalCount; i++)
+        minDot = MathHelper::Min(minDot, XMVectorGetX(XMVector3Dot(axis, normals[i])));
+    if (minDot <= MinConeDot)
+        return bounds;
+
+    // Apex on axis behind all triangle planes: then camera sees every triangle from behind if it looks at apex from
+    // inside of the cone mirrored by 90 degrees, whose half angle sine is cosine of normals spread.
+    XMVECTOR center = XMLoadFloat3(&bounds.Center);
+    float apexOffset = FLT_MAX;
+    for (UINT i = 0; i < normalCount; i++)
+    {
+        float offset = XMVectorGetX(XMVector3Dot(corners[i] - center, normals[i])) / XMVectorGetX(XMVector3Dot(axis, normals[i]));
+        apexOffset = MathHelper::Min(apexOffset, offset);
+    }
+
+    XMStoreFloat3(&bounds.ConeApex, center + axis * apexOffset);
+    XMStoreFloat3(&bounds.ConeAxis, axis);
+    bounds.ConeCutoff = sqrtf(1.0f - minDot * minDot);
+    return bounds;
+}
+}
@@ -0,0 +1,89 @@
+//
+// Clustering of triangles into meshlets for cluster culling.
+//
+
+#pragma once
+
+#include "D3DUtil.h"
+#include "GeometryGenerator.h"
+#include "MeshAsset.h"
+
+namespace DX12Samples
+{
+// Range of meshlet vertices in MeshletData::VertexIndices and triangles in MeshletData::PrimitiveIndices.
+struct Meshlet
+{
+    UINT VertexOffset = 0;
+    UINT VertexCount = 0;
+    UINT PrimitiveOffset = 0;
+    UINT PrimitiveCount = 0;
+};
+
+// Meshlet is backfacing for every camera position which sees cone apex inside of the cone:
+// dot(normalize(ConeApex - camera), ConeAxis) >= ConeCutoff. Meshlets without usable cone have ConeCutoff 1 and zero
+// axis, so that test never passes.
+struct MeshletBounds
+{
+    DirectX::XMFLOAT3 Center = { 0.0f, 0.0f, 0.0f };
+    float Radius = 0.0f;
+    DirectX::XMFLOAT3 ConeApex = { 0.0f, 0.0f, 0.0f };
+    float ConeCutoff = 1.0f;
+    DirectX::XMFLOAT3 ConeAxis = { 0.0f, 0.0f, 0.0f };
+};
+
+// Flat arrays which can be uploaded to structured buffers as is. Primitive is three local vertex indices packed in
+// 10 bit fields, local index points to VertexIndices[VertexOffset + index] which is index of mesh vertex.
+struct MeshletData
+{
+    std::vector<Meshlet> Meshlets;
+    std::vector<MeshletBounds> Bounds;
+    std::vector<UINT> VertexIndices;
+    std::vector<UINT> PrimitiveIndices;
+
+    static UINT PackPrimitive(UINT i0, UINT i1, UINT i2);
+    static void UnpackPrimitive(UINT primitive, UINT& i0, UINT& i1, UINT& i2);
+
+    /**
+     * \brief Mesh vertex indices of every primitive in primitive order, so that triangle i of index buffer built from them
+     * is PrimitiveIndices[i] and meshlet triangles are contiguous range of it.
+     */
+    std::vector<UINT> GetTriangleIndices() const;
+    void Clear();
+
+    /**
+     * \brief Write all arrays to single blob with header.
+     */
+    std::vector<BYTE> Serialize() const;
+    /**
+     * \brief Read blob written by Serialize. Returns false if it's malformed, i.e. has ranges outside of arrays or local
+     * indices outside of their meshlet, data is left empty then.
+     */
+    bool Deserialize(const BYTE* data, size_t size);
+};
+
+class MeshletBuilder
+{
+public:
+    static const UINT MaxVertices = 64;
+    static const UINT MaxPrimitives = 124;
+
+    /**
+     * \brief Grow meshlets over adjacent triangles which add fewest vertices and have closest normals, so that meshlets
+     * are compact and have narrow cones. Meshlet continues from next free triangle in input order
+     * when its neighbours don't fit. Triangles keep winding.
+     * \param positionStride distance between positions in bytes, e.g. sizeof of vertex struct.
+     */
+    static MeshletData Build(const UINT* indices, size_t indexCount, const DirectX::XMFLOAT3* positions, UINT positionStride, UINT vertexCount);
+    static MeshletData Build(const GeometryGenerator::MeshData& meshData);
+    static MeshletData Build(const MeshAsset& mesh);
+
+    /**
+     * \brief Test meshlet against frustum and its normal cone against camera, both in mesh space.
+     */
+    static bool IsVisible(const MeshletBounds& bounds, const DirectX::BoundingFrustum& frustum, const DirectX::XMFLOAT3& cameraPosition);
+    static bool IsBackfacing(const MeshletBounds& bounds, const DirectX::XMFLOAT3& cameraPosition);
+
+private:
+    static MeshletBounds ComputeBounds(const MeshletData& data, const Meshlet& meshlet, const DirectX::XMFLOAT3* positions, UINT positionStride);
+};
+}
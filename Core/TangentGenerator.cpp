@@ -0,0 +1,195 @@
+#include "TangentGenerator.h"
+
+#include "JobSystem.h"
+
+namespace DX12Samples
+{
+using namespace DirectX;
+
+namespace
+{
+const UINT TriangleGrainSize = 1024;
+const UINT VertexGrainSize = 1024;
+
+template<typename T>
+const T& GetAttribute(const T* data, UINT stride, UINT index)
+{
+    return *reinterpret_cast<const T*>(reinterpret_cast<const BYTE*>(data) + (size_t)index * stride);
+}
+
+// Unit vector or zero if v is too short to have direction.
+XMVECTOR SafeNormalize(FXMVECTOR v)
+{
+    XMVECTOR lengthSq = XMVector3LengthSq(v);
+    if (!(XMVectorGetX(lengthSq) > 1e-30f))
+        return XMVectorZero();
+    return v / XMVectorSqrt(lengthSq);
+}
+
+float CornerAngle(FXMVECTOR corner, FXMVECTOR a, FXMVECTOR b)
+{
+    XMVECTOR e0 = SafeNormalize(a - corner);
+    XMVECTOR e1 = SafeNormalize(b - corner);
+    if (XMVector3Equal(e0, XMVectorZero()) || XMVector3Equal(e1, XMVectorZero()))
+        return 0.0f;
+    return acosf(MathHelper::Clamp(XMVectorGetX(XMVector3Dot(e0, e1)), -1.0f, 1.0f));
+}
+
+// Any unit vector orthogonal to n.
+XMVECTOR Perpendicular(FXMVECTOR n)
+{
+    XMVECTOR up = XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+    if (fabsf(XMVectorGetX(XMVector3Dot(n, up))) > 1.0f - 0.001f)
+        up = XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f);
+    return XMVector3Normalize(XMVector3Cross(up, n));
+}
+}
+
+TangentGenerator::TangentGenerator(JobSystem& jobs) : _jobs(&jobs)
+{
+}
+
+void TangentGenerator::Generate(const UINT* indices, size_t indexCount, UINT vertexCount,
+    const XMFLOAT3* positions, UINT positionStride,
+    const XMFLOAT3* normals, UINT normalStride,
+    const XMFLOAT2* texCoords, UINT texCoordStride,
+    XMFLOAT4* tangents) const
+{
+    UINT triangleCount = (UINT)(indexCount / 3);
+
+    //
+    // Vertex to triangle corner table, corners of each vertex are in triangle order.
+    //
+
+    std::vector<UINT> cornerOffsets(vertexCount + 1, 0);
+    for (size_t i = 0; i < triangleCount * 3; i++)
+        cornerOffsets[indices[i] + 1]++;
+    for (UINT v = 0; v < vertexCount; v++)
+        cornerOffsets[v + 1] += cornerOffsets[v];
+
+    std::vector<UINT> corners(triangleCount * 3);
+    {
+        std::vector<UINT> cursor(cornerOffsets.begin(), cornerOffsets.end() - 1);
+        for (UINT i = 0; i < triangleCount * 3; i++)
+            corners[cursor[indices[i]]++] = i;
+    }
+
+    //
+    // Directions of growing u and v on each triangle.
+    //
+
+    std::vector<TriangleFrame> frames(triangleCount);
+    ForEach(triangleCount, TriangleGrainSize, [&](UINT begin, UINT end)
+    {
+        for (UINT t = begin; t < end; t++)
+        {
+            UINT i0 = indices[t * 3 + 0];
+            UINT i1 = indices[t * 3 + 1];
+            UINT i2 = indices[t * 3 + 2];
+
+            XMVECTOR p0 = XMLoadFloat3(&GetAttribute(positions, positionStride, i0));
+            XMVECTOR p1 = XMLoadFloat3(&GetAttribute(positions, positionStride, i1));
+            XMVECTOR p2 = XMLoadFloat3(&GetAttribute(positions, positionStride, i2));
+            const XMFLOAT2& uv0 = GetAttribute(texCoords, texCoordStride, i0);
+            const XMFLOAT2& uv1 = GetAttribute(texCoords, texCoordStride, i1);
+            const XMFLOAT2& uv2 = GetAttribute(texCoords, texCoordStride, i2);
+
+            XMVECTOR e1 = p1 - p0;
+            XMVECTOR e2 = p2 - p0;
+            float du1 = uv1.x - uv0.x, dv1 = uv1.y - uv0.y;
+            float du2 = uv2.x - uv0.x, dv2 = uv2.y - uv0.y;
+
+            // dP/du and dP/dv, scale is irrelevant as directions are averaged with angle weights. Triangles with
+            // degenerate uvs get zero directions and are skipped by gather.
+            float det = du1 * dv2 - du2 * dv1;
+            float sign = det < 0.0f ? -1.0f : 1.0f;
+            XMVECTOR tangent = det != 0.0f ? SafeNormalize(sign * (e1 * dv2 - e2 * dv1)) : XMVectorZero();
+            XMVECTOR bitangent = det != 0.0f ? SafeNormalize(sign * (e2 * du1 - e1 * du2)) : XMVectorZero();
+
+            TriangleFrame& frame = frames[t];
+            XMStoreFloat3(&frame.Tangent, tangent);
+            XMStoreFloat3(&frame.Bitangent, bitangent);
+            frame.Angles[0] = CornerAngle(p0, p1, p2);
+            frame.Angles[1] = CornerAngle(p1, p2, p0);
+            frame.Angles[2] = CornerAngle(p2, p0, p1);
+        }
+    });
+
+    //
+    // Gather triangles of each vertex.
+    //
+
+    ForEach(vertexCount, VertexGrainSize, [&](UINT begin, UINT end)
+    {
+        for (UINT v = begin; v < end; v++)
+        {
+            XMVECTOR n = XMVector3Normalize(XMLoadFloat3(&GetAttribute(normals, normalStride, v)));
+            UINT first = cornerOffsets[v];
+            UINT last = cornerOffsets[v + 1];
+
+            // Handedness of uv mapping which covers larger angle around vertex wins, triangles of other one are
+            // across seam.
+            float handedness = 0.0f;
+            for (UINT c = first; c < last; c++)
+            {
+                const TriangleFrame& frame = frames[corners[c] / 3];
+                XMVECTOR t = XMLoadFloat3(&frame.Tangent);
+                XMVECTOR b = XMLoadFloat3(&frame.Bitangent);
+                float side = XMVectorGetX(XMVector3Dot(XMVector3Cross(n, t), b));
+                if (side != 0.0f)
+                    handedness += side > 0.0f ? frame.Angles[corners[c] % 3] : -frame.Angles[corners[c] % 3];
+            }
+            float w = handedness < 0.0f ? -1.0f : 1.0f;
+
+            XMVECTOR sum = XMVectorZero();
+            for (UINT c = first; c < last; c++)
+            {
+                const TriangleFrame& frame = frames[corners[c] / 3];
+                XMVECTOR t = XMLoadFloat3(&frame.Tangent);
+                XMVECTOR b = XMLoadFloat3(&frame.Bitangent);
+                if (XMVectorGetX(XMVector3Dot(XMVector3Cross(n, t), b)) * w <= 0.0f)
+                    continue;
+
+                // Project on tangent plane of vertex before weighting so that every triangle adds direction of same length.
+                XMVECTOR projected = SafeNormalize(t - n * XMVector3Dot(n, t));
+                sum += projected * frame.Angles[corners[c] % 3];
+            }
+
+            XMVECTOR tangent = SafeNormalize(sum - n * XMVector3Dot(n, sum));
+            if (XMVector3Equal(tangent, XMVectorZero()))
+            {
+                tangent = Perpendicular(n);
+                w = 1.0f;
+            }
+
+            XMStoreFloat4(&tangents[v], XMVectorSetW(tangent, w));
+        }
+    });
+}
+
+void TangentGenerator::Generate(GeometryGenerator::MeshData& meshData) const
+{
+    std::vector<XMFLOAT4> tangents(meshData.Vertices.size());
+    const GeometryGenerator::Vertex* vertices = meshData.Vertices.data();
+    UINT stride = sizeof(GeometryGenerator::Vertex);
+    Generate(meshData.Indices32.data(), meshData.Indices32.size(), (UINT)meshData.Vertices.size(),
+        &vertices->Position, stride, &vertices->Normal, stride, &vertices->TexCoord, stride, tangents.data());
+
+    for (size_t i = 0; i < tangents.size(); i++)
+        meshData.Vertices[i].Tangent = XMFLOAT3(tangents[i].x, tangents[i].y, tangents[i].z);
+}
+
+void TangentGenerator::ForEach(UINT count, UINT grainSize, const std::function<void(UINT begin, UINT end)>& job) const
+{
+    if (_jobs == nullptr || count == 0)
+    {
+        job(0, count);
+        return;
+    }
+
+    _jobs->ParallelFor(count, grainSize, [&job](UINT begin, UINT end, UINT workerIndex)
+    {
+        job(begin, end);
+    });
+}
+}
@@ -0,0 +1,61 @@
+//
+// Tangent frames from texture coordinates of indexed triangle meshes.
+//
+
+#pragma once
+
+#include "D3DUtil.h"
+#include "GeometryGenerator.h"
+
+namespace DX12Samples
+{
+class JobSystem;
+
+// Tangent of every vertex is angle weighted average of directions in which u grows on adjacent triangles, made orthogonal
+// to vertex normal. Each vertex gathers from its own triangles through vertex to triangle table, so nothing is written
+// concurrently and result doesn't depend on number of workers.
+// Vertices are never split, seams must be split in index buffer already. Triangles mirrored in uv relative to most of
+// the vertex's triangles, e.g. across mirrored or wrapped uv seam which shares vertex, are left out of its average.
+class TangentGenerator
+{
+public:
+    TangentGenerator() = default;
+    /**
+     * \brief Generator which processes triangles and vertices in parallel on job system workers.
+     */
+    explicit TangentGenerator(JobSystem& jobs);
+
+    /**
+     * \brief Generate tangents of vertexCount vertices. Attributes are read with their own strides in bytes, so they
+     * can come from interleaved or separate arrays.
+     * \param tangents output, xyz is unit tangent orthogonal to normal, w is bitangent sign so that
+     * bitangent = w * cross(normal, tangent). Vertices without usable uvs get any tangent orthogonal to normal and w = 1.
+     */
+    void Generate(const UINT* indices, size_t indexCount, UINT vertexCount,
+        const DirectX::XMFLOAT3* positions, UINT positionStride,
+        const DirectX::XMFLOAT3* normals, UINT normalStride,
+        const DirectX::XMFLOAT2* texCoords, UINT texCoordStride,
+        DirectX::XMFLOAT4* tangents) const;
+    /**
+     * \brief Replace tangents of mesh. Vertex has no room for bitangent sign, so mirrored uvs need
+     * bitangent computed from other source.
+     */
+    void Generate(GeometryGenerator::MeshData& meshData) const;
+
+private:
+    // Per triangle data computed before gather.
+    struct TriangleFrame
+    {
+        DirectX::XMFLOAT3 Tangent;
+        DirectX::XMFLOAT3 Bitangent;
+        float Angles[3];
+    };
+
+    /**
+     * \brief Run job over [0, count), in chunks on job system workers if generator has it.
+     */
+    void ForEach(UINT count, UINT grainSize, const std::function<void(UINT begin, UINT end)>& job) const;
+
+    JobSystem* _jobs = nullptr;
+};
+}
@@ -0,0 +1,373 @@
+#include "TextParser.h"
+
+#include <cfloat>
+#include <climits>
+#include <cmath>
+
+#include "JobSystem.h"
+
+namespace DX12Samples
+{
+namespace
+{
+// Powers of ten exactly representable in double.
+const double PowersOf10[] =
+{
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+const int MaxExactPowerOf10 = 22;
+const UINT64 MaxExactMantissa = 1ull << 53;
+// Bytes of text per parallel chunk, large enough to amortize task overhead.
+const size_t RecordChunkSize = 256 * 1024;
+const size_t CountBlockSize = 256;
+
+bool IsSpace(char c)
+{
+    // '\t', '\n', '\v', '\f' and '\r' are consecutive.
+    return (c == ' ') | ((unsigned char)(c - '\t') <= '\r' - '\t');
+}
+
+bool IsDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+bool ParseFloatSlow(const char* begin, const char* end, float& value)
+{
+    std::string token(begin, end);
+    char* parsedEnd = nullptr;
+    value = strtof(token.c_str(), &parsedEnd);
+    return parsedEnd == token.c_str() + token.size() && !token.empty();
+}
+
+UINT64 CountTokens(const char* begin, const char* end)
+{
+    // Token starts at every non space character after space, text before begin is treated as space. Whole blocks are
+    // classified and then summed with fixed trip count loops, which compilers vectorize.
+    UINT64 count = 0;
+    BYTE spaces[CountBlockSize + 1];
+    spaces[0] = 1;
+    for (; end - begin >= (ptrdiff_t)CountBlockSize; begin += CountBlockSize)
+    {
+        for (size_t i = 0; i < CountBlockSize; i++)
+            spaces[i + 1] = IsSpace(begin[i]);
+
+        UINT blockCount = 0;
+        for (size_t i = 0; i < CountBlockSize; i++)
+            blockCount += spaces[i] & (spaces[i + 1] ^ 1);
+        count += blockCount;
+        spaces[0] = spaces[CountBlockSize];
+    }
+    for (; begin != end; begin++)
+    {
+        BYTE space = IsSpace(*begin);
+        count += spaces[0] & (space ^ 1);
+        spaces[0] = space;
+    }
+    return count;
+}
+}
+
+TextParser::TextParser(const char* text, size_t size) : _text(text), _size(size)
+{
+}
+
+bool TextParser::Open(const std::string& filename)
+{
+    std::ifstream fin(filename, std::ios::binary);
+    if (!fin)
+        return false;
+
+    fin.seekg(0, std::ios::end);
+    std::ifstream::pos_type size = fin.tellg();
+    fin.seekg(0, std::ios::beg);
+
+    _storage.resize((size_t)size);
+    fin.read(_storage.data(), size);
+    _text = _storage.data();
+    _size = _storage.size();
+    _position = 0;
+    _failed = false;
+    return true;
+}
+
+void TextParser::SetText(const char* text, size_t size)
+{
+    _storage.assign(text, text + size);
+    _text = _storage.data();
+    _size = _storage.size();
+    _position = 0;
+    _failed = false;
+}
+
+TextParser::operator bool() const
+{
+    return !_failed;
+}
+
+size_t TextParser::Size() const
+{
+    return _size;
+}
+
+TextParser& TextParser::Skip(UINT count)
+{
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    for (UINT i = 0; i < count; i++)
+        NextToken(begin, end);
+    return *this;
+}
+
+TextParser& TextParser::operator>>(float& value)
+{
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    if (NextToken(begin, end) && !ParseFloat(begin, end, value))
+    {
+        value = 0.0f;
+        _failed = true;
+    }
+    return *this;
+}
+
+TextParser& TextParser::operator>>(int& value)
+{
+    INT64 parsed = 0;
+    if (ParseInteger(parsed))
+        value = (int)parsed;
+    return *this;
+}
+
+TextParser& TextParser::operator>>(UINT& value)
+{
+    INT64 parsed = 0;
+    if (ParseInteger(parsed))
+        value = (UINT)parsed;
+    return *this;
+}
+
+TextParser& TextParser::operator>>(USHORT& value)
+{
+    INT64 parsed = 0;
+    if (ParseInteger(parsed))
+        value = (USHORT)parsed;
+    return *this;
+}
+
+TextParser& TextParser::operator>>(bool& value)
+{
+    INT64 parsed = 0;
+    if (ParseInteger(parsed))
+    {
+        if (parsed == 0 || parsed == 1)
+            value = parsed == 1;
+        else
+            _failed = true;
+    }
+    return *this;
+}
+
+TextParser& TextParser::operator>>(std::string& value)
+{
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    if (NextToken(begin, end))
+        value.assign(begin, end);
+    return *this;
+}
+
+bool TextParser::ParseRecords(UINT recordCount, UINT recordTokens, char terminator, JobSystem& jobs, const ChunkParser& parseChunk)
+{
+    if (_failed || recordCount == 0)
+        return !_failed;
+
+    const char* sectionBegin = _text + _position;
+    const char* sectionEnd = static_cast<const char*>(memchr(sectionBegin, terminator, _size - _position));
+    if (sectionEnd == nullptr)
+        sectionEnd = _text + _size;
+
+    // Chunks start right after line break, so no token is split between them.
+    size_t sectionSize = sectionEnd - sectionBegin;
+    UINT chunkCount = (UINT)MathHelper::Max<size_t>(sectionSize / RecordChunkSize, 1);
+    std::vector<const char*> chunkBegins(chunkCount + 1, sectionEnd);
+    chunkBegins[0] = sectionBegin;
+    for (UINT i = 1; i < chunkCount; i++)
+    {
+        const char* split = sectionBegin + sectionSize * i / chunkCount;
+        split = MathHelper::Max(split, chunkBegins[i - 1]);
+        const char* lineEnd = static_cast<const char*>(memchr(split, '\n', sectionEnd - split));
+        chunkBegins[i] = lineEnd != nullptr ? lineEnd + 1 : sectionEnd;
+    }
+
+    std::vector<UINT64> firstTokens(chunkCount + 1, 0);
+    jobs.ParallelFor(chunkCount, 1, [&](UINT begin, UINT end, UINT workerIndex)
+    {
+        for (UINT i = begin; i < end; i++)
+            firstTokens[i + 1] = CountTokens(chunkBegins[i], chunkBegins[i + 1]);
+    });
+    for (UINT i = 0; i < chunkCount; i++)
+        firstTokens[i + 1] += firstTokens[i];
+
+    UINT64 tokenCount = (UINT64)recordCount * recordTokens;
+    if (firstTokens[chunkCount] < tokenCount)
+    {
+        _failed = true;
+        return false;
+    }
+
+    // Chunk parses records which start in it, last of them may continue in next chunks.
+    std::vector<size_t> chunkEnds(chunkCount, 0);
+    std::vector<char> chunkFailed(chunkCount, 0);
+    jobs.ParallelFor(chunkCount, 1, [&](UINT begin, UINT end, UINT workerIndex)
+    {
+        for (UINT i = begin; i < end; i++)
+        {
+            UINT64 firstRecord = (firstTokens[i] + recordTokens - 1) / recordTokens;
+            UINT64 endRecord = MathHelper::Min<UINT64>((firstTokens[i + 1] + recordTokens - 1) / recordTokens, recordCount);
+            if (firstRecord >= endRecord)
+                continue;
+
+            TextParser chunk(chunkBegins[i], _size - (chunkBegins[i] - _text));
+            chunk.Skip((UINT)(firstRecord * recordTokens - firstTokens[i]));
+            parseChunk(chunk, (UINT)firstRecord, (UINT)(endRecord - firstRecord));
+            chunkEnds[i] = (chunkBegins[i] - _text) + chunk._position;
+            chunkFailed[i] = chunk._failed;
+        }
+    });
+
+    for (UINT i = 0; i < chunkCount; i++)
+    {
+        _failed = _failed || chunkFailed[i] != 0;
+        _position = MathHelper::Max(_position, chunkEnds[i]);
+    }
+    return !_failed;
+}
+
+bool TextParser::ParseFloat(const char* begin, const char* end, float& value)
+{
+    const char* p = begin;
+    bool negative = false;
+    if (p != end && (*p == '-' || *p == '+'))
+    {
+        negative = *p == '-';
+        p++;
+    }
+
+    // Decimal mantissa and exponent, fast path needs both to be exact in double.
+    UINT64 mantissa = 0;
+    int exponent = 0;
+    int significantDigits = 0;
+    bool anyDigits = false;
+    for (; p != end && IsDigit(*p); p++)
+    {
+        anyDigits = true;
+        if (mantissa != 0 || *p != '0')
+            significantDigits++;
+        if (significantDigits <= 19)
+            mantissa = mantissa * 10 + (*p - '0');
+    }
+    if (p != end && *p == '.')
+    {
+        for (p++; p != end && IsDigit(*p); p++)
+        {
+            anyDigits = true;
+            if (mantissa != 0 || *p != '0')
+                significantDigits++;
+            if (significantDigits <= 19)
+            {
+                mantissa = mantissa * 10 + (*p - '0');
+                exponent--;
+            }
+        }
+    }
+    if (anyDigits && p != end && (*p == 'e' || *p == 'E'))
+    {
+        p++;
+        bool negativeExponent = false;
+        if (p != end && (*p == '-' || *p == '+'))
+        {
+            negativeExponent = *p == '-';
+            p++;
+        }
+        if (p == end || !IsDigit(*p))
+            return ParseFloatSlow(begin, end, value);
+
+        int exponentValue = 0;
+        for (; p != end && IsDigit(*p); p++)
+            exponentValue = MathHelper::Min(exponentValue * 10 + (*p - '0'), 100000);
+        exponent += negativeExponent ? -exponentValue : exponentValue;
+    }
+
+    if (!anyDigits || p != end || significantDigits > 19 || mantissa > MaxExactMantissa ||
+        exponent < -MaxExactPowerOf10 || exponent > MaxExactPowerOf10)
+    {
+        return ParseFloatSlow(begin, end, value);
+    }
+
+    // Single correctly rounded double operation on exact operands. Rounding it to float again gives correctly rounded
+    // float unless double result lands exactly in the middle between two floats, that rare case goes to strtof.
+    double result = (double)mantissa;
+    result = exponent < 0 ? result / PowersOf10[-exponent] : result * PowersOf10[exponent];
+    float rounded = (float)result;
+    if ((double)rounded != result)
+    {
+        float neighbour = nextafterf(rounded, result > rounded ? FLT_MAX : -FLT_MAX);
+        if (((double)rounded + (double)neighbour) * 0.5 == result)
+            return ParseFloatSlow(begin, end, value);
+    }
+    value = negative ? -rounded : rounded;
+    return true;
+}
+
+bool TextParser::NextToken(const char*& begin, const char*& end)
+{
+    if (_failed)
+        return false;
+
+    const char* text = _text;
+    size_t size = _size;
+    while (_position < size && IsSpace(text[_position]))
+        _position++;
+    if (_position == size)
+    {
+        _failed = true;
+        return false;
+    }
+
+    begin = text + _position;
+    while (_position < size && !IsSpace(text[_position]))
+        _position++;
+    end = text + _position;
+    return true;
+}
+
+bool TextParser::ParseInteger(INT64& value)
+{
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    if (!NextToken(begin, end))
+        return false;
+
+    const char* p = begin;
+    bool negative = false;
+    if (*p == '-' || *p == '+')
+    {
+        negative = *p == '-';
+        p++;
+    }
+
+    INT64 magnitude = 0;
+    const char* digitsBegin = p;
+    for (; p != end && IsDigit(*p) && magnitude <= UINT_MAX; p++)
+        magnitude = magnitude * 10 + (*p - '0');
+    if (p == digitsBegin || p != end || magnitude > UINT_MAX)
+    {
+        _failed = true;
+        return false;
+    }
+    value = negative ? -magnitude : magnitude;
+    return true;
+}
+}
@@ -0,0 +1,93 @@
+//
+// Whitespace separated token reader for text model files.
+//
+
+#pragma once
+
+#include <functional>
+
+#include "D3DUtil.h"
+
+namespace DX12Samples
+{
+class JobSystem;
+
+// Reads whole file to memory and parses tokens in place, labels are skipped without allocations. Numbers are parsed
+// to the same values as std::ifstream gives: floats are correctly rounded, common short decimals take a fast path
+// and everything else goes through strtof.
+class TextParser
+{
+public:
+    /**
+     * \brief Parses recordCount consecutive records starting from firstRecord, chunk parser is positioned at first of them.
+     */
+    using ChunkParser = std::function<void(TextParser& chunk, UINT firstRecord, UINT recordCount)>;
+
+    TextParser() = default;
+    TextParser(const TextParser& rhs) = delete;
+    TextParser& operator=(const TextParser& rhs) = delete;
+
+    /**
+     * \brief Read whole file. Returns false if file can't be opened.
+     */
+    bool Open(const std::string& filename);
+    /**
+     * \brief Parse text from memory, data is copied.
+     */
+    void SetText(const char* text, size_t size);
+    /**
+     * \brief False after any read failed, like stream fail bit.
+     */
+    explicit operator bool() const;
+    /**
+     * \brief Size of text in bytes.
+     */
+    size_t Size() const;
+
+    /**
+     * \brief Skip count tokens, e.g. labels. Returns parser so that value after label can be read in same expression.
+     */
+    TextParser& Skip(UINT count = 1);
+
+    TextParser& operator>>(float& value);
+    TextParser& operator>>(int& value);
+    TextParser& operator>>(UINT& value);
+    TextParser& operator>>(USHORT& value);
+    TextParser& operator>>(bool& value);
+    TextParser& operator>>(std::string& value);
+
+    /**
+     * \brief Parse recordCount records of recordTokens tokens each, e.g. vertices, on job system workers. Text up to next
+     * terminator character is split into chunks at line boundaries, chunks count their tokens, start at first record
+     * beginning in them and are parsed in parallel. Parser continues after last record. Returns false if there are
+     * less tokens than records need or any chunk failed.
+     */
+    bool ParseRecords(UINT recordCount, UINT recordTokens, char terminator, JobSystem& jobs, const ChunkParser& parseChunk);
+
+    /**
+     * \brief Parse float from [begin, end). Returns false if text isn't a number.
+     */
+    static bool ParseFloat(const char* begin, const char* end, float& value);
+
+private:
+    /**
+     * \brief Parser over text owned by someone else, used for chunks.
+     */
+    TextParser(const char* text, size_t size);
+
+    /**
+     * \brief Find next token, sets fail state if there is none.
+     */
+    bool NextToken(const char*& begin, const char*& end);
+    /**
+     * \brief Parse integer with optional sign, unsigned types wrap negative values like stream does.
+     */
+    bool ParseInteger(INT64& value);
+
+    std::vector<char> _storage;
+    const char* _text = nullptr;
+    size_t _size = 0;
+    size_t _position = 0;
+    bool _failed = false;
+};
+}
@@ -0,0 +1,212 @@
+#include "VertexPacker.h"
+
+#include <cfloat>
+
+namespace DX12Samples
+{
+using namespace DirectX;
+using namespace PackedVector;
+
+namespace
+{
+const float Unorm16Max = 65535.0f;
+const float Snorm16Max = 32767.0f;
+
+uint16_t EncodeUnorm16(float value)
+{
+    return static_cast<uint16_t>(MathHelper::Clamp(value, 0.0f, 1.0f) * Unorm16Max + 0.5f);
+}
+
+float DecodeUnorm16(uint16_t value)
+{
+    return value / Unorm16Max;
+}
+
+int16_t EncodeSnorm16(float value)
+{
+    float scaled = MathHelper::Clamp(value, -1.0f, 1.0f) * Snorm16Max;
+    return static_cast<int16_t>(scaled >= 0.0f ? scaled + 0.5f : scaled - 0.5f);
+}
+
+float DecodeSnorm16(int16_t value)
+{
+    return (std::max)(value / Snorm16Max, -1.0f);
+}
+
+float SignNotZero(float value)
+{
+    return value >= 0.0f ? 1.0f : -1.0f;
+}
+
+// Value relative to origin in units of extent or 0 if extent is empty.
+float Normalize(float value, float origin, float extent)
+{
+    return extent > 0.0f ? (value - origin) / extent : 0.0f;
+}
+}
+
+UINT PackedMesh::VertexBufferByteSize() const
+{
+    return (UINT)(Vertices.size() * sizeof(PackedVertex));
+}
+
+std::vector<D3D12_INPUT_ELEMENT_DESC> PackedMesh::GetInputLayout() const
+{
+    return VertexPacker::GetInputLayout(Encoding);
+}
+
+PackedMesh VertexPacker::Pack(const GeometryGenerator::MeshData& meshData, PositionEncoding encoding)
+{
+    const auto& vertices = meshData.Vertices;
+    return Pack(vertices.size(), [&vertices](size_t i)
+    {
+        const GeometryGenerator::Vertex& v = vertices[i];
+        return SourceVertex{ &v.Position, &v.Normal, &v.Tangent, &v.TexCoord, 1.0f };
+    }, encoding);
+}
+
+PackedMesh VertexPacker::Pack(const std::vector<M3dLoader::Vertex>& vertices, PositionEncoding encoding)
+{
+    return Pack(vertices.size(), [&vertices](size_t i)
+    {
+        const M3dLoader::Vertex& v = vertices[i];
+        return SourceVertex{ &v.Pos, &v.Normal, reinterpret_cast<const XMFLOAT3*>(&v.TangentU), &v.Uv, SignNotZero(v.TangentU.w) };
+    }, encoding);
+}
+
+template<typename GetVertex>
+PackedMesh VertexPacker::Pack(size_t vertexCount, GetVertex getVertex, PositionEncoding encoding)
+{
+    PackedMesh mesh;
+    mesh.Encoding = encoding;
+    mesh.Vertices.resize(vertexCount);
+    if (vertexCount == 0)
+        return mesh;
+
+    XMVECTOR positionMin = XMVectorReplicate(FLT_MAX);
+    XMVECTOR positionMax = XMVectorReplicate(-FLT_MAX);
+    XMFLOAT2 texCoordMin = { FLT_MAX, FLT_MAX };
+    XMFLOAT2 texCoordMax = { -FLT_MAX, -FLT_MAX };
+    for (size_t i = 0; i < vertexCount; i++)
+    {
+        SourceVertex v = getVertex(i);
+        XMVECTOR position = XMLoadFloat3(v.Position);
+        positionMin = XMVectorMin(positionMin, position);
+        positionMax = XMVectorMax(positionMax, position);
+        texCoordMin = { (std::min)(texCoordMin.x, v.TexCoord->x), (std::min)(texCoordMin.y, v.TexCoord->y) };
+        texCoordMax = { (std::max)(texCoordMax.x, v.TexCoord->x), (std::max)(texCoordMax.y, v.TexCoord->y) };
+    }
+
+    VertexQuantization& quantization = mesh.Quantization;
+    if (encoding == PositionEncoding::Unorm16)
+    {
+        XMStoreFloat3(&quantization.PositionOffset, positionMin);
+        XMStoreFloat3(&quantization.PositionScale, positionMax - positionMin);
+    }
+    else
+    {
+        // Half extent maps bounds to [-1, 1], where half floats keep 11 bits of mantissa for any mesh size.
+        XMStoreFloat3(&quantization.PositionOffset, 0.5f * (positionMin + positionMax));
+        XMStoreFloat3(&quantization.PositionScale, 0.5f * (positionMax - positionMin));
+    }
+    quantization.TexCoordOffset = texCoordMin;
+    quantization.TexCoordScale = { texCoordMax.x - texCoordMin.x, texCoordMax.y - texCoordMin.y };
+
+    const XMFLOAT3& offset = quantization.PositionOffset;
+    const XMFLOAT3& scale = quantization.PositionScale;
+    for (size_t i = 0; i < vertexCount; i++)
+    {
+        SourceVertex v = getVertex(i);
+        PackedVertex& packed = mesh.Vertices[i];
+        if (encoding == PositionEncoding::Unorm16)
+        {
+            packed.Position[0] = EncodeUnorm16(Normalize(v.Position->x, offset.x, scale.x));
+            packed.Position[1] = EncodeUnorm16(Normalize(v.Position->y, offset.y, scale.y));
+            packed.Position[2] = EncodeUnorm16(Normalize(v.Position->z, offset.z, scale.z));
+            packed.Position[3] = EncodeUnorm16(v.Sign > 0.0f ? 1.0f : 0.0f);
+        }
+        else
+        {
+            packed.Position[0] = XMConvertFloatToHalf(Normalize(v.Position->x, offset.x, scale.x));
+            packed.Position[1] = XMConvertFloatToHalf(Normalize(v.Position->y, offset.y, scale.y));
+            packed.Position[2] = XMConvertFloatToHalf(Normalize(v.Position->z, offset.z, scale.z));
+            packed.Position[3] = XMConvertFloatToHalf(v.Sign > 0.0f ? 1.0f : 0.0f);
+        }
+
+        XMFLOAT2 normal = EncodeOctahedral(*v.Normal);
+        packed.Normal[0] = EncodeSnorm16(normal.x);
+        packed.Normal[1] = EncodeSnorm16(normal.y);
+        XMFLOAT2 tangent = EncodeOctahedral(*v.Tangent);
+        packed.Tangent[0] = EncodeSnorm16(tangent.x);
+        packed.Tangent[1] = EncodeSnorm16(tangent.y);
+
+        packed.TexCoord[0] = EncodeUnorm16(Normalize(v.TexCoord->x, quantization.TexCoordOffset.x, quantization.TexCoordScale.x));
+        packed.TexCoord[1] = EncodeUnorm16(Normalize(v.TexCoord->y, quantization.TexCoordOffset.y, quantization.TexCoordScale.y));
+    }
+    return mesh;
+}
+
+UnpackedVertex VertexPacker::Unpack(const PackedVertex& vertex, const VertexQuantization& quantization, PositionEncoding encoding)
+{
+    XMFLOAT4 position;
+    if (encoding == PositionEncoding::Unorm16)
+    {
+        position = { DecodeUnorm16(vertex.Position[0]), DecodeUnorm16(vertex.Position[1]), DecodeUnorm16(vertex.Position[2]), DecodeUnorm16(vertex.Position[3]) };
+    }
+    else
+    {
+        position = { XMConvertHalfToFloat(vertex.Position[0]), XMConvertHalfToFloat(vertex.Position[1]), XMConvertHalfToFloat(vertex.Position[2]),
+            XMConvertHalfToFloat(vertex.Position[3]) };
+    }
+
+    const XMFLOAT3& offset = quantization.PositionOffset;
+    const XMFLOAT3& scale = quantization.PositionScale;
+    UnpackedVertex result;
+    result.Position = { offset.x + scale.x * position.x, offset.y + scale.y * position.y, offset.z + scale.z * position.z };
+    result.Normal = DecodeOctahedral({ DecodeSnorm16(vertex.Normal[0]), DecodeSnorm16(vertex.Normal[1]) });
+    XMFLOAT3 tangent = DecodeOctahedral({ DecodeSnorm16(vertex.Tangent[0]), DecodeSnorm16(vertex.Tangent[1]) });
+    result.Tangent = { tangent.x, tangent.y, tangent.z, position.w * 2.0f - 1.0f };
+    result.TexCoord = {
+        quantization.TexCoordOffset.x + quantization.TexCoordScale.x * DecodeUnorm16(vertex.TexCoord[0]),
+        quantization.TexCoordOffset.y + quantization.TexCoordScale.y * DecodeUnorm16(vertex.TexCoord[1])
+    };
+    return result;
+}
+
+std::vector<D3D12_INPUT_ELEMENT_DESC> VertexPacker::GetInputLayout(PositionEncoding encoding)
+{
+    DXGI_FORMAT positionFormat = encoding == PositionEncoding::Unorm16 ? DXGI_FORMAT_R16G16B16A16_UNORM : DXGI_FORMAT_R16G16B16A16_FLOAT;
+    return
+        {
+            {"POSITION", 0, positionFormat, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+            {"NORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0, 8, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+            {"TANGENT", 0, DXGI_FORMAT_R16G16_SNORM, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+            {"TEXCOORD", 0, DXGI_FORMAT_R16G16_UNORM, 0, 16, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0}
+        };
+}
+
+XMFLOAT2 VertexPacker::EncodeOctahedral(const XMFLOAT3& v)
+{
+    float length = fabsf(v.x) + fabsf(v.y) + fabsf(v.z);
+    if (length == 0.0f)
+        return { 0.0f, 0.0f };
+
+    float x = v.x / length;
+    float y = v.y / length;
+    if (v.z >= 0.0f)
+        return { x, y };
+    return { (1.0f - fabsf(y)) * SignNotZero(x), (1.0f - fabsf(x)) * SignNotZero(y) };
+}
+
+XMFLOAT3 VertexPacker::DecodeOctahedral(const XMFLOAT2& e)
+{
+    XMFLOAT3 v = { e.x, e.y, 1.0f - fabsf(e.x) - fabsf(e.y) };
+    float fold = (std::max)(-v.z, 0.0f);
+    v.x += v.x >= 0.0f ? -fold : fold;
+    v.y += v.y >= 0.0f ? -fold : fold;
+
+    XMFLOAT3 result;
+    XMStoreFloat3(&result, XMVector3Normalize(XMLoadFloat3(&v)));
+    return result;
+}
+}
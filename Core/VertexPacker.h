@@ -0,0 +1,106 @@
+//
+// Packing of float vertices into compact quantized layouts, see Shaders/VertexPacking.hlsl for decoding in shaders.
+//
+
+#pragma once
+
+#include "D3DUtil.h"
+#include "GeometryGenerator.h"
+#include "M3dLoader.h"
+
+namespace DX12Samples
+{
+enum class PositionEncoding
+{
+    /**
+     * \brief 16 bit UNORM relative to mesh bounds, same precision over whole mesh.
+     */
+    Unorm16,
+    /**
+     * \brief Half floats relative to bounds center divided by half extent, in [-1, 1] and more precise near center.
+     */
+    Float16
+};
+
+// Position x, y, z and bitangent sign in w, w is 0 for -1 and 1 for 1 after decoding of UNORM or half float. Normal
+// and tangent are octahedral SNORM, texture coordinates are UNORM relative to their bounds.
+struct PackedVertex
+{
+    uint16_t Position[4];
+    int16_t Normal[2];
+    int16_t Tangent[2];
+    uint16_t TexCoord[2];
+};
+
+// Decoding constants, layout matches VertexQuantization in Shaders/VertexPacking.hlsl so it can be copied to constant
+// buffer as is. Position = PositionOffset + PositionScale * encoded, same for texture coordinates.
+struct VertexQuantization
+{
+    DirectX::XMFLOAT3 PositionOffset = { 0.0f, 0.0f, 0.0f };
+    float Pad0 = 0.0f;
+    DirectX::XMFLOAT3 PositionScale = { 1.0f, 1.0f, 1.0f };
+    float Pad1 = 0.0f;
+    DirectX::XMFLOAT2 TexCoordOffset = { 0.0f, 0.0f };
+    DirectX::XMFLOAT2 TexCoordScale = { 1.0f, 1.0f };
+};
+
+// Vertex as decoded from PackedVertex, Tangent.w is bitangent sign.
+struct UnpackedVertex
+{
+    DirectX::XMFLOAT3 Position;
+    DirectX::XMFLOAT3 Normal;
+    DirectX::XMFLOAT4 Tangent;
+    DirectX::XMFLOAT2 TexCoord;
+};
+
+struct PackedMesh
+{
+    PositionEncoding Encoding = PositionEncoding::Unorm16;
+    VertexQuantization Quantization;
+    std::vector<PackedVertex> Vertices;
+
+    UINT VertexBufferByteSize() const;
+    /**
+     * \brief Input layout for PackedVertex with semantics POSITION, NORMAL, TANGENT and TEXCOORD.
+     */
+    std::vector<D3D12_INPUT_ELEMENT_DESC> GetInputLayout() const;
+};
+
+class VertexPacker
+{
+public:
+    /**
+     * \brief Pack generated vertices, bitangent sign is 1 as generator builds right handed bases.
+     */
+    static PackedMesh Pack(const GeometryGenerator::MeshData& meshData, PositionEncoding encoding = PositionEncoding::Unorm16);
+    /**
+     * \brief Pack model vertices, bitangent sign is taken from TangentU.w.
+     */
+    static PackedMesh Pack(const std::vector<M3dLoader::Vertex>& vertices, PositionEncoding encoding = PositionEncoding::Unorm16);
+
+    /**
+     * \brief Reference decoding, same math as Shaders/VertexPacking.hlsl.
+     */
+    static UnpackedVertex Unpack(const PackedVertex& vertex, const VertexQuantization& quantization, PositionEncoding encoding);
+    static std::vector<D3D12_INPUT_ELEMENT_DESC> GetInputLayout(PositionEncoding encoding);
+
+    /**
+     * \brief Map unit vector to square [-1, 1]^2 by projecting it on octahedron and unfolding lower half.
+     */
+    static DirectX::XMFLOAT2 EncodeOctahedral(const DirectX::XMFLOAT3& v);
+    static DirectX::XMFLOAT3 DecodeOctahedral(const DirectX::XMFLOAT2& e);
+
+private:
+    struct SourceVertex
+    {
+        const DirectX::XMFLOAT3* Position;
+        const DirectX::XMFLOAT3* Normal;
+        const DirectX::XMFLOAT3* Tangent;
+        const DirectX::XMFLOAT2* TexCoord;
+        float Sign;
+    };
+
+    template<typename GetVertex>
+    static PackedMesh Pack(size_t vertexCount, GetVertex getVertex, PositionEncoding encoding);
+};
+}
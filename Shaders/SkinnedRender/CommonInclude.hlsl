@@ -52,7 +52,7 @@ cbuffer cbPerObject : register(b0)
 
 cbuffer cbSkinned : register(b1)
 {
-    float4x4 BoneTransforms[96];
+    float4x3 BoneTransforms[96];
 };
 
 cbuffer cbPass : register(b2)
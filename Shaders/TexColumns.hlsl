@@ -11,6 +11,9 @@
 #endif
 
 #include "LightingUtil.hlsl"
+#ifdef PACKED_VERTICES
+    #include "VertexPacking.hlsl"
+#endif
 
 Texture2D _diffuseMap : register(t0);
 SamplerState _samPointWrap : register(s0);
@@ -55,6 +58,13 @@ cbuffer cbMaterial : register(b2)
     float4x4 MatTransform;
 };
 
+#ifdef PACKED_VERTICES
+cbuffer cbQuantization : register(b3)
+{
+    VertexQuantization Quantization;
+};
+#endif
+
 struct vIn
 {
     float3 pos : POSITION;
@@ -70,7 +80,7 @@ struct vOut
     float2 uv : TEXCOORD;
 };
 
-vOut vert(vIn i)
+vOut TransformVertex(vIn i)
 {
     vOut o = (vOut) 0.0;
     float4 posW = mul(float4(i.pos, 1.0f), Model);
@@ -83,6 +93,22 @@ vOut vert(vIn i)
     return o;
 }
 
+#ifdef PACKED_VERTICES
+vOut vert(PackedVertexIn packed)
+{
+    vIn i;
+    i.pos = DecodePosition(packed, Quantization);
+    i.normal = DecodeNormal(packed);
+    i.uv = DecodeTexCoord(packed, Quantization);
+    return TransformVertex(i);
+}
+#else
+vOut vert(vIn i)
+{
+    return TransformVertex(i);
+}
+#endif
+
 float4 frag(vOut i) : SV_Target
 {
     float4 diffuseAlbedo = _diffuseMap.Sample(_samAnisotropicWrap, i.uv) * DiffuseAlbedo;
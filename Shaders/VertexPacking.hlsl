@@ -0,0 +1,49 @@
+// Decoding of PackedVertex, see Core/VertexPacker.h. Input assembler already converts UNORM, SNORM and half values
+// to floats, so only quantization ranges and octahedral mapping are left.
+
+struct VertexQuantization
+{
+    float3 PositionOffset;
+    float Pad0;
+    float3 PositionScale;
+    float Pad1;
+    float2 TexCoordOffset;
+    float2 TexCoordScale;
+};
+
+struct PackedVertexIn
+{
+    float4 pos : POSITION;
+    float2 normal : NORMAL;
+    float2 tangent : TANGENT;
+    float2 uv : TEXCOORD;
+};
+
+float3 DecodeOctahedral(float2 e)
+{
+    float3 v = float3(e, 1.0f - abs(e.x) - abs(e.y));
+    float fold = saturate(-v.z);
+    v.xy += v.xy >= 0.0f ? -fold : fold;
+    return normalize(v);
+}
+
+float3 DecodePosition(PackedVertexIn i, VertexQuantization q)
+{
+    return q.PositionOffset + q.PositionScale * i.pos.xyz;
+}
+
+float3 DecodeNormal(PackedVertexIn i)
+{
+    return DecodeOctahedral(i.normal);
+}
+
+// Tangent with bitangent sign in w.
+float4 DecodeTangent(PackedVertexIn i)
+{
+    return float4(DecodeOctahedral(i.tangent), i.pos.w * 2.0f - 1.0f);
+}
+
+float2 DecodeTexCoord(PackedVertexIn i, VertexQuantization q)
+{
+    return q.TexCoordOffset + q.TexCoordScale * i.uv;
+}
@@ -1,5 +1,7 @@
 #include "Ch6Ex.h"
 
+#include "../../Core/BoundsBuilder.h"
+
 namespace DX12Samples
 {
 using namespace DirectX;
@@ -366,17 +368,9 @@ void Ch6Ex::BuildGeometry()
     _geometry->IndexFormat = DXGI_FORMAT_R16_UINT;
     _geometry->IndexBufferByteSize = ibByteSize;
 
-    SubmeshGeometry boxGeometry;
-    boxGeometry.IndexCount = 36;
-    boxGeometry.StartIndexLocation = 0;
-    boxGeometry.BaseVertexLocation = 0;
-    _geometry->DrawArgs["box"] = boxGeometry;
-
-    SubmeshGeometry pyramideGeometry;
-    pyramideGeometry.IndexCount = 18;
-    pyramideGeometry.StartIndexLocation = 36;
-    pyramideGeometry.BaseVertexLocation = 8;
-    _geometry->DrawArgs["pyramide"] = pyramideGeometry;
+    BoundsBuilder boundsBuilder;
+    _geometry->DrawArgs["box"] = boundsBuilder.CreateSubmesh(&positions[0].Pos, 8, sizeof(VertexPosData), 36, 0, 0);
+    _geometry->DrawArgs["pyramide"] = boundsBuilder.CreateSubmesh(&positions[8].Pos, 5, sizeof(VertexPosData), 18, 36, 8);
 }
 
 void Ch6Ex::BuildPSO()
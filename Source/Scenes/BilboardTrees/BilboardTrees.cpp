@@ -1,5 +1,6 @@
 #include "BilboardTrees.h"
 
+#include "../../../Core/BoundsBuilder.h"
 #include "../../../Core/GeometryGenerator.h"
 
 namespace DX12Samples
@@ -479,12 +480,13 @@ void BilboardTrees::BuildLandGeometry()
     GeometryGenerator geoGen;
     GeometryGenerator::MeshData grid = geoGen.CreateGrid(160.0f, 160.0f, 50, 50);
 
+    // Heights are written back to grid, so submesh bounds include hills.
     std::vector<FrameResourceUnfogged::Vertex> vertices(grid.Vertices.size());
     for (size_t i = 0; i < grid.Vertices.size(); i++)
     {
         auto& p = grid.Vertices[i].Position;
+        p.y = GetHillsHeight(p.x, p.z);
         vertices[i].Pos = p;
-        vertices[i].Pos.y = GetHillsHeight(p.x, p.z);
         vertices[i].Normal = GetHillsNormal(p.z, p.z);
         vertices[i].TexC = grid.Vertices[i].TexCoord;
     }
@@ -503,10 +505,7 @@ void BilboardTrees::BuildLandGeometry()
     geo->IndexFormat = DXGI_FORMAT_R16_UINT;
     geo->IndexBufferByteSize = ibByteSize;
 
-    SubmeshGeometry submesh;
-    submesh.IndexCount = (UINT)indices.size();
-    submesh.StartIndexLocation = 0;
-    submesh.BaseVertexLocation = 0;
+    SubmeshGeometry submesh = BoundsBuilder().CreateSubmesh(grid, 0, 0);
 
     geo->DrawArgs["grid"] = submesh;
     _geometries["landGeo"] = move(geo);
@@ -552,10 +551,8 @@ void BilboardTrees::BuildWavesGeometry()
     geo->IndexFormat = DXGI_FORMAT_R16_UINT;
     geo->IndexBufferByteSize = ibByteSize;
 
-    SubmeshGeometry submesh;
-    submesh.IndexCount = (UINT)indices.size();
-    submesh.StartIndexLocation = 0;
-    submesh.BaseVertexLocation = 0;
+    SubmeshGeometry submesh = BoundsBuilder().CreateSubmesh(&_waves->Position(0), (UINT)_waves->VertexCount(), sizeof(XMFLOAT3),
+        (UINT)indices.size(), 0, 0);
 
     geo->DrawArgs["grid"] = submesh;
     _geometries["waterGeo"] = move(geo);
@@ -566,10 +563,7 @@ void BilboardTrees::BuildBoxGeometry()
     GeometryGenerator geoGen;
     GeometryGenerator::MeshData box = geoGen.CreateBox(8.0f, 8.0f, 8.0f, 3);
 
-    SubmeshGeometry boxSubmesh;
-    boxSubmesh.IndexCount = (UINT)box.Indices32.size();
-    boxSubmesh.StartIndexLocation = 0;
-    boxSubmesh.BaseVertexLocation = 0;
+    SubmeshGeometry boxSubmesh = BoundsBuilder().CreateSubmesh(box, 0, 0);
 
     std::vector<FrameResourceUnfogged::Vertex> vertices(box.Vertices.size());
 
@@ -637,10 +631,8 @@ void BilboardTrees::BuildTreeSpritesGeometry()
     geo->IndexFormat = DXGI_FORMAT_R16_UINT;
     geo->IndexBufferByteSize = ibByteSize;
 
-    SubmeshGeometry submesh;
-    submesh.IndexCount = (UINT)indices.size();
-    submesh.StartIndexLocation = 0;
-    submesh.BaseVertexLocation = 0;
+    SubmeshGeometry submesh = BoundsBuilder().CreateSubmesh(&vertices[0].Pos, (UINT)vertices.size(), sizeof(TreeSpriteVertex),
+        (UINT)indices.size(), 0, 0);
 
     geo->DrawArgs["points"] = submesh;
     _geometries["treeSpritesGeo"] = move(geo);
@@ -784,6 +776,7 @@ void BilboardTrees::BuildRenderItems()
     wavesRenderItem->IndexCount = wavesRenderItem->Geo->DrawArgs["grid"].IndexCount;
     wavesRenderItem->StartIndexLocation = wavesRenderItem->Geo->DrawArgs["grid"].StartIndexLocation;
     wavesRenderItem->BaseVertexLocation = wavesRenderItem->Geo->DrawArgs["grid"].BaseVertexLocation;
+    wavesRenderItem->Bounds = wavesRenderItem->Geo->DrawArgs["grid"].Bounds;
 
     _wavesRenderItem = wavesRenderItem.get();
 
@@ -799,6 +792,7 @@ void BilboardTrees::BuildRenderItems()
     gridRenderItem->IndexCount = gridRenderItem->Geo->DrawArgs["grid"].IndexCount;
     gridRenderItem->StartIndexLocation = gridRenderItem->Geo->DrawArgs["grid"].StartIndexLocation;
     gridRenderItem->BaseVertexLocation = gridRenderItem->Geo->DrawArgs["grid"].BaseVertexLocation;
+    gridRenderItem->Bounds = gridRenderItem->Geo->DrawArgs["grid"].Bounds;
 
     _renderItemLayer[(int)RenderItem::RenderLayer::Opaque].push_back(gridRenderItem.get());
 
@@ -811,6 +805,7 @@ void BilboardTrees::BuildRenderItems()
     boxRenderItem->IndexCount = boxRenderItem->Geo->DrawArgs["box"].IndexCount;
     boxRenderItem->StartIndexLocation = boxRenderItem->Geo->DrawArgs["box"].StartIndexLocation;
     boxRenderItem->BaseVertexLocation = boxRenderItem->Geo->DrawArgs["box"].BaseVertexLocation;
+    boxRenderItem->Bounds = boxRenderItem->Geo->DrawArgs["box"].Bounds;
 
     _renderItemLayer[(int)RenderItem::RenderLayer::AlphaTested].push_back(boxRenderItem.get());
 
@@ -823,6 +818,7 @@ void BilboardTrees::BuildRenderItems()
     treeSpritesRenderItem->IndexCount = treeSpritesRenderItem->Geo->DrawArgs["points"].IndexCount;
     treeSpritesRenderItem->StartIndexLocation = treeSpritesRenderItem->Geo->DrawArgs["points"].StartIndexLocation;
     treeSpritesRenderItem->BaseVertexLocation = treeSpritesRenderItem->Geo->DrawArgs["points"].BaseVertexLocation;
+    treeSpritesRenderItem->Bounds = treeSpritesRenderItem->Geo->DrawArgs["points"].Bounds;
     
     _renderItemLayer[(int)RenderItem::RenderLayer::AlphaTestedTreeSprites].push_back(treeSpritesRenderItem.get());
 
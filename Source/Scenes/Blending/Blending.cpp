@@ -1,5 +1,6 @@
 #include "Blending.h"
 #include "../../Common/RenderItem.h"
+#include "../../../Core/BoundsBuilder.h"
 #include "../../../Core/GeometryGenerator.h"
 
 namespace DX12Samples
@@ -472,10 +473,8 @@ void Blending::BuildLandGeometry()
     geo->IndexFormat = DXGI_FORMAT_R16_UINT;
     geo->IndexBufferByteSize = ibByteSize;
 
-    SubmeshGeometry submesh;
-    submesh.IndexCount = (UINT)indices.size();
-    submesh.StartIndexLocation = 0;
-    submesh.BaseVertexLocation = 0;
+    SubmeshGeometry submesh = BoundsBuilder().CreateSubmesh(&vertices[0].Pos, (UINT)vertices.size(), sizeof(FrameResourceUnfogged::Vertex),
+        (UINT)indices.size(), 0, 0);
 
     geo->DrawArgs["grid"] = submesh;
     _geometries["landGeo"] = move(geo);
@@ -521,10 +520,8 @@ void Blending::BuildWavesGeometry()
     geo->IndexFormat = DXGI_FORMAT_R16_UINT;
     geo->IndexBufferByteSize = ibByteSize;
 
-    SubmeshGeometry submesh;
-    submesh.IndexCount = (UINT)indices.size();
-    submesh.StartIndexLocation = 0;
-    submesh.BaseVertexLocation = 0;
+    SubmeshGeometry submesh = BoundsBuilder().CreateSubmesh(&_waves->Position(0), (UINT)_waves->VertexCount(), sizeof(XMFLOAT3),
+        (UINT)indices.size(), 0, 0);
 
     geo->DrawArgs["grid"] = submesh;
     _geometries["waterGeo"] = move(geo);
@@ -535,10 +532,7 @@ void Blending::BuildBoxGeometry()
     GeometryGenerator geoGen;
     GeometryGenerator::MeshData box = geoGen.CreateBox(8.0f, 8.0f, 8.0f, 3);
 
-    SubmeshGeometry boxSubmesh;
-    boxSubmesh.IndexCount = (UINT)box.Indices32.size();
-    boxSubmesh.StartIndexLocation = 0;
-    boxSubmesh.BaseVertexLocation = 0;
+    SubmeshGeometry boxSubmesh = BoundsBuilder().CreateSubmesh(box, 0, 0);
 
     std::vector<FrameResourceUnfogged::Vertex> vertices(box.Vertices.size());
 
@@ -673,6 +667,7 @@ void Blending::BuildRenderItems()
     wavesRenderItem->IndexCount = wavesRenderItem->Geo->DrawArgs["grid"].IndexCount;
     wavesRenderItem->StartIndexLocation = wavesRenderItem->Geo->DrawArgs["grid"].StartIndexLocation;
     wavesRenderItem->BaseVertexLocation = wavesRenderItem->Geo->DrawArgs["grid"].BaseVertexLocation;
+    wavesRenderItem->Bounds = wavesRenderItem->Geo->DrawArgs["grid"].Bounds;
 
     _wavesRenderItem = wavesRenderItem.get();
 
@@ -688,6 +683,7 @@ void Blending::BuildRenderItems()
     gridRenderItem->IndexCount = gridRenderItem->Geo->DrawArgs["grid"].IndexCount;
     gridRenderItem->StartIndexLocation = gridRenderItem->Geo->DrawArgs["grid"].StartIndexLocation;
     gridRenderItem->BaseVertexLocation = gridRenderItem->Geo->DrawArgs["grid"].BaseVertexLocation;
+    gridRenderItem->Bounds = gridRenderItem->Geo->DrawArgs["grid"].Bounds;
 
     _renderItemLayer[(int)RenderItem::RenderLayer::Opaque].push_back(gridRenderItem.get());
 
@@ -700,6 +696,7 @@ void Blending::BuildRenderItems()
     boxRenderItem->IndexCount = boxRenderItem->Geo->DrawArgs["box"].IndexCount;
     boxRenderItem->StartIndexLocation = boxRenderItem->Geo->DrawArgs["box"].StartIndexLocation;
     boxRenderItem->BaseVertexLocation = boxRenderItem->Geo->DrawArgs["box"].BaseVertexLocation;
+    boxRenderItem->Bounds = boxRenderItem->Geo->DrawArgs["box"].Bounds;
 
     _renderItemLayer[(int)RenderItem::RenderLayer::AlphaTested].push_back(boxRenderItem.get());
 
@@ -1,5 +1,7 @@
 #include "Box.h"
 
+#include "../../../Core/BoundsBuilder.h"
+
 namespace DX12Samples
 {
 using namespace DirectX;
@@ -257,10 +259,8 @@ void Box::BuildBoxGeometry()
     _boxGeo->IndexFormat = DXGI_FORMAT_R16_UINT;
     _boxGeo->IndexBufferByteSize = ibByteSize;
 
-    SubmeshGeometry submesh;
-    submesh.IndexCount = (UINT)indices.size();
-    submesh.StartIndexLocation = 0;
-    submesh.BaseVertexLocation = 0;
+    SubmeshGeometry submesh = BoundsBuilder().CreateSubmesh(&vertices[0].Pos, (UINT)vertices.size(), sizeof(Vertex),
+        (UINT)indices.size(), 0, 0);
     _boxGeo->DrawArgs["box"] = submesh;
 }
 
@@ -1,5 +1,6 @@
 #include "Crate.h"
 
+#include "../../../Core/BoundsBuilder.h"
 #include "../../../Core/GeometryGenerator.h"
 
 namespace DX12Samples
@@ -351,10 +352,7 @@ void Crate::BuildShapeGeometry()
     GeometryGenerator geoGen;
     GeometryGenerator::MeshData box = geoGen.CreateBox(1.0f, 1.0f, 1.0f, 3);
 
-    SubmeshGeometry boxSubmesh;
-    boxSubmesh.IndexCount = (UINT)box.Indices32.size();
-    boxSubmesh.StartIndexLocation = 0;
-    boxSubmesh.BaseVertexLocation = 0;
+    SubmeshGeometry boxSubmesh = BoundsBuilder().CreateSubmesh(box, 0, 0);
 
     std::vector<CrateFrameResource::Vertex> vertices(box.Vertices.size());
 
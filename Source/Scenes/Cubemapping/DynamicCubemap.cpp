@@ -1,6 +1,8 @@
 #include "DynamicCubemap.h"
 
+#include "../../../Core/BoundsBuilder.h"
 #include "../../../Core/GeometryGenerator.h"
+#include "../../../Core/MeshAsset.h"
 
 namespace DX12Samples
 {
@@ -530,25 +532,12 @@ void DynamicCubemap::BuildShapeGeometry()
     UINT sphereIndexOffset = gridIndexOffset + (UINT)grid.Indices32.size();
     UINT cylinderIndexOffset = sphereIndexOffset + (UINT)sphere.Indices32.size();
 
-    SubmeshGeometry boxSubmesh;
-    boxSubmesh.IndexCount = (UINT)box.Indices32.size();
-    boxSubmesh.StartIndexLocation = boxIndexOffset;
-    boxSubmesh.BaseVertexLocation = boxVertexOffset;
+    BoundsBuilder boundsBuilder;
 
-    SubmeshGeometry gridSubmesh;
-    gridSubmesh.IndexCount = (UINT)grid.Indices32.size();
-    gridSubmesh.StartIndexLocation = gridIndexOffset;
-    gridSubmesh.BaseVertexLocation = gridVertexOffset;
-
-    SubmeshGeometry sphereSubmesh;
-    sphereSubmesh.IndexCount = (UINT)sphere.Indices32.size();
-    sphereSubmesh.StartIndexLocation = sphereIndexOffset;
-    sphereSubmesh.BaseVertexLocation = sphereVertexOffset;
-
-    SubmeshGeometry cylinderSubmesh;
-    cylinderSubmesh.IndexCount = (UINT)cylinder.Indices32.size();
-    cylinderSubmesh.StartIndexLocation = cylinderIndexOffset;
-    cylinderSubmesh.BaseVertexLocation = cylinderVertexOffset;
+    SubmeshGeometry boxSubmesh = boundsBuilder.CreateSubmesh(box, boxIndexOffset, boxVertexOffset);
+    SubmeshGeometry gridSubmesh = boundsBuilder.CreateSubmesh(grid, gridIndexOffset, gridVertexOffset);
+    SubmeshGeometry sphereSubmesh = boundsBuilder.CreateSubmesh(sphere, sphereIndexOffset, sphereVertexOffset);
+    SubmeshGeometry cylinderSubmesh = boundsBuilder.CreateSubmesh(cylinder, cylinderIndexOffset, cylinderVertexOffset);
 
     auto totalVertexCount =
         box.Vertices.size() +
@@ -626,87 +615,28 @@ void DynamicCubemap::BuildShapeGeometry()
 
 void DynamicCubemap::BuildSkullGeometry()
 {
-    std::ifstream fin("Models\\skull.txt");
-
-    if (!fin)
+    auto skull = MeshAssetCache::Instance().Load("Models\\skull.txt", MeshVertexLayout::PosNormalUv);
+    if (skull == nullptr)
     {
-        MessageBox(0, L"Models\\scull.txt not found", nullptr, 0);
+        MessageBox(0, L"Models\\skull.txt not found", nullptr, 0);
         return;
     }
 
-    UINT vcount = 0;
-    UINT tcount = 0;
-    std::string ignore;
-
-    fin >> ignore >> vcount;
-    fin >> ignore >> tcount;
-    fin >> ignore >> ignore >> ignore >> ignore;
-
-    XMFLOAT3 vMinf3(+MathHelper::Infinity, +MathHelper::Infinity, +MathHelper::Infinity);
-    XMFLOAT3 vMaxf3(-MathHelper::Infinity, -MathHelper::Infinity, -MathHelper::Infinity);
-
-    XMVECTOR vMin = XMLoadFloat3(&vMinf3);
-    XMVECTOR vMax = XMLoadFloat3(&vMaxf3);
-
-    std::vector<Vertex> vertices(vcount);
-    for (UINT i = 0; i < vcount; i++)
-    {
-        fin >> vertices[i].Pos.x >> vertices[i].Pos.y >> vertices[i].Pos.z;
-        fin >> vertices[i].Normal.x >> vertices[i].Normal.y >> vertices[i].Normal.z;
-
-        XMVECTOR P = XMLoadFloat3(&vertices[i].Pos);
-
-        XMFLOAT3 spherePos;
-        XMStoreFloat3(&spherePos, XMVector3Normalize(P));
-
-        float theta = atan2f(spherePos.z, spherePos.x);
-
-        if (theta < 0.0f)
-            theta += XM_2PI;
-
-        float phi = acosf(spherePos.y);
-
-        float u = theta / (2.0f * XM_PI);
-        float v = phi / XM_PI;
-
-        vertices[i].Uv = { u, v };
-
-        vMin = XMVectorMin(vMin, P);
-        vMax = XMVectorMax(vMax, P);
-    }
-    BoundingBox bounds;
-    XMStoreFloat3(&bounds.Center, 0.5f * (vMin + vMax));
-    XMStoreFloat3(&bounds.Extents, 0.5f * (vMax - vMin));
-
-    fin >> ignore;
-    fin >> ignore;
-    fin >> ignore;
-
-    std::vector<int32_t> indices(3 * tcount);
-    for (UINT i = 0; i < tcount; i++)
-    {
-        fin >> indices[i * 3 + 0] >> indices[i * 3 + 1] >> indices[i * 3 + 2];
-    }
-    fin.close();
-
-    const UINT vbByteSize = (UINT)vertices.size() * sizeof(Vertex);
-    const UINT ibByteSize = (UINT)indices.size() * sizeof(int32_t);
+    const UINT vbByteSize = skull->VertexBufferByteSize();
+    const UINT ibByteSize = skull->IndexBufferByteSize();
 
     auto geo = std::make_unique<MeshGeometry>();
     geo->Name = "skullGeo";
 
-    geo->VertexBufferGPU = D3DUtil::CreateDefaultBuffer(_device.Get(), _commandList.Get(), vertices.data(), vbByteSize, geo->VertexBufferUploader);
-    geo->IndexBufferGPU = D3DUtil::CreateDefaultBuffer(_device.Get(), _commandList.Get(), indices.data(), ibByteSize, geo->IndexBufferUploader);
+    geo->VertexBufferGPU = D3DUtil::CreateDefaultBuffer(_device.Get(), _commandList.Get(), skull->GetVertices<Vertex>(), vbByteSize, geo->VertexBufferUploader);
+    geo->IndexBufferGPU = D3DUtil::CreateDefaultBuffer(_device.Get(), _commandList.Get(), skull->Indices.data(), ibByteSize, geo->IndexBufferUploader);
 
     geo->VertexByteStride = sizeof(Vertex);
     geo->VertexBufferByteSize = vbByteSize;
     geo->IndexFormat = DXGI_FORMAT_R32_UINT;
     geo->IndexBufferByteSize = ibByteSize;
 
-    SubmeshGeometry submesh;
-    submesh.IndexCount = (UINT)indices.size();
-    submesh.StartIndexLocation = 0;
-    submesh.BaseVertexLocation = 0;
+    SubmeshGeometry submesh = skull->CreateSubmesh();
     geo->DrawArgs["skull"] = submesh;
     _geometries[geo->Name] = move(geo);
 }
@@ -826,6 +756,7 @@ void DynamicCubemap::BuildRenderItems()
     skyRitem->IndexCount = skyRitem->Geo->DrawArgs["sphere"].IndexCount;
     skyRitem->StartIndexLocation = skyRitem->Geo->DrawArgs["sphere"].StartIndexLocation;
     skyRitem->BaseVertexLocation = skyRitem->Geo->DrawArgs["sphere"].BaseVertexLocation;
+    skyRitem->Bounds = skyRitem->Geo->DrawArgs["sphere"].Bounds;
     _renderItemLayer[(int)RenderLayer::Sky].push_back(skyRitem.get());
     _allRenderItems.push_back(move(skyRitem));
 
@@ -839,6 +770,7 @@ void DynamicCubemap::BuildRenderItems()
     skullRitem->IndexCount = skullRitem->Geo->DrawArgs["skull"].IndexCount;
     skullRitem->StartIndexLocation = skullRitem->Geo->DrawArgs["skull"].StartIndexLocation;
     skullRitem->BaseVertexLocation = skullRitem->Geo->DrawArgs["skull"].BaseVertexLocation;
+    skullRitem->Bounds = skullRitem->Geo->DrawArgs["skull"].Bounds;
     _skullRenderItem = skullRitem.get();
     _renderItemLayer[(int)RenderLayer::Opaque].push_back(skullRitem.get());
     _allRenderItems.push_back(move(skullRitem));
@@ -853,6 +785,7 @@ void DynamicCubemap::BuildRenderItems()
     boxRitem->IndexCount = boxRitem->Geo->DrawArgs["box"].IndexCount;
     boxRitem->StartIndexLocation = boxRitem->Geo->DrawArgs["box"].StartIndexLocation;
     boxRitem->BaseVertexLocation = boxRitem->Geo->DrawArgs["box"].BaseVertexLocation;
+    boxRitem->Bounds = boxRitem->Geo->DrawArgs["box"].Bounds;
     _renderItemLayer[(int)RenderLayer::Opaque].push_back(boxRitem.get());
     _allRenderItems.push_back(move(boxRitem));
 
@@ -866,6 +799,7 @@ void DynamicCubemap::BuildRenderItems()
     globeRitem->IndexCount = globeRitem->Geo->DrawArgs["sphere"].IndexCount;
     globeRitem->StartIndexLocation = globeRitem->Geo->DrawArgs["sphere"].StartIndexLocation;
     globeRitem->BaseVertexLocation = globeRitem->Geo->DrawArgs["sphere"].BaseVertexLocation;
+    globeRitem->Bounds = globeRitem->Geo->DrawArgs["sphere"].Bounds;
     _renderItemLayer[(int)RenderLayer::OpaqueDynamicReflectors].push_back(globeRitem.get());
     _allRenderItems.push_back(move(globeRitem));
 
@@ -879,6 +813,7 @@ void DynamicCubemap::BuildRenderItems()
     gridRitem->IndexCount = gridRitem->Geo->DrawArgs["grid"].IndexCount;
     gridRitem->StartIndexLocation = gridRitem->Geo->DrawArgs["grid"].StartIndexLocation;
     gridRitem->BaseVertexLocation = gridRitem->Geo->DrawArgs["grid"].BaseVertexLocation;
+    gridRitem->Bounds = gridRitem->Geo->DrawArgs["grid"].Bounds;
     _renderItemLayer[(int)RenderLayer::Opaque].push_back(gridRitem.get());
     _allRenderItems.push_back(move(gridRitem));
 
@@ -906,6 +841,7 @@ void DynamicCubemap::BuildRenderItems()
         leftCylRitem->IndexCount = leftCylRitem->Geo->DrawArgs["cylinder"].IndexCount;
         leftCylRitem->StartIndexLocation = leftCylRitem->Geo->DrawArgs["cylinder"].StartIndexLocation;
         leftCylRitem->BaseVertexLocation = leftCylRitem->Geo->DrawArgs["cylinder"].BaseVertexLocation;
+        leftCylRitem->Bounds = leftCylRitem->Geo->DrawArgs["cylinder"].Bounds;
 
         XMStoreFloat4x4(&rightCylRitem->Model, leftCylWorld);
         XMStoreFloat4x4(&rightCylRitem->TexTransform, brickTexTransform);
@@ -916,6 +852,7 @@ void DynamicCubemap::BuildRenderItems()
         rightCylRitem->IndexCount = rightCylRitem->Geo->DrawArgs["cylinder"].IndexCount;
         rightCylRitem->StartIndexLocation = rightCylRitem->Geo->DrawArgs["cylinder"].StartIndexLocation;
         rightCylRitem->BaseVertexLocation = rightCylRitem->Geo->DrawArgs["cylinder"].BaseVertexLocation;
+        rightCylRitem->Bounds = rightCylRitem->Geo->DrawArgs["cylinder"].Bounds;
 
         XMStoreFloat4x4(&leftSphereRitem->Model, leftSphereWorld);
         leftSphereRitem->TexTransform = MathHelper::Identity4x4();
@@ -926,6 +863,7 @@ void DynamicCubemap::BuildRenderItems()
         leftSphereRitem->IndexCount = leftSphereRitem->Geo->DrawArgs["sphere"].IndexCount;
         leftSphereRitem->StartIndexLocation = leftSphereRitem->Geo->DrawArgs["sphere"].StartIndexLocation;
         leftSphereRitem->BaseVertexLocation = leftSphereRitem->Geo->DrawArgs["sphere"].BaseVertexLocation;
+        leftSphereRitem->Bounds = leftSphereRitem->Geo->DrawArgs["sphere"].Bounds;
 
         XMStoreFloat4x4(&rightSphereRitem->Model, rightSphereWorld);
         rightSphereRitem->TexTransform = MathHelper::Identity4x4();
@@ -936,6 +874,7 @@ void DynamicCubemap::BuildRenderItems()
         rightSphereRitem->IndexCount = rightSphereRitem->Geo->DrawArgs["sphere"].IndexCount;
         rightSphereRitem->StartIndexLocation = rightSphereRitem->Geo->DrawArgs["sphere"].StartIndexLocation;
         rightSphereRitem->BaseVertexLocation = rightSphereRitem->Geo->DrawArgs["sphere"].BaseVertexLocation;
+        rightSphereRitem->Bounds = rightSphereRitem->Geo->DrawArgs["sphere"].Bounds;
 
         _renderItemLayer[(int)RenderLayer::Opaque].push_back(leftCylRitem.get());
         _renderItemLayer[(int)RenderLayer::Opaque].push_back(rightCylRitem.get());
@@ -1,5 +1,6 @@
 #include "DynamicIndexing.h"
 
+#include "../../../Core/BoundsBuilder.h"
 #include "../../../Core/GeometryGenerator.h"
 
 namespace DX12Samples
@@ -379,25 +380,12 @@ void DynamicIndexing::BuildShapeGeometry()
     UINT sphereIndexOffset = gridIndexOffset + (UINT)grid.Indices32.size();
     UINT cylinderIndexOffset = sphereIndexOffset + (UINT)sphere.Indices32.size();
 
-    SubmeshGeometry boxSubmesh;
-    boxSubmesh.IndexCount = (UINT)box.Indices32.size();
-    boxSubmesh.StartIndexLocation = boxIndexOffset;
-    boxSubmesh.BaseVertexLocation = boxVertexOffset;
+    BoundsBuilder boundsBuilder;
 
-    SubmeshGeometry gridSubmesh;
-    gridSubmesh.IndexCount = (UINT)grid.Indices32.size();
-    gridSubmesh.StartIndexLocation = gridIndexOffset;
-    gridSubmesh.BaseVertexLocation = gridVertexOffset;
-
-    SubmeshGeometry sphereSubmesh;
-    sphereSubmesh.IndexCount = (UINT)sphere.Indices32.size();
-    sphereSubmesh.StartIndexLocation = sphereIndexOffset;
-    sphereSubmesh.BaseVertexLocation = sphereVertexOffset;
-
-    SubmeshGeometry cylinderSubmesh;
-    cylinderSubmesh.IndexCount = (UINT)cylinder.Indices32.size();
-    cylinderSubmesh.StartIndexLocation = cylinderIndexOffset;
-    cylinderSubmesh.BaseVertexLocation = cylinderVertexOffset;
+    SubmeshGeometry boxSubmesh = boundsBuilder.CreateSubmesh(box, boxIndexOffset, boxVertexOffset);
+    SubmeshGeometry gridSubmesh = boundsBuilder.CreateSubmesh(grid, gridIndexOffset, gridVertexOffset);
+    SubmeshGeometry sphereSubmesh = boundsBuilder.CreateSubmesh(sphere, sphereIndexOffset, sphereVertexOffset);
+    SubmeshGeometry cylinderSubmesh = boundsBuilder.CreateSubmesh(cylinder, cylinderIndexOffset, cylinderVertexOffset);
 
     auto totalVertexCount =
         box.Vertices.size() +
@@ -564,6 +552,7 @@ void DynamicIndexing::BuildRenderItems()
     boxRitem->IndexCount = boxRitem->Geo->DrawArgs["box"].IndexCount;
     boxRitem->StartIndexLocation = boxRitem->Geo->DrawArgs["box"].StartIndexLocation;
     boxRitem->BaseVertexLocation = boxRitem->Geo->DrawArgs["box"].BaseVertexLocation;
+    boxRitem->Bounds = boxRitem->Geo->DrawArgs["box"].Bounds;
     _allRenderItems.push_back(move(boxRitem));
 
     auto gridRitem = std::make_unique<RenderItem>();
@@ -576,6 +565,7 @@ void DynamicIndexing::BuildRenderItems()
     gridRitem->IndexCount = gridRitem->Geo->DrawArgs["grid"].IndexCount;
     gridRitem->StartIndexLocation = gridRitem->Geo->DrawArgs["grid"].StartIndexLocation;
     gridRitem->BaseVertexLocation = gridRitem->Geo->DrawArgs["grid"].BaseVertexLocation;
+    gridRitem->Bounds = gridRitem->Geo->DrawArgs["grid"].Bounds;
     _allRenderItems.push_back(move(gridRitem));
 
     XMMATRIX brickTexTransform = XMMatrixScaling(1.0f, 1.0f, 1.0f);
@@ -602,6 +592,7 @@ void DynamicIndexing::BuildRenderItems()
         leftCylRitem->IndexCount = leftCylRitem->Geo->DrawArgs["cylinder"].IndexCount;
         leftCylRitem->StartIndexLocation = leftCylRitem->Geo->DrawArgs["cylinder"].StartIndexLocation;
         leftCylRitem->BaseVertexLocation = leftCylRitem->Geo->DrawArgs["cylinder"].BaseVertexLocation;
+        leftCylRitem->Bounds = leftCylRitem->Geo->DrawArgs["cylinder"].Bounds;
 
         XMStoreFloat4x4(&rightCylRitem->Model, leftCylWorld);
         XMStoreFloat4x4(&rightCylRitem->TexTransform, brickTexTransform);
@@ -612,6 +603,7 @@ void DynamicIndexing::BuildRenderItems()
         rightCylRitem->IndexCount = rightCylRitem->Geo->DrawArgs["cylinder"].IndexCount;
         rightCylRitem->StartIndexLocation = rightCylRitem->Geo->DrawArgs["cylinder"].StartIndexLocation;
         rightCylRitem->BaseVertexLocation = rightCylRitem->Geo->DrawArgs["cylinder"].BaseVertexLocation;
+        rightCylRitem->Bounds = rightCylRitem->Geo->DrawArgs["cylinder"].Bounds;
 
         XMStoreFloat4x4(&leftSphereRitem->Model, leftSphereWorld);
         leftSphereRitem->TexTransform = MathHelper::Identity4x4();
@@ -622,6 +614,7 @@ void DynamicIndexing::BuildRenderItems()
         leftSphereRitem->IndexCount = leftSphereRitem->Geo->DrawArgs["sphere"].IndexCount;
         leftSphereRitem->StartIndexLocation = leftSphereRitem->Geo->DrawArgs["sphere"].StartIndexLocation;
         leftSphereRitem->BaseVertexLocation = leftSphereRitem->Geo->DrawArgs["sphere"].BaseVertexLocation;
+        leftSphereRitem->Bounds = leftSphereRitem->Geo->DrawArgs["sphere"].Bounds;
 
         XMStoreFloat4x4(&rightSphereRitem->Model, rightSphereWorld);
         rightSphereRitem->TexTransform = MathHelper::Identity4x4();
@@ -632,6 +625,7 @@ void DynamicIndexing::BuildRenderItems()
         rightSphereRitem->IndexCount = rightSphereRitem->Geo->DrawArgs["sphere"].IndexCount;
         rightSphereRitem->StartIndexLocation = rightSphereRitem->Geo->DrawArgs["sphere"].StartIndexLocation;
         rightSphereRitem->BaseVertexLocation = rightSphereRitem->Geo->DrawArgs["sphere"].BaseVertexLocation;
+        rightSphereRitem->Bounds = rightSphereRitem->Geo->DrawArgs["sphere"].Bounds;
 
         _allRenderItems.push_back(move(leftCylRitem));
         _allRenderItems.push_back(move(rightCylRitem));
@@ -1,6 +1,7 @@
 #include "GaussBlur.h"
 
 #include "../../Common/RenderItem.h"
+#include "../../../Core/BoundsBuilder.h"
 #include "../../../Core/GeometryGenerator.h"
 
 namespace DX12Samples
@@ -522,10 +523,8 @@ void GaussBlur::BuildLandGeometry()
     geo->IndexFormat = DXGI_FORMAT_R16_UINT;
     geo->IndexBufferByteSize = ibByteSize;
 
-    SubmeshGeometry submesh;
-    submesh.IndexCount = (UINT)indices.size();
-    submesh.StartIndexLocation = 0;
-    submesh.BaseVertexLocation = 0;
+    SubmeshGeometry submesh = BoundsBuilder().CreateSubmesh(&vertices[0].Pos, (UINT)vertices.size(), sizeof(FrameResourceUnfogged::Vertex),
+        (UINT)indices.size(), 0, 0);
 
     geo->DrawArgs["grid"] = submesh;
     _geometries["landGeo"] = move(geo);
@@ -571,10 +570,8 @@ void GaussBlur::BuildWavesGeometry()
     geo->IndexFormat = DXGI_FORMAT_R16_UINT;
     geo->IndexBufferByteSize = ibByteSize;
 
-    SubmeshGeometry submesh;
-    submesh.IndexCount = (UINT)indices.size();
-    submesh.StartIndexLocation = 0;
-    submesh.BaseVertexLocation = 0;
+    SubmeshGeometry submesh = BoundsBuilder().CreateSubmesh(&_waves->Position(0), (UINT)_waves->VertexCount(), sizeof(XMFLOAT3),
+        (UINT)indices.size(), 0, 0);
 
     geo->DrawArgs["grid"] = submesh;
     _geometries["waterGeo"] = move(geo);
@@ -585,10 +582,7 @@ void GaussBlur::BuildBoxGeometry()
     GeometryGenerator geoGen;
     GeometryGenerator::MeshData box = geoGen.CreateBox(8.0f, 8.0f, 8.0f, 3);
 
-    SubmeshGeometry boxSubmesh;
-    boxSubmesh.IndexCount = (UINT)box.Indices32.size();
-    boxSubmesh.StartIndexLocation = 0;
-    boxSubmesh.BaseVertexLocation = 0;
+    SubmeshGeometry boxSubmesh = BoundsBuilder().CreateSubmesh(box, 0, 0);
 
     std::vector<FrameResourceUnfogged::Vertex> vertices(box.Vertices.size());
 
@@ -745,6 +739,7 @@ void GaussBlur::BuildRenderItems()
     wavesRenderItem->IndexCount = wavesRenderItem->Geo->DrawArgs["grid"].IndexCount;
     wavesRenderItem->StartIndexLocation = wavesRenderItem->Geo->DrawArgs["grid"].StartIndexLocation;
     wavesRenderItem->BaseVertexLocation = wavesRenderItem->Geo->DrawArgs["grid"].BaseVertexLocation;
+    wavesRenderItem->Bounds = wavesRenderItem->Geo->DrawArgs["grid"].Bounds;
 
     _wavesRenderItem = wavesRenderItem.get();
 
@@ -760,6 +755,7 @@ void GaussBlur::BuildRenderItems()
     gridRenderItem->IndexCount = gridRenderItem->Geo->DrawArgs["grid"].IndexCount;
     gridRenderItem->StartIndexLocation = gridRenderItem->Geo->DrawArgs["grid"].StartIndexLocation;
     gridRenderItem->BaseVertexLocation = gridRenderItem->Geo->DrawArgs["grid"].BaseVertexLocation;
+    gridRenderItem->Bounds = gridRenderItem->Geo->DrawArgs["grid"].Bounds;
 
     _renderItemLayer[(int)RenderItem::RenderLayer::Opaque].push_back(gridRenderItem.get());
 
@@ -772,6 +768,7 @@ void GaussBlur::BuildRenderItems()
     boxRenderItem->IndexCount = boxRenderItem->Geo->DrawArgs["box"].IndexCount;
     boxRenderItem->StartIndexLocation = boxRenderItem->Geo->DrawArgs["box"].StartIndexLocation;
     boxRenderItem->BaseVertexLocation = boxRenderItem->Geo->DrawArgs["box"].BaseVertexLocation;
+    boxRenderItem->Bounds = boxRenderItem->Geo->DrawArgs["box"].Bounds;
 
     _renderItemLayer[(int)RenderItem::RenderLayer::AlphaTested].push_back(boxRenderItem.get());
 
@@ -1,5 +1,6 @@
 #include "GeomCylinder.h"
 
+#include "../../../Core/BoundsBuilder.h"
 #include "../../../Core/GeometryGenerator.h"
 
 namespace DX12Samples
@@ -287,10 +288,14 @@ void GeomCylinder::BuildShapeGeometry()
     geo->VertexBufferGPU = D3DUtil::CreateDefaultBuffer(_device.Get(), _commandList.Get(), verts.data(), vetsByteSize, geo->VertexBufferUploader);
     geo->IndexBufferGPU = D3DUtil::CreateDefaultBuffer(_device.Get(), _commandList.Get(), indices.data(), indByteSize, geo->IndexBufferUploader);
 
-    SubmeshGeometry submesh;
-    submesh.BaseVertexLocation = 0;
-    submesh.StartIndexLocation = 0;
-    submesh.IndexCount = stepCount;
+    // Geometry shader extrudes circle one unit up, bounds cover both rims.
+    std::array<XMFLOAT3, stepCount * 2> rims;
+    for (int i = 0; i < stepCount; i++)
+    {
+        rims[i] = verts[i];
+        rims[stepCount + i] = XMFLOAT3(verts[i].x, verts[i].y + 1.0f, verts[i].z);
+    }
+    SubmeshGeometry submesh = BoundsBuilder().CreateSubmesh(rims.data(), (UINT)rims.size(), sizeof(XMFLOAT3), stepCount, 0, 0);
 
     geo->IndexBufferByteSize = indByteSize;
     geo->IndexFormat = DXGI_FORMAT_R16_UINT;
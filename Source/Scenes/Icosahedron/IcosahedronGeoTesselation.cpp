@@ -1,5 +1,6 @@
 #include "IcosahedronGeoTesselation.h"
 
+#include "../../../Core/BoundsBuilder.h"
 #include "../../../Core/GeometryGenerator.h"
 
 namespace DX12Samples
@@ -437,10 +438,7 @@ void IcosahedronGeoTesselation::BuildShapeGeometry()
     geo->VertexBufferByteSize = vertSize;
     geo->VertexByteStride = sizeof(CrateFrameResource::Vertex);
     
-    SubmeshGeometry submesh;
-    submesh.BaseVertexLocation = 0;
-    submesh.StartIndexLocation = 0;
-    submesh.IndexCount = indices.size();
+    SubmeshGeometry submesh = BoundsBuilder().CreateSubmesh(icoGeo, 0, 0);
 
     geo->DrawArgs["ico"] = submesh;
     
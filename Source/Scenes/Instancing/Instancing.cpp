@@ -1,5 +1,7 @@
 #include "Instancing.h"
 
+#include "../../../Core/MeshAsset.h"
+
 namespace DX12Samples
 {
 using Microsoft::WRL::ComPtr;
@@ -79,6 +81,7 @@ void Instancing::Update(const GameTimer& timer)
         CloseHandle(eventHandle);
     }
     AnimateMaterials(timer);
+    _lodStreamer.DispatchCompletions();
     UpdateInstanceData(timer);
     UpdateMaterialBuffer(timer);
     UpdateMainPassCB(timer);
@@ -117,6 +120,10 @@ void Instancing::Draw(const GameTimer& timer)
     DrawRenderItems(_commandList.Get(), _opaqueRenderItems);
     _commandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(CurrentBackBuffer(), D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT));
 
+    // Instances of this frame were grouped by current levels, so render item switches to new ones after they are drawn.
+    if (_builtSkullLods != nullptr)
+        BuildSkullLods();
+
     ThrowIfFailed(_commandList->Close());
 
     ID3D12CommandList* cmdLists[] = {_commandList.Get()};
@@ -177,6 +184,12 @@ void Instancing::OnKeyboardInput(const GameTimer& timer)
     if (GetAsyncKeyState('2') & 0x8000)
         _frustumCullingEnabled = false;
 
+    if (GetAsyncKeyState('3') & 0x8000)
+        _lodEnabled = true;
+
+    if (GetAsyncKeyState('4') & 0x8000)
+        _lodEnabled = false;
+
     _camera.UpdateViewMatrix();
 }
 
@@ -194,11 +207,21 @@ void Instancing::UpdateInstanceData(const GameTimer& timer)
     {
         const auto& instanceData = e->Instances;
         int visibleInstanceCount = 0;
+        // Instances are drawn per level, render item without levels has nothing to draw.
+        if (e->Lods.empty())
+        {
+            e->InstanceCount = 0;
+            continue;
+        }
+
+        // Pick level of every visible instance first, then write instances grouped by level.
+        std::vector<UINT> instanceLods(instanceData.size(), UINT_MAX);
+        for (auto& lod : e->Lods)
+            lod.InstanceCount = 0;
 
         for (UINT i = 0; i < (UINT)instanceData.size(); i++)
         {
             XMMATRIX model = XMLoadFloat4x4(&instanceData[i].Model);
-            XMMATRIX texTransform = XMLoadFloat4x4(&instanceData[i].TexTransform);
 
             XMMATRIX invModel = XMMatrixInverse(&XMMatrixDeterminant(model), model);
 
@@ -208,19 +231,46 @@ void Instancing::UpdateInstanceData(const GameTimer& timer)
 
             if (_frustumCullingEnabled == false || localSpaceFrustum.Contains(e->Bounds) != DISJOINT)
             {
-                FrameResource::InstanceData data;
-                XMStoreFloat4x4(&data.Model, XMMatrixTranspose(model));
-                XMStoreFloat4x4(&data.TexTransform, XMMatrixTranspose(texTransform));
-                data.MaterialIndex = instanceData[i].MaterialIndex;
-
-                currInstanceBuffer->CopyData(visibleInstanceCount++, data);
+                UINT lod = _lodEnabled && e->LodChain != nullptr ? e->LodChain->SelectLod(_camera, model, (float)_clientHeight) : 0;
+                lod = MathHelper::Min(lod, (UINT)e->Lods.size() - 1);
+                instanceLods[i] = lod;
+                e->Lods[lod].InstanceCount++;
+                visibleInstanceCount++;
             }
         }
+
+        UINT startInstance = 0;
+        for (auto& lod : e->Lods)
+        {
+            lod.StartInstanceLocation = startInstance;
+            startInstance += lod.InstanceCount;
+            lod.InstanceCount = 0;
+        }
+
+        UINT triangleCount = 0;
+        for (UINT i = 0; i < (UINT)instanceData.size(); i++)
+        {
+            if (instanceLods[i] == UINT_MAX)
+                continue;
+
+            XMMATRIX model = XMLoadFloat4x4(&instanceData[i].Model);
+            XMMATRIX texTransform = XMLoadFloat4x4(&instanceData[i].TexTransform);
+
+            FrameResource::InstanceData data;
+            XMStoreFloat4x4(&data.Model, XMMatrixTranspose(model));
+            XMStoreFloat4x4(&data.TexTransform, XMMatrixTranspose(texTransform));
+            data.MaterialIndex = instanceData[i].MaterialIndex;
+
+            auto& lod = e->Lods[instanceLods[i]];
+            currInstanceBuffer->CopyData(lod.StartInstanceLocation + lod.InstanceCount++, data);
+            triangleCount += lod.IndexCount / 3;
+        }
         e->InstanceCount = visibleInstanceCount;
 
         std::wostringstream outs;
         outs.precision(6);
-        outs << L"Instancing and culling" << L"   " << e->InstanceCount << L" object visible out of " << e->Instances.size();
+        outs << L"Instancing and culling" << L"   " << e->InstanceCount << L" object visible out of " << e->Instances.size()
+            << L"   " << triangleCount << L" triangles";
         _mainWindowCaption = outs.str();
     }
 }
@@ -431,88 +481,77 @@ void Instancing::BuildShaderAndInputLayout()
 
 void Instancing::BuildSkullGeometry()
 {
-    std::ifstream fin("Models\\skull.txt");
-
-    if (!fin)
+    auto skull = MeshAssetCache::Instance().Load("Models\\skull.txt", MeshVertexLayout::PosNormalUv);
+    if (skull == nullptr)
     {
-        MessageBox(0, L"Models\\scull.txt not found", nullptr, 0);
+        MessageBox(0, L"Models\\skull.txt not found", nullptr, 0);
         return;
     }
 
-    UINT vcount = 0;
-    UINT tcount = 0;
-    std::string ignore;
-
-    fin >> ignore >> vcount;
-    fin >> ignore >> tcount;
-    fin >> ignore >> ignore >> ignore >> ignore;
-
-    XMFLOAT3 vMinf3(+MathHelper::Infinity, +MathHelper::Infinity, +MathHelper::Infinity);
-    XMFLOAT3 vMaxf3(-MathHelper::Infinity, -MathHelper::Infinity, -MathHelper::Infinity);
-
-    XMVECTOR vMin = XMLoadFloat3(&vMinf3);
-    XMVECTOR vMax = XMLoadFloat3(&vMaxf3);
-
-    std::vector<Vertex> vertices(vcount);
-    for (UINT i = 0; i < vcount; i++)
-    {
-        fin >> vertices[i].Pos.x >> vertices[i].Pos.y >> vertices[i].Pos.z;
-        fin >> vertices[i].Normal.x >> vertices[i].Normal.y >> vertices[i].Normal.z;
-
-        XMVECTOR P = XMLoadFloat3(&vertices[i].Pos);
-
-        XMFLOAT3 spherePos;
-        XMStoreFloat3(&spherePos, XMVector3Normalize(P));
-
-        float theta = atan2f(spherePos.z, spherePos.x);
+    // Simplification takes hundreds of milliseconds, full detail skull is drawn until levels are built.
+    _lodStreamer.Request<MeshLodChain>([skull]() { return std::make_shared<const MeshLodChain>(MeshSimplifier::BuildLodChain(*skull)); },
+        AssetPriority::Normal, [this](const std::shared_ptr<const MeshLodChain>& lods) { _builtSkullLods = lods; });
 
-        if (theta < 0.0f)
-            theta += XM_2PI;
+    const UINT vbByteSize = skull->VertexBufferByteSize();
+    const UINT ibByteSize = (UINT)skull->Indices.size() * sizeof(UINT);
 
-        float phi = acosf(spherePos.y);
+    auto geo = std::make_unique<MeshGeometry>();
+    geo->Name = "skullGeo";
 
-        float u = theta / (2.0f * XM_PI);
-        float v = phi / XM_PI;
+    geo->VertexBufferGPU = D3DUtil::CreateDefaultBuffer(_device.Get(), _commandList.Get(), skull->GetVertices<Vertex>(), vbByteSize, geo->VertexBufferUploader);
+    geo->IndexBufferGPU = D3DUtil::CreateDefaultBuffer(_device.Get(), _commandList.Get(), skull->Indices.data(), ibByteSize, geo->IndexBufferUploader);
 
-        vertices[i].Uv = {u, v};
+    geo->VertexByteStride = sizeof(Vertex);
+    geo->VertexBufferByteSize = vbByteSize;
+    geo->IndexFormat = DXGI_FORMAT_R32_UINT;
+    geo->IndexBufferByteSize = ibByteSize;
 
-        vMin = XMVectorMin(vMin, P);
-        vMax = XMVectorMax(vMax, P);
-    }
-    BoundingBox bounds;
-    XMStoreFloat3(&bounds.Center, 0.5f * (vMin + vMax));
-    XMStoreFloat3(&bounds.Extents, 0.5f * (vMax - vMin));
+    SubmeshGeometry submesh = skull->CreateSubmesh();
+    geo->DrawArgs["skull"] = submesh;
+    _geometries[geo->Name] = move(geo);
+}
 
-    fin >> ignore;
-    fin >> ignore;
-    fin >> ignore;
+void Instancing::BuildSkullLods()
+{
+    _skullLods = *_builtSkullLods;
+    _builtSkullLods = nullptr;
 
-    std::vector<std::int32_t> indices(3 * tcount);
-    for (UINT i = 0; i < tcount; i++)
-    {
-        fin >> indices[i * 3 + 0] >> indices[i * 3 + 1] >> indices[i * 3 + 2];
-    }
-    fin.close();
+    // Levels are appended to one index buffer and index vertices of full detail skull.
+    std::vector<UINT> indices;
+    for (const auto& level : _skullLods.Levels)
+        indices.insert(indices.end(), level.Indices.begin(), level.Indices.end());
 
-    const UINT vbByteSize = (UINT)vertices.size() * sizeof(Vertex);
-    const UINT ibByteSize = (UINT)indices.size() * sizeof(int32_t);
+    const UINT ibByteSize = (UINT)indices.size() * sizeof(UINT);
+    MeshGeometry* skullGeo = _geometries["skullGeo"].get();
 
     auto geo = std::make_unique<MeshGeometry>();
-    geo->Name = "skullGeo";
+    geo->Name = "skullLodGeo";
 
-    geo->VertexBufferGPU = D3DUtil::CreateDefaultBuffer(_device.Get(), _commandList.Get(), vertices.data(), vbByteSize, geo->VertexBufferUploader);
+    geo->VertexBufferGPU = skullGeo->VertexBufferGPU;
     geo->IndexBufferGPU = D3DUtil::CreateDefaultBuffer(_device.Get(), _commandList.Get(), indices.data(), ibByteSize, geo->IndexBufferUploader);
 
-    geo->VertexByteStride = sizeof(Vertex);
-    geo->VertexBufferByteSize = vbByteSize;
+    geo->VertexByteStride = skullGeo->VertexByteStride;
+    geo->VertexBufferByteSize = skullGeo->VertexBufferByteSize;
     geo->IndexFormat = DXGI_FORMAT_R32_UINT;
     geo->IndexBufferByteSize = ibByteSize;
 
-    SubmeshGeometry submesh;
-    submesh.IndexCount = (UINT)indices.size();
-    submesh.StartIndexLocation = 0;
-    submesh.BaseVertexLocation = 0;
-    geo->DrawArgs["skull"] = submesh;
+    _skullRenderItem->Lods.clear();
+    UINT startIndex = 0;
+    for (size_t i = 0; i < _skullLods.Levels.size(); i++)
+    {
+        SubmeshGeometry submesh = skullGeo->DrawArgs["skull"];
+        submesh.IndexCount = (UINT)_skullLods.Levels[i].Indices.size();
+        submesh.StartIndexLocation = startIndex;
+        geo->DrawArgs[i == 0 ? "skull" : "skullLod" + std::to_string(i)] = submesh;
+        startIndex += submesh.IndexCount;
+
+        RenderItem::Lod lod;
+        lod.IndexCount = submesh.IndexCount;
+        lod.StartIndexLocation = submesh.StartIndexLocation;
+        _skullRenderItem->Lods.push_back(lod);
+    }
+    _skullRenderItem->Geo = geo.get();
+    _skullRenderItem->LodChain = &_skullLods;
     _geometries[geo->Name] = move(geo);
 }
 
@@ -636,6 +675,12 @@ void Instancing::BuildRenderItems()
     skullRenderItem->StartIndexLocation = skullRenderItem->Geo->DrawArgs["skull"].StartIndexLocation;
     skullRenderItem->BaseVertexLocation = skullRenderItem->Geo->DrawArgs["skull"].BaseVertexLocation;
     skullRenderItem->Bounds = skullRenderItem->Geo->DrawArgs["skull"].Bounds;
+    // Single full detail level until BuildSkullLods gets simplified ones.
+    RenderItem::Lod lod;
+    lod.IndexCount = skullRenderItem->IndexCount;
+    lod.StartIndexLocation = skullRenderItem->StartIndexLocation;
+    skullRenderItem->Lods.push_back(lod);
+    _skullRenderItem = skullRenderItem.get();
 
     const int n = cbrt(_numInstances);
     skullRenderItem->Instances.resize(n * n * n);
@@ -684,10 +729,18 @@ void Instancing::DrawRenderItems(ID3D12GraphicsCommandList* cmdList, const std::
         cmdList->IASetIndexBuffer(&ri->Geo->IndexBufferView());
         cmdList->IASetPrimitiveTopology(ri->PrimitiveType);
 
+        // SV_InstanceID starts from 0 for every draw, so level instances are bound from their offset.
         auto instanceBuffer = _currFrameResource->InstanceBuffer->Resource();
-        _commandList->SetGraphicsRootShaderResourceView(0, instanceBuffer->GetGPUVirtualAddress());
+        for (const auto& lod : ri->Lods)
+        {
+            if (lod.InstanceCount == 0)
+                continue;
+
+            D3D12_GPU_VIRTUAL_ADDRESS instanceAddress = instanceBuffer->GetGPUVirtualAddress() + lod.StartInstanceLocation * sizeof(FrameResource::InstanceData);
+            _commandList->SetGraphicsRootShaderResourceView(0, instanceAddress);
 
-        cmdList->DrawIndexedInstanced(ri->IndexCount, ri->InstanceCount, ri->StartIndexLocation, ri->BaseVertexLocation, 0);
+            cmdList->DrawIndexedInstanced(lod.IndexCount, lod.InstanceCount, lod.StartIndexLocation, ri->BaseVertexLocation, 0);
+        }
     }
 }
 }
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include "InstancingRenderItem.h"
 #include "InstancingFrameResource.h"
 #include "../../../Core/Camera.h"
+#include "../../../Core/AssetStreamer.h"
 
 namespace DX12Samples
 {
@@ -88,9 +89,14 @@ protected:
      */
     void BuildShaderAndInputLayout();
     /**
-     * \brief Build geometry for sull.
+     * \brief Build geometry for full detail skull and request its levels of detail from I/O thread.
      */
     void BuildSkullGeometry();
+    /**
+     * \brief Upload simplified skull levels with current command list and switch skull render item to them,
+     * all levels share vertex buffer of full detail skull.
+     */
+    void BuildSkullLods();
     /**
      * \brief Build pipline state objects.
      */
@@ -134,6 +140,11 @@ private:
     std::vector<InstancingRenderItem*> _opaqueRenderItems;
 
     bool _frustumCullingEnabled = true;
+    bool _lodEnabled = true;
+    MeshLodChain _skullLods;
+    std::shared_ptr<const MeshLodChain> _builtSkullLods;
+    InstancingRenderItem* _skullRenderItem = nullptr;
+    AssetStreamer _lodStreamer{ 1 };
     DirectX::BoundingFrustum _camFrustum;
     InstancingFrameResource::PassConstants _passCB;
     Camera _camera;
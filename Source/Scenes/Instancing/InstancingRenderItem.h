@@ -9,6 +9,7 @@
 
 #include "InstancingFrameResource.h"
 #include "../../Core/D3DUtil.h"
+#include "../../../Core/MeshSimplifier.h"
 
 namespace DX12Samples
 {
@@ -35,5 +36,18 @@ struct InstancingRenderItem
     UINT InstanceCount = 0;
     UINT StartIndexLocation = 0;
     UINT BaseVertexLocation = 0;
+
+    /**
+     * \brief Index range of level of detail and range of visible instances which use it in instance buffer.
+     */
+    struct Lod
+    {
+        UINT IndexCount = 0;
+        UINT StartIndexLocation = 0;
+        UINT InstanceCount = 0;
+        UINT StartInstanceLocation = 0;
+    };
+    const MeshLodChain* LodChain = nullptr;
+    std::vector<Lod> Lods;
 };
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include "LitColumns.h"
 
+#include "../../../Core/BoundsBuilder.h"
 #include "../../../Core/GeometryGenerator.h"
+#include "../../../Core/MeshAsset.h"
 
 namespace DX12Samples
 {
@@ -333,25 +335,12 @@ void LitColumns::BuildShapeGeometry()
     UINT sphereIndexOffset = gridIndexOffset + (UINT)grid.Indices32.size();
     UINT cylinderIndexOffset = sphereIndexOffset + (UINT)sphere.Indices32.size();
 
-    SubmeshGeometry boxSubmesh;
-    boxSubmesh.IndexCount = (UINT)box.Indices32.size();
-    boxSubmesh.StartIndexLocation = boxIndexOffset;
-    boxSubmesh.BaseVertexLocation = boxVertexOffset;
+    BoundsBuilder boundsBuilder;
 
-    SubmeshGeometry gridSubmesh;
-    gridSubmesh.IndexCount = (UINT)grid.Indices32.size();
-    gridSubmesh.StartIndexLocation = gridIndexOffset;
-    gridSubmesh.BaseVertexLocation = gridVertexOffset;
-
-    SubmeshGeometry sphereSubmesh;
-    sphereSubmesh.IndexCount = (UINT)sphere.Indices32.size();
-    sphereSubmesh.StartIndexLocation = sphereIndexOffset;
-    sphereSubmesh.BaseVertexLocation = sphereVertexOffset;
-
-    SubmeshGeometry cylinderSubmesh;
-    cylinderSubmesh.IndexCount = (UINT)cylinder.Indices32.size();
-    cylinderSubmesh.StartIndexLocation = cylinderIndexOffset;
-    cylinderSubmesh.BaseVertexLocation = cylinderVertexOffset;
+    SubmeshGeometry boxSubmesh = boundsBuilder.CreateSubmesh(box, boxIndexOffset, boxVertexOffset);
+    SubmeshGeometry gridSubmesh = boundsBuilder.CreateSubmesh(grid, gridIndexOffset, gridVertexOffset);
+    SubmeshGeometry sphereSubmesh = boundsBuilder.CreateSubmesh(sphere, sphereIndexOffset, sphereVertexOffset);
+    SubmeshGeometry cylinderSubmesh = boundsBuilder.CreateSubmesh(cylinder, cylinderIndexOffset, cylinderVertexOffset);
 
     auto totalVertexCount =
         box.Vertices.size() +
@@ -425,57 +414,28 @@ void LitColumns::BuildShapeGeometry()
 
 void LitColumns::BuildSkullGeometry()
 {
-    std::ifstream fin("Models\\skull.txt");
-
-    if (!fin)
+    auto skull = MeshAssetCache::Instance().Load("Models\\skull.txt", MeshVertexLayout::PosNormal);
+    if (skull == nullptr)
     {
-        MessageBox(0, L"Models\\scull.txt not found", nullptr, 0);
+        MessageBox(0, L"Models\\skull.txt not found", nullptr, 0);
         return;
     }
 
-    UINT vcount = 0;
-    UINT tcount = 0;
-    std::string ignore;
-
-    fin >> ignore >> vcount;
-    fin >> ignore >> tcount;
-    fin >> ignore >> ignore >> ignore >> ignore;
-
-    std::vector<Vertex> vertices(vcount);
-    for (UINT i = 0; i < vcount; i++)
-    {
-        fin >> vertices[i].Pos.x >> vertices[i].Pos.y >> vertices[i].Pos.z;
-        fin >> vertices[i].Normal.x >> vertices[i].Normal.y >> vertices[i].Normal.z;
-    }
-    fin >> ignore;
-    fin >> ignore;
-    fin >> ignore;
-
-    std::vector<std::int32_t> indices(3 * tcount);
-    for (UINT i = 0; i < tcount; i++)
-    {
-        fin >> indices[i * 3 + 0] >> indices[i * 3 + 1] >> indices[i * 3 + 2];
-    }
-    fin.close();
-
-    const UINT vbByteSize = (UINT)vertices.size() * sizeof(Vertex);
-    const UINT ibByteSize = (UINT)indices.size() * sizeof(int32_t);
+    const UINT vbByteSize = skull->VertexBufferByteSize();
+    const UINT ibByteSize = skull->IndexBufferByteSize();
 
     auto geo = std::make_unique<MeshGeometry>();
     geo->Name = "skullGeo";
 
-    geo->VertexBufferGPU = D3DUtil::CreateDefaultBuffer(_device.Get(), _commandList.Get(), vertices.data(), vbByteSize, geo->VertexBufferUploader);
-    geo->IndexBufferGPU = D3DUtil::CreateDefaultBuffer(_device.Get(), _commandList.Get(), indices.data(), ibByteSize, geo->IndexBufferUploader);
+    geo->VertexBufferGPU = D3DUtil::CreateDefaultBuffer(_device.Get(), _commandList.Get(), skull->GetVertices<Vertex>(), vbByteSize, geo->VertexBufferUploader);
+    geo->IndexBufferGPU = D3DUtil::CreateDefaultBuffer(_device.Get(), _commandList.Get(), skull->Indices.data(), ibByteSize, geo->IndexBufferUploader);
 
     geo->VertexByteStride = sizeof(Vertex);
     geo->VertexBufferByteSize = vbByteSize;
     geo->IndexFormat = DXGI_FORMAT_R32_UINT;
     geo->IndexBufferByteSize = ibByteSize;
 
-    SubmeshGeometry submesh;
-    submesh.IndexCount = (UINT)indices.size();
-    submesh.StartIndexLocation = 0;
-    submesh.BaseVertexLocation = 0;
+    SubmeshGeometry submesh = skull->CreateSubmesh();
     geo->DrawArgs["skull"] = submesh;
     _geometries[geo->Name] = move(geo);
 }
@@ -1,5 +1,6 @@
 #include "LitWaves.h"
 
+#include "../../../Core/BoundsBuilder.h"
 #include "../../../Core/GeometryGenerator.h"
 
 namespace DX12Samples
@@ -354,10 +355,8 @@ void LitWaves::BuildLandGeometry()
     geo->IndexFormat = DXGI_FORMAT_R16_UINT;
     geo->IndexBufferByteSize = ibByteSize;
 
-    SubmeshGeometry submesh;
-    submesh.IndexCount = (UINT)indices.size();
-    submesh.StartIndexLocation = 0;
-    submesh.BaseVertexLocation = 0;
+    SubmeshGeometry submesh = BoundsBuilder().CreateSubmesh(&vertices[0].Pos, (UINT)vertices.size(), sizeof(LitWavesFrameResource::Vertex),
+        (UINT)indices.size(), 0, 0);
 
     geo->DrawArgs["grid"] = submesh;
     _geometries["landGeo"] = std::move(geo);
@@ -403,10 +402,8 @@ void LitWaves::BuildWavesGeometryBuffers()
     geo->IndexFormat = DXGI_FORMAT_R16_UINT;
     geo->IndexBufferByteSize = ibByteSize;
 
-    SubmeshGeometry submesh;
-    submesh.IndexCount = (UINT)indices.size();
-    submesh.StartIndexLocation = 0;
-    submesh.BaseVertexLocation = 0;
+    SubmeshGeometry submesh = BoundsBuilder().CreateSubmesh(&_waves->Position(0), (UINT)_waves->VertexCount(), sizeof(XMFLOAT3),
+        (UINT)indices.size(), 0, 0);
 
     geo->DrawArgs["grid"] = submesh;
     _geometries["waterGeo"] = move(geo);
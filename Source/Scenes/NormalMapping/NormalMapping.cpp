@@ -1,5 +1,6 @@
 #include "NormalMapping.h"
 
+#include "../../../Core/BoundsBuilder.h"
 #include "../../../Core/GeometryGenerator.h"
 
 namespace DX12Samples
@@ -410,25 +411,12 @@ void NormalMapping::BuildShapeGeometry()
     UINT sphereIndexOffset = gridIndexOffset + (UINT)grid.Indices32.size();
     UINT cylinderIndexOffset = sphereIndexOffset + (UINT)sphere.Indices32.size();
 
-    SubmeshGeometry boxSubmesh;
-    boxSubmesh.IndexCount = (UINT)box.Indices32.size();
-    boxSubmesh.StartIndexLocation = boxIndexOffset;
-    boxSubmesh.BaseVertexLocation = boxVertexOffset;
+    BoundsBuilder boundsBuilder;
 
-    SubmeshGeometry gridSubmesh;
-    gridSubmesh.IndexCount = (UINT)grid.Indices32.size();
-    gridSubmesh.StartIndexLocation = gridIndexOffset;
-    gridSubmesh.BaseVertexLocation = gridVertexOffset;
-
-    SubmeshGeometry sphereSubmesh;
-    sphereSubmesh.IndexCount = (UINT)sphere.Indices32.size();
-    sphereSubmesh.StartIndexLocation = sphereIndexOffset;
-    sphereSubmesh.BaseVertexLocation = sphereVertexOffset;
-
-    SubmeshGeometry cylinderSubmesh;
-    cylinderSubmesh.IndexCount = (UINT)cylinder.Indices32.size();
-    cylinderSubmesh.StartIndexLocation = cylinderIndexOffset;
-    cylinderSubmesh.BaseVertexLocation = cylinderVertexOffset;
+    SubmeshGeometry boxSubmesh = boundsBuilder.CreateSubmesh(box, boxIndexOffset, boxVertexOffset);
+    SubmeshGeometry gridSubmesh = boundsBuilder.CreateSubmesh(grid, gridIndexOffset, gridVertexOffset);
+    SubmeshGeometry sphereSubmesh = boundsBuilder.CreateSubmesh(sphere, sphereIndexOffset, sphereVertexOffset);
+    SubmeshGeometry cylinderSubmesh = boundsBuilder.CreateSubmesh(cylinder, cylinderIndexOffset, cylinderVertexOffset);
 
     auto totalVertexCount =
         box.Vertices.size() +
@@ -619,6 +607,7 @@ void NormalMapping::BuildRenderItems()
     skyRitem->IndexCount = skyRitem->Geo->DrawArgs["sphere"].IndexCount;
     skyRitem->StartIndexLocation = skyRitem->Geo->DrawArgs["sphere"].StartIndexLocation;
     skyRitem->BaseVertexLocation = skyRitem->Geo->DrawArgs["sphere"].BaseVertexLocation;
+    skyRitem->Bounds = skyRitem->Geo->DrawArgs["sphere"].Bounds;
     _renderItemLayer[(int)RenderLayer::Sky].push_back(skyRitem.get());
     _allRenderItems.push_back(move(skyRitem));
 
@@ -632,6 +621,7 @@ void NormalMapping::BuildRenderItems()
     boxRitem->IndexCount = boxRitem->Geo->DrawArgs["box"].IndexCount;
     boxRitem->StartIndexLocation = boxRitem->Geo->DrawArgs["box"].StartIndexLocation;
     boxRitem->BaseVertexLocation = boxRitem->Geo->DrawArgs["box"].BaseVertexLocation;
+    boxRitem->Bounds = boxRitem->Geo->DrawArgs["box"].Bounds;
     _renderItemLayer[(int)RenderLayer::Opaque].push_back(boxRitem.get());
     _allRenderItems.push_back(move(boxRitem));
 
@@ -645,6 +635,7 @@ void NormalMapping::BuildRenderItems()
     globeRitem->IndexCount = globeRitem->Geo->DrawArgs["sphere"].IndexCount;
     globeRitem->StartIndexLocation = globeRitem->Geo->DrawArgs["sphere"].StartIndexLocation;
     globeRitem->BaseVertexLocation = globeRitem->Geo->DrawArgs["sphere"].BaseVertexLocation;
+    globeRitem->Bounds = globeRitem->Geo->DrawArgs["sphere"].Bounds;
     _renderItemLayer[(int)RenderLayer::Opaque].push_back(globeRitem.get());
     _allRenderItems.push_back(move(globeRitem));
 
@@ -658,6 +649,7 @@ void NormalMapping::BuildRenderItems()
     gridRitem->IndexCount = gridRitem->Geo->DrawArgs["grid"].IndexCount;
     gridRitem->StartIndexLocation = gridRitem->Geo->DrawArgs["grid"].StartIndexLocation;
     gridRitem->BaseVertexLocation = gridRitem->Geo->DrawArgs["grid"].BaseVertexLocation;
+    gridRitem->Bounds = gridRitem->Geo->DrawArgs["grid"].Bounds;
     _renderItemLayer[(int)RenderLayer::Opaque].push_back(gridRitem.get());
     _allRenderItems.push_back(move(gridRitem));
 
@@ -685,6 +677,7 @@ void NormalMapping::BuildRenderItems()
         leftCylRitem->IndexCount = leftCylRitem->Geo->DrawArgs["cylinder"].IndexCount;
         leftCylRitem->StartIndexLocation = leftCylRitem->Geo->DrawArgs["cylinder"].StartIndexLocation;
         leftCylRitem->BaseVertexLocation = leftCylRitem->Geo->DrawArgs["cylinder"].BaseVertexLocation;
+        leftCylRitem->Bounds = leftCylRitem->Geo->DrawArgs["cylinder"].Bounds;
 
         XMStoreFloat4x4(&rightCylRitem->Model, leftCylWorld);
         XMStoreFloat4x4(&rightCylRitem->TexTransform, brickTexTransform);
@@ -695,6 +688,7 @@ void NormalMapping::BuildRenderItems()
         rightCylRitem->IndexCount = rightCylRitem->Geo->DrawArgs["cylinder"].IndexCount;
         rightCylRitem->StartIndexLocation = rightCylRitem->Geo->DrawArgs["cylinder"].StartIndexLocation;
         rightCylRitem->BaseVertexLocation = rightCylRitem->Geo->DrawArgs["cylinder"].BaseVertexLocation;
+        rightCylRitem->Bounds = rightCylRitem->Geo->DrawArgs["cylinder"].Bounds;
 
         XMStoreFloat4x4(&leftSphereRitem->Model, leftSphereWorld);
         leftSphereRitem->TexTransform = MathHelper::Identity4x4();
@@ -705,6 +699,7 @@ void NormalMapping::BuildRenderItems()
         leftSphereRitem->IndexCount = leftSphereRitem->Geo->DrawArgs["sphere"].IndexCount;
         leftSphereRitem->StartIndexLocation = leftSphereRitem->Geo->DrawArgs["sphere"].StartIndexLocation;
         leftSphereRitem->BaseVertexLocation = leftSphereRitem->Geo->DrawArgs["sphere"].BaseVertexLocation;
+        leftSphereRitem->Bounds = leftSphereRitem->Geo->DrawArgs["sphere"].Bounds;
 
         XMStoreFloat4x4(&rightSphereRitem->Model, rightSphereWorld);
         rightSphereRitem->TexTransform = MathHelper::Identity4x4();
@@ -715,6 +710,7 @@ void NormalMapping::BuildRenderItems()
         rightSphereRitem->IndexCount = rightSphereRitem->Geo->DrawArgs["sphere"].IndexCount;
         rightSphereRitem->StartIndexLocation = rightSphereRitem->Geo->DrawArgs["sphere"].StartIndexLocation;
         rightSphereRitem->BaseVertexLocation = rightSphereRitem->Geo->DrawArgs["sphere"].BaseVertexLocation;
+        rightSphereRitem->Bounds = rightSphereRitem->Geo->DrawArgs["sphere"].Bounds;
 
         _renderItemLayer[(int)RenderLayer::Opaque].push_back(leftCylRitem.get());
         _renderItemLayer[(int)RenderLayer::Opaque].push_back(rightCylRitem.get());
@@ -2,6 +2,7 @@
 
 #include "../DynamicIndexing/DynamicIndexingFrameResource.h"
 #include "../../../Core/GeometryGenerator.h"
+#include "../../../Core/MeshAsset.h"
 
 namespace DX12Samples
 {
@@ -339,64 +340,29 @@ void Picking::BuildShaderAndInputLayout()
 
 void Picking::BuildCarGeometry()
 {
-    std::ifstream fin("Models/car.txt");
-    if (!fin)
+    auto car = MeshAssetCache::Instance().Load("Models/car.txt", MeshVertexLayout::PosNormalUv);
+    if (car == nullptr)
     {
-        MessageBox(0, L"Models/car.txt not found", 0, 0);
+        MessageBox(0, L"Models/car.txt not found", nullptr, 0);
         return;
     }
-    UINT vcount = 0;
-    UINT tcount = 0;
-    std::string ignore;
 
-    fin >> ignore >> vcount;
-    fin >> ignore >> tcount;
-    fin >> ignore >> ignore >> ignore >> ignore;
+    _carMeshlets = MeshletBuilder::Build(*car);
+    std::vector<UINT> indices = _carMeshlets.GetTriangleIndices();
 
-    XMFLOAT3 vMinf3(+MathHelper::Infinity, +MathHelper::Infinity, +MathHelper::Infinity);
-    XMFLOAT3 vMaxf3(-MathHelper::Infinity, -MathHelper::Infinity, -MathHelper::Infinity);
-
-    XMVECTOR vMin = XMLoadFloat3(&vMinf3);
-    XMVECTOR vMax = XMLoadFloat3(&vMaxf3);
-
-    std::vector<Vertex> vertices(vcount);
-
-    for (UINT i = 0; i < vcount; i++)
-    {
-        fin >> vertices[i].Pos.x >> vertices[i].Pos.y >> vertices[i].Pos.z;
-        fin >> vertices[i].Normal.x >> vertices[i].Normal.y >> vertices[i].Normal.z;
-
-        XMVECTOR P = XMLoadFloat3(&vertices[i].Pos);
-        vertices[i].Uv = { 0.0f, 0.0f };
-        vMin = XMVectorMin(vMin, P);
-        vMax = XMVectorMax(vMax, P);
-    }
-    BoundingBox bounds;
-    XMStoreFloat3(&bounds.Center, 0.5f * (vMin + vMax));
-    XMStoreFloat3(&bounds.Extents, 0.5f * (vMax - vMin));
-
-    fin >> ignore;
-    fin >> ignore;
-    fin >> ignore;
-
-    std::vector<std::int32_t> indices(3 * tcount);
-    for (UINT i = 0; i < tcount; i++)
-        fin >> indices[i * 3 + 0] >> indices[i * 3 + 1] >> indices[i * 3 + 2];
-    fin.close();
-
-    const UINT vbByteSize = (UINT)vertices.size() * sizeof(Vertex);
-    const UINT ibByteSize = (UINT)indices.size() * sizeof(int32_t);
+    const UINT vbByteSize = car->VertexBufferByteSize();
+    const UINT ibByteSize = (UINT)indices.size() * sizeof(UINT);
 
     auto geo = std::make_unique<MeshGeometry>();
     geo->Name = "carGeo";
 
     ThrowIfFailed(D3DCreateBlob(vbByteSize, &geo->VertexBufferCPU));
-    CopyMemory(geo->VertexBufferCPU->GetBufferPointer(), vertices.data(), vbByteSize);
+    CopyMemory(geo->VertexBufferCPU->GetBufferPointer(), car->GetVertices<Vertex>(), vbByteSize);
 
     ThrowIfFailed(D3DCreateBlob(ibByteSize, &geo->IndexBufferCPU));
     CopyMemory(geo->IndexBufferCPU->GetBufferPointer(), indices.data(), ibByteSize);
 
-    geo->VertexBufferGPU = D3DUtil::CreateDefaultBuffer(_device.Get(), _commandList.Get(), vertices.data(), vbByteSize, geo->VertexBufferUploader);
+    geo->VertexBufferGPU = D3DUtil::CreateDefaultBuffer(_device.Get(), _commandList.Get(), car->GetVertices<Vertex>(), vbByteSize, geo->VertexBufferUploader);
     geo->IndexBufferGPU = D3DUtil::CreateDefaultBuffer(_device.Get(), _commandList.Get(), indices.data(), ibByteSize, geo->IndexBufferUploader);
 
     geo->VertexByteStride = sizeof(Vertex);
@@ -404,11 +370,8 @@ void Picking::BuildCarGeometry()
     geo->IndexFormat = DXGI_FORMAT_R32_UINT;
     geo->IndexBufferByteSize = ibByteSize;
 
-    SubmeshGeometry submesh;
-    submesh.IndexCount = (UINT)indices.size();
-    submesh.StartIndexLocation = 0;
-    submesh.BaseVertexLocation = 0;
-    submesh.Bounds = bounds;
+    // Meshlet order draws same triangles, so submesh of whole car fits.
+    SubmeshGeometry submesh = car->CreateSubmesh();
     geo->DrawArgs["car"] = submesh;
     _geometries[geo->Name] = move(geo);
 }
@@ -588,34 +551,43 @@ void Picking::Pick(int sx, int sy)
         {
             auto vertices = (Vertex*)geo->VertexBufferCPU->GetBufferPointer();
             auto indices = (std::uint32_t*)geo->IndexBufferCPU->GetBufferPointer();
-            UINT triCount = ri->IndexCount / 3;
             tmin = MathHelper::Infinity;
-            for (UINT i = 0; i < triCount; i++)
+            for (size_t m = 0; m < _carMeshlets.Meshlets.size(); m++)
             {
-                UINT i0 = indices[i * 3 + 0];
-                UINT i1 = indices[i * 3 + 1];
-                UINT i2 = indices[i * 3 + 2];
-
-                XMVECTOR v0 = XMLoadFloat3(&vertices[i0].Pos);
-                XMVECTOR v1 = XMLoadFloat3(&vertices[i1].Pos);
-                XMVECTOR v2 = XMLoadFloat3(&vertices[i2].Pos);
-                    
-                float t = 0.0f;
-                if (TriangleTests::Intersects(rayOrigin, rayDir, v0, v1, v2, t))
+                // Broad phase: triangles of meshlet are tested only if ray hits its sphere.
+                const Meshlet& meshlet = _carMeshlets.Meshlets[m];
+                const MeshletBounds& bounds = _carMeshlets.Bounds[m];
+                float sphereT = 0.0f;
+                if (!BoundingSphere(bounds.Center, bounds.Radius).Intersects(rayOrigin, rayDir, sphereT))
+                    continue;
+
+                for (UINT i = meshlet.PrimitiveOffset; i < meshlet.PrimitiveOffset + meshlet.PrimitiveCount; i++)
                 {
-                    if (t < tmin)
+                    UINT i0 = indices[i * 3 + 0];
+                    UINT i1 = indices[i * 3 + 1];
+                    UINT i2 = indices[i * 3 + 2];
+
+                    XMVECTOR v0 = XMLoadFloat3(&vertices[i0].Pos);
+                    XMVECTOR v1 = XMLoadFloat3(&vertices[i1].Pos);
+                    XMVECTOR v2 = XMLoadFloat3(&vertices[i2].Pos);
+
+                    float t = 0.0f;
+                    if (TriangleTests::Intersects(rayOrigin, rayDir, v0, v1, v2, t))
                     {
-                        tmin = t;
-                        UINT pickedTriangle = i;
+                        if (t < tmin)
+                        {
+                            tmin = t;
+                            UINT pickedTriangle = i;
 
-                        _pickedRenderItem->Visible = true;
-                        _pickedRenderItem->IndexCount = 3;
-                        _pickedRenderItem->BaseVertexLocation = 0;
+                            _pickedRenderItem->Visible = true;
+                            _pickedRenderItem->IndexCount = 3;
+                            _pickedRenderItem->BaseVertexLocation = 0;
 
-                        _pickedRenderItem->Model = ri->Model;
-                        _pickedRenderItem->NumFramesDirty = FrameResource::NumFrameResources;
+                            _pickedRenderItem->Model = ri->Model;
+                            _pickedRenderItem->NumFramesDirty = FrameResource::NumFrameResources;
 
-                        _pickedRenderItem->StartIndexLocation = 3 * pickedTriangle;
+                            _pickedRenderItem->StartIndexLocation = 3 * pickedTriangle;
+                        }
                     }
                 }
             }
@@ -9,6 +9,7 @@
 #include "../../Common/RenderItem.h"
 #include "../DynamicIndexing/DynamicIndexingFrameResource.h"
 #include "../../../Core/Camera.h"
+#include "../../../Core/MeshletBuilder.h"
 
 namespace DX12Samples
 {
@@ -137,6 +138,7 @@ private:
     std::vector<RenderItem*> _renderItemLayer[(int)RenderItem::RenderLayer::Count];
 
     RenderItem* _pickedRenderItem;
+    MeshletData _carMeshlets; // Car index buffer is in meshlet order, so picking tests only triangles of meshlets the ray hits.
 
     DynamicIndexingFrameResource::PassConstants _mainPassCB;
 
@@ -124,6 +124,10 @@ protected:
      * \brief Build scene objects.
      */
     void BuildRenderItems();
+    /**
+     * \brief Fit scene bounds, which shadow map covers, to world space bounds of opaque items.
+     */
+    void BuildSceneBounds();
     /**
      * \brief Draw scene objects.
      */
@@ -1,6 +1,8 @@
 #include "Shapes.h"
 
+#include "../../../Core/BoundsBuilder.h"
 #include "../../../Core/GeometryGenerator.h"
+#include "../../../Core/MeshAsset.h"
 
 namespace DX12Samples
 {
@@ -327,51 +329,39 @@ void Shapes::BuildShapeGeometry()
     GeometryGenerator geoGen;
     GeometryGenerator::MeshData box = geoGen.CreateBox(1.5f, 0.5f, 1.5f, 3);
     GeometryGenerator::MeshData grid = geoGen.CreateGrid(20.0f, 30.0f, 60, 40);
-    GeometryGenerator::MeshData skull = ParseFile("Models\\skull.txt");
     GeometryGenerator::MeshData sphere = geoGen.CreateSphere(0.5f, 20, 20);
     GeometryGenerator::MeshData cylinder = geoGen.CreateCylinder(0.5f, 0.3f, 3.0f, 20, 20);
+    auto skull = MeshAssetCache::Instance().Load("Models\\skull.txt", MeshVertexLayout::PosNormal);
+    if (skull == nullptr)
+    {
+        MessageBox(0, L"Models\\skull.txt not found", nullptr, 0);
+        return;
+    }
 
     UINT boxVertexOffset = 0;
     UINT gridVertexOffset = (UINT)box.Vertices.size();
     UINT skullVertexOffset = gridVertexOffset + (UINT)grid.Vertices.size();
-    UINT sphereVertexOffset = skullVertexOffset + (UINT)skull.Vertices.size();
+    UINT sphereVertexOffset = skullVertexOffset + skull->VertexCount;
     UINT cylinderVertexOffset = sphereVertexOffset + (UINT)sphere.Vertices.size();
 
     UINT boxIndexOffset = 0;
     UINT gridIndexOffset = (UINT)box.Indices32.size();
     UINT skullIndexOffset = gridIndexOffset + (UINT)grid.Indices32.size();
-    UINT sphereIndexOffset = skullIndexOffset + (UINT)skull.Indices32.size();
+    UINT sphereIndexOffset = skullIndexOffset + (UINT)skull->Indices.size();
     UINT cylinderIndexOffset = sphereIndexOffset + (UINT)sphere.Indices32.size();
 
-    SubmeshGeometry boxSubmesh;
-    boxSubmesh.IndexCount = (UINT)box.Indices32.size();
-    boxSubmesh.StartIndexLocation = boxIndexOffset;
-    boxSubmesh.BaseVertexLocation = boxVertexOffset;
-
-    SubmeshGeometry gridSubmesh;
-    gridSubmesh.IndexCount = (UINT)grid.Indices32.size();
-    gridSubmesh.StartIndexLocation = gridIndexOffset;
-    gridSubmesh.BaseVertexLocation = gridVertexOffset;
-
-    SubmeshGeometry skullSubmesh;
-    skullSubmesh.IndexCount = (UINT)skull.Indices32.size();
-    skullSubmesh.StartIndexLocation = skullIndexOffset;
-    skullSubmesh.BaseVertexLocation = skullVertexOffset;
+    BoundsBuilder boundsBuilder;
 
-    SubmeshGeometry sphereSubmesh;
-    sphereSubmesh.IndexCount = (UINT)sphere.Indices32.size();
-    sphereSubmesh.StartIndexLocation = sphereIndexOffset;
-    sphereSubmesh.BaseVertexLocation = sphereVertexOffset;
-
-    SubmeshGeometry cylinderSubmesh;
-    cylinderSubmesh.IndexCount = (UINT)cylinder.Indices32.size();
-    cylinderSubmesh.StartIndexLocation = cylinderIndexOffset;
-    cylinderSubmesh.BaseVertexLocation = cylinderVertexOffset;
+    SubmeshGeometry boxSubmesh = boundsBuilder.CreateSubmesh(box, boxIndexOffset, boxVertexOffset);
+    SubmeshGeometry gridSubmesh = boundsBuilder.CreateSubmesh(grid, gridIndexOffset, gridVertexOffset);
+    SubmeshGeometry skullSubmesh = skull->CreateSubmesh(skullIndexOffset, skullVertexOffset);
+    SubmeshGeometry sphereSubmesh = boundsBuilder.CreateSubmesh(sphere, sphereIndexOffset, sphereVertexOffset);
+    SubmeshGeometry cylinderSubmesh = boundsBuilder.CreateSubmesh(cylinder, cylinderIndexOffset, cylinderVertexOffset);
 
     auto totalVertexCount =
         box.Vertices.size() +
         grid.Vertices.size() +
-        skull.Vertices.size() +
+        skull->VertexCount +
         sphere.Vertices.size() +
         cylinder.Vertices.size();
     std::vector<Vertex> vertices(totalVertexCount);
@@ -389,9 +379,9 @@ void Shapes::BuildShapeGeometry()
         vertices[k].Color = XMFLOAT4(Colors::ForestGreen);
     }
 
-    for (size_t i = 0; i < skull.Vertices.size(); i++ , k++)
+    for (UINT i = 0; i < skull->VertexCount; i++ , k++)
     {
-        vertices[k].Pos = skull.Vertices[i].Position;
+        vertices[k].Pos = skull->GetPosition(i);
         vertices[k].Color = XMFLOAT4(Colors::GhostWhite);
     }
 
@@ -410,7 +400,8 @@ void Shapes::BuildShapeGeometry()
     std::vector<uint16_t> indices;
     indices.insert(indices.end(), std::begin(box.GetIndices16()), std::end(box.GetIndices16()));
     indices.insert(indices.end(), std::begin(grid.GetIndices16()), std::end(grid.GetIndices16()));
-    indices.insert(indices.end(), std::begin(skull.GetIndices16()), std::end(skull.GetIndices16()));
+    for (UINT index : skull->Indices)
+        indices.push_back((uint16_t)index);
 
     indices.insert(indices.end(), std::begin(sphere.GetIndices16()), std::end(sphere.GetIndices16()));
     indices.insert(indices.end(), std::begin(cylinder.GetIndices16()), std::end(cylinder.GetIndices16()));
@@ -585,61 +576,4 @@ void Shapes::DrawRenderItems(ID3D12GraphicsCommandList* cmdList, const std::vect
         cmdList->DrawIndexedInstanced(ri->IndexCount, 1, ri->StartIndexLocation, ri->BaseVertexLocation, 0);
     }
 }
-
-GeometryGenerator::MeshData Shapes::ParseFile(std::string filename) const
-{
-    GeometryGenerator::MeshData data;
-    enum class ReadMode
-        {
-            Skip,
-            Verts,
-            Trigs
-        };
-    std::fstream file;
-    file.open(filename, std::fstream::in);
-
-    std::vector<float> vertData;
-    std::vector<int> trigData;
-
-    ReadMode readMode = ReadMode::Skip;
-    for (std::string line; std::getline(file, line);)
-    {
-        std::istringstream lineStream(line);
-        std::string str = lineStream.str();
-        if (str == "{" || str == "}" || str == "") continue;
-        if (str.find("VertexList") != std::string::npos)
-        {
-            readMode = ReadMode::Verts;
-            continue;
-        }
-        if (str.find("TriangleList") != std::string::npos)
-        {
-            readMode = ReadMode::Trigs;
-            continue;
-        }
-
-        if (readMode == ReadMode::Skip)
-        {
-            continue;
-        }
-        if (readMode == ReadMode::Verts)
-        {
-            float v1, v2, v3, n1, n2, n3;
-            lineStream >> v1 >> v2 >> v3 >> n1 >> n2 >> n3;
-            data.Vertices.push_back(GeometryGenerator::Vertex(v1, v2, v3, n1, n2, n3, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f));
-            continue;
-        }
-        if (readMode == ReadMode::Trigs)
-        {
-            float t1, t2, t3;
-            lineStream >> t1 >> t2 >> t3;
-            data.Indices32.push_back(t1);
-            data.Indices32.push_back(t2);
-            data.Indices32.push_back(t3);
-            continue;
-        }
-    }
-    file.close();
-    return data;
-}
 }
\ No newline at end of file
@@ -100,12 +100,6 @@ protected:
      * \brief Draw scene objects.
      */
     void DrawRenderItems(ID3D12GraphicsCommandList* cmdList, const std::vector<ShapesRenderItem*>& renderItems);
-    /**
-     * \brief Parsefile to mesh data.
-     * \param filename File name to parse.
-     * \return 
-     */
-    GeometryGenerator::MeshData ParseFile(std::string filename) const;
 
 private:
     std::vector<std::unique_ptr<ShapesFrameResource>> _frameResources;
@@ -0,0 +1,204 @@
+#include "AnimationBlendTree.h"
+
+namespace DX12Samples
+{
+using namespace DirectX;
+
+void AnimationBlendTree::Init(const SkinnedData* skinnedInfo)
+{
+    _skinnedInfo = skinnedInfo;
+    _groupCount = BoneGroupPose::GroupCount(skinnedInfo->BoneCount());
+    _nodes.clear();
+    _root = InvalidNode;
+}
+
+AnimationBlendTree::NodeIndex AnimationBlendTree::AddClip(SkinnedData::ClipHandle clip, float speed)
+{
+    Node node;
+    node.Type = NodeType::Clip;
+    node.Clip = clip;
+    node.Speed = speed;
+    node.TimePos = _skinnedInfo->GetCompiledClip(clip).GetStartTime();
+    _nodes.push_back(std::move(node));
+    return (NodeIndex)_nodes.size() - 1;
+}
+
+AnimationBlendTree::NodeIndex AnimationBlendTree::AddBlend(NodeIndex a, NodeIndex b, float weight)
+{
+    Node node;
+    node.Type = NodeType::Blend;
+    node.Inputs[0] = a;
+    node.Inputs[1] = b;
+    node.Weight = weight;
+    node.TargetWeight = weight;
+    _nodes.push_back(std::move(node));
+    return (NodeIndex)_nodes.size() - 1;
+}
+
+AnimationBlendTree::NodeIndex AnimationBlendTree::AddAdditive(NodeIndex base, NodeIndex additiveClip, float weight)
+{
+    assert(_nodes[additiveClip].Type == NodeType::Clip);
+
+    Node node;
+    node.Type = NodeType::Additive;
+    node.Inputs[0] = base;
+    node.Inputs[1] = additiveClip;
+    node.Weight = weight;
+    node.TargetWeight = weight;
+
+    const CompiledClip& clip = _skinnedInfo->GetCompiledClip(_nodes[additiveClip].Clip);
+    UINT cursor = 0;
+    node.ReferencePose.resize(_groupCount);
+    clip.Sample(clip.GetStartTime(), node.ReferencePose.data(), cursor);
+
+    _nodes.push_back(std::move(node));
+    return (NodeIndex)_nodes.size() - 1;
+}
+
+void AnimationBlendTree::SetBoneMask(NodeIndex node, UINT rootBone)
+{
+    const std::vector<int>& hierarchy = _skinnedInfo->GetBoneHierarchy();
+
+    // Parents go before children in bone order, so single pass marks whole subtree.
+    std::vector<float> weights(_groupCount * 4, 0.0f);
+    weights[rootBone] = 1.0f;
+    for (UINT i : _skinnedInfo->GetBoneOrder())
+    {
+        if (i != rootBone && hierarchy[i] >= 0)
+            weights[i] = weights[hierarchy[i]];
+    }
+
+    std::vector<XMFLOAT4>& mask = _nodes[node].BoneMask;
+    mask.resize(_groupCount);
+    for (UINT group = 0; group < _groupCount; group++)
+        mask[group] = XMFLOAT4(&weights[group * 4]);
+}
+
+void AnimationBlendTree::SetRoot(NodeIndex node)
+{
+    _root = node;
+}
+
+void AnimationBlendTree::SetWeight(NodeIndex node, float weight)
+{
+    _nodes[node].Weight = weight;
+    _nodes[node].TargetWeight = weight;
+    _nodes[node].FadeRate = 0.0f;
+}
+
+float AnimationBlendTree::GetWeight(NodeIndex node) const
+{
+    return _nodes[node].Weight;
+}
+
+void AnimationBlendTree::CrossFade(NodeIndex node, float targetWeight, float duration)
+{
+    if (duration <= 0.0f)
+    {
+        SetWeight(node, targetWeight);
+        return;
+    }
+    _nodes[node].TargetWeight = targetWeight;
+    _nodes[node].FadeRate = fabsf(targetWeight - _nodes[node].Weight) / duration;
+}
+
+void AnimationBlendTree::SetTimePos(NodeIndex clipNode, float timePos)
+{
+    _nodes[clipNode].TimePos = timePos;
+}
+
+float AnimationBlendTree::GetTimePos(NodeIndex clipNode) const
+{
+    return _nodes[clipNode].TimePos;
+}
+
+void AnimationBlendTree::Update(float dt)
+{
+    for (Node& node : _nodes)
+    {
+        if (node.Type == NodeType::Clip)
+        {
+            const CompiledClip& clip = _skinnedInfo->GetCompiledClip(node.Clip);
+            float startTime = clip.GetStartTime();
+            float duration = clip.GetEndTime() - startTime;
+
+            node.TimePos += dt * node.Speed;
+            if (duration > 0.0f && (node.TimePos > startTime + duration || node.TimePos < startTime))
+            {
+                float t = fmodf(node.TimePos - startTime, duration);
+                node.TimePos = startTime + (t < 0.0f ? t + duration : t);
+            }
+        }
+        else if (node.FadeRate > 0.0f)
+        {
+            float step = node.FadeRate * dt;
+            if (fabsf(node.TargetWeight - node.Weight) <= step)
+            {
+                node.Weight = node.TargetWeight;
+                node.FadeRate = 0.0f;
+            }
+            else
+            {
+                node.Weight += node.TargetWeight > node.Weight ? step : -step;
+            }
+        }
+    }
+}
+
+size_t AnimationBlendTree::GetScratchSize() const
+{
+    size_t clipCount = 0;
+    for (const Node& node : _nodes)
+    {
+        if (node.Type == NodeType::Clip)
+            clipCount++;
+    }
+    // Pose per clip plus alignment padding, blend nodes reuse poses of their inputs.
+    size_t poseSize = _groupCount * sizeof(BoneGroupPose) + 16;
+    size_t toParentSize = _skinnedInfo->BoneCount() * sizeof(XMFLOAT4X4) + 16;
+    return clipCount * poseSize + toParentSize + _skinnedInfo->GetFinalTransformsScratchSize();
+}
+
+void AnimationBlendTree::Evaluate(FrameArena& arena, XMFLOAT3X4* finalTransforms)
+{
+    UINT boneCount = _skinnedInfo->BoneCount();
+    BoneGroupPose* pose = EvaluateNode(_root, arena);
+
+    XMFLOAT4X4* toParentTransforms = arena.Allocate<XMFLOAT4X4>(boneCount);
+    for (UINT group = 0; group < _groupCount; group++)
+        BoneGroupPose::ToMatrices(pose[group], toParentTransforms + group * 4, MathHelper::Min(4u, boneCount - group * 4));
+
+    _skinnedInfo->ConcatenateTransforms(toParentTransforms, arena, finalTransforms);
+}
+
+BoneGroupPose* AnimationBlendTree::EvaluateNode(NodeIndex index, FrameArena& arena)
+{
+    Node& node = _nodes[index];
+    if (node.Type == NodeType::Clip)
+    {
+        BoneGroupPose* pose = arena.Allocate<BoneGroupPose>(_groupCount);
+        _skinnedInfo->GetCompiledClip(node.Clip).Sample(node.TimePos, pose, node.KeyframeCursor);
+        return pose;
+    }
+
+    // Inputs which don't contribute are not evaluated at all.
+    bool masked = !node.BoneMask.empty();
+    if (node.Weight <= 0.0f)
+        return EvaluateNode(node.Inputs[0], arena);
+    if (node.Type == NodeType::Blend && node.Weight >= 1.0f && !masked)
+        return EvaluateNode(node.Inputs[1], arena);
+
+    BoneGroupPose* pose = EvaluateNode(node.Inputs[0], arena);
+    BoneGroupPose* other = EvaluateNode(node.Inputs[1], arena);
+    XMVECTOR weight = XMVectorReplicate(node.Weight);
+    for (UINT group = 0; group < _groupCount; group++)
+    {
+        XMVECTOR weights = masked ? XMVectorMultiply(XMLoadFloat4(&node.BoneMask[group]), weight) : weight;
+        if (node.Type == NodeType::Blend)
+            BoneGroupPose::Blend(pose[group], other[group], weights, pose[group]);
+        else
+            BoneGroupPose::ApplyAdditive(pose[group], other[group], node.ReferencePose[group], weights, pose[group]);
+    }
+    return pose;
+}
+}
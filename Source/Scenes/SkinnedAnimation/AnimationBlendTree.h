@@ -0,0 +1,102 @@
+//
+// Blend tree of animation clips evaluated in local space.
+//
+
+#pragma once
+
+#include "SkinnedData.h"
+
+namespace DX12Samples
+{
+// Leaves sample compiled clips into local poses, inner nodes blend or add poses of their inputs in local space,
+// then hierarchy is concatenated once for the whole tree. Pose buffers are taken from frame arena, so evaluation
+// doesn't allocate.
+class AnimationBlendTree
+{
+public:
+    using NodeIndex = UINT;
+    static const NodeIndex InvalidNode = UINT(-1);
+
+    void Init(const SkinnedData* skinnedInfo);
+
+    /**
+     * \brief Add leaf playing clip in loop.
+     */
+    NodeIndex AddClip(SkinnedData::ClipHandle clip, float speed = 1.0f);
+    /**
+     * \brief Add node blending from pose a to pose b, weight 0 gives a, weight 1 gives b.
+     */
+    NodeIndex AddBlend(NodeIndex a, NodeIndex b, float weight);
+    /**
+     * \brief Add node applying difference between additive clip pose and its first frame on top of base pose.
+     * \param additiveClip clip node created by AddClip.
+     */
+    NodeIndex AddAdditive(NodeIndex base, NodeIndex additiveClip, float weight);
+    /**
+     * \brief Limit blend or additive node to rootBone and its children, e.g. upper body layer.
+     */
+    void SetBoneMask(NodeIndex node, UINT rootBone);
+    void SetRoot(NodeIndex node);
+
+    void SetWeight(NodeIndex node, float weight);
+    float GetWeight(NodeIndex node) const;
+    /**
+     * \brief Move weight of blend or additive node to targetWeight over duration seconds.
+     */
+    void CrossFade(NodeIndex node, float targetWeight, float duration);
+    void SetTimePos(NodeIndex clipNode, float timePos);
+    float GetTimePos(NodeIndex clipNode) const;
+
+    /**
+     * \brief Advance clip times and cross fades.
+     */
+    void Update(float dt);
+    /**
+     * \brief Scratch memory in bytes which Evaluate takes from arena.
+     */
+    size_t GetScratchSize() const;
+    /**
+     * \brief Evaluate tree from root node.
+     * \param arena scratch memory, caller resets it once per frame.
+     * \param finalTransforms output array of BoneCount() transposed matrices.
+     */
+    void Evaluate(FrameArena& arena, DirectX::XMFLOAT3X4* finalTransforms);
+
+private:
+    enum class NodeType
+    {
+        Clip,
+        Blend,
+        Additive
+    };
+
+    struct Node
+    {
+        NodeType Type = NodeType::Clip;
+
+        SkinnedData::ClipHandle Clip = SkinnedData::InvalidClip;
+        float TimePos = 0.0f;
+        float Speed = 1.0f;
+        UINT KeyframeCursor = 0;
+
+        NodeIndex Inputs[2] = { InvalidNode, InvalidNode };
+        float Weight = 0.0f;
+        float TargetWeight = 0.0f;
+        float FadeRate = 0.0f;
+        // Per bone weights of mask, empty if node affects all bones.
+        std::vector<DirectX::XMFLOAT4> BoneMask;
+        // First frame of additive clip.
+        std::vector<BoneGroupPose, AlignedAllocator<BoneGroupPose>> ReferencePose;
+    };
+
+    /**
+     * \brief Evaluate node to pose allocated from arena.
+     */
+    BoneGroupPose* EvaluateNode(NodeIndex node, FrameArena& arena);
+
+    const SkinnedData* _skinnedInfo = nullptr;
+    UINT _groupCount = 0;
+    std::vector<Node> _nodes;
+    NodeIndex _root = InvalidNode;
+};
+}
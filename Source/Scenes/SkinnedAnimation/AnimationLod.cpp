@@ -0,0 +1,54 @@
+#include "AnimationLod.h"
+
+namespace DX12Samples
+{
+AnimationLodPolicy::AnimationLodPolicy()
+{
+    AnimationLodLevel nearLevel;
+    nearLevel.MaxDistance = 20.0f;
+
+    AnimationLodLevel middleLevel;
+    middleLevel.MaxDistance = 50.0f;
+    middleLevel.UpdateInterval = 2;
+
+    AnimationLodLevel farLevel;
+    farLevel.UpdateInterval = 4;
+    farLevel.SkeletonLod = 1;
+
+    SetLevels({ nearLevel, middleLevel, farLevel });
+}
+
+void AnimationLodPolicy::SetLevels(const std::vector<AnimationLodLevel>& levels)
+{
+    assert(!levels.empty());
+    _levels = levels;
+}
+
+UINT AnimationLodPolicy::LevelCount() const
+{
+    return (UINT)_levels.size();
+}
+
+const AnimationLodLevel& AnimationLodPolicy::GetLevel(UINT level) const
+{
+    return _levels[level];
+}
+
+UINT AnimationLodPolicy::SkeletonLodCount() const
+{
+    UINT lodCount = 1;
+    for (const AnimationLodLevel& level : _levels)
+        lodCount = MathHelper::Max(lodCount, level.SkeletonLod + 1);
+    return lodCount;
+}
+
+UINT AnimationLodPolicy::SelectLevel(float distance) const
+{
+    for (UINT i = 0; i + 1 < (UINT)_levels.size(); i++)
+    {
+        if (distance < _levels[i].MaxDistance)
+            return i;
+    }
+    return (UINT)_levels.size() - 1;
+}
+}
@@ -0,0 +1,45 @@
+//
+// Animation level of detail selected by distance to camera.
+//
+
+#pragma once
+
+#include "../../../Core/D3DUtil.h"
+
+namespace DX12Samples
+{
+struct AnimationLodLevel
+{
+    // Level is used for instances closer than MaxDistance.
+    float MaxDistance = MathHelper::Infinity;
+    // Animation is evaluated every UpdateInterval frames, palettes are interpolated between evaluations.
+    UINT UpdateInterval = 1;
+    // Skeleton LOD from SkinnedData::BuildLods.
+    UINT SkeletonLod = 0;
+};
+
+class AnimationLodPolicy
+{
+public:
+    /**
+     * \brief Create policy with default levels: full rate and skeleton up to 20 units, then halved rate, then every
+     * fourth frame with collapsed leaf bones.
+     */
+    AnimationLodPolicy();
+
+    /**
+     * \brief Set levels sorted by MaxDistance. Last level is used for everything further than previous ones.
+     */
+    void SetLevels(const std::vector<AnimationLodLevel>& levels);
+    UINT LevelCount() const;
+    const AnimationLodLevel& GetLevel(UINT level) const;
+    /**
+     * \brief Highest skeleton LOD used by levels, SkinnedData needs SkeletonLodCount() LODs built.
+     */
+    UINT SkeletonLodCount() const;
+    UINT SelectLevel(float distance) const;
+
+private:
+    std::vector<AnimationLodLevel> _levels;
+};
+}
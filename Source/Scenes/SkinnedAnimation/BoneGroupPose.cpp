@@ -0,0 +1,137 @@
+#include "BoneGroupPose.h"
+
+namespace DX12Samples
+{
+using namespace DirectX;
+
+namespace
+{
+void NormalizeQuaternions(XMVECTOR& qx, XMVECTOR& qy, XMVECTOR& qz, XMVECTOR& qw)
+{
+    XMVECTOR lengthSq = XMVectorMultiply(qx, qx);
+    lengthSq = XMVectorMultiplyAdd(qy, qy, lengthSq);
+    lengthSq = XMVectorMultiplyAdd(qz, qz, lengthSq);
+    lengthSq = XMVectorMultiplyAdd(qw, qw, lengthSq);
+    XMVECTOR invLength = XMVectorReciprocalSqrt(lengthSq);
+    qx = XMVectorMultiply(qx, invLength);
+    qy = XMVectorMultiply(qy, invLength);
+    qz = XMVectorMultiply(qz, invLength);
+    qw = XMVectorMultiply(qw, invLength);
+}
+}
+
+UINT BoneGroupPose::GroupCount(UINT boneCount)
+{
+    return (boneCount + 3) / 4;
+}
+
+void BoneGroupPose::Blend(const BoneGroupPose& a, const BoneGroupPose& b, FXMVECTOR weights, BoneGroupPose& out)
+{
+    out.Tx = XMVectorLerpV(a.Tx, b.Tx, weights);
+    out.Ty = XMVectorLerpV(a.Ty, b.Ty, weights);
+    out.Tz = XMVectorLerpV(a.Tz, b.Tz, weights);
+
+    out.Sx = XMVectorLerpV(a.Sx, b.Sx, weights);
+    out.Sy = XMVectorLerpV(a.Sy, b.Sy, weights);
+    out.Sz = XMVectorLerpV(a.Sz, b.Sz, weights);
+
+    // Normalized lerp along the shortest arc: flip second quaternion where dot product is negative.
+    XMVECTOR dot = XMVectorMultiply(a.Qx, b.Qx);
+    dot = XMVectorMultiplyAdd(a.Qy, b.Qy, dot);
+    dot = XMVectorMultiplyAdd(a.Qz, b.Qz, dot);
+    dot = XMVectorMultiplyAdd(a.Qw, b.Qw, dot);
+    XMVECTOR flip = XMVectorLess(dot, XMVectorZero());
+
+    XMVECTOR qx = XMVectorLerpV(a.Qx, XMVectorSelect(b.Qx, XMVectorNegate(b.Qx), flip), weights);
+    XMVECTOR qy = XMVectorLerpV(a.Qy, XMVectorSelect(b.Qy, XMVectorNegate(b.Qy), flip), weights);
+    XMVECTOR qz = XMVectorLerpV(a.Qz, XMVectorSelect(b.Qz, XMVectorNegate(b.Qz), flip), weights);
+    XMVECTOR qw = XMVectorLerpV(a.Qw, XMVectorSelect(b.Qw, XMVectorNegate(b.Qw), flip), weights);
+    NormalizeQuaternions(qx, qy, qz, qw);
+    out.Qx = qx;
+    out.Qy = qy;
+    out.Qz = qz;
+    out.Qw = qw;
+}
+
+void BoneGroupPose::ApplyAdditive(const BoneGroupPose& base, const BoneGroupPose& additive, const BoneGroupPose& reference, FXMVECTOR weights, BoneGroupPose& out)
+{
+    XMVECTOR one = XMVectorSplatOne();
+
+    out.Tx = XMVectorMultiplyAdd(XMVectorSubtract(additive.Tx, reference.Tx), weights, base.Tx);
+    out.Ty = XMVectorMultiplyAdd(XMVectorSubtract(additive.Ty, reference.Ty), weights, base.Ty);
+    out.Tz = XMVectorMultiplyAdd(XMVectorSubtract(additive.Tz, reference.Tz), weights, base.Tz);
+
+    out.Sx = XMVectorMultiply(base.Sx, XMVectorLerpV(one, XMVectorDivide(additive.Sx, reference.Sx), weights));
+    out.Sy = XMVectorMultiply(base.Sy, XMVectorLerpV(one, XMVectorDivide(additive.Sy, reference.Sy), weights));
+    out.Sz = XMVectorMultiply(base.Sz, XMVectorLerpV(one, XMVectorDivide(additive.Sz, reference.Sz), weights));
+
+    // Delta rotation d = additive * conjugate(reference), so that d * reference = additive.
+    XMVECTOR dw = XMVectorMultiplyAdd(additive.Qw, reference.Qw,
+        XMVectorMultiplyAdd(additive.Qx, reference.Qx,
+            XMVectorMultiplyAdd(additive.Qy, reference.Qy, XMVectorMultiply(additive.Qz, reference.Qz))));
+    XMVECTOR dx = XMVectorSubtract(XMVectorMultiplyAdd(additive.Qx, reference.Qw, XMVectorMultiply(additive.Qz, reference.Qy)),
+        XMVectorMultiplyAdd(additive.Qw, reference.Qx, XMVectorMultiply(additive.Qy, reference.Qz)));
+    XMVECTOR dy = XMVectorSubtract(XMVectorMultiplyAdd(additive.Qy, reference.Qw, XMVectorMultiply(additive.Qx, reference.Qz)),
+        XMVectorMultiplyAdd(additive.Qw, reference.Qy, XMVectorMultiply(additive.Qz, reference.Qx)));
+    XMVECTOR dz = XMVectorSubtract(XMVectorMultiplyAdd(additive.Qz, reference.Qw, XMVectorMultiply(additive.Qy, reference.Qx)),
+        XMVectorMultiplyAdd(additive.Qw, reference.Qz, XMVectorMultiply(additive.Qx, reference.Qy)));
+
+    // Scale delta by weight with normalized lerp from identity, then apply it on top of base: q = d * base.
+    dx = XMVectorMultiply(dx, weights);
+    dy = XMVectorMultiply(dy, weights);
+    dz = XMVectorMultiply(dz, weights);
+    dw = XMVectorLerpV(one, dw, weights);
+    NormalizeQuaternions(dx, dy, dz, dw);
+
+    XMVECTOR qw = XMVectorSubtract(XMVectorMultiply(dw, base.Qw),
+        XMVectorMultiplyAdd(dx, base.Qx, XMVectorMultiplyAdd(dy, base.Qy, XMVectorMultiply(dz, base.Qz))));
+    XMVECTOR qx = XMVectorSubtract(XMVectorMultiplyAdd(dw, base.Qx, XMVectorMultiplyAdd(dx, base.Qw, XMVectorMultiply(dy, base.Qz))),
+        XMVectorMultiply(dz, base.Qy));
+    XMVECTOR qy = XMVectorSubtract(XMVectorMultiplyAdd(dw, base.Qy, XMVectorMultiplyAdd(dy, base.Qw, XMVectorMultiply(dz, base.Qx))),
+        XMVectorMultiply(dx, base.Qz));
+    XMVECTOR qz = XMVectorSubtract(XMVectorMultiplyAdd(dw, base.Qz, XMVectorMultiplyAdd(dz, base.Qw, XMVectorMultiply(dx, base.Qy))),
+        XMVectorMultiply(dy, base.Qx));
+    NormalizeQuaternions(qx, qy, qz, qw);
+    out.Qx = qx;
+    out.Qy = qy;
+    out.Qz = qz;
+    out.Qw = qw;
+}
+
+void BoneGroupPose::ToMatrices(const BoneGroupPose& pose, XMFLOAT4X4* boneTransforms, UINT count)
+{
+    // Rotation matrix from quaternion, rows scaled by S, same as XMMatrixAffineTransformation.
+    XMVECTOR one = XMVectorSplatOne();
+    XMVECTOR two = XMVectorReplicate(2.0f);
+    XMVECTOR xx = XMVectorMultiply(pose.Qx, pose.Qx);
+    XMVECTOR yy = XMVectorMultiply(pose.Qy, pose.Qy);
+    XMVECTOR zz = XMVectorMultiply(pose.Qz, pose.Qz);
+    XMVECTOR xy = XMVectorMultiply(pose.Qx, pose.Qy);
+    XMVECTOR xz = XMVectorMultiply(pose.Qx, pose.Qz);
+    XMVECTOR yz = XMVectorMultiply(pose.Qy, pose.Qz);
+    XMVECTOR xw = XMVectorMultiply(pose.Qx, pose.Qw);
+    XMVECTOR yw = XMVectorMultiply(pose.Qy, pose.Qw);
+    XMVECTOR zw = XMVectorMultiply(pose.Qz, pose.Qw);
+
+    XMVECTOR m00 = XMVectorMultiply(pose.Sx, XMVectorNegativeMultiplySubtract(two, XMVectorAdd(yy, zz), one));
+    XMVECTOR m01 = XMVectorMultiply(pose.Sx, XMVectorMultiply(two, XMVectorAdd(xy, zw)));
+    XMVECTOR m02 = XMVectorMultiply(pose.Sx, XMVectorMultiply(two, XMVectorSubtract(xz, yw)));
+
+    XMVECTOR m10 = XMVectorMultiply(pose.Sy, XMVectorMultiply(two, XMVectorSubtract(xy, zw)));
+    XMVECTOR m11 = XMVectorMultiply(pose.Sy, XMVectorNegativeMultiplySubtract(two, XMVectorAdd(xx, zz), one));
+    XMVECTOR m12 = XMVectorMultiply(pose.Sy, XMVectorMultiply(two, XMVectorAdd(yz, xw)));
+
+    XMVECTOR m20 = XMVectorMultiply(pose.Sz, XMVectorMultiply(two, XMVectorAdd(xz, yw)));
+    XMVECTOR m21 = XMVectorMultiply(pose.Sz, XMVectorMultiply(two, XMVectorSubtract(yz, xw)));
+    XMVECTOR m22 = XMVectorMultiply(pose.Sz, XMVectorNegativeMultiplySubtract(two, XMVectorAdd(xx, yy), one));
+
+    // Transpose component vectors so that row i of each matrix holds bone i.
+    XMMATRIX row0 = XMMatrixTranspose(XMMATRIX(m00, m01, m02, XMVectorZero()));
+    XMMATRIX row1 = XMMatrixTranspose(XMMATRIX(m10, m11, m12, XMVectorZero()));
+    XMMATRIX row2 = XMMatrixTranspose(XMMATRIX(m20, m21, m22, XMVectorZero()));
+    XMMATRIX row3 = XMMatrixTranspose(XMMATRIX(pose.Tx, pose.Ty, pose.Tz, one));
+
+    for (UINT i = 0; i < count; i++)
+        XMStoreFloat4x4(&boneTransforms[i], XMMATRIX(row0.r[i], row1.r[i], row2.r[i], row3.r[i]));
+}
+}
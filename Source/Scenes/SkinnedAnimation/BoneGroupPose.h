@@ -0,0 +1,36 @@
+//
+// Local space transforms of 4 bones in structure of arrays layout.
+//
+
+#pragma once
+
+#include "../../../Core/AlignedAllocator.h"
+#include "../../../Core/D3DUtil.h"
+
+namespace DX12Samples
+{
+// Each vector holds single component for all 4 bones, so one SIMD lane works on one bone.
+// Skeleton pose is an array of GroupCount(boneCount) groups, padding bones have identity transform.
+struct BoneGroupPose
+{
+    DirectX::XMVECTOR Tx, Ty, Tz;
+    DirectX::XMVECTOR Sx, Sy, Sz;
+    DirectX::XMVECTOR Qx, Qy, Qz, Qw;
+
+    static UINT GroupCount(UINT boneCount);
+    /**
+     * \brief Blend a to b per bone. Translation and scale are lerped, rotation uses shortest arc normalized lerp.
+     * \param weights blend factor of b for each of 4 bones.
+     */
+    static void Blend(const BoneGroupPose& a, const BoneGroupPose& b, DirectX::FXMVECTOR weights, BoneGroupPose& out);
+    /**
+     * \brief Add difference between additive and reference poses on top of base pose.
+     * \param weights amount of difference applied for each of 4 bones.
+     */
+    static void ApplyAdditive(const BoneGroupPose& base, const BoneGroupPose& additive, const BoneGroupPose& reference, DirectX::FXMVECTOR weights, BoneGroupPose& out);
+    /**
+     * \brief Convert to to parent matrices, same as XMMatrixAffineTransformation. Writes up to count matrices.
+     */
+    static void ToMatrices(const BoneGroupPose& pose, DirectX::XMFLOAT4X4* boneTransforms, UINT count);
+};
+}
@@ -0,0 +1,157 @@
+#include "CompiledClip.h"
+#include "SkinnedData.h"
+
+namespace DX12Samples
+{
+using namespace DirectX;
+
+void CompiledClip::Build(const AnimationClip& clip)
+{
+    _boneCount = (UINT)clip.BoneAnimations.size();
+    _groupCount = BoneGroupPose::GroupCount(_boneCount);
+
+    _times.clear();
+    for (const BoneAnimation& bone : clip.BoneAnimations)
+    {
+        for (const Keyframe& key : bone.Keyframes)
+            _times.push_back(key.TimePos);
+    }
+    std::sort(_times.begin(), _times.end());
+    _times.erase(std::unique(_times.begin(), _times.end()), _times.end());
+    // Clip without keys is baked to single identity key, so sampling never has to check for empty arrays.
+    if (_times.empty())
+        _times.push_back(0.0f);
+
+    // Bake keys through aligned scratch arrays, one float per bone lane. Padding lanes and bones without keys keep identity transform.
+    const UINT laneCount = _groupCount * 4;
+    std::vector<float> components[10];
+    for (auto& component : components)
+        component.resize(laneCount);
+
+    _keys.resize(_times.size() * _groupCount);
+    std::vector<UINT> cursors(_boneCount, 0);
+    for (UINT key = 0; key < (UINT)_times.size(); key++)
+    {
+        for (UINT lane = 0; lane < laneCount; lane++)
+        {
+            Keyframe k;
+            if (lane < _boneCount && !clip.BoneAnimations[lane].Keyframes.empty())
+                clip.BoneAnimations[lane].Interpolate(_times[key], k, cursors[lane]);
+
+            float values[10] =
+            {
+                k.Translation.x, k.Translation.y, k.Translation.z,
+                k.Scale.x, k.Scale.y, k.Scale.z,
+                k.RotationQuat.x, k.RotationQuat.y, k.RotationQuat.z, k.RotationQuat.w
+            };
+            for (UINT c = 0; c < 10; c++)
+                components[c][lane] = values[c];
+        }
+        for (UINT group = 0; group < _groupCount; group++)
+        {
+            BoneGroupPose& groupKey = _keys[key * _groupCount + group];
+            XMVECTOR* dst = &groupKey.Tx;
+            for (UINT c = 0; c < 10; c++)
+                dst[c] = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&components[c][group * 4]));
+        }
+    }
+}
+
+UINT CompiledClip::BoneCount() const
+{
+    return _boneCount;
+}
+
+UINT CompiledClip::GroupCount() const
+{
+    return _groupCount;
+}
+
+UINT CompiledClip::KeyCount() const
+{
+    return (UINT)_times.size();
+}
+
+float CompiledClip::GetStartTime() const
+{
+    return _times.front();
+}
+
+float CompiledClip::GetEndTime() const
+{
+    return _times.back();
+}
+
+size_t CompiledClip::ByteSize() const
+{
+    return _keys.size() * sizeof(BoneGroupPose) + _times.size() * sizeof(float);
+}
+
+void CompiledClip::Interpolate(float t, XMFLOAT4X4* boneTransforms, UINT& cursor) const
+{
+    float lerpPercent = 0.0f;
+    const BoneGroupPose* k0 = nullptr;
+    const BoneGroupPose* k1 = nullptr;
+    FindKeys(t, cursor, k0, k1, lerpPercent);
+
+    XMVECTOR weights = XMVectorReplicate(lerpPercent);
+    for (UINT group = 0; group < _groupCount; group++)
+    {
+        BoneGroupPose pose;
+        BoneGroupPose::Blend(k0[group], k1[group], weights, pose);
+        BoneGroupPose::ToMatrices(pose, boneTransforms + group * 4, MathHelper::Min(4u, _boneCount - group * 4));
+    }
+}
+
+void CompiledClip::Sample(float t, BoneGroupPose* pose, UINT& cursor) const
+{
+    float lerpPercent = 0.0f;
+    const BoneGroupPose* k0 = nullptr;
+    const BoneGroupPose* k1 = nullptr;
+    FindKeys(t, cursor, k0, k1, lerpPercent);
+
+    XMVECTOR weights = XMVectorReplicate(lerpPercent);
+    for (UINT group = 0; group < _groupCount; group++)
+        BoneGroupPose::Blend(k0[group], k1[group], weights, pose[group]);
+}
+
+void CompiledClip::FindKeys(float t, UINT& cursor, const BoneGroupPose*& k0, const BoneGroupPose*& k1, float& lerpPercent) const
+{
+    UINT key0 = 0;
+    lerpPercent = 0.0f;
+    if (_times.size() == 1 || t <= _times.front())
+    {
+        cursor = 0;
+    }
+    else if (t >= _times.back())
+    {
+        cursor = (UINT)_times.size() - 2;
+        key0 = cursor;
+        lerpPercent = 1.0f;
+    }
+    else
+    {
+        cursor = FindKey(t, cursor);
+        key0 = cursor;
+        lerpPercent = (t - _times[key0]) / (_times[key0 + 1] - _times[key0]);
+    }
+    UINT key1 = MathHelper::Min(key0 + 1, (UINT)_times.size() - 1);
+
+    k0 = &_keys[key0 * _groupCount];
+    k1 = &_keys[key1 * _groupCount];
+}
+
+UINT CompiledClip::FindKey(float t, UINT cursor) const
+{
+    const UINT lastSegment = (UINT)_times.size() - 2;
+    if (cursor <= lastSegment && _times[cursor] <= t)
+    {
+        if (t <= _times[cursor + 1])
+            return cursor;
+        if (cursor + 1 <= lastSegment && t <= _times[cursor + 2])
+            return cursor + 1;
+    }
+    auto it = std::lower_bound(_times.begin(), _times.end(), t);
+    return (UINT)(it - _times.begin()) - 1;
+}
+}
@@ -0,0 +1,65 @@
+//
+// Animation clip baked to structure of arrays layout for fast sampling.
+//
+
+#pragma once
+
+#include "../../../Core/D3DUtil.h"
+#include "BoneGroupPose.h"
+
+namespace DX12Samples
+{
+struct AnimationClip;
+
+// All bones are resampled to the union of their key times, so single key search serves every bone. For each key bones are
+// packed in groups of 4 with every component in its own vector, which lets one SIMD lane work on one bone.
+// Rotations are blended with normalized lerp instead of slerp, for 60Hz keys difference with AnimationClip::Interpolate
+// is below 1e-4 in matrix elements (relative to bone translation magnitude).
+class CompiledClip
+{
+public:
+    /**
+     * \brief Bake animation clip. Bones with different key times are resampled to the union of all key times.
+     * Bones without keys stay in identity pose, clip without any keys gets single key at time 0.
+     */
+    void Build(const AnimationClip& clip);
+
+    UINT BoneCount() const;
+    UINT GroupCount() const;
+    UINT KeyCount() const;
+    float GetStartTime() const;
+    float GetEndTime() const;
+    /**
+     * \brief Memory used by baked keys and key times in bytes.
+     */
+    size_t ByteSize() const;
+    /**
+     * \brief Get to parent transforms of all bones at time t. Same output as AnimationClip::Interpolate within tolerance.
+     * \param t animation time.
+     * \param boneTransforms output array of BoneCount() matrices.
+     * \param cursor key index found on previous call, updated by function.
+     */
+    void Interpolate(float t, DirectX::XMFLOAT4X4* boneTransforms, UINT& cursor) const;
+    /**
+     * \brief Get local pose of all bones at time t without converting it to matrices.
+     * \param pose output array of GroupCount() bone groups.
+     */
+    void Sample(float t, BoneGroupPose* pose, UINT& cursor) const;
+
+private:
+    /**
+     * \brief Find key i such as _times[i] <= t <= _times[i + 1], starting from cursor.
+     */
+    UINT FindKey(float t, UINT cursor) const;
+    /**
+     * \brief Find keys around t and blend factor between them.
+     */
+    void FindKeys(float t, UINT& cursor, const BoneGroupPose*& k0, const BoneGroupPose*& k1, float& lerpPercent) const;
+
+    UINT _boneCount = 0;
+    UINT _groupCount = 0;
+    std::vector<float> _times;
+    // _keys[key * _groupCount + group].
+    std::vector<BoneGroupPose, AlignedAllocator<BoneGroupPose>> _keys;
+};
+}
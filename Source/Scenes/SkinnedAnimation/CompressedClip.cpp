@@ -0,0 +1,395 @@
+#include "CompressedClip.h"
+#include "SkinnedData.h"
+
+#include <chrono>
+
+namespace DX12Samples
+{
+using namespace DirectX;
+
+namespace
+{
+const float MaxQuantizedTime = 65535.0f;
+const float MaxQuantizedValue = 65535.0f;
+const float MaxQuantizedRotation = 32767.0f;
+
+XMVECTOR GetKeyValue(const Keyframe& key, UINT type)
+{
+    switch (type)
+    {
+    case 0:
+        return XMLoadFloat3(&key.Translation);
+    case 1:
+        return XMLoadFloat3(&key.Scale);
+    default:
+        return XMLoadFloat4(&key.RotationQuat);
+    }
+}
+
+float RotationError(FXMVECTOR q0, FXMVECTOR q1)
+{
+    // Angle from chord length between quaternions, acos of dot product loses precision for small angles.
+    XMVECTOR n0 = XMQuaternionNormalize(q0);
+    XMVECTOR n1 = XMQuaternionNormalize(q1);
+    if (XMVectorGetX(XMQuaternionDot(n0, n1)) < 0.0f)
+        n1 = XMVectorNegate(n1);
+    float chord = XMVectorGetX(XMVector4Length(XMVectorSubtract(n0, n1)));
+    return 4.0f * asinf(MathHelper::Min(0.5f * chord, 1.0f));
+}
+
+float KeyError(FXMVECTOR v0, FXMVECTOR v1, UINT type)
+{
+    switch (type)
+    {
+    case 0:
+        return XMVectorGetX(XMVector3Length(XMVectorSubtract(v0, v1)));
+    case 1:
+    {
+        XMFLOAT3 d;
+        XMStoreFloat3(&d, XMVectorAbs(XMVectorSubtract(v0, v1)));
+        return MathHelper::Max(d.x, MathHelper::Max(d.y, d.z));
+    }
+    default:
+        return RotationError(v0, v1);
+    }
+}
+
+XMVECTOR InterpolateKeys(FXMVECTOR v0, FXMVECTOR v1, float lerpPercent, UINT type)
+{
+    if (type == 2)
+        return XMQuaternionSlerp(v0, v1, lerpPercent);
+    return XMVectorLerp(v0, v1, lerpPercent);
+}
+}
+
+std::string ClipCompressionReport::ToString() const
+{
+    std::ostringstream outs;
+    outs << "Clip compression: " << RawBytes << " -> " << CompressedBytes << " bytes, "
+        << RawKeyCount << " -> " << CompressedKeyCount << " track keys\n"
+        << "  max error: translation " << MaxTranslationError << ", rotation " << MaxRotationError << " rad, scale " << MaxScaleError << "\n"
+        << "  sample time: raw " << RawSampleTime << " us, compressed " << CompressedSampleTime << " us\n";
+    return outs.str();
+}
+
+void CompressedClip::Build(const AnimationClip& clip, const ClipCompressionSettings& settings)
+{
+    _boneCount = (UINT)clip.BoneAnimations.size();
+    _startTime = clip.GetClipStartTime();
+    _endTime = clip.GetClipEndTime();
+
+    const float tolerances[TrackTypeCount] = { settings.TranslationTolerance, settings.ScaleTolerance, settings.RotationTolerance };
+
+    _tracks.resize(_boneCount * TrackTypeCount);
+    _keyTimes.clear();
+    _keys.clear();
+    for (UINT bone = 0; bone < _boneCount; bone++)
+    {
+        for (UINT type = 0; type < TrackTypeCount; type++)
+            BuildTrack(clip.BoneAnimations[bone], (TrackType)type, tolerances[type], _tracks[bone * TrackTypeCount + type]);
+    }
+}
+
+UINT CompressedClip::BoneCount() const
+{
+    return _boneCount;
+}
+
+UINT CompressedClip::KeyCount() const
+{
+    return (UINT)_keys.size();
+}
+
+float CompressedClip::GetStartTime() const
+{
+    return _startTime;
+}
+
+float CompressedClip::GetEndTime() const
+{
+    return _endTime;
+}
+
+size_t CompressedClip::ByteSize() const
+{
+    return _tracks.size() * sizeof(Track) + _keyTimes.size() * sizeof(USHORT) + _keys.size() * sizeof(QuantizedKey);
+}
+
+UINT CompressedClip::CursorCount() const
+{
+    return (UINT)_tracks.size();
+}
+
+void CompressedClip::Interpolate(float t, XMFLOAT4X4* boneTransforms, UINT* keyframeCursors) const
+{
+    float quantizedTime = QuantizeTime(t);
+    XMVECTOR zero = XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f);
+    for (UINT bone = 0; bone < _boneCount; bone++)
+    {
+        XMVECTOR S, P, Q;
+        SampleBone(quantizedTime, bone, S, P, Q, keyframeCursors);
+        XMStoreFloat4x4(&boneTransforms[bone], XMMatrixAffineTransformation(S, zero, Q, P));
+    }
+}
+
+void CompressedClip::Interpolate(float t, UINT bone, Keyframe& key, UINT* keyframeCursors) const
+{
+    XMVECTOR S, P, Q;
+    SampleBone(QuantizeTime(t), bone, S, P, Q, keyframeCursors);
+    key.TimePos = t;
+    XMStoreFloat3(&key.Translation, P);
+    XMStoreFloat3(&key.Scale, S);
+    XMStoreFloat4(&key.RotationQuat, Q);
+}
+
+ClipCompressionReport CompressedClip::Measure(const AnimationClip& clip, const CompressedClip& compressedClip, UINT sampleCount)
+{
+    ClipCompressionReport report;
+    for (const BoneAnimation& boneAnimation : clip.BoneAnimations)
+    {
+        report.RawBytes += boneAnimation.Keyframes.size() * sizeof(Keyframe);
+        report.RawKeyCount += (UINT)boneAnimation.Keyframes.size() * TrackTypeCount;
+    }
+    report.CompressedBytes = compressedClip.ByteSize();
+    report.CompressedKeyCount = compressedClip.KeyCount();
+
+    sampleCount = MathHelper::Max(sampleCount, 2u);
+    const float startTime = clip.GetClipStartTime();
+    const float timeStep = (clip.GetClipEndTime() - startTime) / (sampleCount - 1);
+    const UINT boneCount = (UINT)clip.BoneAnimations.size();
+
+    std::vector<UINT> rawCursors(boneCount, 0);
+    std::vector<UINT> compressedCursors(compressedClip.CursorCount(), 0);
+    for (UINT sample = 0; sample < sampleCount; sample++)
+    {
+        float t = startTime + sample * timeStep;
+        for (UINT bone = 0; bone < boneCount; bone++)
+        {
+            Keyframe raw;
+            Keyframe compressed;
+            clip.BoneAnimations[bone].Interpolate(t, raw, rawCursors[bone]);
+            compressedClip.Interpolate(t, bone, compressed, compressedCursors.data());
+
+            XMVECTOR rawS = XMLoadFloat3(&raw.Scale);
+            XMVECTOR rawP = XMLoadFloat3(&raw.Translation);
+            XMVECTOR rawQ = XMLoadFloat4(&raw.RotationQuat);
+            XMVECTOR S = XMLoadFloat3(&compressed.Scale);
+            XMVECTOR P = XMLoadFloat3(&compressed.Translation);
+            XMVECTOR Q = XMLoadFloat4(&compressed.RotationQuat);
+            report.MaxTranslationError = MathHelper::Max(report.MaxTranslationError, KeyError(rawP, P, TranslationTrack));
+            report.MaxScaleError = MathHelper::Max(report.MaxScaleError, KeyError(rawS, S, ScaleTrack));
+            report.MaxRotationError = MathHelper::Max(report.MaxRotationError, KeyError(rawQ, Q, RotationTrack));
+        }
+    }
+
+    std::vector<XMFLOAT4X4> transforms(boneCount);
+    rawCursors.assign(boneCount, 0);
+    compressedCursors.assign(compressedClip.CursorCount(), 0);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (UINT sample = 0; sample < sampleCount; sample++)
+        clip.Interpolate(startTime + sample * timeStep, transforms.data(), rawCursors.data());
+    auto end = std::chrono::high_resolution_clock::now();
+    report.RawSampleTime = std::chrono::duration<double, std::micro>(end - start).count() / sampleCount;
+
+    start = std::chrono::high_resolution_clock::now();
+    for (UINT sample = 0; sample < sampleCount; sample++)
+        compressedClip.Interpolate(startTime + sample * timeStep, transforms.data(), compressedCursors.data());
+    end = std::chrono::high_resolution_clock::now();
+    report.CompressedSampleTime = std::chrono::duration<double, std::micro>(end - start).count() / sampleCount;
+
+    return report;
+}
+
+float CompressedClip::QuantizeTime(float t) const
+{
+    float duration = _endTime - _startTime;
+    if (duration <= 0.0f)
+        return 0.0f;
+    return MathHelper::Clamp((t - _startTime) / duration, 0.0f, 1.0f) * MaxQuantizedTime;
+}
+
+void CompressedClip::SampleBone(float quantizedTime, UINT bone, XMVECTOR& S, XMVECTOR& P, XMVECTOR& Q, UINT* keyframeCursors) const
+{
+    const Track* tracks = &_tracks[bone * TrackTypeCount];
+    UINT* cursors = &keyframeCursors[bone * TrackTypeCount];
+    P = SampleTrack(tracks[TranslationTrack], TranslationTrack, quantizedTime, cursors[TranslationTrack]);
+    S = SampleTrack(tracks[ScaleTrack], ScaleTrack, quantizedTime, cursors[ScaleTrack]);
+    Q = SampleTrack(tracks[RotationTrack], RotationTrack, quantizedTime, cursors[RotationTrack]);
+}
+
+void CompressedClip::BuildTrack(const BoneAnimation& boneAnimation, TrackType type, float tolerance, Track& track)
+{
+    const std::vector<Keyframe>& keyframes = boneAnimation.Keyframes;
+    const UINT keyCount = (UINT)keyframes.size();
+
+    // Constant tracks keep single key, others keep key only when it can't be restored from previous kept key and next key.
+    std::vector<UINT> keptKeys = { 0 };
+    XMVECTOR first = GetKeyValue(keyframes[0], type);
+    bool constant = true;
+    for (UINT i = 1; i < keyCount && constant; i++)
+        constant = KeyError(first, GetKeyValue(keyframes[i], type), type) <= tolerance;
+
+    if (!constant)
+    {
+        UINT last = 0;
+        for (UINT next = 2; next < keyCount; next++)
+        {
+            XMVECTOR v0 = GetKeyValue(keyframes[last], type);
+            XMVECTOR v1 = GetKeyValue(keyframes[next], type);
+            float t0 = keyframes[last].TimePos;
+            float t1 = keyframes[next].TimePos;
+            bool restorable = true;
+            for (UINT i = last + 1; i < next && restorable; i++)
+            {
+                // Keys with duplicate time positions are compared with the earlier key.
+                float lerpPercent = t1 > t0 ? (keyframes[i].TimePos - t0) / (t1 - t0) : 0.0f;
+                restorable = KeyError(InterpolateKeys(v0, v1, lerpPercent, type), GetKeyValue(keyframes[i], type), type) <= tolerance;
+            }
+            if (!restorable)
+            {
+                last = next - 1;
+                keptKeys.push_back(last);
+            }
+        }
+        if (keyCount > 1)
+            keptKeys.push_back(keyCount - 1);
+    }
+
+    track.FirstKey = (UINT)_keys.size();
+
+    XMVECTOR rangeMin = XMVectorReplicate(MathHelper::Infinity);
+    XMVECTOR rangeMax = XMVectorReplicate(-MathHelper::Infinity);
+    for (UINT i : keptKeys)
+    {
+        rangeMin = XMVectorMin(rangeMin, GetKeyValue(keyframes[i], type));
+        rangeMax = XMVectorMax(rangeMax, GetKeyValue(keyframes[i], type));
+    }
+    XMVECTOR rangeExtent = XMVectorSubtract(rangeMax, rangeMin);
+    XMStoreFloat3(&track.RangeMin, rangeMin);
+    XMStoreFloat3(&track.RangeExtent, rangeExtent);
+    XMVECTOR invExtent = XMVectorSelect(XMVectorReciprocal(rangeExtent), XMVectorZero(), XMVectorEqual(rangeExtent, XMVectorZero()));
+
+    for (UINT i : keptKeys)
+    {
+        USHORT keyTime = (USHORT)(QuantizeTime(keyframes[i].TimePos) + 0.5f);
+        QuantizedKey key;
+        if (type == RotationTrack)
+        {
+            key = QuantizeRotation(GetKeyValue(keyframes[i], type));
+        }
+        else
+        {
+            XMFLOAT3 normalized;
+            XMStoreFloat3(&normalized, XMVectorMultiply(XMVectorSubtract(GetKeyValue(keyframes[i], type), rangeMin), invExtent));
+            key.Value[0] = (USHORT)(MathHelper::Clamp(normalized.x, 0.0f, 1.0f) * MaxQuantizedValue + 0.5f);
+            key.Value[1] = (USHORT)(MathHelper::Clamp(normalized.y, 0.0f, 1.0f) * MaxQuantizedValue + 0.5f);
+            key.Value[2] = (USHORT)(MathHelper::Clamp(normalized.z, 0.0f, 1.0f) * MaxQuantizedValue + 0.5f);
+        }
+
+        // Keys quantized to the same time would make zero length segment, later key replaces the earlier one.
+        if (_keys.size() > track.FirstKey && _keyTimes.back() == keyTime)
+        {
+            _keys.back() = key;
+            continue;
+        }
+        _keyTimes.push_back(keyTime);
+        _keys.push_back(key);
+    }
+    track.KeyCount = (UINT)_keys.size() - track.FirstKey;
+}
+
+XMVECTOR CompressedClip::DecodeKey(const Track& track, TrackType type, UINT key) const
+{
+    const QuantizedKey& quantizedKey = _keys[track.FirstKey + key];
+    if (type == RotationTrack)
+        return DequantizeRotation(quantizedKey);
+
+    XMVECTOR normalized = XMVectorScale(
+        XMVectorSet(quantizedKey.Value[0], quantizedKey.Value[1], quantizedKey.Value[2], 0.0f), 1.0f / MaxQuantizedValue);
+    return XMVectorMultiplyAdd(normalized, XMLoadFloat3(&track.RangeExtent), XMLoadFloat3(&track.RangeMin));
+}
+
+XMVECTOR CompressedClip::SampleTrack(const Track& track, TrackType type, float quantizedTime, UINT& cursor) const
+{
+    const USHORT* times = &_keyTimes[track.FirstKey];
+    const UINT lastKey = track.KeyCount - 1;
+    if (lastKey == 0 || quantizedTime <= times[0])
+    {
+        cursor = 0;
+        return DecodeKey(track, type, 0);
+    }
+    if (quantizedTime >= times[lastKey])
+    {
+        cursor = lastKey - 1;
+        return DecodeKey(track, type, lastKey);
+    }
+
+    // Check key from previous call and next one before falling back to binary search.
+    UINT i = cursor;
+    if (!(i < lastKey && times[i] <= quantizedTime && quantizedTime <= times[i + 1]))
+    {
+        if (i + 1 < lastKey && times[i + 1] <= quantizedTime && quantizedTime <= times[i + 2])
+            i = i + 1;
+        else
+            i = (UINT)(std::upper_bound(times, times + track.KeyCount, quantizedTime) - times) - 1;
+    }
+    cursor = i;
+
+    // Key times of track are strictly increasing, BuildTrack merges keys with equal quantized times.
+    float lerpPercent = (quantizedTime - times[i]) / (float)(times[i + 1] - times[i]);
+    return InterpolateKeys(DecodeKey(track, type, i), DecodeKey(track, type, i + 1), lerpPercent, type);
+}
+
+CompressedClip::QuantizedKey CompressedClip::QuantizeRotation(FXMVECTOR q)
+{
+    XMFLOAT4 v;
+    XMStoreFloat4(&v, XMQuaternionNormalize(q));
+    float c[4] = { v.x, v.y, v.z, v.w };
+
+    UINT largest = 0;
+    for (UINT i = 1; i < 4; i++)
+    {
+        if (fabsf(c[i]) > fabsf(c[largest]))
+            largest = i;
+    }
+    // q and -q are the same rotation, flip so largest component is positive and can be restored from the rest.
+    float sign = c[largest] < 0.0f ? -1.0f : 1.0f;
+
+    uint64_t packed = largest;
+    for (UINT i = 0; i < 4; i++)
+    {
+        if (i == largest)
+            continue;
+        // Remaining components are in [-1/sqrt(2), 1/sqrt(2)].
+        float normalized = MathHelper::Clamp(sign * c[i] * 0.70710678f + 0.5f, 0.0f, 1.0f);
+        packed = (packed << 15) | (uint64_t)(normalized * MaxQuantizedRotation + 0.5f);
+    }
+
+    QuantizedKey key;
+    key.Value[0] = (USHORT)(packed >> 32);
+    key.Value[1] = (USHORT)(packed >> 16);
+    key.Value[2] = (USHORT)packed;
+    return key;
+}
+
+XMVECTOR CompressedClip::DequantizeRotation(const QuantizedKey& key)
+{
+    uint64_t packed = ((uint64_t)key.Value[0] << 32) | ((uint64_t)key.Value[1] << 16) | key.Value[2];
+    UINT largest = (UINT)(packed >> 45) & 3;
+
+    float c[4];
+    float sumSq = 0.0f;
+    for (int i = 3; i >= 0; i--)
+    {
+        if (i == (int)largest)
+            continue;
+        float normalized = (float)(packed & 0x7FFF) / MaxQuantizedRotation;
+        c[i] = (normalized - 0.5f) * 1.41421356f;
+        sumSq += c[i] * c[i];
+        packed >>= 15;
+    }
+    c[largest] = sqrtf(MathHelper::Max(1.0f - sumSq, 0.0f));
+    return XMQuaternionNormalize(XMVectorSet(c[0], c[1], c[2], c[3]));
+}
+}
@@ -0,0 +1,122 @@
+//
+// Animation clip compressed with key reduction and quantization.
+//
+
+#pragma once
+
+#include "../../../Core/D3DUtil.h"
+#include "../../../Core/AnimationHelper.h"
+
+namespace DX12Samples
+{
+struct AnimationClip;
+
+struct ClipCompressionSettings
+{
+    // Max distance between source and reconstructed translation for key to be removed.
+    float TranslationTolerance = 1.0e-3f;
+    // Max angle in radians between source and reconstructed rotation for key to be removed.
+    float RotationTolerance = 1.0e-3f;
+    // Max difference of scale components for key to be removed.
+    float ScaleTolerance = 1.0e-4f;
+};
+
+struct ClipCompressionReport
+{
+    size_t RawBytes = 0;
+    size_t CompressedBytes = 0;
+    UINT RawKeyCount = 0;
+    UINT CompressedKeyCount = 0;
+    // Max bone space errors over all bones and sampled times.
+    float MaxTranslationError = 0.0f;
+    float MaxRotationError = 0.0f;
+    float MaxScaleError = 0.0f;
+    // Average time to sample all bones of the clip in microseconds.
+    double RawSampleTime = 0.0;
+    double CompressedSampleTime = 0.0;
+
+    std::string ToString() const;
+};
+
+// Every bone has separate translation, scale and rotation tracks. Keys which can be restored by interpolation of
+// neighbours within tolerance are removed, then remaining keys are quantized to 48 bits:
+// rotations with smallest three encoding (2 bit index of largest component + 3 x 15 bits),
+// translations and scales as 3 x 16 bits in range of the track. Key times are stored as 16 bit fraction of clip duration.
+class CompressedClip
+{
+public:
+    void Build(const AnimationClip& clip, const ClipCompressionSettings& settings = ClipCompressionSettings());
+
+    UINT BoneCount() const;
+    UINT KeyCount() const;
+    float GetStartTime() const;
+    float GetEndTime() const;
+    /**
+     * \brief Memory used by tracks and keys in bytes.
+     */
+    size_t ByteSize() const;
+    /**
+     * \brief Number of keyframe cursors Interpolate needs, one per track.
+     */
+    UINT CursorCount() const;
+    /**
+     * \brief Decompress to parent transforms of all bones at time t.
+     * \param t animation time.
+     * \param boneTransforms output array of BoneCount() matrices.
+     * \param keyframeCursors array of CursorCount() cursors kept between calls.
+     */
+    void Interpolate(float t, DirectX::XMFLOAT4X4* boneTransforms, UINT* keyframeCursors) const;
+    /**
+     * \brief Decompress single bone at time t.
+     */
+    void Interpolate(float t, UINT bone, Keyframe& key, UINT* keyframeCursors) const;
+
+    /**
+     * \brief Compare compressed clip with source clip at sampleCount evenly spaced times and measure sampling speed of both.
+     */
+    static ClipCompressionReport Measure(const AnimationClip& clip, const CompressedClip& compressedClip, UINT sampleCount = 1000);
+
+private:
+    enum TrackType
+    {
+        TranslationTrack = 0,
+        ScaleTrack,
+        RotationTrack,
+        TrackTypeCount
+    };
+
+    struct Track
+    {
+        UINT FirstKey = 0;
+        UINT KeyCount = 0;
+        // Dequantization range, unused for rotations.
+        DirectX::XMFLOAT3 RangeMin = { 0.0f, 0.0f, 0.0f };
+        DirectX::XMFLOAT3 RangeExtent = { 0.0f, 0.0f, 0.0f };
+    };
+
+    struct QuantizedKey
+    {
+        USHORT Value[3];
+    };
+
+    float QuantizeTime(float t) const;
+    void SampleBone(float quantizedTime, UINT bone, DirectX::XMVECTOR& S, DirectX::XMVECTOR& P, DirectX::XMVECTOR& Q, UINT* keyframeCursors) const;
+    void BuildTrack(const BoneAnimation& boneAnimation, TrackType type, float tolerance, Track& track);
+    DirectX::XMVECTOR DecodeKey(const Track& track, TrackType type, UINT key) const;
+    /**
+     * \brief Interpolate track value at quantized time, cursor is updated with key found.
+     */
+    DirectX::XMVECTOR SampleTrack(const Track& track, TrackType type, float quantizedTime, UINT& cursor) const;
+
+    static QuantizedKey QuantizeRotation(DirectX::FXMVECTOR q);
+    static DirectX::XMVECTOR DequantizeRotation(const QuantizedKey& key);
+
+    UINT _boneCount = 0;
+    float _startTime = 0.0f;
+    float _endTime = 0.0f;
+    // _tracks[bone * TrackTypeCount + type].
+    std::vector<Track> _tracks;
+    std::vector<USHORT> _keyTimes;
+    std::vector<QuantizedKey> _keys;
+};
+}
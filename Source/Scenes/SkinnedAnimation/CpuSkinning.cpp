@@ -0,0 +1,67 @@
+#include "CpuSkinning.h"
+
+namespace DX12Samples
+{
+using namespace DirectX;
+
+namespace
+{
+// Vertex is ~20ns of work, chunks of this size keep scheduling overhead negligible.
+const UINT SkinningGrainSize = 1024;
+}
+
+void CpuSkinning::Skin(const M3dLoader::SkinnedVertex* vertices, UINT count, const XMFLOAT3X4* palette, SkinnedVertexResult* out)
+{
+    for (UINT i = 0; i < count; i++)
+    {
+        const M3dLoader::SkinnedVertex& vertex = vertices[i];
+        XMMATRIX m = BlendBones(vertex, palette);
+        XMStoreFloat3(&out[i].Pos, XMVector3Transform(XMLoadFloat3(&vertex.Pos), m));
+        XMStoreFloat3(&out[i].Normal, XMVector3TransformNormal(XMLoadFloat3(&vertex.Normal), m));
+        XMStoreFloat3(&out[i].TangentU, XMVector3TransformNormal(XMLoadFloat3(&vertex.TangentU), m));
+    }
+}
+
+void CpuSkinning::Skin(const M3dLoader::SkinnedVertex* vertices, UINT count, const XMFLOAT3X4* palette, SkinnedVertexResult* out, JobSystem& jobs)
+{
+    jobs.ParallelFor(count, SkinningGrainSize, [vertices, palette, out](UINT begin, UINT end, UINT workerIndex)
+    {
+        Skin(vertices + begin, end - begin, palette, out + begin);
+    });
+}
+
+void CpuSkinning::SkinPositions(const M3dLoader::SkinnedVertex* vertices, UINT count, const XMFLOAT3X4* palette, XMFLOAT3* positions)
+{
+    for (UINT i = 0; i < count; i++)
+    {
+        XMMATRIX m = BlendBones(vertices[i], palette);
+        XMStoreFloat3(&positions[i], XMVector3Transform(XMLoadFloat3(&vertices[i].Pos), m));
+    }
+}
+
+void CpuSkinning::SkinPositions(const M3dLoader::SkinnedVertex* vertices, UINT count, const XMFLOAT3X4* palette, XMFLOAT3* positions, JobSystem& jobs)
+{
+    jobs.ParallelFor(count, SkinningGrainSize, [vertices, palette, positions](UINT begin, UINT end, UINT workerIndex)
+    {
+        SkinPositions(vertices + begin, end - begin, palette, positions + begin);
+    });
+}
+
+XMMATRIX CpuSkinning::BlendBones(const M3dLoader::SkinnedVertex& vertex, const XMFLOAT3X4* palette)
+{
+    // Fourth weight is implicit like in the shader.
+    float weights[4] = { vertex.BoneWeights.x, vertex.BoneWeights.y, vertex.BoneWeights.z, 0.0f };
+    weights[3] = 1.0f - weights[0] - weights[1] - weights[2];
+
+    // Rows of transposed 3x4 matrices are blended directly, each is one vector.
+    XMVECTOR rows[3] = { XMVectorZero(), XMVectorZero(), XMVectorZero() };
+    for (UINT j = 0; j < 4; j++)
+    {
+        const XMFLOAT3X4& bone = palette[vertex.BoneIndices[j]];
+        XMVECTOR weight = XMVectorReplicate(weights[j]);
+        for (UINT row = 0; row < 3; row++)
+            rows[row] = XMVectorMultiplyAdd(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(bone.m[row])), weight, rows[row]);
+    }
+    return XMMatrixTranspose(XMMATRIX(rows[0], rows[1], rows[2], g_XMIdentityR3));
+}
+}
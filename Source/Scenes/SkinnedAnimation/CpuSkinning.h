@@ -0,0 +1,46 @@
+//
+// Linear blend skinning on CPU, same math as skinned vertex shader.
+//
+
+#pragma once
+
+#include "../../../Core/M3dLoader.h"
+#include "../../../Core/JobSystem.h"
+
+namespace DX12Samples
+{
+struct SkinnedVertexResult
+{
+    DirectX::XMFLOAT3 Pos;
+    DirectX::XMFLOAT3 Normal;
+    DirectX::XMFLOAT3 TangentU;
+};
+
+// Reference for Shaders/SkinnedRender/Default.hlsl and fallback for CPU side work on animated meshes, e.g. picking and bounds.
+// Palette is BoneCount() transposed 3x4 matrices from SkinnedData::GetFinalTransforms. For every vertex the 4 bone
+// matrices are blended by weights first, then blended matrix transforms position, normal and tangent, which gives
+// the same result as blending transformed vectors like the shader does.
+class CpuSkinning
+{
+public:
+    /**
+     * \brief Skin vertices [0, count) on calling thread.
+     */
+    static void Skin(const M3dLoader::SkinnedVertex* vertices, UINT count, const DirectX::XMFLOAT3X4* palette, SkinnedVertexResult* out);
+    /**
+     * \brief Skin vertices [0, count) on job system workers.
+     */
+    static void Skin(const M3dLoader::SkinnedVertex* vertices, UINT count, const DirectX::XMFLOAT3X4* palette, SkinnedVertexResult* out, JobSystem& jobs);
+    /**
+     * \brief Skin positions only, enough for picking and bounds.
+     */
+    static void SkinPositions(const M3dLoader::SkinnedVertex* vertices, UINT count, const DirectX::XMFLOAT3X4* palette, DirectX::XMFLOAT3* positions);
+    static void SkinPositions(const M3dLoader::SkinnedVertex* vertices, UINT count, const DirectX::XMFLOAT3X4* palette, DirectX::XMFLOAT3* positions, JobSystem& jobs);
+
+private:
+    /**
+     * \brief Blend 4 bone matrices of vertex by its weights. Returns matrix in row vector convention like XMLoadFloat3x4.
+     */
+    static DirectX::XMMATRIX BlendBones(const M3dLoader::SkinnedVertex& vertex, const DirectX::XMFLOAT3X4* palette);
+};
+}
@@ -26,7 +26,8 @@ public:
 
     struct SkinnedConstants
     {
-        DirectX::XMFLOAT4X4 BoneTransforms[96];
+        // Transposed affine transforms, last column is always (0, 0, 0, 1) and isn't uploaded.
+        DirectX::XMFLOAT3X4 BoneTransforms[96];
     };
 
     struct PassConstants
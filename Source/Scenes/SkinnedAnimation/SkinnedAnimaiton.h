@@ -12,6 +12,9 @@
 #include "../../../Core/Camera.h"
 #include "../Shadowmapping/ShadowMap.h"
 #include "../../../Core/M3dLoader.h"
+#include "../../../Core/AssetStreamer.h"
+#include "SkinnedBounds.h"
+#include "SkinnedCrowd.h"
 
 namespace DX12Samples
 {
@@ -62,6 +65,10 @@ protected:
      * \brief Handle keyboard input.
      */
     void OnKeyboardInput(const GameTimer& timer);
+    /**
+     * \brief Select soldier under cursor by its skinned triangles, selected soldier plays blend tree.
+     */
+    void Pick(int sx, int sy);
     /**
      * \brief Animate materials e.g water.
      */
@@ -95,9 +102,13 @@ protected:
      */
     void UpdateSSAOCB(const GameTimer& timer);
     /**
-     * \brief Load scene texutres from dds.
+     * \brief Request scene texutres from dds, resources are created when streamer dispatches completions.
+     */
+    void LoadTextures(AssetStreamer& streamer);
+    /**
+     * \brief Request textures which aren't loaded or requested yet.
      */
-    void LoadTextures();
+    void RequestTextures(AssetStreamer& streamer, const std::vector<std::string>& texNames, const std::vector<std::string>& texFilenames);
     /**
      * \brief Build scene main root signature.
      */
@@ -119,9 +130,9 @@ protected:
      */
     void BuildShapeGeometry();
     /**
-     * \brief Load sinned model from file.
+     * \brief Create sinned model geometry from loaded file and request its textures.
      */
-    void LoadSkinnedModel();
+    void LoadSkinnedModel(const SkinnedModelAsset& model, AssetStreamer& streamer);
     /**
      * \brief Build skull geometry.
      */
@@ -213,13 +224,32 @@ private:
 
     UINT _skinnedSrvHeapStart = 0;
     std::string _skinnedModelFilename = "Models\\soldier.m3d";
-    std::unique_ptr<SkinnedModelInstance> _skinnedModelInst;
     SkinnedData _skinnedInfo;
+    SkinnedBounds _skinnedBounds;
+    // Soldiers stand in CrowdRows x CrowdColumns grid and are animated on job system workers.
+    static const UINT CrowdRows = 5;
+    static const UINT CrowdColumns = 4;
+    JobSystem _jobs;
+    SkinnedCrowd _crowd;
+    std::vector<DirectX::XMFLOAT4X4> _crowdModels;
+    std::vector<DirectX::BoundingBox> _crowdBounds;
+    std::vector<bool> _crowdVisible;
+    std::vector<float> _crowdDistances;
+    AnimationLodPolicy _animationLodPolicy;
+    // Selected soldier plays blend tree, holding B cross fades it to still pose and back. Right click selects soldier.
+    UINT _selectedInstance = 0;
+    std::vector<DirectX::XMFLOAT3> _pickPositions;
+    AnimationBlendTree _blendTree;
+    AnimationBlendTree::NodeIndex _walkNode = AnimationBlendTree::InvalidNode;
+    AnimationBlendTree::NodeIndex _holdNode = AnimationBlendTree::InvalidNode;
+    AnimationBlendTree::NodeIndex _holdBlendNode = AnimationBlendTree::InvalidNode;
+    bool _holdPose = false;
     std::vector<M3dLoader::Subset> _skinnedSubsets;
     std::vector<M3dLoader::M3dMaterial> _skinnedMats;
     std::vector<std::string> _skinnedTextureNames;
 
     Camera _camera;
+    DirectX::BoundingFrustum _camFrustum;
     std::unique_ptr<ShadowMap> _shadowMap;
     std::unique_ptr<SSAO> _ssao;
     DirectX::BoundingSphere _sceneBounds;
@@ -230,6 +260,8 @@ private:
     DirectX::XMFLOAT4X4 _lightView = MathHelper::Identity4x4();
     DirectX::XMFLOAT4X4 _lightProj = MathHelper::Identity4x4();
     DirectX::XMFLOAT4X4 _shadowTransform = MathHelper::Identity4x4();
+    // Volume covered by shadow map in light view space.
+    DirectX::BoundingBox _shadowVolume;
 
     float _lightRotationAngle = 0.0f;
     DirectX::XMFLOAT3 _baseLightDirections[3] =
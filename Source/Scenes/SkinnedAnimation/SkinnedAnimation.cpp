@@ -1,7 +1,9 @@
 #include "SkinnedAnimaiton.h"
 
 #include <minwinbase.h>
+#include "../../../Core/BoundsBuilder.h"
 #include "../../../Core/GeometryGenerator.h"
+#include "CpuSkinning.h"
 
 namespace DX12Samples
 {
@@ -29,13 +31,28 @@ bool SkinnedAnimation::Init()
     _shadowMap = std::make_unique<ShadowMap>(_device.Get(), 2048, 2048);
     _ssao = std::make_unique<SSAO>(_device.Get(), _commandList.Get(), _clientWidth, _clientHeight);
 
-    LoadSkinnedModel();
-    LoadTextures();
+    // Model and textures are read and decoded on I/O threads while objects which don't need them are built.
+    AssetStreamer streamer;
+    AssetHandle<SkinnedModelAsset> skinnedModelHandle = streamer.LoadSkinnedModel(_skinnedModelFilename, AssetPriority::High);
+    LoadTextures(streamer);
     BuildRootSignature();
     BuildSSAORootSignature();
-    BuildDescriptorHeaps();
     BuildShaderAndInputLayout();
     BuildShapeGeometry();
+
+    std::shared_ptr<const SkinnedModelAsset> skinnedModel = skinnedModelHandle.Get();
+    if (skinnedModel == nullptr)
+    {
+        MessageBox(nullptr, AnsiToWString(_skinnedModelFilename + " not found.").c_str(), nullptr, 0);
+        return false;
+    }
+    LoadSkinnedModel(*skinnedModel, streamer);
+    streamer.Flush();
+    // Text model is converted once, following runs map binary file instead of parsing text.
+    if (!M3dLoader::IsBinaryUpToDate(_skinnedModelFilename))
+        M3dLoader().ConvertM3d(_skinnedModelFilename, M3dLoader::GetBinaryFilename(_skinnedModelFilename));
+
+    BuildDescriptorHeaps();
     BuildMaterials();
     BuildRenderItems();
     BuildFrameResources();
@@ -91,6 +108,8 @@ void SkinnedAnimation::OnResize()
 {
     Application::OnResize();
     _camera.SetFrustum(0.25f * MathHelper::Pi, AspectRatio(), 1.0f, 1000.0f);
+
+    BoundingFrustum::CreateFromMatrix(_camFrustum, _camera.GetProj());
     if (_ssao != nullptr)
     {
         _ssao->OnResize(_clientWidth, _clientHeight);
@@ -123,9 +142,9 @@ void SkinnedAnimation::Update(const GameTimer& timer)
     }
     AnimateMaterials(timer);
     UpdateObjectCBs(timer);
+    UpdateShadowTransform(timer);
     UpdateSkinnedCBs(timer);
     UpdateMaterialBuffer(timer);
-    UpdateShadowTransform(timer);
     UpdateMainPassCB(timer);
     UpdateShadowPassCB(timer);
     UpdateSSAOCB(timer);
@@ -205,9 +224,16 @@ void SkinnedAnimation::Draw(const GameTimer& timer)
 
 void SkinnedAnimation::OnMouseDown(WPARAM btnState, int x, int y)
 {
-    _lastMousePos.x = x;
-    _lastMousePos.y = y;
-    SetCapture(_hMainWindow);
+    if ((btnState & MK_LBUTTON) != 0)
+    {
+        _lastMousePos.x = x;
+        _lastMousePos.y = y;
+        SetCapture(_hMainWindow);
+    }
+    else if ((btnState & MK_RBUTTON) != 0)
+    {
+        Pick(x, y);
+    }
 }
 
 void SkinnedAnimation::OnMouseUp(WPARAM btnState, int x, int y)
@@ -245,9 +271,90 @@ void SkinnedAnimation::OnKeyboardInput(const GameTimer& timer)
     if (GetAsyncKeyState('D') & 0x8000)
         _camera.Strafe(10.0f * dt);
 
+    bool holdPose = (GetAsyncKeyState('B') & 0x8000) != 0;
+    if (holdPose != _holdPose && _holdBlendNode != AnimationBlendTree::InvalidNode)
+    {
+        _holdPose = holdPose;
+        // Still pose starts from current walk pose, so only walk slows down during the fade.
+        if (holdPose)
+            _blendTree.SetTimePos(_holdNode, _blendTree.GetTimePos(_walkNode));
+        _blendTree.CrossFade(_holdBlendNode, holdPose ? 1.0f : 0.0f, 0.3f);
+    }
+
     _camera.UpdateViewMatrix();
 }
 
+void SkinnedAnimation::Pick(int sx, int sy)
+{
+    XMFLOAT4X4 P = _camera.GetProj4x4f();
+
+    float vx = (+2.0f * sx / _clientWidth - 1.0f) / P(0, 0);
+    float vy = (-2.0f * sy / _clientHeight + 1.0f) / P(1, 1);
+
+    XMVECTOR rayOriginV = XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f);
+    XMVECTOR rayDirV = XMVectorSet(vx, vy, 1.0f, 0.0f);
+
+    XMMATRIX V = _camera.GetView();
+    XMMATRIX invView = XMMatrixInverse(&XMMatrixDeterminant(V), V);
+
+    MeshGeometry* geo = _geometries[_skinnedModelFilename].get();
+    auto vertices = (const M3dLoader::SkinnedVertex*)geo->VertexBufferCPU->GetBufferPointer();
+    auto indices = (const std::uint16_t*)geo->IndexBufferCPU->GetBufferPointer();
+    UINT vertexCount = geo->VertexBufferByteSize / geo->VertexByteStride;
+    UINT triCount = geo->IndexBufferByteSize / sizeof(std::uint16_t) / 3;
+    _pickPositions.resize(vertexCount);
+
+    // Bounds reject most soldiers, only soldiers which ray hits are skinned on CPU and tested per triangle.
+    float closestDistance = MathHelper::Infinity;
+    UINT picked = _crowd.InstanceCount();
+    for (UINT instance = 0; instance < _crowd.InstanceCount(); instance++)
+    {
+        XMMATRIX M = XMLoadFloat4x4(&_crowdModels[instance]);
+        XMMATRIX invModel = XMMatrixInverse(&XMMatrixDeterminant(M), M);
+        XMMATRIX toLocal = XMMatrixMultiply(invView, invModel);
+
+        XMVECTOR rayOrigin = XMVector3TransformCoord(rayOriginV, toLocal);
+        XMVECTOR rayDir = XMVector3Normalize(XMVector3TransformNormal(rayDirV, toLocal));
+
+        float tmin = 0.0f;
+        if (!_crowdBounds[instance].Intersects(rayOrigin, rayDir, tmin))
+            continue;
+
+        CpuSkinning::SkinPositions(vertices, vertexCount, _crowd.Palette(instance), _pickPositions.data(), _jobs);
+        tmin = MathHelper::Infinity;
+        for (UINT i = 0; i < triCount; i++)
+        {
+            XMVECTOR v0 = XMLoadFloat3(&_pickPositions[indices[i * 3 + 0]]);
+            XMVECTOR v1 = XMLoadFloat3(&_pickPositions[indices[i * 3 + 1]]);
+            XMVECTOR v2 = XMLoadFloat3(&_pickPositions[indices[i * 3 + 2]]);
+
+            float t = 0.0f;
+            if (TriangleTests::Intersects(rayOrigin, rayDir, v0, v1, v2, t) && t < tmin)
+                tmin = t;
+        }
+        if (tmin == MathHelper::Infinity)
+            continue;
+
+        // Soldiers have different local spaces, compare hits by view space distance.
+        XMVECTOR hit = XMVector3TransformCoord(XMVectorMultiplyAdd(rayDir, XMVectorReplicate(tmin), rayOrigin), XMMatrixMultiply(M, V));
+        float distance = XMVectorGetX(XMVector3Length(hit));
+        if (distance < closestDistance)
+        {
+            closestDistance = distance;
+            picked = instance;
+        }
+    }
+    if (picked == _crowd.InstanceCount() || picked == _selectedInstance)
+        return;
+
+    // Previous soldier continues its clip from where walk node is, new one starts walk node from its own time.
+    _crowd.Instance(_selectedInstance).TimePos = _blendTree.GetTimePos(_walkNode);
+    _crowd.SetBlendTree(_selectedInstance, nullptr);
+    _selectedInstance = picked;
+    _blendTree.SetTimePos(_walkNode, _crowd.Instance(picked).TimePos);
+    _crowd.SetBlendTree(picked, &_blendTree);
+}
+
 void SkinnedAnimation::AnimateMaterials(const GameTimer& timer)
 {
 }
@@ -277,13 +384,44 @@ void SkinnedAnimation::UpdateSkinnedCBs(const GameTimer& timer)
 {
     auto currSkinnedCB = _currFrameResource->SkinnedCB.get();
 
-    _skinnedModelInst->UpdateSkinnedAnimation(timer.DeltaTime());
+    XMVECTOR cameraPosition = _camera.GetPosition();
+    for (UINT i = 0; i < _crowd.InstanceCount(); i++)
+    {
+        XMVECTOR instancePosition = XMVectorSet(_crowdModels[i]._41, _crowdModels[i]._42, _crowdModels[i]._43, 1.0f);
+        _crowdDistances[i] = XMVectorGetX(XMVector3Length(XMVectorSubtract(instancePosition, cameraPosition)));
+    }
+    _crowd.UpdateLods(_animationLodPolicy, _crowdDistances.data());
+    _crowd.Update(timer.DeltaTime(), _jobs);
 
+    // Instance is drawn if it is in camera frustum or casts shadow into shadow map, otherwise palette isn't uploaded.
+    XMMATRIX view = _camera.GetView();
+    XMMATRIX lightView = XMLoadFloat4x4(&_lightView);
+    _skinnedBounds.Compute(_crowd.Palettes().data(), _crowd.InstanceCount(), _crowdBounds.data(), _jobs);
     SkinnedAnimFrameResource::SkinnedConstants skinnedConstants;
-    for (int i = 0; i < _skinnedModelInst->FinalTransforms.size(); i++)
-        skinnedConstants.BoneTransforms[i] = _skinnedModelInst->FinalTransforms[i];
-//    std::copy(std::begin(_skinnedModelInst->FinalTransforms), std::end(_skinnedModelInst->FinalTransforms), &skinnedConstants.BoneTransforms[0]);
-    currSkinnedCB->CopyData(0, skinnedConstants);
+    for (UINT i = 0; i < _crowd.InstanceCount(); i++)
+    {
+        const BoundingBox& bounds = _crowdBounds[i];
+
+        // Crowd models mirror and scale, which BoundingFrustum::Transform doesn't support, so boxes are moved to view space instead.
+        XMMATRIX model = XMLoadFloat4x4(&_crowdModels[i]);
+        BoundingBox viewSpaceBounds;
+        bounds.Transform(viewSpaceBounds, XMMatrixMultiply(model, view));
+        BoundingBox lightSpaceBounds;
+        bounds.Transform(lightSpaceBounds, XMMatrixMultiply(model, lightView));
+
+        _crowdVisible[i] = _camFrustum.Contains(viewSpaceBounds) != DISJOINT || _shadowVolume.Intersects(lightSpaceBounds);
+        if (!_crowdVisible[i])
+            continue;
+
+        std::copy(_crowd.Palette(i), _crowd.Palette(i) + _crowd.BoneCount(), &skinnedConstants.BoneTransforms[0]);
+        currSkinnedCB->CopyData(i, skinnedConstants);
+    }
+
+    for (RenderItem* ri : _renderItemLayer[(int)RenderLayer::SkinnedOpaque])
+    {
+        ri->Bounds = _crowdBounds[ri->SkinnedCBIndex];
+        ri->Visible = _crowdVisible[ri->SkinnedCBIndex];
+    }
 }
 
 void SkinnedAnimation::UpdateMaterialBuffer(const GameTimer& timer)
@@ -331,6 +469,7 @@ void SkinnedAnimation::UpdateShadowTransform(const GameTimer& timer)
 
     _lightNearZ = n;
     _lightFarZ = f;
+    BoundingBox::CreateFromPoints(_shadowVolume, XMVectorSet(l, b, n, 1.0f), XMVectorSet(r, t, f, 1.0f));
     XMMATRIX lightProj = XMMatrixOrthographicOffCenterLH(l, r, b, t, n, f);
 
     XMMATRIX T
@@ -456,7 +595,7 @@ void SkinnedAnimation::UpdateSSAOCB(const GameTimer& timer)
     currSssaoCB->CopyData(0, ssaoCB);
 }
 
-void SkinnedAnimation::LoadTextures()
+void SkinnedAnimation::LoadTextures(AssetStreamer& streamer)
 {
     std::vector<std::string> texNames =
     {
@@ -468,44 +607,36 @@ void SkinnedAnimation::LoadTextures()
         "defaultNormalMap",
         "skyCubeMap"
     };
-    std::vector<std::wstring> texFilenames =
+    std::vector<std::string> texFilenames =
     {
-        L"Textures/bricks2.dds",
-        L"Textures/bricks2_nmap.dds",
-        L"Textures/tile.dds",
-        L"Textures/tile_nmap.dds",
-        L"Textures/white1x1.dds",
-        L"Textures/default_nmap.dds",
-        L"Textures/sunsetcube1024.dds"
+        "Textures/bricks2.dds",
+        "Textures/bricks2_nmap.dds",
+        "Textures/tile.dds",
+        "Textures/tile_nmap.dds",
+        "Textures/white1x1.dds",
+        "Textures/default_nmap.dds",
+        "Textures/sunsetcube1024.dds"
     };
+    RequestTextures(streamer, texNames, texFilenames);
+}
 
-    for (UINT i = 0; i < _skinnedMats.size(); i++)
-    {
-        std::string diffuseName = _skinnedMats[i].DiffuseMapName;
-        std::string normalName = _skinnedMats[i].NormalMapName;
-
-        std::wstring diffuseFilename = L"Textures/" + AnsiToWString(diffuseName);
-        std::wstring normalFilename = L"Textures/" + AnsiToWString(normalName);
-
-        diffuseName = diffuseName.substr(0, diffuseName.find_last_of("."));
-        normalName = normalName.substr(0, normalName.find_last_of("."));
-
-        _skinnedTextureNames.push_back(diffuseName);
-        texNames.push_back(diffuseName);
-        texFilenames.push_back(diffuseFilename);
-
-        _skinnedTextureNames.push_back(normalName);
-        texNames.push_back(normalName);
-        texFilenames.push_back(normalFilename);
-    }
+void SkinnedAnimation::RequestTextures(AssetStreamer& streamer, const std::vector<std::string>& texNames, const std::vector<std::string>& texFilenames)
+{
     for (int i = 0; i < (int)texNames.size(); i++)
     {
         if (_textures.find(texNames[i]) == std::end(_textures))
         {
             auto texMap = std::make_unique<Texture>();
             texMap->Name = texNames[i];
-            texMap->Filename = texFilenames[i];
-            ThrowIfFailed(DirectX::CreateDDSTextureFromFile12(_device.Get(), _commandList.Get(), texMap->Filename.c_str(), texMap->Resource, texMap->UploadHeap));
+            texMap->Filename = AnsiToWString(texFilenames[i]);
+
+            Texture* texture = texMap.get();
+            streamer.LoadTextureFile(texFilenames[i], AssetPriority::Normal, [this, texture](const std::shared_ptr<const TextureFileAsset>& file)
+            {
+                if (file == nullptr)
+                    throw DxException(HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND), texture->Filename, AnsiToWString(__FILE__), __LINE__);
+                ThrowIfFailed(DirectX::CreateDDSTextureFromMemory12(_device.Get(), _commandList.Get(), file->Data.data(), file->Data.size(), texture->Resource, texture->UploadHeap));
+            });
             _textures[texMap->Name] = std::move(texMap);
         }
     }
@@ -765,30 +896,13 @@ void SkinnedAnimation::BuildShapeGeometry()
     UINT cylinderIndexOffset = sphereIndexOffset + (UINT)sphere.Indices32.size();
     UINT quadIndexOffset = cylinderIndexOffset + (UINT)cylinder.Indices32.size();
 
-    SubmeshGeometry boxSubmesh;
-    boxSubmesh.IndexCount = (UINT)box.Indices32.size();
-    boxSubmesh.StartIndexLocation = boxIndexOffset;
-    boxSubmesh.BaseVertexLocation = boxVertexOffset;
-
-    SubmeshGeometry gridSubmesh;
-    gridSubmesh.IndexCount = (UINT)grid.Indices32.size();
-    gridSubmesh.StartIndexLocation = gridIndexOffset;
-    gridSubmesh.BaseVertexLocation = gridVertexOffset;
-
-    SubmeshGeometry sphereSubmesh;
-    sphereSubmesh.IndexCount = (UINT)sphere.Indices32.size();
-    sphereSubmesh.StartIndexLocation = sphereIndexOffset;
-    sphereSubmesh.BaseVertexLocation = sphereVertexOffset;
-
-    SubmeshGeometry cylinderSubmesh;
-    cylinderSubmesh.IndexCount = (UINT)cylinder.Indices32.size();
-    cylinderSubmesh.StartIndexLocation = cylinderIndexOffset;
-    cylinderSubmesh.BaseVertexLocation = cylinderVertexOffset;
+    BoundsBuilder boundsBuilder;
 
-    SubmeshGeometry quadSubmesh;
-    quadSubmesh.IndexCount = (UINT)quad.Indices32.size();
-    quadSubmesh.StartIndexLocation = quadIndexOffset;
-    quadSubmesh.BaseVertexLocation = quadVertexOffset;
+    SubmeshGeometry boxSubmesh = boundsBuilder.CreateSubmesh(box, boxIndexOffset, boxVertexOffset);
+    SubmeshGeometry gridSubmesh = boundsBuilder.CreateSubmesh(grid, gridIndexOffset, gridVertexOffset);
+    SubmeshGeometry sphereSubmesh = boundsBuilder.CreateSubmesh(sphere, sphereIndexOffset, sphereVertexOffset);
+    SubmeshGeometry cylinderSubmesh = boundsBuilder.CreateSubmesh(cylinder, cylinderIndexOffset, cylinderVertexOffset);
+    SubmeshGeometry quadSubmesh = boundsBuilder.CreateSubmesh(quad, quadIndexOffset, quadVertexOffset);
 
     auto totalVertexCount =
         box.Vertices.size() +
@@ -879,19 +993,64 @@ void SkinnedAnimation::BuildShapeGeometry()
     _geometries[geo->Name] = move(geo);
 }
 
-void SkinnedAnimation::LoadSkinnedModel()
+void SkinnedAnimation::LoadSkinnedModel(const SkinnedModelAsset& model, AssetStreamer& streamer)
 {
-    std::vector<M3dLoader::SkinnedVertex> vertices;
-    std::vector<std::uint16_t> indices;
+    const std::vector<M3dLoader::SkinnedVertex>& vertices = model.Vertices;
+    const std::vector<std::uint16_t>& indices = model.Indices;
+    _skinnedSubsets = model.Subsets;
+    _skinnedMats = model.Materials;
+    _skinnedInfo = model.SkinnedInfo;
+
+    std::vector<std::string> texNames;
+    std::vector<std::string> texFilenames;
+    for (UINT i = 0; i < _skinnedMats.size(); i++)
+    {
+        std::string diffuseName = _skinnedMats[i].DiffuseMapName;
+        std::string normalName = _skinnedMats[i].NormalMapName;
 
-    M3dLoader m3dLoader;
-    m3dLoader.LoadM3d(_skinnedModelFilename, vertices, indices, _skinnedSubsets, _skinnedMats, _skinnedInfo);
+        std::string diffuseFilename = "Textures/" + diffuseName;
+        std::string normalFilename = "Textures/" + normalName;
 
-    _skinnedModelInst = std::make_unique<SkinnedModelInstance>();
-    _skinnedModelInst->SkinnedInfo = &_skinnedInfo;
-    _skinnedModelInst->FinalTransforms.resize(_skinnedInfo.BoneCount());
-    _skinnedModelInst->ClipName = "Take1";
-    _skinnedModelInst->TimePos = 0.0f;
+        diffuseName = diffuseName.substr(0, diffuseName.find_last_of("."));
+        normalName = normalName.substr(0, normalName.find_last_of("."));
+
+        _skinnedTextureNames.push_back(diffuseName);
+        texNames.push_back(diffuseName);
+        texFilenames.push_back(diffuseFilename);
+
+        _skinnedTextureNames.push_back(normalName);
+        texNames.push_back(normalName);
+        texFilenames.push_back(normalFilename);
+    }
+    RequestTextures(streamer, texNames, texFilenames);
+
+    _skinnedInfo.BuildLods(_animationLodPolicy.SkeletonLodCount());
+    _crowd.Init(&_skinnedInfo, CrowdRows * CrowdColumns, "Take1", _jobs.WorkerCount());
+    _crowdModels.resize(_crowd.InstanceCount());
+    _crowdBounds.resize(_crowd.InstanceCount());
+    _crowdVisible.resize(_crowd.InstanceCount());
+    _crowdDistances.resize(_crowd.InstanceCount());
+    for (UINT row = 0; row < CrowdRows; row++)
+    {
+        for (UINT column = 0; column < CrowdColumns; column++)
+        {
+            XMMATRIX modelScale = XMMatrixScaling(0.05f, 0.05f, -0.05f);
+            XMMATRIX modelRot = XMMatrixRotationY(MathHelper::Pi);
+            XMMATRIX modelOffset = XMMatrixTranslation(-3.0f + 2.0f * column, 0.0f, -5.0f + 3.0f * row);
+            XMStoreFloat4x4(&_crowdModels[row * CrowdColumns + column], modelScale * modelRot * modelOffset);
+        }
+    }
+
+    SkinnedData::ClipHandle clip = _skinnedInfo.FindClip("Take1");
+    _blendTree.Init(&_skinnedInfo);
+    _walkNode = _blendTree.AddClip(clip);
+    _holdNode = _blendTree.AddClip(clip, 0.0f);
+    _holdBlendNode = _blendTree.AddBlend(_walkNode, _holdNode, 0.0f);
+    _blendTree.SetRoot(_holdBlendNode);
+    _blendTree.SetTimePos(_walkNode, _crowd.Instance(_selectedInstance).TimePos);
+    _crowd.SetBlendTree(_selectedInstance, &_blendTree);
+
+    _skinnedBounds.Build(_skinnedInfo, vertices);
 
     const UINT vbByteSize = (UINT)vertices.size() * sizeof(M3dLoader::SkinnedVertex);
     const UINT ibByteSize = (UINT)indices.size() * sizeof(std::uint16_t);
@@ -914,15 +1073,14 @@ void SkinnedAnimation::LoadSkinnedModel()
     geo->IndexFormat = DXGI_FORMAT_R16_UINT;
     geo->IndexBufferByteSize = ibByteSize;
 
+    // Bind pose bounds of subset vertices, animated instances get bounds from _skinnedBounds every frame.
+    BoundsBuilder boundsBuilder;
     for (UINT i = 0; i < (UINT)_skinnedSubsets.size(); i++)
     {
-        SubmeshGeometry submesh;
+        const M3dLoader::Subset& subset = _skinnedSubsets[i];
         std::string name = "sm_" + std::to_string(i);
-
-        submesh.IndexCount = (UINT)_skinnedSubsets[i].FaceCount * 3;
-        submesh.StartIndexLocation = _skinnedSubsets[i].FaceStart * 3;
-        submesh.BaseVertexLocation = 0;
-        geo->DrawArgs[name] = submesh;
+        geo->DrawArgs[name] = boundsBuilder.CreateSubmesh(&vertices[subset.VertexStart].Pos, subset.VertexCount, sizeof(M3dLoader::SkinnedVertex),
+            subset.FaceCount * 3, subset.FaceStart * 3, 0);
     }
     _geometries[geo->Name] = std::move(geo);
 }
@@ -1111,7 +1269,7 @@ void SkinnedAnimation::BuildPSOs()
 void SkinnedAnimation::BuildFrameResources()
 {
     for (int i = 0; i < FrameResource::NumFrameResources; i++)
-        _frameResources.push_back(std::make_unique<FrameResource>(_device.Get(), 2, (UINT)_allRenderItems.size(), 1, (UINT)_materials.size()));
+        _frameResources.push_back(std::make_unique<FrameResource>(_device.Get(), 2, (UINT)_allRenderItems.size(), _crowd.InstanceCount(), (UINT)_materials.size()));
 }
 
 void SkinnedAnimation::BuildMaterials()
@@ -1186,6 +1344,7 @@ void SkinnedAnimation::BuildRenderItems()
     skyRitem->IndexCount = skyRitem->Geo->DrawArgs["sphere"].IndexCount;
     skyRitem->StartIndexLocation = skyRitem->Geo->DrawArgs["sphere"].StartIndexLocation;
     skyRitem->BaseVertexLocation = skyRitem->Geo->DrawArgs["sphere"].BaseVertexLocation;
+    skyRitem->Bounds = skyRitem->Geo->DrawArgs["sphere"].Bounds;
     _renderItemLayer[(int)RenderLayer::Sky].push_back(skyRitem.get());
     _allRenderItems.push_back(move(skyRitem));
 
@@ -1199,6 +1358,7 @@ void SkinnedAnimation::BuildRenderItems()
     quadRitem->IndexCount = quadRitem->Geo->DrawArgs["quad"].IndexCount;
     quadRitem->StartIndexLocation = quadRitem->Geo->DrawArgs["quad"].StartIndexLocation;
     quadRitem->BaseVertexLocation = quadRitem->Geo->DrawArgs["quad"].BaseVertexLocation;
+    quadRitem->Bounds = quadRitem->Geo->DrawArgs["quad"].Bounds;
     _renderItemLayer[(int)RenderLayer::Debug].push_back(quadRitem.get());
     _allRenderItems.push_back(move(quadRitem));
 
@@ -1212,6 +1372,7 @@ void SkinnedAnimation::BuildRenderItems()
     boxRitem->IndexCount = boxRitem->Geo->DrawArgs["box"].IndexCount;
     boxRitem->StartIndexLocation = boxRitem->Geo->DrawArgs["box"].StartIndexLocation;
     boxRitem->BaseVertexLocation = boxRitem->Geo->DrawArgs["box"].BaseVertexLocation;
+    boxRitem->Bounds = boxRitem->Geo->DrawArgs["box"].Bounds;
     _renderItemLayer[(int)RenderLayer::Opaque].push_back(boxRitem.get());
     _allRenderItems.push_back(move(boxRitem));
     
@@ -1225,6 +1386,7 @@ void SkinnedAnimation::BuildRenderItems()
     gridRitem->IndexCount = gridRitem->Geo->DrawArgs["grid"].IndexCount;
     gridRitem->StartIndexLocation = gridRitem->Geo->DrawArgs["grid"].StartIndexLocation;
     gridRitem->BaseVertexLocation = gridRitem->Geo->DrawArgs["grid"].BaseVertexLocation;
+    gridRitem->Bounds = gridRitem->Geo->DrawArgs["grid"].Bounds;
     _renderItemLayer[(int)RenderLayer::Opaque].push_back(gridRitem.get());
     _allRenderItems.push_back(move(gridRitem));
 
@@ -1252,6 +1414,7 @@ void SkinnedAnimation::BuildRenderItems()
         leftCylRitem->IndexCount = leftCylRitem->Geo->DrawArgs["cylinder"].IndexCount;
         leftCylRitem->StartIndexLocation = leftCylRitem->Geo->DrawArgs["cylinder"].StartIndexLocation;
         leftCylRitem->BaseVertexLocation = leftCylRitem->Geo->DrawArgs["cylinder"].BaseVertexLocation;
+        leftCylRitem->Bounds = leftCylRitem->Geo->DrawArgs["cylinder"].Bounds;
 
         XMStoreFloat4x4(&rightCylRitem->Model, leftCylWorld);
         XMStoreFloat4x4(&rightCylRitem->TexTransform, brickTexTransform);
@@ -1262,6 +1425,7 @@ void SkinnedAnimation::BuildRenderItems()
         rightCylRitem->IndexCount = rightCylRitem->Geo->DrawArgs["cylinder"].IndexCount;
         rightCylRitem->StartIndexLocation = rightCylRitem->Geo->DrawArgs["cylinder"].StartIndexLocation;
         rightCylRitem->BaseVertexLocation = rightCylRitem->Geo->DrawArgs["cylinder"].BaseVertexLocation;
+        rightCylRitem->Bounds = rightCylRitem->Geo->DrawArgs["cylinder"].Bounds;
 
         XMStoreFloat4x4(&leftSphereRitem->Model, leftSphereWorld);
         leftSphereRitem->TexTransform = MathHelper::Identity4x4();
@@ -1272,6 +1436,7 @@ void SkinnedAnimation::BuildRenderItems()
         leftSphereRitem->IndexCount = leftSphereRitem->Geo->DrawArgs["sphere"].IndexCount;
         leftSphereRitem->StartIndexLocation = leftSphereRitem->Geo->DrawArgs["sphere"].StartIndexLocation;
         leftSphereRitem->BaseVertexLocation = leftSphereRitem->Geo->DrawArgs["sphere"].BaseVertexLocation;
+        leftSphereRitem->Bounds = leftSphereRitem->Geo->DrawArgs["sphere"].Bounds;
 
         XMStoreFloat4x4(&rightSphereRitem->Model, rightSphereWorld);
         rightSphereRitem->TexTransform = MathHelper::Identity4x4();
@@ -1282,6 +1447,7 @@ void SkinnedAnimation::BuildRenderItems()
         rightSphereRitem->IndexCount = rightSphereRitem->Geo->DrawArgs["sphere"].IndexCount;
         rightSphereRitem->StartIndexLocation = rightSphereRitem->Geo->DrawArgs["sphere"].StartIndexLocation;
         rightSphereRitem->BaseVertexLocation = rightSphereRitem->Geo->DrawArgs["sphere"].BaseVertexLocation;
+        rightSphereRitem->Bounds = rightSphereRitem->Geo->DrawArgs["sphere"].Bounds;
 
         _renderItemLayer[(int)RenderLayer::Opaque].push_back(leftCylRitem.get());
         _renderItemLayer[(int)RenderLayer::Opaque].push_back(rightCylRitem.get());
@@ -1293,31 +1459,31 @@ void SkinnedAnimation::BuildRenderItems()
         _allRenderItems.push_back(move(leftSphereRitem));
         _allRenderItems.push_back(move(rightSphereRitem));
     }
-    for (UINT i = 0; i < _skinnedMats.size(); i++)
+    for (UINT instance = 0; instance < _crowd.InstanceCount(); instance++)
     {
-        std::string submeshName = "sm_" + std::to_string(i);
-
-        auto ritem = std::make_unique<RenderItem>();
-
-        XMMATRIX modelScale = XMMatrixScaling(0.05f, 0.05f, -0.05f);
-        XMMATRIX modelRot = XMMatrixRotationY(MathHelper::Pi);
-        XMMATRIX modelOffset = XMMatrixTranslation(0.0f, 0.0f, -5.0f);
-        XMStoreFloat4x4(&ritem->Model, modelScale*modelRot*modelOffset);
-
-        ritem->TexTransform = MathHelper::Identity4x4();
-        ritem->ObjCBIndex = objCBIndex++;
-        ritem->Mat = _materials[_skinnedMats[i].Name].get();
-        ritem->Geo = _geometries[_skinnedModelFilename].get();
-        ritem->PrimitiveType = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-        ritem->IndexCount = ritem->Geo->DrawArgs[submeshName].IndexCount;
-        ritem->StartIndexLocation = ritem->Geo->DrawArgs[submeshName].StartIndexLocation;
-        ritem->BaseVertexLocation = ritem->Geo->DrawArgs[submeshName].BaseVertexLocation;
-
-        ritem->SkinnedCBIndex = 0;
-        ritem->SkinnedModelInst = _skinnedModelInst.get();
-
-        _renderItemLayer[(int)RenderLayer::SkinnedOpaque].push_back(ritem.get());
-        _allRenderItems.push_back(std::move(ritem));
+        for (UINT i = 0; i < _skinnedMats.size(); i++)
+        {
+            std::string submeshName = "sm_" + std::to_string(i);
+
+            auto ritem = std::make_unique<RenderItem>();
+
+            ritem->Model = _crowdModels[instance];
+            ritem->TexTransform = MathHelper::Identity4x4();
+            ritem->ObjCBIndex = objCBIndex++;
+            ritem->Mat = _materials[_skinnedMats[i].Name].get();
+            ritem->Geo = _geometries[_skinnedModelFilename].get();
+            ritem->PrimitiveType = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+            ritem->IndexCount = ritem->Geo->DrawArgs[submeshName].IndexCount;
+            ritem->StartIndexLocation = ritem->Geo->DrawArgs[submeshName].StartIndexLocation;
+            ritem->BaseVertexLocation = ritem->Geo->DrawArgs[submeshName].BaseVertexLocation;
+            ritem->Bounds = ritem->Geo->DrawArgs[submeshName].Bounds;
+
+            ritem->SkinnedCBIndex = instance;
+            ritem->SkinnedModelInst = &_crowd.Instance(instance);
+
+            _renderItemLayer[(int)RenderLayer::SkinnedOpaque].push_back(ritem.get());
+            _allRenderItems.push_back(std::move(ritem));
+        }
     }
 }
 
@@ -1333,6 +1499,9 @@ void SkinnedAnimation::DrawRenderItems(ID3D12GraphicsCommandList* cmdList, const
     {
         auto ri = renderItems[i];
 
+        if (ri->Visible == false)
+            continue;
+
         cmdList->IASetVertexBuffers(0, 1, &ri->Geo->VertexBufferView());
         cmdList->IASetIndexBuffer(&ri->Geo->IndexBufferView());
         cmdList->IASetPrimitiveTopology(ri->PrimitiveType);
@@ -1343,7 +1512,7 @@ void SkinnedAnimation::DrawRenderItems(ID3D12GraphicsCommandList* cmdList, const
 
         if (ri->SkinnedModelInst != nullptr)
         {
-            D3D12_GPU_VIRTUAL_ADDRESS skinnedCBAddress = skinnedCB->GetGPUVirtualAddress();
+            D3D12_GPU_VIRTUAL_ADDRESS skinnedCBAddress = skinnedCB->GetGPUVirtualAddress() + ri->SkinnedCBIndex * skinnedCBByteSize;
             cmdList->SetGraphicsRootConstantBufferView(1, skinnedCBAddress);
         }
         else
@@ -0,0 +1,107 @@
+#include "SkinnedBounds.h"
+
+namespace DX12Samples
+{
+using namespace DirectX;
+
+namespace
+{
+// Influences below this weight are ignored, otherwise few far vertices with negligible weights inflate whole bone box.
+// Vertex can stick out of bounds by at most this fraction of distance between its positions moved by the two bones.
+const float MinBoundsWeight = 0.01f;
+}
+
+void SkinnedBounds::Build(const SkinnedData& skinnedInfo, const std::vector<M3dLoader::SkinnedVertex>& vertices)
+{
+    const std::vector<XMFLOAT4X4>& boneOffsets = skinnedInfo.GetBoneOffsets();
+    _boneCount = skinnedInfo.BoneCount();
+
+    std::vector<XMFLOAT3> boneMin(_boneCount, XMFLOAT3(MathHelper::Infinity, MathHelper::Infinity, MathHelper::Infinity));
+    std::vector<XMFLOAT3> boneMax(_boneCount, XMFLOAT3(-MathHelper::Infinity, -MathHelper::Infinity, -MathHelper::Infinity));
+    std::vector<bool> used(_boneCount, false);
+    for (const M3dLoader::SkinnedVertex& vertex : vertices)
+    {
+        float weights[4] = { vertex.BoneWeights.x, vertex.BoneWeights.y, vertex.BoneWeights.z, 0.0f };
+        weights[3] = 1.0f - weights[0] - weights[1] - weights[2];
+
+        XMVECTOR pos = XMLoadFloat3(&vertex.Pos);
+        for (UINT j = 0; j < 4; j++)
+        {
+            UINT bone = vertex.BoneIndices[j];
+            if (weights[j] < MinBoundsWeight || bone >= _boneCount)
+                continue;
+
+            // Bone offset moves bind pose vertex to bone space.
+            XMVECTOR p = XMVector3Transform(pos, XMLoadFloat4x4(&boneOffsets[bone]));
+            XMStoreFloat3(&boneMin[bone], XMVectorMin(XMLoadFloat3(&boneMin[bone]), p));
+            XMStoreFloat3(&boneMax[bone], XMVectorMax(XMLoadFloat3(&boneMax[bone]), p));
+            used[bone] = true;
+        }
+    }
+
+    _bones.clear();
+    _boxes.clear();
+    for (UINT bone = 0; bone < _boneCount; bone++)
+    {
+        if (!used[bone])
+            continue;
+
+        XMVECTOR minPoint = XMLoadFloat3(&boneMin[bone]);
+        XMVECTOR maxPoint = XMLoadFloat3(&boneMax[bone]);
+        XMVECTOR center = XMVectorScale(XMVectorAdd(minPoint, maxPoint), 0.5f);
+        XMFLOAT3 extents;
+        XMStoreFloat3(&extents, XMVectorScale(XMVectorSubtract(maxPoint, minPoint), 0.5f));
+
+        XMMATRIX offset = XMLoadFloat4x4(&boneOffsets[bone]);
+        XMMATRIX toBindPose = XMMatrixInverse(nullptr, offset);
+
+        BoneBox box;
+        XMStoreFloat3(&box.Center, XMVector3Transform(center, toBindPose));
+        XMStoreFloat3(&box.Axes[0], XMVectorScale(toBindPose.r[0], extents.x));
+        XMStoreFloat3(&box.Axes[1], XMVectorScale(toBindPose.r[1], extents.y));
+        XMStoreFloat3(&box.Axes[2], XMVectorScale(toBindPose.r[2], extents.z));
+
+        _bones.push_back(bone);
+        _boxes.push_back(box);
+    }
+}
+
+UINT SkinnedBounds::BoneCount() const
+{
+    return _boneCount;
+}
+
+void SkinnedBounds::Compute(const XMFLOAT3X4* palette, BoundingBox& bounds) const
+{
+    XMVECTOR minPoint = XMVectorReplicate(MathHelper::Infinity);
+    XMVECTOR maxPoint = XMVectorReplicate(-MathHelper::Infinity);
+    for (size_t i = 0; i < _bones.size(); i++)
+    {
+        const BoneBox& box = _boxes[i];
+        XMMATRIX m = XMLoadFloat3x4(&palette[_bones[i]]);
+
+        // Extents of moved box along world axes are sums of absolute projections of its half axes.
+        XMVECTOR center = XMVector3Transform(XMLoadFloat3(&box.Center), m);
+        XMVECTOR extents = XMVectorAbs(XMVector3TransformNormal(XMLoadFloat3(&box.Axes[0]), m));
+        extents = XMVectorAdd(extents, XMVectorAbs(XMVector3TransformNormal(XMLoadFloat3(&box.Axes[1]), m)));
+        extents = XMVectorAdd(extents, XMVectorAbs(XMVector3TransformNormal(XMLoadFloat3(&box.Axes[2]), m)));
+
+        minPoint = XMVectorMin(minPoint, XMVectorSubtract(center, extents));
+        maxPoint = XMVectorMax(maxPoint, XMVectorAdd(center, extents));
+    }
+
+    XMStoreFloat3(&bounds.Center, XMVectorScale(XMVectorAdd(minPoint, maxPoint), 0.5f));
+    XMStoreFloat3(&bounds.Extents, XMVectorScale(XMVectorSubtract(maxPoint, minPoint), 0.5f));
+}
+
+void SkinnedBounds::Compute(const XMFLOAT3X4* palettes, UINT instanceCount, BoundingBox* bounds, JobSystem& jobs) const
+{
+    // Instance is ~one microsecond for 58 bones.
+    const UINT grainSize = 64;
+    jobs.ParallelFor(instanceCount, grainSize, [this, palettes, bounds](UINT begin, UINT end, UINT workerIndex)
+    {
+        for (UINT i = begin; i < end; i++)
+            Compute(palettes + (size_t)i * _boneCount, bounds[i]);
+    });
+}
+}
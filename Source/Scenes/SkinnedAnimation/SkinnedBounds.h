@@ -0,0 +1,49 @@
+//
+// Animated bounding boxes of skinned meshes.
+//
+
+#pragma once
+
+#include <DirectXCollision.h>
+
+#include "../../../Core/M3dLoader.h"
+#include "../../../Core/JobSystem.h"
+
+namespace DX12Samples
+{
+// Every bone gets AABB of vertices it influences with non negligible weight, built in bone space from bind pose. Skinned
+// vertex is a weighted average of its position moved by each influencing bone, so it stays inside union of bone boxes
+// moved by palette. Instance box is AABB of that union, tight for any pose and cheap enough to compute every frame.
+class SkinnedBounds
+{
+public:
+    /**
+     * \brief Build bone boxes from bind pose vertices. Bones which don't influence any vertex are skipped.
+     */
+    void Build(const SkinnedData& skinnedInfo, const std::vector<M3dLoader::SkinnedVertex>& vertices);
+
+    UINT BoneCount() const;
+    /**
+     * \brief Get bounds of skinned mesh in model space.
+     * \param palette BoneCount() transposed final transforms from SkinnedData::GetFinalTransforms.
+     */
+    void Compute(const DirectX::XMFLOAT3X4* palette, DirectX::BoundingBox& bounds) const;
+    /**
+     * \brief Get bounds of instanceCount instances on job system workers.
+     * \param palettes contiguous palettes, instance i starts at i * BoneCount() like SkinnedCrowd::Palettes.
+     */
+    void Compute(const DirectX::XMFLOAT3X4* palettes, UINT instanceCount, DirectX::BoundingBox* bounds, JobSystem& jobs) const;
+
+private:
+    // Bone space box mapped back to bind pose: center and half axes. Moving it by palette gives bone box in animated pose.
+    struct BoneBox
+    {
+        DirectX::XMFLOAT3 Center;
+        DirectX::XMFLOAT3 Axes[3];
+    };
+
+    UINT _boneCount = 0;
+    std::vector<UINT> _bones;
+    std::vector<BoneBox> _boxes;
+};
+}
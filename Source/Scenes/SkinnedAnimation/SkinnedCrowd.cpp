@@ -0,0 +1,106 @@
+#include "SkinnedCrowd.h"
+
+namespace DX12Samples
+{
+using namespace DirectX;
+
+void SkinnedCrowd::Init(SkinnedData* skinnedInfo, UINT instanceCount, const std::string& clipName, UINT workerCount)
+{
+    _skinnedInfo = skinnedInfo;
+    _boneCount = skinnedInfo->BoneCount();
+
+    _instances.resize(instanceCount);
+    _palettes.resize((size_t)instanceCount * _boneCount);
+
+    SkinnedData::ClipHandle clip = skinnedInfo->FindClip(clipName);
+    float clipEndTime = skinnedInfo->GetClipEndTime(clip);
+    for (UINT i = 0; i < instanceCount; i++)
+    {
+        _instances[i].SkinnedInfo = skinnedInfo;
+        _instances[i].SetClip(clipName);
+        _instances[i].TimePos = MathHelper::RandF(0.0f, clipEndTime);
+    }
+
+    _arenas.clear();
+    for (UINT i = 0; i < MathHelper::Max(workerCount, 1u); i++)
+        _arenas.push_back(std::make_unique<FrameArena>(skinnedInfo->GetFinalTransformsScratchSize()));
+}
+
+void SkinnedCrowd::Update(float dt, JobSystem& jobs)
+{
+    assert(jobs.WorkerCount() <= _arenas.size());
+
+    // Instance update is ~tens of microseconds, batch a few per task to keep scheduling overhead low.
+    const UINT grainSize = 16;
+    jobs.ParallelFor(InstanceCount(), grainSize, [this, dt](UINT begin, UINT end, UINT workerIndex)
+    {
+        UpdateRange(dt, begin, end, workerIndex);
+    });
+}
+
+void SkinnedCrowd::Update(float dt)
+{
+    UpdateRange(dt, 0, InstanceCount(), 0);
+}
+
+void SkinnedCrowd::UpdateLods(const AnimationLodPolicy& policy, const float* distances)
+{
+    assert(policy.SkeletonLodCount() <= _skinnedInfo->LodCount());
+
+    // Instance index as phase spreads evaluations of reduced rate instances evenly over frames.
+    for (UINT i = 0; i < InstanceCount(); i++)
+        _instances[i].SetLod(policy.GetLevel(policy.SelectLevel(distances[i])), i);
+}
+
+void SkinnedCrowd::SetBlendTree(UINT instance, AnimationBlendTree* blendTree)
+{
+    _instances[instance].BlendTree = blendTree;
+    if (blendTree == nullptr)
+    {
+        // Reduced rate palettes are stale after blend tree, evaluate them again.
+        _instances[instance].LodChanged = true;
+        return;
+    }
+    // Arenas hold scratch only during Update, they can be reset here.
+    for (auto& arena : _arenas)
+    {
+        arena->Reset();
+        arena->Reserve(blendTree->GetScratchSize());
+    }
+}
+
+UINT SkinnedCrowd::InstanceCount() const
+{
+    return (UINT)_instances.size();
+}
+
+UINT SkinnedCrowd::BoneCount() const
+{
+    return _boneCount;
+}
+
+SkinnedModelInstance& SkinnedCrowd::Instance(UINT index)
+{
+    return _instances[index];
+}
+
+const XMFLOAT3X4* SkinnedCrowd::Palette(UINT instance) const
+{
+    return &_palettes[(size_t)instance * _boneCount];
+}
+
+const std::vector<XMFLOAT3X4>& SkinnedCrowd::Palettes() const
+{
+    return _palettes;
+}
+
+void SkinnedCrowd::UpdateRange(float dt, UINT begin, UINT end, UINT workerIndex)
+{
+    FrameArena& arena = *_arenas[workerIndex];
+    for (UINT i = begin; i < end; i++)
+    {
+        arena.Reset();
+        _instances[i].UpdateSkinnedAnimation(dt, arena, &_palettes[(size_t)i * _boneCount]);
+    }
+}
+}
@@ -0,0 +1,60 @@
+//
+// Many instances of one skinned model animated in parallel.
+//
+
+#pragma once
+
+#include "SkinnedModelInstance.h"
+#include "../../../Core/JobSystem.h"
+
+namespace DX12Samples
+{
+class SkinnedCrowd
+{
+public:
+    /**
+     * \brief Create instanceCount instances playing clipName. Instances start at different times so crowd doesn't move in sync.
+     * \param workerCount amount of job system workers which will update crowd, each gets own scratch arena.
+     */
+    void Init(SkinnedData* skinnedInfo, UINT instanceCount, const std::string& clipName, UINT workerCount);
+    /**
+     * \brief Update all instances on job system workers. Palettes are written to single contiguous buffer.
+     */
+    void Update(float dt, JobSystem& jobs);
+    /**
+     * \brief Update all instances on calling thread.
+     */
+    void Update(float dt);
+    /**
+     * \brief Select animation LOD of every instance. Skeleton LODs used by policy must be built in SkinnedData.
+     * \param distances distance from camera to every instance.
+     */
+    void UpdateLods(const AnimationLodPolicy& policy, const float* distances);
+    /**
+     * \brief Play blend tree on instance instead of its clip, worker arenas grow to tree scratch size.
+     * \param blendTree not owned, nullptr returns instance to its clip.
+     */
+    void SetBlendTree(UINT instance, AnimationBlendTree* blendTree);
+
+    UINT InstanceCount() const;
+    UINT BoneCount() const;
+    SkinnedModelInstance& Instance(UINT index);
+    /**
+     * \brief Get BoneCount() transposed final transforms of instance.
+     */
+    const DirectX::XMFLOAT3X4* Palette(UINT instance) const;
+    /**
+     * \brief All palettes, instance i starts at i * BoneCount().
+     */
+    const std::vector<DirectX::XMFLOAT3X4>& Palettes() const;
+
+private:
+    void UpdateRange(float dt, UINT begin, UINT end, UINT workerIndex);
+
+    SkinnedData* _skinnedInfo = nullptr;
+    UINT _boneCount = 0;
+    std::vector<SkinnedModelInstance> _instances;
+    std::vector<DirectX::XMFLOAT3X4> _palettes;
+    std::vector<std::unique_ptr<FrameArena>> _arenas;
+};
+}
@@ -26,6 +26,18 @@ void AnimationClip::Interpolate(float t, std::vector<DirectX::XMFLOAT4X4>& boneT
         BoneAnimations[i].Interpolate(t, boneTransforms[i]);
 }
 
+void AnimationClip::Interpolate(float t, std::vector<DirectX::XMFLOAT4X4>& boneTransforms, std::vector<UINT>& keyframeCursors) const
+{
+    for (UINT i = 0; i < BoneAnimations.size(); i++)
+        BoneAnimations[i].Interpolate(t, boneTransforms[i], keyframeCursors[i]);
+}
+
+void AnimationClip::Interpolate(float t, DirectX::XMFLOAT4X4* boneTransforms, UINT* keyframeCursors) const
+{
+    for (UINT i = 0; i < BoneAnimations.size(); i++)
+        BoneAnimations[i].Interpolate(t, boneTransforms[i], keyframeCursors[i]);
+}
+
 UINT SkinnedData::BoneCount() const
 {
     return _boneHierarchy.size();
@@ -33,49 +45,244 @@ UINT SkinnedData::BoneCount() const
 
 float SkinnedData::GetClipStartTime(const std::string& clipName) const
 {
-    auto clip = _animations.find(clipName);
-    return clip->second.GetClipStartTime();
+    ClipHandle clip = FindClip(clipName);
+    return clip != InvalidClip ? _clips[clip].GetClipStartTime() : 0.0f;
 }
 
 float SkinnedData::GetClipEndTime(const std::string& clipName) const
 {
-    auto clip = _animations.find(clipName);
-    return clip->second.GetClipEndTime();
+    return GetClipEndTime(FindClip(clipName));
+}
+
+SkinnedData::ClipHandle SkinnedData::FindClip(const std::string& clipName) const
+{
+    auto clip = _clipHandles.find(clipName);
+    if (clip == _clipHandles.end())
+        return InvalidClip;
+    return clip->second;
+}
+
+float SkinnedData::GetClipEndTime(ClipHandle clip) const
+{
+    return clip != InvalidClip ? _clipEndTimes[clip] : 0.0f;
+}
+
+const AnimationClip& SkinnedData::GetClip(ClipHandle clip) const
+{
+    return _clips[clip];
+}
+
+const CompiledClip& SkinnedData::GetCompiledClip(ClipHandle clip) const
+{
+    return _compiledClips[clip];
 }
 
-void SkinnedData::Set(std::vector<int>& boneHierarchy, std::vector<DirectX::XMFLOAT4X4>& boneOffsets, std::unordered_map<std::string, AnimationClip>& animations)
+const std::vector<int>& SkinnedData::GetBoneHierarchy() const
 {
+    return _boneHierarchy;
+}
+
+size_t SkinnedData::GetFinalTransformsScratchSize() const
+{
+    // toParent and toRoot transforms plus alignment padding for each of them.
+    return 2 * (_boneOffsets.size() * sizeof(XMFLOAT4X4) + 16);
+}
+
+bool SkinnedData::Set(std::vector<int>& boneHierarchy, std::vector<DirectX::XMFLOAT4X4>& boneOffsets, std::unordered_map<std::string, AnimationClip>& animations)
+{
+    std::vector<UINT> boneOrder;
+    if (!BuildBoneOrder(boneHierarchy, boneOrder))
+        return false;
+
     _boneHierarchy = boneHierarchy;
+    _boneOrder = std::move(boneOrder);
     _boneOffsets = boneOffsets;
-    _animations = animations;
+
+    _clips.clear();
+    _compiledClips.clear();
+    _clipHandles.clear();
+    _clipEndTimes.clear();
+    _lods.clear();
+    for (const auto& animation : animations)
+    {
+        _clipHandles[animation.first] = (ClipHandle)_clips.size();
+        _clips.push_back(animation.second);
+        _compiledClips.emplace_back();
+        _compiledClips.back().Build(animation.second);
+        _clipEndTimes.push_back(animation.second.GetClipEndTime());
+    }
+    return true;
 }
 
-void SkinnedData::GetFinalTransforms(const std::string& clipName, float timePos, std::vector<DirectX::XMFLOAT4X4>& finalTransforms) const
+bool SkinnedData::BuildBoneOrder(const std::vector<int>& boneHierarchy, std::vector<UINT>& boneOrder)
 {
+    const UINT numBones = (UINT)boneHierarchy.size();
+
+    // Bones are visited breadth first from roots, bones never reached have a cycle in their parents chain.
+    std::vector<UINT> childCounts(numBones + 1, 0);
+    for (UINT i = 0; i < numBones; i++)
+    {
+        int parent = boneHierarchy[i];
+        if (parent < -1 || parent >= (int)numBones || parent == (int)i)
+            return false;
+        childCounts[parent + 1]++;
+    }
+    // Children of bone i are children[firstChild[i + 1]..firstChild[i + 2]), roots are at index 0.
+    std::vector<UINT> firstChild(numBones + 2, 0);
+    for (UINT i = 0; i <= numBones; i++)
+        firstChild[i + 1] = firstChild[i] + childCounts[i];
+    std::vector<UINT> children(numBones);
+    std::vector<UINT> filled(firstChild.begin(), firstChild.end() - 1);
+    for (UINT i = 0; i < numBones; i++)
+        children[filled[boneHierarchy[i] + 1]++] = i;
+
+    boneOrder.clear();
+    boneOrder.reserve(numBones);
+    boneOrder.insert(boneOrder.end(), children.begin() + firstChild[0], children.begin() + firstChild[1]);
+    for (UINT i = 0; i < (UINT)boneOrder.size(); i++)
+    {
+        UINT bone = boneOrder[i];
+        boneOrder.insert(boneOrder.end(), children.begin() + firstChild[bone + 1], children.begin() + firstChild[bone + 2]);
+    }
+    return boneOrder.size() == numBones;
+}
+
+void SkinnedData::BuildLods(UINT lodCount)
+{
+    const UINT numBones = (UINT)_boneHierarchy.size();
+
+    _lods.clear();
+    std::vector<bool> kept(numBones, true);
+    for (UINT lod = 1; lod < lodCount; lod++)
+    {
+        // Collapse bones which have no evaluated children left. Root is always kept.
+        std::vector<bool> hasChildren(numBones, false);
+        for (UINT i = 0; i < numBones; i++)
+        {
+            if (kept[i] && _boneHierarchy[i] >= 0)
+                hasChildren[_boneHierarchy[i]] = true;
+        }
+        for (UINT i = 0; i < numBones; i++)
+        {
+            if (!hasChildren[i] && _boneHierarchy[i] >= 0)
+                kept[i] = false;
+        }
+
+        // Kept bones are listed in evaluation order, so parents go before children in LOD skeleton too.
+        SkeletonLod skeletonLod;
+        std::vector<int> lodIndices(numBones, -1);
+        skeletonLod.PaletteSource.resize(numBones);
+        for (UINT i : _boneOrder)
+        {
+            if (kept[i])
+            {
+                lodIndices[i] = (int)skeletonLod.Bones.size();
+                skeletonLod.Bones.push_back(i);
+                skeletonLod.Hierarchy.push_back(_boneHierarchy[i] >= 0 ? lodIndices[_boneHierarchy[i]] : -1);
+                skeletonLod.PaletteSource[i] = i;
+            }
+            else
+            {
+                skeletonLod.PaletteSource[i] = skeletonLod.PaletteSource[_boneHierarchy[i]];
+            }
+        }
+
+        for (const AnimationClip& clip : _clips)
+        {
+            AnimationClip lodClip;
+            for (UINT bone : skeletonLod.Bones)
+                lodClip.BoneAnimations.push_back(clip.BoneAnimations[bone]);
+            skeletonLod.Clips.emplace_back();
+            skeletonLod.Clips.back().Build(lodClip);
+        }
+        _lods.push_back(std::move(skeletonLod));
+    }
+}
+
+UINT SkinnedData::LodCount() const
+{
+    return (UINT)_lods.size() + 1;
+}
+
+const std::vector<UINT>& SkinnedData::GetBoneOrder() const
+{
+    return _boneOrder;
+}
+
+const std::vector<XMFLOAT4X4>& SkinnedData::GetBoneOffsets() const
+{
+    return _boneOffsets;
+}
+
+UINT SkinnedData::GetLodBoneCount(UINT lod) const
+{
+    lod = MathHelper::Min(lod, LodCount() - 1);
+    return lod == 0 ? BoneCount() : (UINT)_lods[lod - 1].Bones.size();
+}
+
+void SkinnedData::GetFinalTransforms(ClipHandle clip, float timePos, FrameArena& arena, DirectX::XMFLOAT3X4* finalTransforms, UINT& keyframeCursor) const
+{
+    assert(clip < _compiledClips.size());
     UINT numBones = _boneOffsets.size();
 
-    std::vector<XMFLOAT4X4> toParentTransforms(numBones);
+    XMFLOAT4X4* toParentTransforms = arena.Allocate<XMFLOAT4X4>(numBones);
+    _compiledClips[clip].Interpolate(timePos, toParentTransforms, keyframeCursor);
+
+    ConcatenateTransforms(toParentTransforms, arena, finalTransforms);
+}
+
+void SkinnedData::GetFinalTransforms(ClipHandle clip, float timePos, UINT lod, FrameArena& arena, DirectX::XMFLOAT3X4* finalTransforms, UINT& keyframeCursor) const
+{
+    // LODs which weren't built fall back to the coarsest one which was.
+    lod = MathHelper::Min(lod, LodCount() - 1);
+    if (lod == 0)
+    {
+        GetFinalTransforms(clip, timePos, arena, finalTransforms, keyframeCursor);
+        return;
+    }
 
-    auto clip = _animations.find(clipName);
-    clip->second.Interpolate(timePos, toParentTransforms);
+    const SkeletonLod& skeletonLod = _lods[lod - 1];
+    const UINT numLodBones = (UINT)skeletonLod.Bones.size();
 
-    std::vector<XMFLOAT4X4> toRootTransforms(numBones);
-    toRootTransforms[0] = toParentTransforms[0];
+    XMFLOAT4X4* toParentTransforms = arena.Allocate<XMFLOAT4X4>(numLodBones);
+    skeletonLod.Clips[clip].Interpolate(timePos, toParentTransforms, keyframeCursor);
 
-    for (UINT i = 1; i < numBones; i++)
+    XMFLOAT4X4* toRootTransforms = arena.Allocate<XMFLOAT4X4>(numLodBones);
+    for (UINT i = 0; i < numLodBones; i++)
     {
-        XMMATRIX toParent = XMLoadFloat4x4(&toParentTransforms[i]);
-        int parentIndex = _boneHierarchy[i];
-        XMMATRIX parentToRoot = XMLoadFloat4x4(&toRootTransforms[parentIndex]);
-        XMMATRIX toRoot = XMMatrixMultiply(toParent, parentToRoot);
+        UINT bone = skeletonLod.Bones[i];
+        int parentIndex = skeletonLod.Hierarchy[i];
+        XMMATRIX toRoot = XMLoadFloat4x4(&toParentTransforms[i]);
+        if (parentIndex >= 0)
+            toRoot = XMMatrixMultiply(toRoot, XMLoadFloat4x4(&toRootTransforms[parentIndex]));
         XMStoreFloat4x4(&toRootTransforms[i], toRoot);
+        XMStoreFloat3x4(&finalTransforms[bone], XMMatrixMultiply(XMLoadFloat4x4(&_boneOffsets[bone]), toRoot));
     }
-    for (UINT i = 0; i < numBones; i++)
+    // In bind pose offset * toRoot is identity for every bone, so collapsed bone keeps its bind pose relative to ancestor.
+    for (UINT i : _boneOrder)
     {
+        if (skeletonLod.PaletteSource[i] != i)
+            finalTransforms[i] = finalTransforms[skeletonLod.PaletteSource[i]];
+    }
+}
+
+void SkinnedData::ConcatenateTransforms(const DirectX::XMFLOAT4X4* toParentTransforms, FrameArena& arena, DirectX::XMFLOAT3X4* finalTransforms) const
+{
+    UINT numBones = _boneOffsets.size();
+
+    // Single pass in evaluation order: parent to root transform is always ready when child is processed.
+    XMFLOAT4X4* toRootTransforms = arena.Allocate<XMFLOAT4X4>(numBones);
+    for (UINT i : _boneOrder)
+    {
+        int parentIndex = _boneHierarchy[i];
+        XMMATRIX toRoot = XMLoadFloat4x4(&toParentTransforms[i]);
+        if (parentIndex >= 0)
+            toRoot = XMMatrixMultiply(toRoot, XMLoadFloat4x4(&toRootTransforms[parentIndex]));
+        XMStoreFloat4x4(&toRootTransforms[i], toRoot);
+
+        // XMStoreFloat3x4 stores transposed matrix, last column of affine transform is dropped.
         XMMATRIX offset = XMLoadFloat4x4(&_boneOffsets[i]);
-        XMMATRIX toRoot = XMLoadFloat4x4(&toRootTransforms[i]);
-        XMMATRIX finalTransform = XMMatrixMultiply(offset, toRoot);
-        XMStoreFloat4x4(&finalTransforms[i], XMMatrixTranspose(finalTransform));
+        XMStoreFloat3x4(&finalTransforms[i], XMMatrixMultiply(offset, toRoot));
     }
 }
 }
\ No newline at end of file
@@ -6,6 +6,8 @@
 
 #include "../../Core/D3DUtil.h"
 #include "../../../Core/AnimationHelper.h"
+#include "../../../Core/FrameArena.h"
+#include "CompiledClip.h"
 
 namespace DX12Samples
 {
@@ -15,23 +17,127 @@ struct AnimationClip
     float GetClipEndTime() const;
 
     void Interpolate(float t, std::vector<DirectX::XMFLOAT4X4>& boneTransforms) const;
+    /**
+     * \brief Interpolate all bones using per bone keyframe cursors from previous call.
+     */
+    void Interpolate(float t, std::vector<DirectX::XMFLOAT4X4>& boneTransforms, std::vector<UINT>& keyframeCursors) const;
+    /**
+     * \brief Interpolate all bones to caller owned arrays. Both arrays must hold at least BoneAnimations.size() elements.
+     */
+    void Interpolate(float t, DirectX::XMFLOAT4X4* boneTransforms, UINT* keyframeCursors) const;
     std::vector<BoneAnimation> BoneAnimations;
 };
 
 class SkinnedData
 {
 public:
+    /**
+     * \brief Handle to animation clip. Resolve it once with FindClip to avoid string lookups every frame.
+     */
+    using ClipHandle = UINT;
+    static const ClipHandle InvalidClip = UINT(-1);
+
     UINT BoneCount() const;
 
+    /**
+     * \brief Get clip start and end time, 0 if there is no such clip.
+     */
     float GetClipStartTime(const std::string& clipName) const;
     float GetClipEndTime(const std::string& clipName) const;
+    /**
+     * \brief Find clip handle by name. Returns InvalidClip if there is no such clip.
+     */
+    ClipHandle FindClip(const std::string& clipName) const;
+    /**
+     * \brief Get cached clip end time, 0 for InvalidClip.
+     */
+    float GetClipEndTime(ClipHandle clip) const;
+    /**
+     * \brief Get source keyframes of clip, e.g. to compress it.
+     */
+    const AnimationClip& GetClip(ClipHandle clip) const;
+    /**
+     * \brief Get clip baked for sampling, e.g. to get local poses for blending.
+     */
+    const CompiledClip& GetCompiledClip(ClipHandle clip) const;
+    /**
+     * \brief Parent index of every bone, -1 for roots.
+     */
+    const std::vector<int>& GetBoneHierarchy() const;
+    /**
+     * \brief Bone indices ordered so that parents always go before children.
+     */
+    const std::vector<UINT>& GetBoneOrder() const;
+    /**
+     * \brief Transforms from bind pose to bone space of every bone.
+     */
+    const std::vector<DirectX::XMFLOAT4X4>& GetBoneOffsets() const;
+    /**
+     * \brief Scratch memory in bytes which GetFinalTransforms with arena takes per call.
+     */
+    size_t GetFinalTransformsScratchSize() const;
 
-    void Set(std::vector<int>& boneHierarchy, std::vector<DirectX::XMFLOAT4X4>& boneOffsets, std::unordered_map<std::string, AnimationClip>& animations);
+    /**
+     * \brief Set skeleton and clips. Returns false if hierarchy has invalid parent index or cycle.
+     */
+    bool Set(std::vector<int>& boneHierarchy, std::vector<DirectX::XMFLOAT4X4>& boneOffsets, std::unordered_map<std::string, AnimationClip>& animations);
+    /**
+     * \brief Build skeleton LODs 1..lodCount - 1. Every LOD collapses one more level of leaf bones into their parents.
+     */
+    void BuildLods(UINT lodCount);
+    UINT LodCount() const;
+    /**
+     * \brief Number of bones evaluated in lod, LOD 0 is full skeleton.
+     */
+    UINT GetLodBoneCount(UINT lod) const;
 
-    void GetFinalTransforms(const std::string& clipName, float timePos, std::vector<DirectX::XMFLOAT4X4>& finalTransforms) const;
+    /**
+     * \brief Get final transforms without heap allocations. Intermediate transforms are taken from arena.
+     * \param clip valid clip handle from FindClip.
+     * \param timePos animation time.
+     * \param arena scratch memory, caller resets it once per frame.
+     * \param finalTransforms output array of BoneCount() transposed affine matrices, ready for SkinnedConstants.
+     * \param keyframeCursor key found on previous call, kept by caller between calls. Clip is sampled from its compiled form,
+     * in which all bones share key times, so single cursor serves the whole skeleton.
+     */
+    void GetFinalTransforms(ClipHandle clip, float timePos, FrameArena& arena, DirectX::XMFLOAT3X4* finalTransforms, UINT& keyframeCursor) const;
+    /**
+     * \brief Get final transforms evaluating only bones of skeleton lod. Collapsed bones get transform of their closest
+     * evaluated ancestor, which moves their vertices rigidly with it. Output still has BoneCount() matrices.
+     * lod is clamped to LodCount() - 1.
+     */
+    void GetFinalTransforms(ClipHandle clip, float timePos, UINT lod, FrameArena& arena, DirectX::XMFLOAT3X4* finalTransforms, UINT& keyframeCursor) const;
+    /**
+     * \brief Concatenate to parent transforms down the hierarchy and apply bone offsets.
+     * \param toParentTransforms array of BoneCount() to parent transforms.
+     * \param arena scratch memory for BoneCount() to root transforms.
+     * \param finalTransforms output array of BoneCount() transposed matrices.
+     */
+    void ConcatenateTransforms(const DirectX::XMFLOAT4X4* toParentTransforms, FrameArena& arena, DirectX::XMFLOAT3X4* finalTransforms) const;
 private:
+    /**
+     * \brief Validate hierarchy and sort bones so that parents go before children.
+     */
+    static bool BuildBoneOrder(const std::vector<int>& boneHierarchy, std::vector<UINT>& boneOrder);
+
+    struct SkeletonLod
+    {
+        // Evaluated bones in hierarchy order and their parents as indices in Bones.
+        std::vector<UINT> Bones;
+        std::vector<int> Hierarchy;
+        // For every bone of full skeleton: itself if evaluated, otherwise closest evaluated ancestor.
+        std::vector<UINT> PaletteSource;
+        std::vector<CompiledClip> Clips;
+    };
+
     std::vector<int> _boneHierarchy;
+    std::vector<UINT> _boneOrder;
     std::vector<DirectX::XMFLOAT4X4> _boneOffsets;
-    std::unordered_map<std::string, AnimationClip> _animations;
+    std::vector<AnimationClip> _clips;
+    std::vector<CompiledClip> _compiledClips;
+    std::unordered_map<std::string, ClipHandle> _clipHandles;
+    std::vector<float> _clipEndTimes;
+    // _lods[lod - 1], LOD 0 uses full skeleton data above.
+    std::vector<SkeletonLod> _lods;
 };
 }
\ No newline at end of file
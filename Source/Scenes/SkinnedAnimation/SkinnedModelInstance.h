@@ -4,25 +4,143 @@
 
 #pragma once
 
-#include "SkinnedData.h"
+#include "AnimationBlendTree.h"
+#include "AnimationLod.h"
 
 namespace DX12Samples
 {
 struct SkinnedModelInstance
 {
     SkinnedData* SkinnedInfo = nullptr;
-    std::vector<DirectX::XMFLOAT4X4> FinalTransforms;
+    std::vector<DirectX::XMFLOAT3X4> FinalTransforms;
     std::string ClipName;
+    SkinnedData::ClipHandle Clip = SkinnedData::InvalidClip;
+    // Compiled clips share key times between bones, so one cursor tracks the whole skeleton.
+    UINT KeyframeCursor = 0;
+    // Optional, not owned. When set, instance plays blend tree instead of single clip.
+    AnimationBlendTree* BlendTree = nullptr;
 
     float TimePos = 0.0f;
 
-    void UpdateSkinnedAnimation(float dt)
+    // Animation LOD state, see SetLod. Blend trees are always evaluated every frame with full skeleton.
+    UINT SkeletonLod = 0;
+    UINT UpdateInterval = 1;
+    UINT LodPhase = 0;
+    bool LodChanged = false;
+    UINT FramesUntilUpdate = 0;
+    UINT IntervalFrames = 1;
+    std::vector<DirectX::XMFLOAT3X4> PrevTransforms;
+    std::vector<DirectX::XMFLOAT3X4> NextTransforms;
+
+    /**
+     * \brief Set clip to play and resolve its handle.
+     */
+    void SetClip(const std::string& clipName)
     {
-        TimePos += dt;
+        ClipName = clipName;
+        Clip = SkinnedInfo->FindClip(clipName);
+        KeyframeCursor = 0;
+    }
+
+    /**
+     * \brief Set evaluation rate and skeleton LOD. Instances with same interval but different phases are evaluated on
+     * different frames. Allocates interpolation palettes only when interval becomes greater than 1.
+     */
+    void SetLod(const AnimationLodLevel& level, UINT phase)
+    {
+        UINT updateInterval = MathHelper::Max(level.UpdateInterval, 1u);
+        // Skeleton LODs which weren't built are clamped to the last built one.
+        UINT skeletonLod = MathHelper::Min(level.SkeletonLod, SkinnedInfo->LodCount() - 1);
+        if (updateInterval == UpdateInterval && skeletonLod == SkeletonLod)
+            return;
+
+        UpdateInterval = updateInterval;
+        SkeletonLod = skeletonLod;
+        LodPhase = phase % updateInterval;
+        LodChanged = true;
+        if (UpdateInterval > 1)
+        {
+            PrevTransforms.resize(SkinnedInfo->BoneCount());
+            NextTransforms.resize(SkinnedInfo->BoneCount());
+        }
+    }
+
+    /**
+     * \brief Update animation taking scratch memory from arena. Doesn't allocate after SetClip was called.
+     */
+    void UpdateSkinnedAnimation(float dt, FrameArena& arena)
+    {
+        UpdateSkinnedAnimation(dt, arena, FinalTransforms.data());
+    }
 
-        if (TimePos > SkinnedInfo->GetClipEndTime(ClipName))
-            TimePos = 0.0f;
-        SkinnedInfo->GetFinalTransforms(ClipName, TimePos, FinalTransforms);
+    /**
+     * \brief Update animation writing BoneCount() transforms to finalTransforms instead of FinalTransforms.
+     */
+    void UpdateSkinnedAnimation(float dt, FrameArena& arena, DirectX::XMFLOAT3X4* finalTransforms)
+    {
+        if (BlendTree != nullptr)
+        {
+            BlendTree->Update(dt);
+            BlendTree->Evaluate(arena, finalTransforms);
+            return;
+        }
+
+        if (Clip == SkinnedData::InvalidClip)
+        {
+            SetClip(ClipName);
+            // Unknown clip, keep last palette.
+            if (Clip == SkinnedData::InvalidClip)
+                return;
+        }
+
+        float clipEndTime = SkinnedInfo->GetClipEndTime(Clip);
+        TimePos = AdvanceTime(TimePos, dt, clipEndTime);
+        if (UpdateInterval <= 1)
+        {
+            SkinnedInfo->GetFinalTransforms(Clip, TimePos, SkeletonLod, arena, finalTransforms, KeyframeCursor);
+            return;
+        }
+
+        // Reduced rate: evaluate pose UpdateInterval frames ahead, assuming constant dt, and interpolate palettes until then.
+        UINT nextInterval = UpdateInterval;
+        if (LodChanged)
+        {
+            SkinnedInfo->GetFinalTransforms(Clip, TimePos, SkeletonLod, arena, NextTransforms.data(), KeyframeCursor);
+            nextInterval = LodPhase + 1;
+            FramesUntilUpdate = 0;
+            LodChanged = false;
+        }
+        if (FramesUntilUpdate == 0)
+        {
+            std::swap(PrevTransforms, NextTransforms);
+            // Step the same way as full rate path, so evaluated pose matches TimePos instance will have.
+            float nextTimePos = TimePos;
+            for (UINT i = 0; i < nextInterval; i++)
+                nextTimePos = AdvanceTime(nextTimePos, dt, clipEndTime);
+            SkinnedInfo->GetFinalTransforms(Clip, nextTimePos, SkeletonLod, arena, NextTransforms.data(), KeyframeCursor);
+            FramesUntilUpdate = nextInterval;
+            IntervalFrames = nextInterval;
+        }
+
+        // Palettes are 3 rows of 4 floats each.
+        float lerpPercent = (float)(IntervalFrames - FramesUntilUpdate) / IntervalFrames;
+        const DirectX::XMFLOAT4* prev = reinterpret_cast<const DirectX::XMFLOAT4*>(PrevTransforms.data());
+        const DirectX::XMFLOAT4* next = reinterpret_cast<const DirectX::XMFLOAT4*>(NextTransforms.data());
+        DirectX::XMFLOAT4* lerped = reinterpret_cast<DirectX::XMFLOAT4*>(finalTransforms);
+        for (size_t i = 0; i < PrevTransforms.size() * 3; i++)
+            DirectX::XMStoreFloat4(&lerped[i], DirectX::XMVectorLerp(DirectX::XMLoadFloat4(&prev[i]), DirectX::XMLoadFloat4(&next[i]), lerpPercent));
+        FramesUntilUpdate--;
+    }
+
+    /**
+     * \brief Advance clip time by dt, restarting clip from the beginning when its end is passed.
+     */
+    static float AdvanceTime(float timePos, float dt, float clipEndTime)
+    {
+        timePos += dt;
+        if (timePos > clipEndTime)
+            timePos = 0.0f;
+        return timePos;
     }
 };
 }
@@ -1,6 +1,8 @@
 #include "Stenciling.h"
 
+#include "../../../Core/BoundsBuilder.h"
 #include "../../../Core/GeometryGenerator.h"
+#include "../../../Core/MeshAsset.h"
 
 namespace DX12Samples
 {
@@ -507,20 +509,11 @@ void Stenciling::BuildRoomGeometry()
         16, 18, 19
     };
 
-    SubmeshGeometry floorSubmesh;
-    floorSubmesh.IndexCount = 6;
-    floorSubmesh.StartIndexLocation = 0;
-    floorSubmesh.BaseVertexLocation = 0;
-
-    SubmeshGeometry wallSubmesh;
-    wallSubmesh.IndexCount = 18;
-    wallSubmesh.StartIndexLocation = 6;
-    wallSubmesh.BaseVertexLocation = 0;
-
-    SubmeshGeometry mirrorSubmesh;
-    mirrorSubmesh.IndexCount = 6;
-    mirrorSubmesh.StartIndexLocation = 24;
-    mirrorSubmesh.BaseVertexLocation = 0;
+    // Parts share base vertex, bounds are of vertices each part indexes.
+    BoundsBuilder boundsBuilder;
+    SubmeshGeometry floorSubmesh = boundsBuilder.CreateSubmesh(&vertices[0].Pos, 4, sizeof(Vertex), 6, 0, 0);
+    SubmeshGeometry wallSubmesh = boundsBuilder.CreateSubmesh(&vertices[4].Pos, 12, sizeof(Vertex), 18, 6, 0);
+    SubmeshGeometry mirrorSubmesh = boundsBuilder.CreateSubmesh(&vertices[16].Pos, 4, sizeof(Vertex), 6, 24, 0);
 
     const UINT vbByteSize = (UINT)vertices.size() * sizeof(Vertex);
     const UINT ibByteSize = (UINT)indices.size() * sizeof(uint16_t);
@@ -552,57 +545,28 @@ void Stenciling::BuildRoomGeometry()
 
 void Stenciling::BuildSkullGeometry()
 {
-    std::ifstream fin("Models\\skull.txt");
-
-    if (!fin)
+    auto skull = MeshAssetCache::Instance().Load("Models\\skull.txt", MeshVertexLayout::PosNormalUv);
+    if (skull == nullptr)
     {
-        MessageBox(0, L"Models\\scull.txt not found", nullptr, 0);
+        MessageBox(0, L"Models\\skull.txt not found", nullptr, 0);
         return;
     }
 
-    UINT vcount = 0;
-    UINT tcount = 0;
-    std::string ignore;
-
-    fin >> ignore >> vcount;
-    fin >> ignore >> tcount;
-    fin >> ignore >> ignore >> ignore >> ignore;
-
-    std::vector<Vertex> vertices(vcount);
-    for (UINT i = 0; i < vcount; i++)
-    {
-        fin >> vertices[i].Pos.x >> vertices[i].Pos.y >> vertices[i].Pos.z;
-        fin >> vertices[i].Normal.x >> vertices[i].Normal.y >> vertices[i].Normal.z;
-    }
-    fin >> ignore;
-    fin >> ignore;
-    fin >> ignore;
-
-    std::vector<int32_t> indices(3 * tcount);
-    for (UINT i = 0; i < tcount; i++)
-    {
-        fin >> indices[i * 3 + 0] >> indices[i * 3 + 1] >> indices[i * 3 + 2];
-    }
-    fin.close();
-
-    const UINT vbByteSize = (UINT)vertices.size() * sizeof(Vertex);
-    const UINT ibByteSize = (UINT)indices.size() * sizeof(int32_t);
+    const UINT vbByteSize = skull->VertexBufferByteSize();
+    const UINT ibByteSize = skull->IndexBufferByteSize();
 
     auto geo = std::make_unique<MeshGeometry>();
     geo->Name = "skullGeo";
 
-    geo->VertexBufferGPU = D3DUtil::CreateDefaultBuffer(_device.Get(), _commandList.Get(), vertices.data(), vbByteSize, geo->VertexBufferUploader);
-    geo->IndexBufferGPU = D3DUtil::CreateDefaultBuffer(_device.Get(), _commandList.Get(), indices.data(), ibByteSize, geo->IndexBufferUploader);
+    geo->VertexBufferGPU = D3DUtil::CreateDefaultBuffer(_device.Get(), _commandList.Get(), skull->GetVertices<Vertex>(), vbByteSize, geo->VertexBufferUploader);
+    geo->IndexBufferGPU = D3DUtil::CreateDefaultBuffer(_device.Get(), _commandList.Get(), skull->Indices.data(), ibByteSize, geo->IndexBufferUploader);
 
     geo->VertexByteStride = sizeof(Vertex);
     geo->VertexBufferByteSize = vbByteSize;
     geo->IndexFormat = DXGI_FORMAT_R32_UINT;
     geo->IndexBufferByteSize = ibByteSize;
 
-    SubmeshGeometry submesh;
-    submesh.IndexCount = (UINT)indices.size();
-    submesh.StartIndexLocation = 0;
-    submesh.BaseVertexLocation = 0;
+    SubmeshGeometry submesh = skull->CreateSubmesh();
     geo->DrawArgs["skull"] = submesh;
     _geometries[geo->Name] = move(geo);
 }
@@ -796,6 +760,7 @@ void Stenciling::BuildRenderItems()
     floorRitem->IndexCount = floorRitem->Geo->DrawArgs["floor"].IndexCount;
     floorRitem->StartIndexLocation = floorRitem->Geo->DrawArgs["floor"].StartIndexLocation;
     floorRitem->BaseVertexLocation = floorRitem->Geo->DrawArgs["floor"].BaseVertexLocation;
+    floorRitem->Bounds = floorRitem->Geo->DrawArgs["floor"].Bounds;
     _renderItemLayer[(int)RenderLayer::Opaque].push_back(floorRitem.get());
 
     auto wallsRitem = std::make_unique<RenderItem>();
@@ -808,6 +773,7 @@ void Stenciling::BuildRenderItems()
     wallsRitem->IndexCount = wallsRitem->Geo->DrawArgs["wall"].IndexCount;
     wallsRitem->StartIndexLocation = wallsRitem->Geo->DrawArgs["wall"].StartIndexLocation;
     wallsRitem->BaseVertexLocation = wallsRitem->Geo->DrawArgs["wall"].BaseVertexLocation;
+    wallsRitem->Bounds = wallsRitem->Geo->DrawArgs["wall"].Bounds;
     _renderItemLayer[(int)RenderLayer::Opaque].push_back(wallsRitem.get());
 
     auto skullRitem = std::make_unique<RenderItem>();
@@ -820,6 +786,7 @@ void Stenciling::BuildRenderItems()
     skullRitem->IndexCount = skullRitem->Geo->DrawArgs["skull"].IndexCount;
     skullRitem->StartIndexLocation = skullRitem->Geo->DrawArgs["skull"].StartIndexLocation;
     skullRitem->BaseVertexLocation = skullRitem->Geo->DrawArgs["skull"].BaseVertexLocation;
+    skullRitem->Bounds = skullRitem->Geo->DrawArgs["skull"].Bounds;
     _skullRenderItem = skullRitem.get();
     _renderItemLayer[(int)RenderLayer::Opaque].push_back(skullRitem.get());
 
@@ -846,6 +813,7 @@ void Stenciling::BuildRenderItems()
     mirrorRitem->IndexCount = mirrorRitem->Geo->DrawArgs["mirror"].IndexCount;
     mirrorRitem->StartIndexLocation = mirrorRitem->Geo->DrawArgs["mirror"].StartIndexLocation;
     mirrorRitem->BaseVertexLocation = mirrorRitem->Geo->DrawArgs["mirror"].BaseVertexLocation;
+    mirrorRitem->Bounds = mirrorRitem->Geo->DrawArgs["mirror"].Bounds;
     _renderItemLayer[(int)RenderLayer::Mirrors].push_back(mirrorRitem.get());
     _renderItemLayer[(int)RenderLayer::Transparent].push_back(mirrorRitem.get());
 
@@ -1,5 +1,6 @@
 #include "BasicTesselation.h"
 
+#include "../../../Core/BoundsBuilder.h"
 #include "../../../Core/GeometryGenerator.h"
 
 namespace DX12Samples
@@ -355,10 +356,14 @@ void BasicTesselation::BuildQuadPatchGeometry()
     geo->IndexFormat = DXGI_FORMAT_R16_UINT;
     geo->IndexBufferByteSize = ibByteSize;
 
-    SubmeshGeometry quadSubmesh;
-    quadSubmesh.IndexCount = 4;
-    quadSubmesh.StartIndexLocation = 0;
-    quadSubmesh.BaseVertexLocation = 0;
+    // Domain shader sets height to 0.3 * (z * sin(x) + x * cos(z)), which stays within 0.3 * (|x| + |z|) = 6 on the patch.
+    std::array<XMFLOAT3, 8> displaced;
+    for (size_t i = 0; i < vertices.size(); i++)
+    {
+        displaced[i * 2] = XMFLOAT3(vertices[i].x, -6.0f, vertices[i].z);
+        displaced[i * 2 + 1] = XMFLOAT3(vertices[i].x, 6.0f, vertices[i].z);
+    }
+    SubmeshGeometry quadSubmesh = BoundsBuilder().CreateSubmesh(displaced.data(), (UINT)displaced.size(), sizeof(XMFLOAT3), 4, 0, 0);
 
     geo->DrawArgs["quadpatch"] = quadSubmesh;
 
@@ -440,6 +445,7 @@ void BasicTesselation::BuildRenderItems()
     quadPatchRitem->IndexCount = quadPatchRitem->Geo->DrawArgs["quadpatch"].IndexCount;
     quadPatchRitem->StartIndexLocation = quadPatchRitem->Geo->DrawArgs["quadpatch"].StartIndexLocation;
     quadPatchRitem->BaseVertexLocation = quadPatchRitem->Geo->DrawArgs["quadpatch"].BaseVertexLocation;
+    quadPatchRitem->Bounds = quadPatchRitem->Geo->DrawArgs["quadpatch"].Bounds;
     _renderItemLayer[(int)RenderLayer::Opaque].push_back(quadPatchRitem.get());
 
     _allRenderItems.push_back(move(quadPatchRitem));
@@ -1,5 +1,6 @@
 #include "BezierPatch.h"
 
+#include "../../../Core/BoundsBuilder.h"
 #include "../../../Core/GeometryGenerator.h"
 
 namespace DX12Samples
@@ -377,10 +378,8 @@ void BezierPatch::BuildQuadPatchGeometry()
     geo->IndexFormat = DXGI_FORMAT_R16_UINT;
     geo->IndexBufferByteSize = ibByteSize;
 
-    SubmeshGeometry quadSubmesh;
-    quadSubmesh.IndexCount = 16;
-    quadSubmesh.StartIndexLocation = 0;
-    quadSubmesh.BaseVertexLocation = 0;
+    // Bezier surface lies inside convex hull of its control points.
+    SubmeshGeometry quadSubmesh = BoundsBuilder().CreateSubmesh(vertices.data(), (UINT)vertices.size(), sizeof(XMFLOAT3), 16, 0, 0);
 
     geo->DrawArgs["quadpatch"] = quadSubmesh;
 
@@ -462,6 +461,7 @@ void BezierPatch::BuildRenderItems()
     quadPatchRitem->IndexCount = quadPatchRitem->Geo->DrawArgs["quadpatch"].IndexCount;
     quadPatchRitem->StartIndexLocation = quadPatchRitem->Geo->DrawArgs["quadpatch"].StartIndexLocation;
     quadPatchRitem->BaseVertexLocation = quadPatchRitem->Geo->DrawArgs["quadpatch"].BaseVertexLocation;
+    quadPatchRitem->Bounds = quadPatchRitem->Geo->DrawArgs["quadpatch"].Bounds;
     _renderItemLayer[(int)RenderLayer::Opaque].push_back(quadPatchRitem.get());
 
     _allRenderItems.push_back(move(quadPatchRitem));
@@ -1,5 +1,6 @@
 #include "TexColumns.h"
 
+#include "../../../Core/BoundsBuilder.h"
 #include "../../../Core/GeometryGenerator.h"
 
 namespace DX12Samples
@@ -7,7 +8,6 @@ namespace DX12Samples
 using Microsoft::WRL::ComPtr;
 using namespace DirectX;
 using namespace PackedVector;
-using Vertex = FrameResourceUnfogged::Vertex;
 
 TexColumns::TexColumns(HINSTANCE hInstance) : Application(hInstance)
 {
@@ -101,6 +101,7 @@ void TexColumns::Draw(const GameTimer& timer)
     _commandList->SetDescriptorHeaps(_countof(descriptorHeaps), descriptorHeaps);
 
     _commandList->SetGraphicsRootSignature(_rootSignature.Get());
+    _commandList->SetGraphicsRoot32BitConstants(4, sizeof(VertexQuantization) / 4, &_vertexQuantization, 0);
 
     auto passCB = _currFrameResource->PassCB->Resource();
     _commandList->SetGraphicsRootConstantBufferView(2, passCB->GetGPUVirtualAddress());
@@ -283,14 +284,15 @@ void TexColumns::BuildRootSignature()
 {
     CD3DX12_DESCRIPTOR_RANGE texTable;
     texTable.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0);
-    CD3DX12_ROOT_PARAMETER slotRootParameter[4];
+    CD3DX12_ROOT_PARAMETER slotRootParameter[5];
     slotRootParameter[0].InitAsDescriptorTable(1, &texTable, D3D12_SHADER_VISIBILITY_PIXEL);
     slotRootParameter[1].InitAsConstantBufferView(0);
     slotRootParameter[2].InitAsConstantBufferView(1);
     slotRootParameter[3].InitAsConstantBufferView(2);
+    slotRootParameter[4].InitAsConstants(sizeof(VertexQuantization) / 4, 3, 0, D3D12_SHADER_VISIBILITY_VERTEX);
 
     auto staticSamplers = FrameResourceUnfogged::GetStaticSamplers();
-    CD3DX12_ROOT_SIGNATURE_DESC rootSigDesc(4, slotRootParameter, (UINT)staticSamplers.size(), staticSamplers.data(), D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
+    CD3DX12_ROOT_SIGNATURE_DESC rootSigDesc(5, slotRootParameter, (UINT)staticSamplers.size(), staticSamplers.data(), D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
     ComPtr<ID3DBlob> serializedRootSig = nullptr;
     ComPtr<ID3DBlob> errorBlob = nullptr;
     
@@ -339,15 +341,16 @@ void TexColumns::BuildDescriptorHeaps()
 
 void TexColumns::BuildShaderAndInputLayout()
 {
-    _shaders["standardVS"] = D3DUtil::CompileShader(L"Shaders\\TexColumns.hlsl", nullptr, "vert", "vs_5_0");
-    _shaders["opaquePS"] = D3DUtil::CompileShader(L"Shaders\\TexColumns.hlsl", nullptr, "frag", "ps_5_0");
-
-    _inputLayout =
+    const D3D_SHADER_MACRO packedDefines[] =
     {
-        { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-        { "NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-        { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 24, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+        "PACKED_VERTICES", "1",
+        NULL, NULL
     };
+    _shaders["standardVS"] = D3DUtil::CompileShader(L"Shaders\\TexColumns.hlsl", packedDefines, "vert", "vs_5_0");
+    _shaders["opaquePS"] = D3DUtil::CompileShader(L"Shaders\\TexColumns.hlsl", nullptr, "frag", "ps_5_0");
+
+    // 20 byte PackedVertex instead of 44 byte Vertex, see BuildShapeGeometry.
+    _inputLayout = VertexPacker::GetInputLayout(PositionEncoding::Unorm16);
 }
 
 void TexColumns::BuildShapeGeometry()
@@ -368,62 +371,19 @@ void TexColumns::BuildShapeGeometry()
     UINT sphereIndexOffset = gridIndexOffset + (UINT)grid.Indices32.size();
     UINT cylinderIndexOffset = sphereIndexOffset + (UINT)sphere.Indices32.size();
 
-    SubmeshGeometry boxSubmesh;
-    boxSubmesh.IndexCount = (UINT)box.Indices32.size();
-    boxSubmesh.StartIndexLocation = boxIndexOffset;
-    boxSubmesh.BaseVertexLocation = boxVertexOffset;
-
-    SubmeshGeometry gridSubmesh;
-    gridSubmesh.IndexCount = (UINT)grid.Indices32.size();
-    gridSubmesh.StartIndexLocation = gridIndexOffset;
-    gridSubmesh.BaseVertexLocation = gridVertexOffset;
+    BoundsBuilder boundsBuilder;
 
-    SubmeshGeometry sphereSubmesh;
-    sphereSubmesh.IndexCount = (UINT)sphere.Indices32.size();
-    sphereSubmesh.StartIndexLocation = sphereIndexOffset;
-    sphereSubmesh.BaseVertexLocation = sphereVertexOffset;
+    SubmeshGeometry boxSubmesh = boundsBuilder.CreateSubmesh(box, boxIndexOffset, boxVertexOffset);
+    SubmeshGeometry gridSubmesh = boundsBuilder.CreateSubmesh(grid, gridIndexOffset, gridVertexOffset);
+    SubmeshGeometry sphereSubmesh = boundsBuilder.CreateSubmesh(sphere, sphereIndexOffset, sphereVertexOffset);
+    SubmeshGeometry cylinderSubmesh = boundsBuilder.CreateSubmesh(cylinder, cylinderIndexOffset, cylinderVertexOffset);
 
-    SubmeshGeometry cylinderSubmesh;
-    cylinderSubmesh.IndexCount = (UINT)cylinder.Indices32.size();
-    cylinderSubmesh.StartIndexLocation = cylinderIndexOffset;
-    cylinderSubmesh.BaseVertexLocation = cylinderVertexOffset;
-
-    auto totalVertexCount =
-        box.Vertices.size() +
-        grid.Vertices.size() +
-        sphere.Vertices.size() +
-        cylinder.Vertices.size();
-
-    std::vector<Vertex> vertices(totalVertexCount);
-
-    UINT k = 0;
-    for (size_t i = 0; i < box.Vertices.size(); ++i, ++k)
-    {
-        vertices[k].Pos = box.Vertices[i].Position;
-        vertices[k].Normal = box.Vertices[i].Normal;
-        vertices[k].TexC = box.Vertices[i].TexCoord;
-    }
-
-    for (size_t i = 0; i < grid.Vertices.size(); ++i, ++k)
-    {
-        vertices[k].Pos = grid.Vertices[i].Position;
-        vertices[k].Normal = grid.Vertices[i].Normal;
-        vertices[k].TexC = grid.Vertices[i].TexCoord;
-    }
-
-    for (size_t i = 0; i < sphere.Vertices.size(); ++i, ++k)
-    {
-        vertices[k].Pos = sphere.Vertices[i].Position;
-        vertices[k].Normal = sphere.Vertices[i].Normal;
-        vertices[k].TexC = sphere.Vertices[i].TexCoord;
-    }
-
-    for (size_t i = 0; i < cylinder.Vertices.size(); ++i, ++k)
-    {
-        vertices[k].Pos = cylinder.Vertices[i].Position;
-        vertices[k].Normal = cylinder.Vertices[i].Normal;
-        vertices[k].TexC = cylinder.Vertices[i].TexCoord;
-    }
+    // Shapes share one vertex buffer, so they are packed together with single quantization range.
+    GeometryGenerator::MeshData shapes;
+    for (const GeometryGenerator::MeshData* mesh : { &box, &grid, &sphere, &cylinder })
+        shapes.Vertices.insert(shapes.Vertices.end(), mesh->Vertices.begin(), mesh->Vertices.end());
+    PackedMesh packed = VertexPacker::Pack(shapes, PositionEncoding::Unorm16);
+    _vertexQuantization = packed.Quantization;
 
     std::vector<uint16_t> indices;
     indices.insert(indices.end(), begin(box.GetIndices16()), end(box.GetIndices16()));
@@ -431,25 +391,25 @@ void TexColumns::BuildShapeGeometry()
     indices.insert(indices.end(), begin(sphere.GetIndices16()), end(sphere.GetIndices16()));
     indices.insert(indices.end(), begin(cylinder.GetIndices16()), end(cylinder.GetIndices16()));
 
-    const UINT vbByteSize = (UINT)vertices.size() * sizeof(Vertex);
+    const UINT vbByteSize = packed.VertexBufferByteSize();
     const UINT ibByteSize = (UINT)indices.size()  * sizeof(uint16_t);
 
     auto geo = std::make_unique<MeshGeometry>();
     geo->Name = "shapeGeo";
 
     ThrowIfFailed(D3DCreateBlob(vbByteSize, &geo->VertexBufferCPU));
-    CopyMemory(geo->VertexBufferCPU->GetBufferPointer(), vertices.data(), vbByteSize);
+    CopyMemory(geo->VertexBufferCPU->GetBufferPointer(), packed.Vertices.data(), vbByteSize);
 
     ThrowIfFailed(D3DCreateBlob(ibByteSize, &geo->IndexBufferCPU));
     CopyMemory(geo->IndexBufferCPU->GetBufferPointer(), indices.data(), ibByteSize);
 
     geo->VertexBufferGPU = D3DUtil::CreateDefaultBuffer(_device.Get(),
-        _commandList.Get(), vertices.data(), vbByteSize, geo->VertexBufferUploader);
+        _commandList.Get(), packed.Vertices.data(), vbByteSize, geo->VertexBufferUploader);
 
     geo->IndexBufferGPU = D3DUtil::CreateDefaultBuffer(_device.Get(),
         _commandList.Get(), indices.data(), ibByteSize, geo->IndexBufferUploader);
 
-    geo->VertexByteStride = sizeof(Vertex);
+    geo->VertexByteStride = sizeof(PackedVertex);
     geo->VertexBufferByteSize = vbByteSize;
     geo->IndexFormat = DXGI_FORMAT_R16_UINT;
     geo->IndexBufferByteSize = ibByteSize;
@@ -544,6 +504,7 @@ void TexColumns::BuildRenderItems()
     boxRitem->IndexCount = boxRitem->Geo->DrawArgs["box"].IndexCount;
     boxRitem->StartIndexLocation = boxRitem->Geo->DrawArgs["box"].StartIndexLocation;
     boxRitem->BaseVertexLocation = boxRitem->Geo->DrawArgs["box"].BaseVertexLocation;
+    boxRitem->Bounds = boxRitem->Geo->DrawArgs["box"].Bounds;
     _allRenderItems.push_back(move(boxRitem));
 
     auto gridRitem = std::make_unique<RenderItem>();
@@ -556,6 +517,7 @@ void TexColumns::BuildRenderItems()
     gridRitem->IndexCount = gridRitem->Geo->DrawArgs["grid"].IndexCount;
     gridRitem->StartIndexLocation = gridRitem->Geo->DrawArgs["grid"].StartIndexLocation;
     gridRitem->BaseVertexLocation = gridRitem->Geo->DrawArgs["grid"].BaseVertexLocation;
+    gridRitem->Bounds = gridRitem->Geo->DrawArgs["grid"].Bounds;
     _allRenderItems.push_back(move(gridRitem));
 
     XMMATRIX brickTexTransform = XMMatrixScaling(1.0f, 1.0f, 1.0f);
@@ -582,6 +544,7 @@ void TexColumns::BuildRenderItems()
         leftCylRitem->IndexCount = leftCylRitem->Geo->DrawArgs["cylinder"].IndexCount;
         leftCylRitem->StartIndexLocation = leftCylRitem->Geo->DrawArgs["cylinder"].StartIndexLocation;
         leftCylRitem->BaseVertexLocation = leftCylRitem->Geo->DrawArgs["cylinder"].BaseVertexLocation;
+        leftCylRitem->Bounds = leftCylRitem->Geo->DrawArgs["cylinder"].Bounds;
 
         XMStoreFloat4x4(&rightCylRitem->Model, leftCylWorld);
         XMStoreFloat4x4(&rightCylRitem->TexTransform, brickTexTransform);
@@ -592,6 +555,7 @@ void TexColumns::BuildRenderItems()
         rightCylRitem->IndexCount = rightCylRitem->Geo->DrawArgs["cylinder"].IndexCount;
         rightCylRitem->StartIndexLocation = rightCylRitem->Geo->DrawArgs["cylinder"].StartIndexLocation;
         rightCylRitem->BaseVertexLocation = rightCylRitem->Geo->DrawArgs["cylinder"].BaseVertexLocation;
+        rightCylRitem->Bounds = rightCylRitem->Geo->DrawArgs["cylinder"].Bounds;
 
         XMStoreFloat4x4(&leftSphereRitem->Model, leftSphereWorld);
         leftSphereRitem->TexTransform = MathHelper::Identity4x4();
@@ -602,6 +566,7 @@ void TexColumns::BuildRenderItems()
         leftSphereRitem->IndexCount = leftSphereRitem->Geo->DrawArgs["sphere"].IndexCount;
         leftSphereRitem->StartIndexLocation = leftSphereRitem->Geo->DrawArgs["sphere"].StartIndexLocation;
         leftSphereRitem->BaseVertexLocation = leftSphereRitem->Geo->DrawArgs["sphere"].BaseVertexLocation;
+        leftSphereRitem->Bounds = leftSphereRitem->Geo->DrawArgs["sphere"].Bounds;
 
         XMStoreFloat4x4(&rightSphereRitem->Model, rightSphereWorld);
         rightSphereRitem->TexTransform = MathHelper::Identity4x4();
@@ -612,6 +577,7 @@ void TexColumns::BuildRenderItems()
         rightSphereRitem->IndexCount = rightSphereRitem->Geo->DrawArgs["sphere"].IndexCount;
         rightSphereRitem->StartIndexLocation = rightSphereRitem->Geo->DrawArgs["sphere"].StartIndexLocation;
         rightSphereRitem->BaseVertexLocation = rightSphereRitem->Geo->DrawArgs["sphere"].BaseVertexLocation;
+        rightSphereRitem->Bounds = rightSphereRitem->Geo->DrawArgs["sphere"].Bounds;
 
         _allRenderItems.push_back(move(leftCylRitem));
         _allRenderItems.push_back(move(rightCylRitem));
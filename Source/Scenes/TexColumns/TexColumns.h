@@ -8,6 +8,7 @@
 #include "../../../Core/D3DUtil.h"
 #include "../../Common/RenderItem.h"
 #include "../../Common/FrameResourceUnfogged.h"
+#include "../../../Core/VertexPacker.h"
 
 namespace DX12Samples
 {
@@ -130,6 +131,7 @@ private:
     std::unordered_map<std::string, Microsoft::WRL::ComPtr<ID3D12PipelineState>> _PSOs;
 
     std::vector<D3D12_INPUT_ELEMENT_DESC> _inputLayout;
+    VertexQuantization _vertexQuantization;
 
 
     std::vector<std::unique_ptr<RenderItem>> _allRenderItems;
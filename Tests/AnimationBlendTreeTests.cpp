@@ -0,0 +1,174 @@
+#include "TestFramework.h"
+#include "TestAssets.h"
+#include "../Source/Scenes/SkinnedAnimation/SkinnedCrowd.h"
+
+namespace DX12Samples
+{
+namespace Tests
+{
+using namespace DirectX;
+
+namespace
+{
+float MaxPaletteDifference(const std::vector<XMFLOAT3X4>& a, const std::vector<XMFLOAT3X4>& b)
+{
+    float maxDifference = 0.0f;
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        const float* x = &a[i]._11;
+        const float* y = &b[i]._11;
+        for (int j = 0; j < 12; j++)
+            maxDifference = MathHelper::Max(maxDifference, fabsf(x[j] - y[j]));
+    }
+    return maxDifference;
+}
+}
+
+TEST(BlendTreeSingleClipMatchesSkinnedData)
+{
+    const SkinnedAsset* soldier = GetSoldier();
+    CHECK(soldier != nullptr);
+    if (soldier == nullptr)
+        return;
+
+    const SkinnedData& skinInfo = soldier->SkinInfo;
+    SkinnedData::ClipHandle clip = skinInfo.FindClip("Take1");
+    AnimationBlendTree tree;
+    tree.Init(&skinInfo);
+    AnimationBlendTree::NodeIndex node = tree.AddClip(clip);
+    tree.SetRoot(node);
+
+    FrameArena arena(MathHelper::Max(tree.GetScratchSize(), skinInfo.GetFinalTransformsScratchSize()));
+    std::vector<XMFLOAT3X4> expected(skinInfo.BoneCount());
+    std::vector<XMFLOAT3X4> actual(skinInfo.BoneCount());
+    UINT cursor = 0;
+    float maxDifference = 0.0f;
+    for (UINT frame = 0; frame < 300; frame++)
+    {
+        tree.Update(1.0f / 60.0f);
+        arena.Reset();
+        tree.Evaluate(arena, actual.data());
+        arena.Reset();
+        skinInfo.GetFinalTransforms(clip, tree.GetTimePos(node), arena, expected.data(), cursor);
+        maxDifference = MathHelper::Max(maxDifference, MaxPaletteDifference(expected, actual));
+    }
+    // Palettes hold model space translations of tens of units, compare with relative tolerance.
+    CHECK(maxDifference <= 1e-3f);
+}
+
+TEST(BlendTreeCrossFadeReachesTarget)
+{
+    const SkinnedAsset* soldier = GetSoldier();
+    if (soldier == nullptr)
+        return;
+
+    // Same setup as in the scene: walk is faded to still pose started from the current walk time.
+    const SkinnedData& skinInfo = soldier->SkinInfo;
+    SkinnedData::ClipHandle clip = skinInfo.FindClip("Take1");
+    AnimationBlendTree tree;
+    tree.Init(&skinInfo);
+    AnimationBlendTree::NodeIndex walk = tree.AddClip(clip);
+    AnimationBlendTree::NodeIndex hold = tree.AddClip(clip, 0.0f);
+    AnimationBlendTree::NodeIndex blend = tree.AddBlend(walk, hold, 0.0f);
+    tree.SetRoot(blend);
+    tree.SetTimePos(walk, 0.5f);
+
+    tree.SetTimePos(hold, tree.GetTimePos(walk));
+    tree.CrossFade(blend, 1.0f, 0.3f);
+    tree.Update(0.15f);
+    CHECK_NEAR(tree.GetWeight(blend), 0.5f, 1e-4f);
+    tree.Update(0.2f);
+    CHECK(tree.GetWeight(blend) == 1.0f);
+    CHECK_NEAR(tree.GetTimePos(hold), 0.5f, 1e-6f);
+
+    FrameArena arena(MathHelper::Max(tree.GetScratchSize(), skinInfo.GetFinalTransformsScratchSize()));
+    std::vector<XMFLOAT3X4> expected(skinInfo.BoneCount());
+    std::vector<XMFLOAT3X4> actual(skinInfo.BoneCount());
+    UINT cursor = 0;
+    tree.Evaluate(arena, actual.data());
+    arena.Reset();
+    skinInfo.GetFinalTransforms(clip, 0.5f, arena, expected.data(), cursor);
+    CHECK(MaxPaletteDifference(expected, actual) <= 1e-3f);
+}
+
+TEST(CrowdBlendTreeDoesNotAllocate)
+{
+    const SkinnedAsset* soldier = GetSoldier();
+    if (soldier == nullptr)
+        return;
+
+    SkinnedData* skinInfo = const_cast<SkinnedData*>(&soldier->SkinInfo);
+    SkinnedData::ClipHandle clip = skinInfo->FindClip("Take1");
+    AnimationBlendTree tree;
+    tree.Init(skinInfo);
+    AnimationBlendTree::NodeIndex blend = tree.AddBlend(tree.AddClip(clip), tree.AddClip(clip, 0.0f), 0.0f);
+    tree.SetRoot(blend);
+
+    JobSystem jobs(1);
+    SkinnedCrowd crowd;
+    crowd.Init(skinInfo, 8, "Take1", jobs.WorkerCount());
+    crowd.SetBlendTree(0, &tree);
+    tree.CrossFade(blend, 1.0f, 0.5f);
+
+    crowd.Update(1.0f / 60.0f, jobs);
+    size_t allocations = HeapAllocationCount();
+    for (UINT frame = 0; frame < 120; frame++)
+        crowd.Update(1.0f / 60.0f);
+    CHECK(HeapAllocationCount() == allocations);
+}
+
+BENCHMARK(BlendTreeLayers)
+{
+    const SkinnedAsset* soldier = GetSoldier();
+    if (soldier == nullptr)
+        return;
+
+    const SkinnedData& skinInfo = soldier->SkinInfo;
+    SkinnedData::ClipHandle clip = skinInfo.FindClip("Take1");
+    std::vector<XMFLOAT3X4> palette(skinInfo.BoneCount());
+    const int iterations = 5000;
+
+    FrameArena arena(skinInfo.GetFinalTransformsScratchSize());
+    UINT cursor = 0;
+    float t = 0.0f;
+    double clipMs = MeasureMs([&]()
+    {
+        t = fmodf(t + 1.0f / 60.0f, skinInfo.GetClipEndTime(clip));
+        arena.Reset();
+        skinInfo.GetFinalTransforms(clip, t, arena, palette.data(), cursor);
+    }, iterations);
+    std::printf("soldier Take1, %u bones, us per pose:\n  GetFinalTransforms %.2f\n", skinInfo.BoneCount(), clipMs * 1000.0);
+
+    // Every layer adds clip node on top of the previous tree.
+    for (UINT layers = 1; layers <= 4; layers++)
+    {
+        AnimationBlendTree tree;
+        tree.Init(&skinInfo);
+        AnimationBlendTree::NodeIndex root = tree.AddClip(clip);
+        for (UINT layer = 1; layer < layers; layer++)
+        {
+            AnimationBlendTree::NodeIndex other = tree.AddClip(clip, 0.5f * layer);
+            if (layer == 3)
+            {
+                root = tree.AddAdditive(root, other, 0.5f);
+                tree.SetBoneMask(root, skinInfo.BoneCount() / 2);
+            }
+            else
+            {
+                root = tree.AddBlend(root, other, 0.5f);
+            }
+        }
+        tree.SetRoot(root);
+        arena.Reset();
+        arena.Reserve(tree.GetScratchSize());
+        double treeMs = MeasureMs([&]()
+        {
+            tree.Update(1.0f / 60.0f);
+            arena.Reset();
+            tree.Evaluate(arena, palette.data());
+        }, iterations);
+        std::printf("  blend tree, %u clip(s)%s %.2f\n", layers, layers == 4 ? " (masked additive)" : "", treeMs * 1000.0);
+    }
+}
+}
+}
@@ -0,0 +1,141 @@
+#include "TestFramework.h"
+#include "TestAssets.h"
+#include "../Core/AnimationHelper.h"
+
+#include <random>
+
+namespace DX12Samples
+{
+namespace Tests
+{
+using namespace DirectX;
+
+namespace
+{
+/**
+ * \brief Keyframe search BoneAnimation::Interpolate used before keyframe cursors: linear scan from first keyframe.
+ */
+void InterpolateLinearScan(const BoneAnimation& animation, float t, XMFLOAT4X4& M)
+{
+    const std::vector<Keyframe>& keys = animation.Keyframes;
+    const Keyframe* key = nullptr;
+    if (t <= keys.front().TimePos)
+        key = &keys.front();
+    else if (t >= keys.back().TimePos)
+        key = &keys.back();
+    if (key != nullptr)
+    {
+        XMMATRIX transform = XMMatrixAffineTransformation(XMLoadFloat3(&key->Scale), XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f),
+            XMLoadFloat4(&key->RotationQuat), XMLoadFloat3(&key->Translation));
+        XMStoreFloat4x4(&M, transform);
+        return;
+    }
+
+    UINT i = 0;
+    while (!(t >= keys[i].TimePos && t <= keys[i + 1].TimePos))
+        i++;
+
+    float lerpPercent = (t - keys[i].TimePos) / (keys[i + 1].TimePos - keys[i].TimePos);
+    XMVECTOR S = XMVectorLerp(XMLoadFloat3(&keys[i].Scale), XMLoadFloat3(&keys[i + 1].Scale), lerpPercent);
+    XMVECTOR P = XMVectorLerp(XMLoadFloat3(&keys[i].Translation), XMLoadFloat3(&keys[i + 1].Translation), lerpPercent);
+    XMVECTOR Q = XMQuaternionSlerp(XMLoadFloat4(&keys[i].RotationQuat), XMLoadFloat4(&keys[i + 1].RotationQuat), lerpPercent);
+    XMStoreFloat4x4(&M, XMMatrixAffineTransformation(S, XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f), Q, P));
+}
+
+BoneAnimation CreateSyntheticTrack(UINT keyCount)
+{
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    BoneAnimation animation;
+    animation.Keyframes.resize(keyCount);
+    float t = 0.0f;
+    for (UINT i = 0; i < keyCount; i++)
+    {
+        Keyframe& key = animation.Keyframes[i];
+        key.TimePos = t;
+        key.Translation = XMFLOAT3(unit(random) * 10.0f, unit(random), unit(random));
+        XMStoreFloat4(&key.RotationQuat, XMQuaternionRotationRollPitchYaw(unit(random), unit(random), unit(random)));
+        // Irregular spacing, so search can't be replaced by division.
+        t += 1.0f / 120.0f + unit(random) / 60.0f;
+    }
+    return animation;
+}
+
+bool SameMatrix(const XMFLOAT4X4& a, const XMFLOAT4X4& b)
+{
+    return memcmp(&a, &b, sizeof(XMFLOAT4X4)) == 0;
+}
+}
+
+TEST(KeyframeCursorMatchesLinearScan)
+{
+    BoneAnimation animation = CreateSyntheticTrack(10000);
+    float endTime = animation.GetEndTime();
+
+    std::mt19937 random(11);
+    std::uniform_real_distribution<float> seek(-1.0f, endTime + 1.0f);
+    UINT cursor = 0;
+    UINT mismatches = 0;
+    for (UINT i = 0; i < 50000; i++)
+    {
+        // Mostly play forward, sometimes seek anywhere including outside of the track.
+        float t = i % 7 == 0 ? seek(random) : fmodf(i * (1.0f / 60.0f), endTime);
+        XMFLOAT4X4 expected;
+        XMFLOAT4X4 withCursor;
+        XMFLOAT4X4 withSearch;
+        InterpolateLinearScan(animation, t, expected);
+        animation.Interpolate(t, withCursor, cursor);
+        animation.Interpolate(t, withSearch);
+        if (!SameMatrix(expected, withCursor) || !SameMatrix(expected, withSearch))
+            mismatches++;
+    }
+    CHECK(mismatches == 0);
+}
+
+BENCHMARK(KeyframeSearch)
+{
+    const int iterations = 20;
+
+    BoneAnimation synthetic = CreateSyntheticTrack(10000);
+    float endTime = synthetic.GetEndTime();
+    const UINT frames = 2000;
+    XMFLOAT4X4 M;
+    UINT cursor = 0;
+    double scanMs = MeasureMs([&]() { for (UINT f = 0; f < frames; f++) InterpolateLinearScan(synthetic, fmodf(f * 0.05f, endTime), M); }, iterations);
+    double searchMs = MeasureMs([&]() { for (UINT f = 0; f < frames; f++) synthetic.Interpolate(fmodf(f * 0.05f, endTime), M); }, iterations);
+    double cursorMs = MeasureMs([&]() { for (UINT f = 0; f < frames; f++) synthetic.Interpolate(fmodf(f * 0.05f, endTime), M, cursor); }, iterations);
+    std::printf("10k key track: linear scan %.3f us, binary search %.3f us, cursor %.3f us per sample\n",
+        scanMs * 1000.0 / frames, searchMs * 1000.0 / frames, cursorMs * 1000.0 / frames);
+
+    const SkinnedAsset* soldier = GetSoldier();
+    if (soldier == nullptr)
+        return;
+    const AnimationClip& clip = soldier->SkinInfo.GetClip(soldier->SkinInfo.FindClip("Take1"));
+    const std::vector<BoneAnimation>& bones = clip.BoneAnimations;
+    endTime = clip.GetClipEndTime();
+    std::vector<UINT> cursors(bones.size(), 0);
+    auto playClip = [&](int mode)
+    {
+        for (UINT f = 0; f < frames; f++)
+        {
+            float t = fmodf(f * (1.0f / 60.0f), endTime);
+            for (size_t b = 0; b < bones.size(); b++)
+            {
+                if (mode == 0)
+                    InterpolateLinearScan(bones[b], t, M);
+                else if (mode == 1)
+                    bones[b].Interpolate(t, M);
+                else
+                    bones[b].Interpolate(t, M, cursors[b]);
+            }
+        }
+    };
+    scanMs = MeasureMs([&]() { playClip(0); }, 1);
+    searchMs = MeasureMs([&]() { playClip(1); }, 1);
+    cursorMs = MeasureMs([&]() { playClip(2); }, 1);
+    std::printf("soldier Take1, %zu bones: linear scan %.2f us, binary search %.2f us, cursor %.2f us per pose\n",
+        bones.size(), scanMs * 1000.0 / frames, searchMs * 1000.0 / frames, cursorMs * 1000.0 / frames);
+}
+}
+}
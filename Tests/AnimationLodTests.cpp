@@ -0,0 +1,97 @@
+#include "TestFramework.h"
+#include "TestAssets.h"
+#include "../Source/Scenes/SkinnedAnimation/SkinnedModelInstance.h"
+
+namespace DX12Samples
+{
+namespace Tests
+{
+using namespace DirectX;
+
+namespace
+{
+bool SamePalette(const std::vector<XMFLOAT3X4>& a, const std::vector<XMFLOAT3X4>& b)
+{
+    return memcmp(a.data(), b.data(), a.size() * sizeof(XMFLOAT3X4)) == 0;
+}
+
+void InitInstance(SkinnedModelInstance& instance, SkinnedData* skinInfo, float timePos)
+{
+    instance.SkinnedInfo = skinInfo;
+    instance.FinalTransforms.resize(skinInfo->BoneCount());
+    instance.SetClip("Take1");
+    instance.TimePos = timePos;
+}
+}
+
+TEST(SkeletonLodClampedWhenNotBuilt)
+{
+    const SkinnedAsset* soldier = GetSoldier();
+    CHECK(soldier != nullptr);
+    if (soldier == nullptr)
+        return;
+
+    SkinnedData skinInfo = soldier->SkinInfo;
+    skinInfo.BuildLods(1);
+    CHECK(skinInfo.LodCount() == 1);
+    CHECK(skinInfo.GetLodBoneCount(3) == skinInfo.BoneCount());
+
+    // Default far level uses skeleton LOD 1.
+    AnimationLodPolicy policy;
+    SkinnedModelInstance instance;
+    InitInstance(instance, &skinInfo, 0.0f);
+    instance.SetLod(policy.GetLevel(policy.LevelCount() - 1), 0);
+    CHECK(instance.SkeletonLod == 0);
+
+    SkinnedData::ClipHandle clip = skinInfo.FindClip("Take1");
+    FrameArena arena(skinInfo.GetFinalTransformsScratchSize());
+    std::vector<XMFLOAT3X4> full(skinInfo.BoneCount());
+    std::vector<XMFLOAT3X4> clamped(skinInfo.BoneCount());
+    UINT cursor = 0;
+    skinInfo.GetFinalTransforms(clip, 0.5f, arena, full.data(), cursor);
+    arena.Reset();
+    skinInfo.GetFinalTransforms(clip, 0.5f, 1, arena, clamped.data(), cursor);
+    CHECK(SamePalette(full, clamped));
+}
+
+TEST(ReducedRatePoseMatchesFullRate)
+{
+    const SkinnedAsset* soldier = GetSoldier();
+    if (soldier == nullptr)
+        return;
+
+    SkinnedData* skinInfo = const_cast<SkinnedData*>(&soldier->SkinInfo);
+    float clipEndTime = skinInfo->GetClipEndTime(skinInfo->FindClip("Take1"));
+    AnimationLodLevel level;
+    level.UpdateInterval = 4;
+
+    // Start right before clip end, so evaluations ahead of time cross the restart of the clip.
+    const float dt = 1.0f / 60.0f;
+    SkinnedModelInstance fullRate;
+    SkinnedModelInstance reducedRate;
+    InitInstance(fullRate, skinInfo, clipEndTime - 5.5f * dt);
+    InitInstance(reducedRate, skinInfo, clipEndTime - 5.5f * dt);
+    reducedRate.SetLod(level, 1);
+
+    FrameArena arena(skinInfo->GetFinalTransformsScratchSize());
+    UINT evaluatedFrames = 0;
+    UINT mismatches = 0;
+    for (UINT frame = 0; frame < 200; frame++)
+    {
+        arena.Reset();
+        fullRate.UpdateSkinnedAnimation(dt, arena);
+        arena.Reset();
+        reducedRate.UpdateSkinnedAnimation(dt, arena);
+        // Palette isn't interpolated on frames when pose was evaluated.
+        if (reducedRate.FramesUntilUpdate + 1 == reducedRate.IntervalFrames)
+        {
+            evaluatedFrames++;
+            if (!SamePalette(fullRate.FinalTransforms, reducedRate.FinalTransforms))
+                mismatches++;
+        }
+    }
+    CHECK(evaluatedFrames >= 200 / level.UpdateInterval);
+    CHECK(mismatches == 0);
+}
+}
+}
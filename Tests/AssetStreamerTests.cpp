@@ -0,0 +1,185 @@
+#include "TestFramework.h"
+#include "../Core/AssetStreamer.h"
+
+#include <thread>
+
+namespace DX12Samples
+{
+namespace Tests
+{
+using namespace DirectX;
+
+namespace
+{
+const char* MeshFilenames[] = { "Models/skull.txt", "Models/car.txt" };
+const char* SkinnedModelFilename = "Models/soldier.m3d";
+const char* TextureFilenames[] =
+{
+    "Textures/WireFence.dds", "Textures/WoodCrate01.dds", "Textures/WoodCrate01_mod.dds", "Textures/WoodCrate02.dds",
+    "Textures/bricks.dds", "Textures/bricks2.dds", "Textures/bricks2_nmap.dds", "Textures/bricks3.dds",
+    "Textures/bricks_nmap.dds", "Textures/checkboard.dds", "Textures/default_nmap.dds", "Textures/grass.dds",
+    "Textures/ice.dds", "Textures/stone.dds", "Textures/tile.dds", "Textures/tile_nmap.dds", "Textures/tree01S.dds",
+    "Textures/tree02S.dds", "Textures/tree35S.dds", "Textures/treeArray2.dds", "Textures/treearray.dds",
+    "Textures/water1.dds", "Textures/white1x1.dds"
+};
+
+// Every asset scenes load from Models/ and Textures/.
+struct AssetSet
+{
+    std::vector<std::shared_ptr<const MeshAsset>> Meshes;
+    std::shared_ptr<const SkinnedModelAsset> SkinnedModel;
+    std::vector<std::shared_ptr<const TextureFileAsset>> Textures;
+    UINT Callbacks = 0;
+};
+
+/**
+ * \brief Request every asset at once, or one by one waiting for each if serial is set. Mesh cache is cleared, so meshes are parsed.
+ */
+AssetSet LoadAssets(AssetStreamer& streamer, bool serial)
+{
+    MeshAssetCache::Instance().Clear();
+    AssetSet assets;
+    auto count = [&assets](const std::shared_ptr<const void>&) { assets.Callbacks++; };
+    auto wait = [&streamer, serial]()
+    {
+        if (serial)
+            streamer.Flush();
+    };
+
+    std::vector<AssetHandle<MeshAsset>> meshes;
+    for (const char* filename : MeshFilenames)
+    {
+        meshes.push_back(streamer.LoadMesh(filename, MeshVertexLayout::PosNormalUvTangent, AssetPriority::Normal, count));
+        wait();
+    }
+    AssetHandle<SkinnedModelAsset> skinnedModel = streamer.LoadSkinnedModel(SkinnedModelFilename, AssetPriority::High, count);
+    wait();
+    std::vector<AssetHandle<TextureFileAsset>> textures;
+    for (const char* filename : TextureFilenames)
+    {
+        textures.push_back(streamer.LoadTextureFile(filename, AssetPriority::Low, count));
+        wait();
+    }
+    streamer.Flush();
+
+    for (auto& mesh : meshes)
+        assets.Meshes.push_back(mesh.Get());
+    assets.SkinnedModel = skinnedModel.Get();
+    for (auto& texture : textures)
+        assets.Textures.push_back(texture.Get());
+    return assets;
+}
+
+template<typename T>
+bool SameRecords(const std::vector<T>& a, const std::vector<T>& b)
+{
+    return a.size() == b.size() && memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+}
+
+bool SameAssets(const AssetSet& a, const AssetSet& b)
+{
+    bool same = a.Meshes.size() == b.Meshes.size() && a.Textures.size() == b.Textures.size();
+    for (size_t i = 0; same && i < a.Meshes.size(); i++)
+        same = SameRecords(a.Meshes[i]->Vertices, b.Meshes[i]->Vertices) && SameRecords(a.Meshes[i]->Indices, b.Meshes[i]->Indices);
+    same = same && SameRecords(a.SkinnedModel->Vertices, b.SkinnedModel->Vertices) && SameRecords(a.SkinnedModel->Indices, b.SkinnedModel->Indices);
+    for (size_t i = 0; same && i < a.Textures.size(); i++)
+        same = a.Textures[i]->Data == b.Textures[i]->Data && a.Textures[i]->MipLevels == b.Textures[i]->MipLevels;
+    return same;
+}
+
+bool AllLoaded(const AssetSet& assets)
+{
+    bool loaded = assets.SkinnedModel != nullptr;
+    for (auto& mesh : assets.Meshes)
+        loaded = loaded && mesh != nullptr;
+    for (auto& texture : assets.Textures)
+        loaded = loaded && texture != nullptr;
+    return loaded;
+}
+}
+
+TEST(AssetStreamerMatchesSerialLoad)
+{
+    const UINT assetCount = _countof(MeshFilenames) + 1 + _countof(TextureFilenames);
+    AssetStreamer serialStreamer(1);
+    AssetSet serial = LoadAssets(serialStreamer, true);
+    CHECK(AllLoaded(serial));
+    CHECK(serial.Callbacks == assetCount);
+
+    AssetStreamer streamer(4);
+    AssetSet streamed = LoadAssets(streamer, false);
+    CHECK(AllLoaded(streamed));
+    CHECK(streamed.Callbacks == assetCount);
+    CHECK(streamer.PendingCount() == 0);
+    CHECK(SameAssets(serial, streamed));
+}
+
+TEST(AssetStreamerPriorityOrder)
+{
+    AssetStreamer streamer(1);
+    std::mutex orderMutex;
+    std::vector<int> order;
+    std::atomic<bool> release{ false };
+
+    // Occupy the only I/O thread, so the rest is queued before any of it starts.
+    auto blocker = streamer.Request<int>([&release]()
+    {
+        while (!release)
+            std::this_thread::yield();
+        return std::make_shared<int>(0);
+    });
+    while (blocker.GetState() == AssetState::Queued)
+        std::this_thread::yield();
+
+    const AssetPriority priorities[] = { AssetPriority::Low, AssetPriority::Normal, AssetPriority::High, AssetPriority::Normal };
+    std::vector<AssetHandle<int>> handles;
+    UINT callbacks = 0;
+    for (int i = 0; i < _countof(priorities); i++)
+    {
+        handles.push_back(streamer.Request<int>([&orderMutex, &order, i]()
+        {
+            std::lock_guard<std::mutex> lock(orderMutex);
+            order.push_back(i);
+            return std::make_shared<int>(i);
+        }, priorities[i], [&callbacks](const std::shared_ptr<const int>&) { callbacks++; }));
+    }
+    release = true;
+    for (auto& handle : handles)
+        handle.Get();
+
+    // Callbacks run only on dispatching thread.
+    CHECK(callbacks == 0);
+    streamer.Flush();
+    CHECK(callbacks == handles.size());
+    CHECK(order == std::vector<int>({ 2, 1, 3, 0 }));
+    CHECK(*handles[2].Get() == 2);
+}
+
+TEST(AssetStreamerReportsFailure)
+{
+    AssetStreamer streamer;
+    bool failed = false;
+    auto missing = streamer.LoadTextureFile("Textures/NoSuchTexture.dds", AssetPriority::Normal,
+        [&failed](const std::shared_ptr<const TextureFileAsset>& texture) { failed = texture == nullptr; });
+    streamer.Flush();
+    CHECK(missing.GetState() == AssetState::Failed && missing.Get() == nullptr);
+    CHECK(failed);
+    // Not a DDS file.
+    CHECK(AssetStreamer::ReadTextureFile("Models/car.txt") == nullptr);
+}
+
+BENCHMARK(AssetStreamerLoadTime)
+{
+    AssetStreamer serialStreamer(1);
+    double serialMs = MeasureMs([&]() { LoadAssets(serialStreamer, true); });
+    std::printf("%zu meshes, soldier.m3d and %zu textures, hardware threads %u: one by one %.1f ms\n",
+        _countof(MeshFilenames), _countof(TextureFilenames), std::thread::hardware_concurrency(), serialMs);
+    for (UINT threads : { 1u, 2u, 4u, 8u })
+    {
+        AssetStreamer streamer(threads);
+        double streamedMs = MeasureMs([&]() { LoadAssets(streamer, false); });
+        std::printf("  %u I/O threads: %.1f ms (%.2fx)\n", threads, streamedMs, serialMs / streamedMs);
+    }
+}
+}
+}
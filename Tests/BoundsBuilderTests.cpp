@@ -0,0 +1,412 @@
+#include "TestFramework.h"
+#include "TestAssets.h"
+#include "../Core/BoundsBuilder.h"
+#include "../Core/JobSystem.h"
+#include "../Core/MeshAsset.h"
+
+#include <algorithm>
+#include <random>
+
+namespace DX12Samples
+{
+namespace Tests
+{
+using namespace DirectX;
+
+namespace
+{
+struct PointSet
+{
+    std::string Name;
+    std::vector<XMFLOAT3> Positions;
+};
+
+PointSet LoadTextModel(const char* filename)
+{
+    PointSet set;
+    set.Name = filename;
+    std::vector<XMFLOAT3> normals;
+    std::vector<UINT> indices;
+    M3dLoader().LoadTextModel(filename, set.Positions, normals, indices);
+    return set;
+}
+
+std::vector<PointSet> LoadModels()
+{
+    std::vector<PointSet> sets;
+    sets.push_back(LoadTextModel("Models/skull.txt"));
+    sets.push_back(LoadTextModel("Models/car.txt"));
+    PointSet soldier;
+    soldier.Name = "Models/soldier.m3d";
+    if (const SkinnedAsset* asset = GetSoldier())
+    {
+        for (const M3dLoader::SkinnedVertex& vertex : asset->Vertices)
+            soldier.Positions.push_back(vertex.Pos);
+    }
+    sets.push_back(soldier);
+    return sets;
+}
+
+/**
+ * \brief Box of uniform points rotated off the axes, so its oriented box is much smaller than its axis aligned one.
+ */
+PointSet CreateRotatedBox(UINT count)
+{
+    PointSet set;
+    set.Name = "rotated box";
+    std::mt19937 random(21);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    XMMATRIX rotation = XMMatrixRotationAxis(XMVector3Normalize(XMVectorSet(1.0f, 2.0f, 3.0f, 0.0f)), 0.7f);
+    set.Positions.resize(count);
+    for (XMFLOAT3& p : set.Positions)
+        XMStoreFloat3(&p, XMVector3TransformNormal(XMVectorSet(10.0f * unit(random), 2.0f * unit(random), 0.5f * unit(random), 0.0f), rotation));
+    return set;
+}
+
+std::vector<XMFLOAT3> CreateGaussianPoints(UINT count)
+{
+    std::mt19937 random(3);
+    std::normal_distribution<float> coordinate(0.0f, 10.0f);
+    std::vector<XMFLOAT3> points(count);
+    for (XMFLOAT3& p : points)
+        p = XMFLOAT3(coordinate(random), coordinate(random), coordinate(random));
+    return points;
+}
+
+float Volume(const XMFLOAT3& extents)
+{
+    return 8.0f * extents.x * extents.y * extents.z;
+}
+
+float Volume(const BoundingSphere& sphere)
+{
+    return 4.0f / 3.0f * XM_PI * sphere.Radius * sphere.Radius * sphere.Radius;
+}
+
+bool ContainsAll(const MeshBounds& bounds, const std::vector<XMFLOAT3>& positions)
+{
+    const float tolerance = 1e-4f;
+    XMMATRIX toLocal = XMMatrixTranspose(XMMatrixRotationQuaternion(XMLoadFloat4(&bounds.OrientedBox.Orientation)));
+    XMVECTOR boxCenter = XMLoadFloat3(&bounds.Box.Center);
+    XMVECTOR boxExtents = XMLoadFloat3(&bounds.Box.Extents) + XMVectorReplicate(tolerance);
+    XMVECTOR orientedCenter = XMLoadFloat3(&bounds.OrientedBox.Center);
+    XMVECTOR orientedExtents = XMLoadFloat3(&bounds.OrientedBox.Extents) + XMVectorReplicate(tolerance);
+    XMVECTOR sphereCenter = XMLoadFloat3(&bounds.Sphere.Center);
+    bool contains = true;
+    for (const XMFLOAT3& position : positions)
+    {
+        XMVECTOR p = XMLoadFloat3(&position);
+        contains = contains && XMVector3LessOrEqual(XMVectorAbs(p - boxCenter), boxExtents);
+        contains = contains && XMVector3LessOrEqual(XMVectorAbs(XMVector3TransformNormal(p - orientedCenter, toLocal)), orientedExtents);
+        contains = contains && XMVectorGetX(XMVector3Length(p - sphereCenter)) <= bounds.Sphere.Radius * 1.00001f + tolerance;
+    }
+    return contains;
+}
+
+bool SameBounds(const MeshBounds& a, const MeshBounds& b)
+{
+    return memcmp(&a.Box, &b.Box, sizeof(BoundingBox)) == 0 && memcmp(&a.Sphere, &b.Sphere, sizeof(BoundingSphere)) == 0 &&
+        memcmp(&a.OrientedBox, &b.OrientedBox, sizeof(BoundingOrientedBox)) == 0;
+}
+
+/**
+ * \brief Sphere of two passes from Ritter's paper: around farthest pair of extreme points along axes, grown by points outside.
+ */
+BoundingSphere RitterSphere(const std::vector<XMFLOAT3>& positions)
+{
+    // Coordinates of XMFLOAT3 are consecutive floats.
+    size_t minPoints[3] = { 0, 0, 0 };
+    size_t maxPoints[3] = { 0, 0, 0 };
+    for (size_t i = 0; i < positions.size(); i++)
+    {
+        for (int axis = 0; axis < 3; axis++)
+        {
+            if ((&positions[i].x)[axis] < (&positions[minPoints[axis]].x)[axis])
+                minPoints[axis] = i;
+            if ((&positions[i].x)[axis] > (&positions[maxPoints[axis]].x)[axis])
+                maxPoints[axis] = i;
+        }
+    }
+    auto span = [&](int axis)
+    {
+        return XMVectorGetX(XMVector3LengthSq(XMLoadFloat3(&positions[maxPoints[axis]]) - XMLoadFloat3(&positions[minPoints[axis]])));
+    };
+    int widest = 0;
+    for (int axis = 1; axis < 3; axis++)
+    {
+        if (span(axis) > span(widest))
+            widest = axis;
+    }
+    XMVECTOR center = (XMLoadFloat3(&positions[minPoints[widest]]) + XMLoadFloat3(&positions[maxPoints[widest]])) * 0.5f;
+    float radius = XMVectorGetX(XMVector3Length(XMLoadFloat3(&positions[maxPoints[widest]]) - center));
+    for (const XMFLOAT3& position : positions)
+    {
+        XMVECTOR p = XMLoadFloat3(&position);
+        float distance = XMVectorGetX(XMVector3Length(p - center));
+        if (distance > radius)
+        {
+            float newRadius = (radius + distance) * 0.5f;
+            center += (p - center) * ((newRadius - radius) / distance);
+            radius = newRadius;
+        }
+    }
+    return BoundingSphere(XMFLOAT3(XMVectorGetX(center), XMVectorGetY(center), XMVectorGetZ(center)), radius);
+}
+
+struct Vector3d
+{
+    double X, Y, Z;
+};
+
+Vector3d operator-(const Vector3d& a, const Vector3d& b) { return { a.X - b.X, a.Y - b.Y, a.Z - b.Z }; }
+Vector3d operator+(const Vector3d& a, const Vector3d& b) { return { a.X + b.X, a.Y + b.Y, a.Z + b.Z }; }
+Vector3d operator*(const Vector3d& a, double s) { return { a.X * s, a.Y * s, a.Z * s }; }
+double Dot(const Vector3d& a, const Vector3d& b) { return a.X * b.X + a.Y * b.Y + a.Z * b.Z; }
+Vector3d Cross(const Vector3d& a, const Vector3d& b) { return { a.Y * b.Z - a.Z * b.Y, a.Z * b.X - a.X * b.Z, a.X * b.Y - a.Y * b.X }; }
+
+struct Sphere3d
+{
+    Vector3d Center = { 0.0, 0.0, 0.0 };
+    double RadiusSq = -1.0;
+
+    bool Contains(const Vector3d& p) const
+    {
+        Vector3d d = p - Center;
+        return Dot(d, d) <= RadiusSq * (1.0 + 1e-12) + 1e-12;
+    }
+};
+
+Sphere3d SphereOf(const Vector3d& a, const Vector3d& b)
+{
+    Sphere3d s;
+    s.Center = (a + b) * 0.5;
+    s.RadiusSq = Dot(b - s.Center, b - s.Center);
+    return s;
+}
+
+Sphere3d SphereOf(const Vector3d& a, const Vector3d& b, const Vector3d& c)
+{
+    Vector3d u = b - a;
+    Vector3d v = c - a;
+    Vector3d w = Cross(u, v);
+    double denominator = 2.0 * Dot(w, w);
+    if (denominator < 1e-30)
+    {
+        // Collinear points, sphere of farthest pair.
+        Sphere3d candidates[] = { SphereOf(a, b), SphereOf(a, c), SphereOf(b, c) };
+        return *std::max_element(std::begin(candidates), std::end(candidates), [](const Sphere3d& l, const Sphere3d& r) { return l.RadiusSq < r.RadiusSq; });
+    }
+    Vector3d offset = (Cross(w, u) * Dot(v, v) + Cross(v, w) * Dot(u, u)) * (1.0 / denominator);
+    Sphere3d s;
+    s.Center = a + offset;
+    s.RadiusSq = Dot(offset, offset);
+    return s;
+}
+
+Sphere3d SphereOf(const Vector3d& a, const Vector3d& b, const Vector3d& c, const Vector3d& d)
+{
+    Vector3d u = b - a;
+    Vector3d v = c - a;
+    Vector3d t = d - a;
+    double determinant = 2.0 * Dot(u, Cross(v, t));
+    if (fabs(determinant) < 1e-30)
+        return SphereOf(a, b, c);
+    Vector3d offset = (Cross(v, t) * Dot(u, u) + Cross(t, u) * Dot(v, v) + Cross(u, v) * Dot(t, t)) * (1.0 / determinant);
+    Sphere3d s;
+    s.Center = a + offset;
+    s.RadiusSq = Dot(offset, offset);
+    return s;
+}
+
+/**
+ * \brief Minimal sphere by Welzl's algorithm with move to front loops over shuffled points, in double.
+ */
+BoundingSphere MinimalSphere(const std::vector<XMFLOAT3>& positions)
+{
+    std::vector<Vector3d> p(positions.size());
+    for (size_t i = 0; i < p.size(); i++)
+        p[i] = { positions[i].x, positions[i].y, positions[i].z };
+    std::shuffle(p.begin(), p.end(), std::mt19937(11));
+
+    Sphere3d s;
+    s.Center = p[0];
+    s.RadiusSq = 0.0;
+    for (size_t i = 1; i < p.size(); i++)
+    {
+        if (s.Contains(p[i]))
+            continue;
+        s.Center = p[i];
+        s.RadiusSq = 0.0;
+        for (size_t j = 0; j < i; j++)
+        {
+            if (s.Contains(p[j]))
+                continue;
+            s = SphereOf(p[i], p[j]);
+            for (size_t k = 0; k < j; k++)
+            {
+                if (s.Contains(p[k]))
+                    continue;
+                s = SphereOf(p[i], p[j], p[k]);
+                for (size_t l = 0; l < k; l++)
+                {
+                    if (!s.Contains(p[l]))
+                        s = SphereOf(p[i], p[j], p[k], p[l]);
+                }
+            }
+        }
+    }
+    return BoundingSphere(XMFLOAT3((float)s.Center.X, (float)s.Center.Y, (float)s.Center.Z), (float)sqrt(s.RadiusSq));
+}
+
+/**
+ * \brief Volume of smallest box over orientationCount random orientations, reference for oriented boxes.
+ */
+float SampledOrientedBoxVolume(const std::vector<XMFLOAT3>& positions, UINT orientationCount)
+{
+    std::mt19937 random(17);
+    std::normal_distribution<float> component;
+    float best = FLT_MAX;
+    for (UINT o = 0; o < orientationCount; o++)
+    {
+        XMVECTOR q = XMQuaternionNormalize(XMVectorSet(component(random), component(random), component(random), component(random)));
+        XMMATRIX toLocal = XMMatrixTranspose(XMMatrixRotationQuaternion(q));
+        XMVECTOR minimum = XMVectorReplicate(FLT_MAX);
+        XMVECTOR maximum = XMVectorReplicate(-FLT_MAX);
+        for (const XMFLOAT3& position : positions)
+        {
+            XMVECTOR p = XMVector3TransformNormal(XMLoadFloat3(&position), toLocal);
+            minimum = XMVectorMin(minimum, p);
+            maximum = XMVectorMax(maximum, p);
+        }
+        XMFLOAT3 extents;
+        XMStoreFloat3(&extents, (maximum - minimum) * 0.5f);
+        best = MathHelper::Min(best, Volume(extents));
+    }
+    return best;
+}
+}
+
+TEST(BoundsContainModelPoints)
+{
+    BoundsBuilder builder;
+    std::vector<PointSet> sets = LoadModels();
+    sets.push_back(CreateRotatedBox(50000));
+    for (const PointSet& set : sets)
+    {
+        CHECK(!set.Positions.empty());
+        if (set.Positions.empty())
+            continue;
+
+        MeshBounds bounds = builder.Compute(set.Positions.data(), (UINT)set.Positions.size(), sizeof(XMFLOAT3));
+        CHECK(ContainsAll(bounds, set.Positions));
+        // Sphere is minimal one unless pass limit is hit, oriented box is never larger than axis aligned one.
+        CHECK(Volume(bounds.Sphere) <= Volume(MinimalSphere(set.Positions)) * 1.001f);
+        CHECK(Volume(bounds.OrientedBox.Extents) <= Volume(bounds.Box.Extents) * 1.0001f);
+    }
+
+    MeshBounds rotated = builder.Compute(sets.back().Positions.data(), (UINT)sets.back().Positions.size(), sizeof(XMFLOAT3));
+    CHECK(Volume(rotated.OrientedBox.Extents) < Volume(rotated.Box.Extents) * 0.5f);
+}
+
+TEST(BoundsOfDegeneratePoints)
+{
+    BoundsBuilder builder;
+    MeshBounds empty = builder.Compute(nullptr, 0, sizeof(XMFLOAT3));
+    CHECK(empty.Sphere.Radius == 0.0f && Volume(empty.Box.Extents) == 0.0f && Volume(empty.OrientedBox.Extents) == 0.0f);
+
+    std::vector<std::vector<XMFLOAT3>> sets;
+    sets.push_back({ XMFLOAT3(1.0f, 2.0f, 3.0f) });
+    sets.push_back(std::vector<XMFLOAT3>(100, XMFLOAT3(-4.0f, 0.5f, 2.0f)));
+    std::vector<XMFLOAT3> line;
+    std::vector<XMFLOAT3> plane;
+    for (int i = 0; i < 100; i++)
+    {
+        line.push_back(XMFLOAT3(0.1f * i, 0.2f * i, -0.3f * i));
+        plane.push_back(XMFLOAT3((float)(i % 10), 0.0f, (float)(i / 10)));
+    }
+    sets.push_back(line);
+    sets.push_back(plane);
+    for (const std::vector<XMFLOAT3>& positions : sets)
+    {
+        MeshBounds bounds = builder.Compute(positions.data(), (UINT)positions.size(), sizeof(XMFLOAT3));
+        CHECK(ContainsAll(bounds, positions));
+        CHECK(std::isfinite(bounds.Sphere.Radius) && std::isfinite(Volume(bounds.OrientedBox.Extents)));
+    }
+}
+
+TEST(BoundsDontDependOnWorkers)
+{
+    std::vector<XMFLOAT3> points = CreateGaussianPoints(200000);
+    MeshBounds serial = BoundsBuilder().Compute(points.data(), (UINT)points.size(), sizeof(XMFLOAT3));
+    for (int threads : { 0, 1, 3, 7 })
+    {
+        JobSystem jobs(threads);
+        CHECK(SameBounds(BoundsBuilder(jobs).Compute(points.data(), (UINT)points.size(), sizeof(XMFLOAT3)), serial));
+    }
+}
+
+TEST(SubmeshesGetBounds)
+{
+    GeometryGenerator geoGen;
+    GeometryGenerator::MeshData cylinder = geoGen.CreateCylinder(0.5f, 0.3f, 3.0f, 20, 20);
+    BoundsBuilder builder;
+    SubmeshGeometry submesh = builder.CreateSubmesh(cylinder, 30, 40);
+    CHECK(submesh.IndexCount == cylinder.Indices32.size() && submesh.StartIndexLocation == 30 && submesh.BaseVertexLocation == 40);
+    MeshBounds bounds = builder.Compute(cylinder);
+    MeshBounds filled;
+    filled.Box = submesh.Bounds;
+    filled.Sphere = submesh.SphereBounds;
+    filled.OrientedBox = submesh.OrientedBounds;
+    CHECK(SameBounds(filled, bounds));
+    CHECK(fabsf(submesh.Bounds.Extents.y - 1.5f) < 1e-5f);
+
+    std::shared_ptr<const MeshAsset> skull = MeshAssetCache::Instance().Load("Models/skull.txt", MeshVertexLayout::PosNormal);
+    CHECK(skull != nullptr);
+    if (skull == nullptr)
+        return;
+    SubmeshGeometry skullSubmesh = skull->CreateSubmesh(6, 8);
+    CHECK(skullSubmesh.IndexCount == skull->Indices.size() && skullSubmesh.StartIndexLocation == 6 && skullSubmesh.BaseVertexLocation == 8);
+    CHECK(memcmp(&skullSubmesh.SphereBounds, &skull->Bounds.Sphere, sizeof(BoundingSphere)) == 0);
+}
+
+BENCHMARK(BoundsVolumeRatios)
+{
+    std::vector<PointSet> sets = LoadModels();
+    sets.push_back(CreateRotatedBox(50000));
+    BoundsBuilder builder;
+    std::printf("%-20s %7s %13s %13s %12s %14s\n", "points", "count", "sphere/min", "Ritter/min", "OBB/AABB", "OBB/sampled");
+    for (const PointSet& set : sets)
+    {
+        if (set.Positions.empty())
+            continue;
+        MeshBounds bounds = builder.Compute(set.Positions.data(), (UINT)set.Positions.size(), sizeof(XMFLOAT3));
+        float minimal = Volume(MinimalSphere(set.Positions));
+        float sampled = SampledOrientedBoxVolume(set.Positions, 1000);
+        std::printf("%-20s %7zu %13.4f %13.4f %12.3f %14.3f\n", set.Name.c_str(), set.Positions.size(), Volume(bounds.Sphere) / minimal,
+            Volume(RitterSphere(set.Positions)) / minimal, Volume(bounds.OrientedBox.Extents) / Volume(bounds.Box.Extents),
+            Volume(bounds.OrientedBox.Extents) / sampled);
+    }
+}
+
+BENCHMARK(BoundsBuildTime)
+{
+    const UINT count = 10000000;
+    std::vector<XMFLOAT3> points = CreateGaussianPoints(count);
+    BoundsBuilder builder;
+    MeshBounds bounds;
+    double boxMs = MeasureMs([&]() { bounds.Box = builder.ComputeBox(points.data(), count, sizeof(XMFLOAT3)); });
+    double sphereMs = MeasureMs([&]() { bounds.Sphere = builder.ComputeSphere(points.data(), count, sizeof(XMFLOAT3)); });
+    double orientedMs = MeasureMs([&]() { bounds.OrientedBox = builder.ComputeOrientedBox(points.data(), count, sizeof(XMFLOAT3)); });
+    double ritterMs = MeasureMs([&]() { bounds.Sphere = RitterSphere(points); });
+    std::printf("%u gaussian points: box %.1f ms, sphere %.1f ms, oriented box %.1f ms, Ritter sphere %.1f ms\n",
+        count, boxMs, sphereMs, orientedMs, ritterMs);
+    for (int threads : { 1, 3 })
+    {
+        JobSystem jobs(threads);
+        BoundsBuilder parallel(jobs);
+        double parallelMs = MeasureMs([&]() { bounds = parallel.Compute(points.data(), count, sizeof(XMFLOAT3)); });
+        std::printf("  %u workers: all volumes %.1f ms\n", jobs.WorkerCount(), parallelMs);
+    }
+}
+}
+}
@@ -0,0 +1,132 @@
+#include "TestFramework.h"
+#include "TestAssets.h"
+
+namespace DX12Samples
+{
+namespace Tests
+{
+using namespace DirectX;
+
+namespace
+{
+// Documented CompiledClip tolerance: rotation and scale elements absolute, translation relative to its magnitude.
+const float CompiledClipTolerance = 1e-4f;
+
+float SoldierClipTime(UINT frame, float endTime)
+{
+    return fmodf(frame * (1.0f / 60.0f), endTime);
+}
+}
+
+TEST(CompiledClipMatchesAnimationClip)
+{
+    const SkinnedAsset* soldier = GetSoldier();
+    CHECK(soldier != nullptr);
+    if (soldier == nullptr)
+        return;
+
+    const SkinnedData& skinInfo = soldier->SkinInfo;
+    SkinnedData::ClipHandle clip = skinInfo.FindClip("Take1");
+    CHECK(clip != SkinnedData::InvalidClip);
+    const AnimationClip& source = skinInfo.GetClip(clip);
+    const CompiledClip& compiled = skinInfo.GetCompiledClip(clip);
+
+    UINT boneCount = skinInfo.BoneCount();
+    std::vector<XMFLOAT4X4> expected(boneCount);
+    std::vector<XMFLOAT4X4> actual(boneCount);
+    std::vector<UINT> boneCursors(boneCount, 0);
+    UINT cursor = 0;
+    float endTime = source.GetClipEndTime();
+    float maxError = 0.0f;
+    // Play forward at 60Hz, then probe times before start, after end and random seeks.
+    for (UINT frame = 0; frame < 1000; frame++)
+    {
+        float t = frame < 900 ? SoldierClipTime(frame, endTime) : (frame - 950) * endTime / 40.0f;
+        source.Interpolate(t, expected.data(), boneCursors.data());
+        compiled.Interpolate(t, actual.data(), cursor);
+
+        for (UINT bone = 0; bone < boneCount; bone++)
+        {
+            float translation = MathHelper::Max(1.0f, fabsf(expected[bone](3, 0)) + fabsf(expected[bone](3, 1)) + fabsf(expected[bone](3, 2)));
+            for (int r = 0; r < 4; r++)
+            {
+                for (int c = 0; c < 4; c++)
+                {
+                    float error = fabsf(expected[bone](r, c) - actual[bone](r, c));
+                    maxError = MathHelper::Max(maxError, r == 3 ? error / translation : error);
+                }
+            }
+        }
+    }
+    CHECK(maxError <= CompiledClipTolerance);
+}
+
+TEST(CompiledClipWithoutKeys)
+{
+    // 6 bones, so second group has padding lanes. Bone 2 is animated, other bones have no keys.
+    AnimationClip clip;
+    clip.BoneAnimations.resize(6);
+    Keyframe key;
+    key.TimePos = 0.5f;
+    key.Translation = XMFLOAT3(1.0f, 2.0f, 3.0f);
+    clip.BoneAnimations[2].Keyframes.push_back(key);
+
+    CompiledClip compiled;
+    compiled.Build(clip);
+    CHECK(compiled.KeyCount() == 1);
+    CHECK(compiled.GetStartTime() == 0.5f && compiled.GetEndTime() == 0.5f);
+
+    std::vector<XMFLOAT4X4> transforms(6);
+    UINT cursor = 0;
+    compiled.Interpolate(1.0f, transforms.data(), cursor);
+    XMFLOAT4X4 identity;
+    XMStoreFloat4x4(&identity, XMMatrixIdentity());
+    bool identityBones = true;
+    for (UINT bone = 0; bone < 6; bone++)
+    {
+        if (bone != 2)
+            identityBones = identityBones && memcmp(&transforms[bone], &identity, sizeof(XMFLOAT4X4)) == 0;
+    }
+    CHECK(identityBones);
+    CHECK(transforms[2](3, 0) == 1.0f && transforms[2](3, 1) == 2.0f && transforms[2](3, 2) == 3.0f);
+
+    // Clip without any keys samples to identity at time 0.
+    AnimationClip emptyClip;
+    emptyClip.BoneAnimations.resize(3);
+    CompiledClip emptyCompiled;
+    emptyCompiled.Build(emptyClip);
+    CHECK(emptyCompiled.KeyCount() == 1 && emptyCompiled.GetStartTime() == 0.0f && emptyCompiled.GetEndTime() == 0.0f);
+    std::vector<BoneGroupPose, AlignedAllocator<BoneGroupPose>> pose(emptyCompiled.GroupCount());
+    CHECK(reinterpret_cast<uintptr_t>(pose.data()) % alignof(BoneGroupPose) == 0);
+    emptyCompiled.Sample(2.0f, pose.data(), cursor);
+    emptyCompiled.Interpolate(2.0f, transforms.data(), cursor);
+    CHECK(memcmp(&transforms[0], &identity, sizeof(XMFLOAT4X4)) == 0);
+}
+
+BENCHMARK(CompiledClipInterpolate)
+{
+    const SkinnedAsset* soldier = GetSoldier();
+    if (soldier == nullptr)
+        return;
+
+    const SkinnedData& skinInfo = soldier->SkinInfo;
+    SkinnedData::ClipHandle clip = skinInfo.FindClip("Take1");
+    const AnimationClip& source = skinInfo.GetClip(clip);
+    const CompiledClip& compiled = skinInfo.GetCompiledClip(clip);
+    float endTime = source.GetClipEndTime();
+
+    UINT boneCount = skinInfo.BoneCount();
+    std::vector<XMFLOAT4X4> transforms(boneCount);
+    std::vector<UINT> boneCursors(boneCount, 0);
+    UINT cursor = 0;
+    UINT frame = 0;
+    const int iterations = 20000;
+    double sourceMs = MeasureMs([&]() { source.Interpolate(SoldierClipTime(frame++, endTime), transforms.data(), boneCursors.data()); }, iterations);
+    frame = 0;
+    double compiledMs = MeasureMs([&]() { compiled.Interpolate(SoldierClipTime(frame++, endTime), transforms.data(), cursor); }, iterations);
+
+    std::printf("soldier Take1, %u bones: AnimationClip %.2f us, CompiledClip %.2f us per pose (%.1fx), %zu bytes compiled\n",
+        boneCount, sourceMs * 1000.0, compiledMs * 1000.0, sourceMs / compiledMs, compiled.ByteSize());
+}
+}
+}
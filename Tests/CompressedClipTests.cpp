@@ -0,0 +1,80 @@
+#include "TestFramework.h"
+#include "TestAssets.h"
+#include "../Source/Scenes/SkinnedAnimation/CompressedClip.h"
+
+namespace DX12Samples
+{
+namespace Tests
+{
+using namespace DirectX;
+
+TEST(CompressedClipWithinTolerance)
+{
+    const SkinnedAsset* soldier = GetSoldier();
+    CHECK(soldier != nullptr);
+    if (soldier == nullptr)
+        return;
+
+    const AnimationClip& clip = soldier->SkinInfo.GetClip(soldier->SkinInfo.FindClip("Take1"));
+    ClipCompressionSettings settings;
+    CompressedClip compressedClip;
+    compressedClip.Build(clip, settings);
+    ClipCompressionReport report = CompressedClip::Measure(clip, compressedClip);
+
+    CHECK(report.CompressedBytes < report.RawBytes);
+    // Quantization adds error on top of key reduction tolerance.
+    CHECK(report.MaxRotationError <= settings.RotationTolerance * 2.0f);
+    CHECK(report.MaxScaleError <= settings.ScaleTolerance * 2.0f);
+    CHECK(report.MaxTranslationError <= 0.05f);
+}
+
+TEST(CompressedClipDuplicateKeyTimes)
+{
+    // Step key at the same time position and keys closer than time quantization step. Clip is 65535 seconds long,
+    // so quantized times equal key times and sampling can land exactly on duplicate keys.
+    const float times[] = { 0.0f, 100.0f, 100.0f, 100.2f, 100.4f, 65535.0f };
+    const float heights[] = { 0.0f, 1.0f, 5.0f, 6.0f, 7.0f, 7.0f };
+    AnimationClip clip;
+    clip.BoneAnimations.resize(1);
+    for (UINT i = 0; i < _countof(times); i++)
+    {
+        Keyframe key;
+        key.TimePos = times[i];
+        key.Translation = XMFLOAT3(0.0f, heights[i], 0.0f);
+        key.RotationQuat = XMFLOAT4(0.0f, sinf(heights[i] * 0.1f), 0.0f, cosf(heights[i] * 0.1f));
+        clip.BoneAnimations[0].Keyframes.push_back(key);
+    }
+
+    CompressedClip compressedClip;
+    compressedClip.Build(clip);
+    std::vector<UINT> cursors(compressedClip.CursorCount(), 0);
+    bool finite = true;
+    for (UINT sample = 0; sample <= 2000; sample++)
+    {
+        // Dense sampling around the duplicates, cursors left by other instances may point at any key.
+        float t = sample % 2 == 0 ? 99.0f + sample * 0.001f : 100.0f;
+        std::fill(cursors.begin(), cursors.end(), sample % 4);
+        Keyframe key;
+        compressedClip.Interpolate(t, 0, key, cursors.data());
+        finite = finite && std::isfinite(key.Translation.y) && std::isfinite(key.RotationQuat.y) && std::isfinite(key.RotationQuat.w);
+    }
+    CHECK(finite);
+
+    Keyframe end;
+    compressedClip.Interpolate(65535.0f, 0, end, cursors.data());
+    CHECK_NEAR(end.Translation.y, 7.0f, 1e-3f);
+}
+
+BENCHMARK(CompressedClipReport)
+{
+    const SkinnedAsset* soldier = GetSoldier();
+    if (soldier == nullptr)
+        return;
+
+    const AnimationClip& clip = soldier->SkinInfo.GetClip(soldier->SkinInfo.FindClip("Take1"));
+    CompressedClip compressedClip;
+    compressedClip.Build(clip);
+    std::printf("soldier Take1\n%s", CompressedClip::Measure(clip, compressedClip, 10000).ToString().c_str());
+}
+}
+}
@@ -0,0 +1,130 @@
+#include "TestFramework.h"
+#include "TestAssets.h"
+#include "../Source/Scenes/SkinnedAnimation/CpuSkinning.h"
+
+namespace DX12Samples
+{
+namespace Tests
+{
+using namespace DirectX;
+
+namespace
+{
+/**
+ * \brief Scalar port of skinning in Shaders/SkinnedRender/Default.hlsl. BoneTransforms there are column major float4x3,
+ * so row r of XMFLOAT3X4 palette is column r of the shader matrix.
+ */
+void SkinLikeShader(const M3dLoader::SkinnedVertex& vertex, const XMFLOAT3X4* palette, SkinnedVertexResult& out)
+{
+    float weights[4] = { vertex.BoneWeights.x, vertex.BoneWeights.y, vertex.BoneWeights.z, 0.0f };
+    weights[3] = 1.0f - weights[0] - weights[1] - weights[2];
+
+    const float pos[4] = { vertex.Pos.x, vertex.Pos.y, vertex.Pos.z, 1.0f };
+    const float normal[3] = { vertex.Normal.x, vertex.Normal.y, vertex.Normal.z };
+    const float tangent[3] = { vertex.TangentU.x, vertex.TangentU.y, vertex.TangentU.z };
+    float posL[3] = {};
+    float normalL[3] = {};
+    float tangentL[3] = {};
+    for (int j = 0; j < 4; j++)
+    {
+        const XMFLOAT3X4& bone = palette[vertex.BoneIndices[j]];
+        for (int c = 0; c < 3; c++)
+        {
+            // mul(float4(pos, 1), M) and mul(normal, (float3x3)M).
+            posL[c] += weights[j] * (pos[0] * bone.m[c][0] + pos[1] * bone.m[c][1] + pos[2] * bone.m[c][2] + pos[3] * bone.m[c][3]);
+            normalL[c] += weights[j] * (normal[0] * bone.m[c][0] + normal[1] * bone.m[c][1] + normal[2] * bone.m[c][2]);
+            tangentL[c] += weights[j] * (tangent[0] * bone.m[c][0] + tangent[1] * bone.m[c][1] + tangent[2] * bone.m[c][2]);
+        }
+    }
+    out.Pos = XMFLOAT3(posL);
+    out.Normal = XMFLOAT3(normalL);
+    out.TangentU = XMFLOAT3(tangentL);
+}
+
+float MaxDifference(const XMFLOAT3& a, const XMFLOAT3& b)
+{
+    return MathHelper::Max(fabsf(a.x - b.x), MathHelper::Max(fabsf(a.y - b.y), fabsf(a.z - b.z)));
+}
+
+void GetSoldierPalette(const SkinnedData& skinInfo, float t, std::vector<XMFLOAT3X4>& palette)
+{
+    SkinnedData::ClipHandle clip = skinInfo.FindClip("Take1");
+    FrameArena arena(skinInfo.GetFinalTransformsScratchSize());
+    UINT cursor = 0;
+    palette.resize(skinInfo.BoneCount());
+    skinInfo.GetFinalTransforms(clip, t, arena, palette.data(), cursor);
+}
+}
+
+TEST(CpuSkinningMatchesShader)
+{
+    const SkinnedAsset* soldier = GetSoldier();
+    CHECK(soldier != nullptr);
+    if (soldier == nullptr)
+        return;
+
+    const std::vector<M3dLoader::SkinnedVertex>& vertices = soldier->Vertices;
+    UINT count = (UINT)vertices.size();
+    std::vector<XMFLOAT3X4> palette;
+    std::vector<SkinnedVertexResult> serial(count);
+    std::vector<SkinnedVertexResult> parallel(count);
+    std::vector<XMFLOAT3> positions(count);
+    JobSystem jobs(3);
+
+    float maxPositionError = 0.0f;
+    float maxDirectionError = 0.0f;
+    bool parallelMatches = true;
+    for (float t : { 0.0f, 0.4f, 1.3f, 2.0f })
+    {
+        GetSoldierPalette(soldier->SkinInfo, t, palette);
+        CpuSkinning::Skin(vertices.data(), count, palette.data(), serial.data());
+        CpuSkinning::Skin(vertices.data(), count, palette.data(), parallel.data(), jobs);
+        CpuSkinning::SkinPositions(vertices.data(), count, palette.data(), positions.data(), jobs);
+        parallelMatches = parallelMatches && memcmp(serial.data(), parallel.data(), count * sizeof(SkinnedVertexResult)) == 0;
+
+        for (UINT i = 0; i < count; i++)
+        {
+            SkinnedVertexResult expected;
+            SkinLikeShader(vertices[i], palette.data(), expected);
+            // Soldier is ~100 units tall, position error is relative to that.
+            float positionScale = MathHelper::Max(1.0f, fabsf(expected.Pos.x) + fabsf(expected.Pos.y) + fabsf(expected.Pos.z));
+            maxPositionError = MathHelper::Max(maxPositionError, MaxDifference(expected.Pos, serial[i].Pos) / positionScale);
+            maxPositionError = MathHelper::Max(maxPositionError, MaxDifference(expected.Pos, positions[i]) / positionScale);
+            maxDirectionError = MathHelper::Max(maxDirectionError, MaxDifference(expected.Normal, serial[i].Normal));
+            maxDirectionError = MathHelper::Max(maxDirectionError, MaxDifference(expected.TangentU, serial[i].TangentU));
+        }
+    }
+    CHECK(parallelMatches);
+    CHECK(maxPositionError <= 1e-5f);
+    CHECK(maxDirectionError <= 1e-5f);
+}
+
+BENCHMARK(CpuSkinningThroughput)
+{
+    const SkinnedAsset* soldier = GetSoldier();
+    if (soldier == nullptr)
+        return;
+
+    const std::vector<M3dLoader::SkinnedVertex>& vertices = soldier->Vertices;
+    UINT count = (UINT)vertices.size();
+    std::vector<XMFLOAT3X4> palette;
+    GetSoldierPalette(soldier->SkinInfo, 0.5f, palette);
+    std::vector<SkinnedVertexResult> out(count);
+    std::vector<XMFLOAT3> positions(count);
+    JobSystem jobs;
+
+    const int iterations = 50;
+    SkinnedVertexResult reference;
+    double shaderMs = MeasureMs([&]() { for (UINT i = 0; i < count; i++) SkinLikeShader(vertices[i], palette.data(), reference); }, iterations);
+    double skinMs = MeasureMs([&]() { CpuSkinning::Skin(vertices.data(), count, palette.data(), out.data()); }, iterations);
+    double skinJobsMs = MeasureMs([&]() { CpuSkinning::Skin(vertices.data(), count, palette.data(), out.data(), jobs); }, iterations);
+    double positionsMs = MeasureMs([&]() { CpuSkinning::SkinPositions(vertices.data(), count, palette.data(), positions.data()); }, iterations);
+    double positionsJobsMs = MeasureMs([&]() { CpuSkinning::SkinPositions(vertices.data(), count, palette.data(), positions.data(), jobs); }, iterations);
+
+    auto mVertsPerSecond = [count](double ms) { return count / (ms * 1000.0); };
+    std::printf("soldier, %u vertices, million vertices/s (%u workers):\n", count, jobs.WorkerCount());
+    std::printf("  scalar shader port %.1f\n  Skin %.1f, with jobs %.1f\n  SkinPositions %.1f, with jobs %.1f\n",
+        mVertsPerSecond(shaderMs), mVertsPerSecond(skinMs), mVertsPerSecond(skinJobsMs), mVertsPerSecond(positionsMs), mVertsPerSecond(positionsJobsMs));
+}
+}
+}
@@ -0,0 +1,215 @@
+#include "TestFramework.h"
+#include "../Core/D3DUtil.h"
+#include "../Core/GeometryGenerator.h"
+#include "../Core/JobSystem.h"
+
+#include <unordered_set>
+
+namespace DX12Samples
+{
+namespace Tests
+{
+using namespace DirectX;
+
+namespace
+{
+size_t GeosphereVertexCount(UINT level)
+{
+    return 10 * ((size_t)1 << (2 * level)) + 2;
+}
+
+/**
+ * \brief Every directed edge is used once and its reverse by neighbour triangle, so mesh is closed and consistently wound.
+ */
+bool IsWatertight(const GeometryGenerator::MeshData& meshData)
+{
+    const auto& indices = meshData.Indices32;
+    std::unordered_set<UINT64> edges;
+    bool unique = true;
+    for (size_t i = 0; unique && i < indices.size(); i++)
+    {
+        UINT64 from = indices[i];
+        UINT64 to = indices[i % 3 == 2 ? i - 2 : i + 1];
+        unique = edges.insert(from << 32 | to).second;
+    }
+    bool paired = unique;
+    for (auto it = edges.begin(); paired && it != edges.end(); ++it)
+        paired = edges.count(*it >> 32 | *it << 32) == 1;
+    return paired;
+}
+
+/**
+ * \brief Geosphere as CreateGeosphere built it before edge midpoints were shared: six new vertices per triangle and level,
+ * same projection and texture coordinates.
+ */
+GeometryGenerator::MeshData ReferenceGeosphere(float radius, UINT level)
+{
+    GeometryGenerator::MeshData meshData = GeometryGenerator().CreateGeosphere(radius, 0);
+    for (UINT l = 0; l < level; l++)
+    {
+        GeometryGenerator::MeshData input = meshData;
+        meshData.Vertices.clear();
+        meshData.Indices32.clear();
+        for (size_t t = 0; t < input.Indices32.size(); t += 3)
+        {
+            XMVECTOR p[3];
+            for (int i = 0; i < 3; i++)
+                p[i] = XMLoadFloat3(&input.Vertices[input.Indices32[t + i]].Position);
+            XMVECTOR corners[6] = { p[0], p[1], p[2], 0.5f * (p[0] + p[1]), 0.5f * (p[1] + p[2]), 0.5f * (p[0] + p[2]) };
+            UINT base = (UINT)meshData.Vertices.size();
+            for (XMVECTOR corner : corners)
+            {
+                GeometryGenerator::Vertex vertex;
+                XMStoreFloat3(&vertex.Position, corner);
+                meshData.Vertices.push_back(vertex);
+            }
+            const UINT split[12] = { 0, 3, 5, 3, 4, 5, 5, 4, 2, 3, 1, 4 };
+            for (UINT i : split)
+                meshData.Indices32.push_back(base + i);
+        }
+    }
+    for (GeometryGenerator::Vertex& vertex : meshData.Vertices)
+    {
+        XMVECTOR n = XMVector3Normalize(XMLoadFloat3(&vertex.Position));
+        XMStoreFloat3(&vertex.Position, radius * n);
+        XMStoreFloat3(&vertex.Normal, n);
+
+        float theta = atan2f(vertex.Position.z, vertex.Position.x);
+        if (theta < 0.0f)
+            theta += XM_2PI;
+        float phi = acosf(vertex.Position.y / radius);
+        vertex.TexCoord = XMFLOAT2(theta / XM_2PI, phi / XM_PI);
+        XMStoreFloat3(&vertex.Tangent, XMVector3Normalize(XMVectorSet(-sinf(phi) * sinf(theta), 0.0f, sinf(phi) * cosf(theta), 0.0f)));
+    }
+    return meshData;
+}
+
+/**
+ * \brief Meshes whose rows GeometryGenerator generates on job system workers.
+ */
+std::vector<GeometryGenerator::MeshData> CreateRowMeshes(GeometryGenerator& geoGen, GeometryGenerator::uint32 size)
+{
+    std::vector<GeometryGenerator::MeshData> meshes;
+    meshes.push_back(geoGen.CreateGrid(100.0f, 100.0f, size, size));
+    meshes.push_back(geoGen.CreateSphere(1.0f, size, size));
+    meshes.push_back(geoGen.CreateCylinder(1.0f, 0.5f, 3.0f, size, size));
+    return meshes;
+}
+
+bool SameMesh(const GeometryGenerator::MeshData& a, const GeometryGenerator::MeshData& b)
+{
+    return a.Vertices.size() == b.Vertices.size() && a.Indices32 == b.Indices32 &&
+        memcmp(a.Vertices.data(), b.Vertices.data(), a.Vertices.size() * sizeof(GeometryGenerator::Vertex)) == 0;
+}
+}
+
+TEST(GeosphereSharesVertices)
+{
+    GeometryGenerator geoGen;
+    for (UINT level = 0; level <= 5; level++)
+    {
+        GeometryGenerator::MeshData sphere = geoGen.CreateGeosphere(2.0f, level);
+        CHECK(sphere.Vertices.size() == GeosphereVertexCount(level));
+        CHECK(sphere.Indices32.size() == 60 * ((size_t)1 << (2 * level)));
+        CHECK(IsWatertight(sphere));
+        bool onSphere = true;
+        for (const GeometryGenerator::Vertex& vertex : sphere.Vertices)
+            onSphere = onSphere && fabsf(XMVectorGetX(XMVector3Length(XMLoadFloat3(&vertex.Position))) - 2.0f) < 1e-5f;
+        CHECK(onSphere);
+    }
+    // Cap.
+    CHECK(geoGen.CreateGeosphere(1.0f, 9).Vertices.size() == GeosphereVertexCount(8));
+}
+
+TEST(GeosphereIndices16UpToLevel6)
+{
+    GeometryGenerator geoGen;
+    GeometryGenerator::MeshData level6 = geoGen.CreateGeosphere(1.0f, 6);
+    CHECK(level6.Vertices.size() <= 65536);
+    CHECK(level6.GetIndices16().size() == level6.Indices32.size());
+
+    GeometryGenerator::MeshData level7 = geoGen.CreateGeosphere(1.0f, 7);
+    CHECK(level7.Vertices.size() == GeosphereVertexCount(7));
+    bool threw = false;
+    try
+    {
+        level7.GetIndices16();
+    }
+    catch (const DxException&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+    bool validIndices = true;
+    for (UINT index : level7.Indices32)
+        validIndices = validIndices && index < level7.Vertices.size();
+    CHECK(validIndices);
+}
+
+TEST(ParallelGeneratorMatchesSerial)
+{
+    GeometryGenerator serialGen;
+    std::vector<GeometryGenerator::MeshData> serial = CreateRowMeshes(serialGen, 300);
+    for (int threads : { 0, 1, 3, 7 })
+    {
+        JobSystem jobs(threads);
+        GeometryGenerator geoGen(jobs);
+        std::vector<GeometryGenerator::MeshData> parallel = CreateRowMeshes(geoGen, 300);
+        bool same = parallel.size() == serial.size();
+        for (size_t i = 0; same && i < serial.size(); i++)
+            same = SameMesh(serial[i], parallel[i]);
+        CHECK(same);
+    }
+}
+
+BENCHMARK(GeometryGeneratorScaling)
+{
+    const GeometryGenerator::uint32 size = 1024;
+    auto create = [size](GeometryGenerator& geoGen, int mesh)
+    {
+        if (mesh == 0)
+            return geoGen.CreateGrid(100.0f, 100.0f, size, size);
+        if (mesh == 1)
+            return geoGen.CreateSphere(1.0f, size, size);
+        return geoGen.CreateCylinder(1.0f, 0.5f, 3.0f, size, size);
+    };
+    const char* names[] = { "grid", "sphere", "cylinder" };
+
+    std::printf("%u x %u rows, hardware threads %u\n", size, size, std::thread::hardware_concurrency());
+    GeometryGenerator serialGen;
+    for (int mesh = 0; mesh < _countof(names); mesh++)
+    {
+        double serialMs = MeasureMs([&]() { create(serialGen, mesh); });
+        std::printf("  %-8s serial %.1f ms", names[mesh], serialMs);
+        for (int threads : { 1, 3, 7 })
+        {
+            JobSystem jobs(threads);
+            GeometryGenerator geoGen(jobs);
+            double parallelMs = MeasureMs([&]() { create(geoGen, mesh); });
+            std::printf(", %u workers %.1f ms (%.2fx)", jobs.WorkerCount(), parallelMs, serialMs / parallelMs);
+        }
+        std::printf("\n");
+    }
+}
+
+BENCHMARK(GeosphereLevels)
+{
+    GeometryGenerator geoGen;
+    std::printf("%5s %9s %9s %9s %9s %10s %10s\n", "level", "vertices", "old verts", "ms", "old ms", "MB", "old MB");
+    for (UINT level = 0; level <= 8; level++)
+    {
+        GeometryGenerator::MeshData sphere;
+        GeometryGenerator::MeshData reference;
+        int iterations = level < 5 ? 20 : 1;
+        double ms = MeasureMs([&]() { sphere = geoGen.CreateGeosphere(1.0f, level); }, iterations);
+        double referenceMs = MeasureMs([&]() { reference = ReferenceGeosphere(1.0f, level); }, iterations);
+        auto megabytes = [](const GeometryGenerator::MeshData& meshData)
+        {
+            return (meshData.Vertices.size() * sizeof(GeometryGenerator::Vertex) + meshData.Indices32.size() * sizeof(UINT)) / (1024.0 * 1024.0);
+        };
+        std::printf("%5u %9zu %9zu %9.2f %9.2f %10.2f %10.2f\n", level, sphere.Vertices.size(), reference.Vertices.size(), ms, referenceMs,
+            megabytes(sphere), megabytes(reference));
+    }
+}
+}
+}
@@ -0,0 +1,67 @@
+#include "TestFramework.h"
+#include "../Core/JobSystem.h"
+
+#include <atomic>
+#include <stdexcept>
+
+namespace DX12Samples
+{
+namespace Tests
+{
+TEST(ParallelForVisitsEveryIndexOnce)
+{
+    JobSystem jobs(3);
+    std::vector<std::atomic<UINT>> visits(10000);
+    UINT failures = 0;
+    // Many small dispatches with different grains, so workers race for tasks while they are being published.
+    for (UINT round = 0; round < 200; round++)
+    {
+        for (auto& visit : visits)
+            visit = 0;
+        UINT count = 1 + (round * 97) % (UINT)visits.size();
+        UINT grainSize = 1 + round % 64;
+        jobs.ParallelFor(count, grainSize, [&visits](UINT begin, UINT end, UINT)
+        {
+            for (UINT i = begin; i < end; i++)
+                visits[i]++;
+        });
+        for (UINT i = 0; i < (UINT)visits.size(); i++)
+        {
+            if (visits[i].load() != (i < count ? 1u : 0u))
+                failures++;
+        }
+    }
+    CHECK(failures == 0);
+}
+TEST(ParallelForRethrowsJobException)
+{
+    JobSystem jobs(3);
+    for (UINT throwAt : { 0u, 511u, 999u })
+    {
+        std::atomic<UINT> processed{ 0 };
+        bool caught = false;
+        try
+        {
+            jobs.ParallelFor(1000, 8, [&processed, throwAt](UINT begin, UINT end, UINT)
+            {
+                if (throwAt >= begin && throwAt < end)
+                    throw std::runtime_error("job failed");
+                processed += end - begin;
+            });
+        }
+        catch (const std::runtime_error&)
+        {
+            caught = true;
+        }
+        CHECK(caught);
+        // Every other chunk still ran and nothing is left in flight.
+        CHECK(processed.load() == 1000 - 8);
+    }
+
+    // Job system is still usable after a failed dispatch.
+    std::atomic<UINT> sum{ 0 };
+    jobs.ParallelFor(1000, 8, [&sum](UINT begin, UINT end, UINT) { sum += end - begin; });
+    CHECK(sum.load() == 1000);
+}
+}
+}
@@ -0,0 +1,289 @@
+#include "TestFramework.h"
+#include "../Core/M3dLoader.h"
+
+#include <fstream>
+#include <random>
+#include <thread>
+
+namespace DX12Samples
+{
+namespace Tests
+{
+using namespace DirectX;
+
+namespace
+{
+const char* SoldierFilename = "Models/soldier.m3d";
+// Tests work on copies, so binary files of real models are never created or removed.
+const char* SoldierCopyFilename = "Models/soldier_m3dtest.m3d";
+const char* SyntheticFilename = "Models/synthetic_m3dtest.txt";
+
+bool CopyPrefix(const std::string& from, const std::string& to, double fraction)
+{
+    std::ifstream fin(from, std::ios::binary);
+    std::string text((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+    std::ofstream fout(to, std::ios::binary | std::ios::trunc);
+    fout.write(text.data(), (std::streamsize)(text.size() * fraction));
+    return !text.empty() && (bool)fout;
+}
+
+bool FileExists(const std::string& filename)
+{
+    return std::ifstream(filename).good();
+}
+
+struct SkinnedModel
+{
+    std::vector<M3dLoader::SkinnedVertex> Vertices;
+    std::vector<USHORT> Indices;
+    std::vector<M3dLoader::Subset> Subsets;
+    std::vector<M3dLoader::M3dMaterial> Materials;
+    SkinnedData SkinInfo;
+
+    bool Load(M3dLoader& loader, const std::string& filename)
+    {
+        return loader.LoadM3d(filename, Vertices, Indices, Subsets, Materials, SkinInfo);
+    }
+};
+
+struct TextModel
+{
+    std::vector<XMFLOAT3> Positions;
+    std::vector<XMFLOAT3> Normals;
+    std::vector<UINT> Indices;
+
+    bool Load(M3dLoader& loader, const std::string& filename)
+    {
+        return loader.LoadTextModel(filename, Positions, Normals, Indices);
+    }
+};
+
+/**
+ * \brief Write VertexCount/TriangleCount model with random vertices, numbers are written in all forms parser accepts.
+ * Returns file size in bytes.
+ */
+size_t WriteSyntheticTextModel(const std::string& filename, UINT vertexCount)
+{
+    std::mt19937 random(3);
+    std::uniform_real_distribution<float> coordinate(-100.0f, 100.0f);
+    std::uniform_int_distribution<UINT> vertex(0, vertexCount - 1);
+    const char* formats[] = { "%g", "%.6f", "%e", "%.0f" };
+
+    std::string text;
+    UINT triangleCount = vertexCount * 2;
+    text += "VertexCount: " + std::to_string(vertexCount) + "\nTriangleCount: " + std::to_string(triangleCount) + "\n";
+    text += "VertexList (pos, normal)\n{\n";
+    char number[32];
+    for (UINT i = 0; i < vertexCount; i++)
+    {
+        text += '\t';
+        for (int c = 0; c < 6; c++)
+        {
+            snprintf(number, sizeof(number), formats[(i + c) % 4], coordinate(random));
+            text += number;
+            text += c < 5 ? (i % 5 == 0 ? "  " : " ") : "\n";
+        }
+    }
+    text += "}\nTriangleList\n{\n";
+    for (UINT i = 0; i < triangleCount; i++)
+        text += "\t" + std::to_string(vertex(random)) + " " + std::to_string(vertex(random)) + " " + std::to_string(vertex(random)) + "\n";
+    text += "}\n";
+
+    std::ofstream fout(filename, std::ios::binary | std::ios::trunc);
+    fout.write(text.data(), text.size());
+    return fout ? text.size() : 0;
+}
+
+/**
+ * \brief Overwrite one record of binary file section in place.
+ */
+template<typename T>
+bool PatchRecord(const std::string& binaryFilename, M3dSectionType type, UINT record, const T& value)
+{
+    std::fstream file(binaryFilename, std::ios::in | std::ios::out | std::ios::binary);
+    M3dBinaryHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    for (UINT i = 0; file && i < header.SectionCount; i++)
+    {
+        M3dBinarySection section;
+        file.read(reinterpret_cast<char*>(&section), sizeof(section));
+        if (file && section.Type == type && record < section.Count)
+        {
+            file.seekp(section.Offset + record * sizeof(T));
+            file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+            return (bool)file;
+        }
+    }
+    return false;
+}
+
+template<typename T>
+bool SameRecords(const std::vector<T>& a, const std::vector<T>& b)
+{
+    return a.size() == b.size() && memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+}
+}
+
+TEST(LoadM3dFailsOnTruncatedText)
+{
+    std::string binaryFilename = M3dLoader::GetBinaryFilename(SoldierCopyFilename);
+    DeleteFileA(binaryFilename.c_str());
+    CHECK(CopyPrefix(SoldierFilename, SoldierCopyFilename, 0.5));
+
+    M3dLoader loader;
+    SkinnedModel model;
+    CHECK(!model.Load(loader, SoldierCopyFilename));
+    // Loading never writes binary file.
+    CHECK(!FileExists(binaryFilename));
+    CHECK(!loader.ConvertM3d(SoldierCopyFilename, binaryFilename));
+    CHECK(!FileExists(binaryFilename) && !FileExists(binaryFilename + ".tmp"));
+
+    DeleteFileA(SoldierCopyFilename);
+}
+
+TEST(ConvertM3dMatchesText)
+{
+    std::string binaryFilename = M3dLoader::GetBinaryFilename(SoldierCopyFilename);
+    DeleteFileA(binaryFilename.c_str());
+    CHECK(CopyPrefix(SoldierFilename, SoldierCopyFilename, 1.0));
+
+    M3dLoader loader;
+    SkinnedModel text;
+    CHECK(text.Load(loader, SoldierCopyFilename));
+    CHECK(!FileExists(binaryFilename));
+
+    CHECK(loader.ConvertM3d(SoldierCopyFilename, binaryFilename));
+    CHECK(FileExists(binaryFilename) && !FileExists(binaryFilename + ".tmp"));
+    SkinnedModel binary;
+    CHECK(binary.Load(loader, SoldierCopyFilename));
+
+    CHECK(SameRecords(text.Vertices, binary.Vertices));
+    CHECK(SameRecords(text.Indices, binary.Indices));
+    CHECK(SameRecords(text.Subsets, binary.Subsets));
+    CHECK(text.Materials.size() == binary.Materials.size() && text.Materials[0].DiffuseMapName == binary.Materials[0].DiffuseMapName);
+    CHECK(text.SkinInfo.GetBoneHierarchy() == binary.SkinInfo.GetBoneHierarchy());
+    CHECK(SameRecords(text.SkinInfo.GetBoneOffsets(), binary.SkinInfo.GetBoneOffsets()));
+    const AnimationClip& textClip = text.SkinInfo.GetClip(text.SkinInfo.FindClip("Take1"));
+    const AnimationClip& binaryClip = binary.SkinInfo.GetClip(binary.SkinInfo.FindClip("Take1"));
+    bool sameKeyframes = textClip.BoneAnimations.size() == binaryClip.BoneAnimations.size();
+    for (size_t i = 0; sameKeyframes && i < textClip.BoneAnimations.size(); i++)
+        sameKeyframes = SameRecords(textClip.BoneAnimations[i].Keyframes, binaryClip.BoneAnimations[i].Keyframes);
+    CHECK(sameKeyframes);
+
+    DeleteFileA(binaryFilename.c_str());
+    DeleteFileA(SoldierCopyFilename);
+}
+
+TEST(LoadM3dIgnoresCorruptedBinary)
+{
+    std::string binaryFilename = M3dLoader::GetBinaryFilename(SoldierCopyFilename);
+    DeleteFileA(binaryFilename.c_str());
+    CHECK(CopyPrefix(SoldierFilename, SoldierCopyFilename, 1.0));
+
+    M3dLoader loader;
+    SkinnedModel text;
+    CHECK(text.Load(loader, SoldierCopyFilename));
+    if (text.Subsets.empty())
+        return;
+
+    // Index past the last vertex, subset vertex range and subset face range past the end of buffers.
+    UINT vertexCount = (UINT)text.Vertices.size();
+    UINT faceCount = (UINT)text.Indices.size() / 3;
+    for (int corruption = 0; corruption < 3; corruption++)
+    {
+        CHECK(loader.ConvertM3d(SoldierCopyFilename, binaryFilename));
+        CHECK(M3dLoader::IsBinaryUpToDate(SoldierCopyFilename));
+        M3dLoader::Subset subset = text.Subsets.back();
+        if (corruption == 1)
+            subset.VertexCount = vertexCount - subset.VertexStart + 1;
+        else if (corruption == 2)
+            subset.FaceCount = faceCount - subset.FaceStart + 1;
+        bool patched = corruption == 0 ? PatchRecord(binaryFilename, M3dSectionType::Indices, faceCount * 3 - 1, (USHORT)vertexCount) :
+            PatchRecord(binaryFilename, M3dSectionType::Subsets, (UINT)text.Subsets.size() - 1, subset);
+        CHECK(patched);
+
+        // Loader falls back to text file.
+        SkinnedModel loaded;
+        CHECK(loaded.Load(loader, SoldierCopyFilename));
+        CHECK(SameRecords(text.Indices, loaded.Indices));
+        CHECK(SameRecords(text.Subsets, loaded.Subsets));
+    }
+
+    DeleteFileA(binaryFilename.c_str());
+    DeleteFileA(SoldierCopyFilename);
+}
+
+TEST(ParallelLoadMatchesSerial)
+{
+    // 2 MB synthetic model is split into several chunks, real models check section boundaries of both formats.
+    CHECK(WriteSyntheticTextModel(SyntheticFilename, 20000) > 0);
+    M3dLoader serialLoader;
+    for (int threadCount : { 0, 1, 2, 3, 7 })
+    {
+        JobSystem jobs(threadCount);
+        M3dLoader parallelLoader(jobs);
+        for (const char* filename : { "Models/skull.txt", "Models/car.txt", SyntheticFilename })
+        {
+            TextModel serial;
+            TextModel parallel;
+            CHECK(serial.Load(serialLoader, filename) && parallel.Load(parallelLoader, filename));
+            CHECK(SameRecords(serial.Positions, parallel.Positions));
+            CHECK(SameRecords(serial.Normals, parallel.Normals));
+            CHECK(SameRecords(serial.Indices, parallel.Indices));
+        }
+
+        SkinnedModel serial;
+        SkinnedModel parallel;
+        CHECK(serial.Load(serialLoader, SoldierFilename) && parallel.Load(parallelLoader, SoldierFilename));
+        CHECK(SameRecords(serial.Vertices, parallel.Vertices));
+        CHECK(SameRecords(serial.Indices, parallel.Indices));
+        CHECK(SameRecords(serial.Subsets, parallel.Subsets));
+    }
+    DeleteFileA(SyntheticFilename);
+}
+
+BENCHMARK(ParallelLoadScaling)
+{
+    size_t fileSize = WriteSyntheticTextModel(SyntheticFilename, 550000);
+    if (fileSize == 0)
+        return;
+
+    M3dLoader serialLoader;
+    double serialMs = MeasureMs([&]() { TextModel model; model.Load(serialLoader, SyntheticFilename); }, 1);
+    std::printf("synthetic %.1f MB text model: serial %.1f ms\n", fileSize / (1024.0 * 1024.0), serialMs);
+    UINT hardwareThreads = MathHelper::Max(1u, std::thread::hardware_concurrency());
+    for (UINT workers = 1; workers <= hardwareThreads; workers *= 2)
+    {
+        JobSystem jobs((int)workers - 1);
+        M3dLoader parallelLoader(jobs);
+        double parallelMs = MeasureMs([&]() { TextModel model; model.Load(parallelLoader, SyntheticFilename); }, 1);
+        std::printf("  %u workers: %.1f ms (%.2fx)\n", workers, parallelMs, serialMs / parallelMs);
+    }
+    DeleteFileA(SyntheticFilename);
+}
+
+BENCHMARK(M3dLoadTime)
+{
+    std::string binaryFilename = M3dLoader::GetBinaryFilename(SoldierCopyFilename);
+    DeleteFileA(binaryFilename.c_str());
+    if (!CopyPrefix(SoldierFilename, SoldierCopyFilename, 1.0))
+        return;
+
+    JobSystem jobs;
+    M3dLoader loader;
+    M3dLoader parallelLoader(jobs);
+    const int iterations = 5;
+    // SkinnedData setup is included, it is part of every load.
+    double textMs = MeasureMs([&]() { SkinnedModel model; model.Load(loader, SoldierCopyFilename); }, iterations);
+    double parallelMs = MeasureMs([&]() { SkinnedModel model; model.Load(parallelLoader, SoldierCopyFilename); }, iterations);
+    double convertMs = MeasureMs([&]() { loader.ConvertM3d(SoldierCopyFilename, binaryFilename); }, 1, 1);
+    double binaryMs = MeasureMs([&]() { SkinnedModel model; model.Load(loader, SoldierCopyFilename); }, iterations);
+
+    std::printf("soldier.m3d load: text %.1f ms, text with jobs %.1f ms (%u workers), binary %.1f ms; conversion %.1f ms\n",
+        textMs, parallelMs, jobs.WorkerCount(), binaryMs, convertMs);
+
+    DeleteFileA(binaryFilename.c_str());
+    DeleteFileA(SoldierCopyFilename);
+}
+}
+}
@@ -0,0 +1,21 @@
+//
+// Headless tests and benchmarks. Run from repository root so Models/ and Textures/ are found.
+// Usage: DX12SamplesTests [--bench] [name filter]
+//
+
+#include "TestFramework.h"
+
+int main(int argc, char** argv)
+{
+    bool runBenchmarks = false;
+    std::string filter;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--bench")
+            runBenchmarks = true;
+        else
+            filter = arg;
+    }
+    return DX12Samples::Tests::TestRegistry::Get().Run(filter, runBenchmarks) == 0 ? 0 : 1;
+}
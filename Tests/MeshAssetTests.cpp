@@ -0,0 +1,117 @@
+#include "TestFramework.h"
+#include "../Core/MeshAsset.h"
+#include "../Core/M3dLoader.h"
+
+#include <random>
+
+namespace DX12Samples
+{
+namespace Tests
+{
+using namespace DirectX;
+
+namespace
+{
+/**
+ * \brief Spherical Uv MeshAssetCache::BuildAsset computed per vertex before it was vectorized.
+ */
+XMFLOAT2 SphericalUvReference(const XMFLOAT3& position)
+{
+    XMFLOAT3 spherePos;
+    XMStoreFloat3(&spherePos, XMVector3Normalize(XMLoadFloat3(&position)));
+
+    float theta = atan2f(spherePos.z, spherePos.x);
+    if (theta < 0.0f)
+        theta += XM_2PI;
+    float phi = acosf(spherePos.y);
+    return XMFLOAT2(theta / (2.0f * XM_PI), phi / XM_PI);
+}
+
+/**
+ * \brief Distance between Uvs, u wraps around at the seam.
+ */
+float UvDistance(const XMFLOAT2& a, const XMFLOAT2& b)
+{
+    float du = fabsf(a.x - b.x);
+    return MathHelper::Max(MathHelper::Min(du, 1.0f - du), fabsf(a.y - b.y));
+}
+
+struct PosNormalUvVertex
+{
+    XMFLOAT3 Pos;
+    XMFLOAT3 Normal;
+    XMFLOAT2 Uv;
+};
+
+std::vector<XMFLOAT3> CreateRandomPositions(UINT count)
+{
+    std::mt19937 random(5);
+    std::uniform_real_distribution<float> coordinate(-10.0f, 10.0f);
+    std::vector<XMFLOAT3> positions(count);
+    for (XMFLOAT3& p : positions)
+        p = XMFLOAT3(coordinate(random), coordinate(random), coordinate(random));
+    return positions;
+}
+}
+
+TEST(SphericalUvsMatchScalar)
+{
+    std::vector<XMFLOAT3> positions = CreateRandomPositions(1001);
+    // Poles, seam, axes and origin.
+    const XMFLOAT3 special[] = { XMFLOAT3(0.0f, 1.0f, 0.0f), XMFLOAT3(0.0f, -2.0f, 0.0f), XMFLOAT3(1.0f, 0.0f, 0.0f),
+        XMFLOAT3(1.0f, 0.0f, -1e-6f), XMFLOAT3(-1.0f, 0.0f, 0.0f), XMFLOAT3(0.0f, 0.0f, 1.0f), XMFLOAT3(0.0f, 0.0f, -3.0f),
+        XMFLOAT3(0.0f, 0.0f, 0.0f) };
+    positions.insert(positions.begin(), std::begin(special), std::end(special));
+
+    std::vector<XMFLOAT2> uvs(positions.size());
+    MeshAssetCache::ComputeSphericalUvs(positions.data(), (UINT)positions.size(), uvs.data());
+    float maxError = 0.0f;
+    for (size_t i = 0; i < positions.size(); i++)
+        maxError = MathHelper::Max(maxError, UvDistance(uvs[i], SphericalUvReference(positions[i])));
+    CHECK(maxError <= 1e-4f);
+
+    // Tail of group of four must not be written past count.
+    XMFLOAT2 tail[4] = { XMFLOAT2(-1.0f, -1.0f), XMFLOAT2(-1.0f, -1.0f), XMFLOAT2(-1.0f, -1.0f), XMFLOAT2(-1.0f, -1.0f) };
+    MeshAssetCache::ComputeSphericalUvs(positions.data(), 3, tail);
+    CHECK(tail[3].x == -1.0f && tail[3].y == -1.0f);
+}
+
+TEST(MeshAssetMatchesSourceMesh)
+{
+    std::shared_ptr<const MeshAsset> asset = MeshAssetCache::Instance().Load("Models/skull.txt", MeshVertexLayout::PosNormalUv);
+    CHECK(asset != nullptr);
+    if (asset == nullptr)
+        return;
+
+    CHECK(asset->VertexStride == MeshAssetCache::GetVertexStride(MeshVertexLayout::PosNormalUv));
+    const PosNormalUvVertex* vertices = asset->GetVertices<PosNormalUvVertex>();
+    float maxError = 0.0f;
+    for (UINT i = 0; i < asset->VertexCount; i++)
+        maxError = MathHelper::Max(maxError, UvDistance(vertices[i].Uv, SphericalUvReference(vertices[i].Pos)));
+    CHECK(maxError <= 1e-4f);
+}
+
+BENCHMARK(SphericalUvs)
+{
+    std::vector<XMFLOAT3> skull;
+    std::vector<XMFLOAT3> normals;
+    std::vector<UINT> indices;
+    M3dLoader().LoadTextModel("Models/skull.txt", skull, normals, indices);
+    std::vector<XMFLOAT3> random = CreateRandomPositions(1 << 20);
+
+    for (const std::vector<XMFLOAT3>* positions : { &skull, &random })
+    {
+        UINT count = (UINT)positions->size();
+        std::vector<XMFLOAT2> uvs(count);
+        int iterations = count > 100000 ? 5 : 50;
+        double scalarMs = MeasureMs([&]()
+        {
+            for (UINT i = 0; i < count; i++)
+                uvs[i] = SphericalUvReference((*positions)[i]);
+        }, iterations);
+        double vectorMs = MeasureMs([&]() { MeshAssetCache::ComputeSphericalUvs(positions->data(), count, uvs.data()); }, iterations);
+        std::printf("%u vertices: scalar Uvs %.3f ms, 4 wide %.3f ms (%.1fx)\n", count, scalarMs, vectorMs, scalarMs / vectorMs);
+    }
+}
+}
+}
@@ -0,0 +1,161 @@
+#include "TestFramework.h"
+#include "../Core/M3dLoader.h"
+#include "../Core/MeshOptimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <random>
+
+namespace DX12Samples
+{
+namespace Tests
+{
+using namespace DirectX;
+
+namespace
+{
+struct TestMesh
+{
+    std::string Name;
+    std::vector<XMFLOAT3> Positions;
+    std::vector<UINT> Indices;
+};
+
+TestMesh LoadTextMesh(const char* filename)
+{
+    TestMesh mesh;
+    mesh.Name = filename;
+    std::vector<XMFLOAT3> normals;
+    M3dLoader().LoadTextModel(filename, mesh.Positions, normals, mesh.Indices);
+    return mesh;
+}
+
+TestMesh FromMeshData(const char* name, const GeometryGenerator::MeshData& meshData)
+{
+    TestMesh mesh;
+    mesh.Name = name;
+    for (const GeometryGenerator::Vertex& vertex : meshData.Vertices)
+        mesh.Positions.push_back(vertex.Position);
+    mesh.Indices = meshData.Indices32;
+    return mesh;
+}
+
+/**
+ * \brief Shuffle triangle order, e.g. like exporters which sort triangles by material or hash.
+ */
+void ShuffleTriangles(std::vector<UINT>& indices)
+{
+    std::vector<UINT> triangles(indices.size() / 3);
+    for (UINT i = 0; i < triangles.size(); i++)
+        triangles[i] = i;
+    std::shuffle(triangles.begin(), triangles.end(), std::mt19937(9));
+    std::vector<UINT> shuffled;
+    shuffled.reserve(indices.size());
+    for (UINT triangle : triangles)
+        shuffled.insert(shuffled.end(), indices.begin() + triangle * 3, indices.begin() + triangle * 3 + 3);
+    indices.swap(shuffled);
+}
+
+std::vector<TestMesh> CreateTestMeshes()
+{
+    GeometryGenerator geoGen;
+    std::vector<TestMesh> meshes;
+    meshes.push_back(LoadTextMesh("Models/skull.txt"));
+    meshes.push_back(LoadTextMesh("Models/car.txt"));
+    meshes.push_back(FromMeshData("grid 200x200", geoGen.CreateGrid(20.0f, 20.0f, 200, 200)));
+    meshes.push_back(FromMeshData("shuffled grid 200x200", geoGen.CreateGrid(20.0f, 20.0f, 200, 200)));
+    ShuffleTriangles(meshes.back().Indices);
+    meshes.push_back(FromMeshData("geosphere 5", geoGen.CreateGeosphere(1.0f, 5)));
+    return meshes;
+}
+
+/**
+ * \brief Triangles as position triples rotated so the smallest vertex goes first and sorted, winding is kept.
+ */
+std::vector<std::array<XMFLOAT3, 3>> CanonicalTriangles(const std::vector<XMFLOAT3>& positions, const std::vector<UINT>& indices)
+{
+    auto less = [](const XMFLOAT3& a, const XMFLOAT3& b) { return memcmp(&a, &b, sizeof(XMFLOAT3)) < 0; };
+    std::vector<std::array<XMFLOAT3, 3>> triangles(indices.size() / 3);
+    for (size_t t = 0; t < triangles.size(); t++)
+    {
+        const UINT* triangle = &indices[t * 3];
+        int first = 0;
+        for (int i = 1; i < 3; i++)
+        {
+            if (less(positions[triangle[i]], positions[triangle[first]]))
+                first = i;
+        }
+        for (int i = 0; i < 3; i++)
+            triangles[t][i] = positions[triangle[(first + i) % 3]];
+    }
+    std::sort(triangles.begin(), triangles.end(), [](const std::array<XMFLOAT3, 3>& a, const std::array<XMFLOAT3, 3>& b)
+    {
+        return memcmp(a.data(), b.data(), sizeof(a)) < 0;
+    });
+    return triangles;
+}
+}
+
+TEST(OptimizeMeshImprovesVertexCache)
+{
+    for (TestMesh& mesh : CreateTestMeshes())
+    {
+        CHECK(!mesh.Indices.empty());
+        UINT vertexCount = (UINT)mesh.Positions.size();
+        auto triangles = CanonicalTriangles(mesh.Positions, mesh.Indices);
+        VertexCacheStats before = MeshOptimizer::AnalyzeVertexCache(mesh.Indices.data(), mesh.Indices.size(), vertexCount);
+
+        MeshOptimizer::OptimizeVertexCache(mesh.Indices.data(), mesh.Indices.size(), vertexCount);
+        VertexCacheStats cacheOptimized = MeshOptimizer::AnalyzeVertexCache(mesh.Indices.data(), mesh.Indices.size(), vertexCount);
+        MeshOptimizer::Optimize(mesh.Positions, mesh.Indices.data(), mesh.Indices.size());
+        VertexCacheStats after = MeshOptimizer::AnalyzeVertexCache(mesh.Indices.data(), mesh.Indices.size(), vertexCount);
+
+        CHECK(after.TriangleCount == before.TriangleCount && after.VertexCount == before.VertexCount);
+        CHECK(cacheOptimized.Acmr <= before.Acmr);
+        // Overdraw clusters are split where cache is cold, so they cost little.
+        CHECK(after.Acmr <= cacheOptimized.Acmr * 1.05f);
+        CHECK(after.Atvr >= 1.0f);
+        // Same triangles with same winding, only order and vertex numbering change.
+        auto optimized = CanonicalTriangles(mesh.Positions, mesh.Indices);
+        CHECK(optimized.size() == triangles.size() && memcmp(optimized.data(), triangles.data(), triangles.size() * sizeof(triangles[0])) == 0);
+    }
+}
+
+TEST(OptimizeVertexFetchOrdersByFirstUse)
+{
+    TestMesh mesh = LoadTextMesh("Models/car.txt");
+    UINT vertexCount = (UINT)mesh.Positions.size();
+    MeshOptimizer::RemapVertices(mesh.Positions, MeshOptimizer::OptimizeVertexFetch(mesh.Indices.data(), mesh.Indices.size(), vertexCount));
+    UINT nextVertex = 0;
+    bool firstUseOrder = true;
+    for (UINT index : mesh.Indices)
+    {
+        firstUseOrder = firstUseOrder && index <= nextVertex;
+        if (index == nextVertex)
+            nextVertex++;
+    }
+    CHECK(firstUseOrder);
+}
+
+BENCHMARK(VertexCacheReport)
+{
+    std::printf("%-24s %9s %9s %9s %9s %9s %11s\n", "mesh", "triangles", "ACMR", "ACMR opt", "ATVR", "ATVR opt", "optimize ms");
+    for (TestMesh& mesh : CreateTestMeshes())
+    {
+        UINT vertexCount = (UINT)mesh.Positions.size();
+        VertexCacheStats before = MeshOptimizer::AnalyzeVertexCache(mesh.Indices.data(), mesh.Indices.size(), vertexCount);
+        std::vector<XMFLOAT3> positions;
+        std::vector<UINT> indices;
+        double optimizeMs = MeasureMs([&]()
+        {
+            positions = mesh.Positions;
+            indices = mesh.Indices;
+            MeshOptimizer::Optimize(positions, indices.data(), indices.size());
+        });
+        VertexCacheStats after = MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), vertexCount);
+        std::printf("%-24s %9u %9.3f %9.3f %9.3f %9.3f %11.2f\n", mesh.Name.c_str(), before.TriangleCount,
+            before.Acmr, after.Acmr, before.Atvr, after.Atvr, optimizeMs);
+    }
+}
+}
+}
@@ -0,0 +1,97 @@
+#include "TestFramework.h"
+#include "../Core/MeshPartitioner.h"
+
+namespace DX12Samples
+{
+namespace Tests
+{
+using namespace DirectX;
+
+namespace
+{
+/**
+ * \brief Every part addresses at most maxPartVertices vertices, draws source triangles in source order and its bounds
+ * contain its vertices.
+ */
+bool IsValidPartition(const IndexPartition16& partition, const GeometryGenerator::MeshData& meshData, UINT maxPartVertices)
+{
+    size_t nextIndex = 0;
+    bool valid = true;
+    for (size_t part = 0; valid && part < partition.Submeshes.size(); part++)
+    {
+        const SubmeshGeometry& submesh = partition.Submeshes[part];
+        size_t partEnd = part + 1 < partition.Submeshes.size() ? partition.Submeshes[part + 1].BaseVertexLocation : partition.VertexSources.size();
+        size_t partVertexCount = partEnd - submesh.BaseVertexLocation;
+        valid = submesh.StartIndexLocation == nextIndex && partVertexCount <= maxPartVertices;
+
+        const BoundingBox& box = submesh.Bounds;
+        for (size_t i = submesh.BaseVertexLocation; valid && i < partEnd; i++)
+        {
+            const XMFLOAT3& p = meshData.Vertices[partition.VertexSources[i]].Position;
+            valid = fabsf(p.x - box.Center.x) <= box.Extents.x + 1e-4f && fabsf(p.y - box.Center.y) <= box.Extents.y + 1e-4f &&
+                fabsf(p.z - box.Center.z) <= box.Extents.z + 1e-4f;
+        }
+        for (UINT i = 0; valid && i < submesh.IndexCount; i++)
+        {
+            size_t index = submesh.StartIndexLocation + i;
+            UINT local = partition.Indices[index];
+            valid = local < partVertexCount && partition.VertexSources[submesh.BaseVertexLocation + local] == meshData.Indices32[index];
+        }
+        nextIndex += submesh.IndexCount;
+    }
+    return valid && nextIndex == meshData.Indices32.size();
+}
+}
+
+TEST(PartitionMillionVertexGrid)
+{
+    GeometryGenerator geoGen;
+    GeometryGenerator::MeshData grid = geoGen.CreateGrid(1000.0f, 1000.0f, 1000, 1000);
+    CHECK(grid.Vertices.size() == 1000000);
+
+    bool threw = false;
+    try
+    {
+        grid.GetIndices16();
+    }
+    catch (const DxException&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+
+    IndexPartition16 partition = MeshPartitioner::Split(grid);
+    CHECK(partition.Submeshes.size() >= grid.Vertices.size() / IndexPartition16::MaxVertices + 1);
+    CHECK(IsValidPartition(partition, grid, IndexPartition16::MaxVertices));
+    // Grid rows are split between parts, only vertices of boundary rows are duplicated.
+    CHECK(partition.VertexSources.size() < grid.Vertices.size() * 11 / 10);
+
+    IndexPartition16 small = MeshPartitioner::Split(grid, 1000);
+    CHECK(IsValidPartition(small, grid, 1000));
+}
+
+TEST(PartitionSmallMeshKeepsVertices)
+{
+    GeometryGenerator geoGen;
+    GeometryGenerator::MeshData sphere = geoGen.CreateGeosphere(2.0f, 3);
+    IndexPartition16 partition = MeshPartitioner::Split(sphere);
+    CHECK(partition.Submeshes.size() == 1);
+    CHECK(partition.VertexSources.size() == sphere.Vertices.size());
+    CHECK(partition.Indices == sphere.GetIndices16());
+    CHECK(IsValidPartition(partition, sphere, IndexPartition16::MaxVertices));
+    CHECK(fabsf(partition.Submeshes[0].SphereBounds.Radius - 2.0f) < 0.01f);
+}
+
+BENCHMARK(PartitionMillionVertexGridTime)
+{
+    GeometryGenerator geoGen;
+    GeometryGenerator::MeshData grid = geoGen.CreateGrid(1000.0f, 1000.0f, 1000, 1000);
+    IndexPartition16 partition;
+    double splitMs = MeasureMs([&]() { partition = MeshPartitioner::Split(grid.Indices32.data(), grid.Indices32.size(), (UINT)grid.Vertices.size()); });
+    double boundsMs = MeasureMs([&]() { partition.ComputeBounds(&grid.Vertices[0].Position, sizeof(GeometryGenerator::Vertex)); });
+    std::printf("1M vertex grid: %zu parts, %.1f%% vertices duplicated, index buffer %u -> %u bytes; split %.1f ms, bounds %.1f ms\n",
+        partition.Submeshes.size(), 100.0 * (partition.VertexSources.size() - grid.Vertices.size()) / grid.Vertices.size(),
+        (UINT)(grid.Indices32.size() * sizeof(UINT)), partition.IndexBufferByteSize(), splitMs, boundsMs);
+}
+}
+}
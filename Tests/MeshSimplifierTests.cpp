@@ -0,0 +1,55 @@
+#include "TestFramework.h"
+#include "../Core/MeshSimplifier.h"
+
+namespace DX12Samples
+{
+namespace Tests
+{
+using namespace DirectX;
+
+namespace
+{
+std::shared_ptr<const MeshAsset> GetSkull()
+{
+    return MeshAssetCache::Instance().Load("Models/skull.txt", MeshVertexLayout::PosNormalUv);
+}
+}
+
+TEST(SkullLodChainLevels)
+{
+    std::shared_ptr<const MeshAsset> skull = GetSkull();
+    CHECK(skull != nullptr);
+    if (skull == nullptr)
+        return;
+
+    MeshLodChain chain = MeshSimplifier::BuildLodChain(*skull);
+    CHECK(chain.Levels.size() > 1);
+    CHECK(chain.Levels[0].Indices == skull->Indices && chain.Levels[0].Error == 0.0f);
+    for (size_t i = 1; i < chain.Levels.size(); i++)
+    {
+        const MeshLod& level = chain.Levels[i];
+        bool validIndices = level.Indices.size() % 3 == 0;
+        for (UINT index : level.Indices)
+            validIndices = validIndices && index < skull->VertexCount;
+        CHECK(validIndices);
+        CHECK(level.Indices.size() < chain.Levels[i - 1].Indices.size());
+        // Coarser levels collapse more, so estimated deviation never gets smaller.
+        CHECK(level.Error >= chain.Levels[i - 1].Error && level.Error > 0.0f);
+        CHECK(level.Error < chain.Bounds.Radius);
+    }
+}
+
+BENCHMARK(SkullLodChainBuildTime)
+{
+    std::shared_ptr<const MeshAsset> skull = GetSkull();
+    if (skull == nullptr)
+        return;
+
+    MeshLodChain chain;
+    double buildMs = MeasureMs([&]() { chain = MeshSimplifier::BuildLodChain(*skull); }, 1, 1);
+    std::printf("skull: %u vertices, lod chain build %.1f ms\n", skull->VertexCount, buildMs);
+    for (size_t i = 0; i < chain.Levels.size(); i++)
+        std::printf("  level %zu: %zu triangles, error %.4f\n", i, chain.Levels[i].Indices.size() / 3, chain.Levels[i].Error);
+}
+}
+}
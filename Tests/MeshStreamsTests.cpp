@@ -0,0 +1,198 @@
+#include "TestFramework.h"
+#include "../Core/MeshStreams.h"
+#include "../Core/MeshAsset.h"
+
+#include <random>
+
+namespace DX12Samples
+{
+namespace Tests
+{
+using namespace DirectX;
+
+namespace
+{
+using Vertices = std::vector<GeometryGenerator::Vertex>;
+
+GeometryGenerator::MeshData CreateRandomMesh(UINT vertexCount)
+{
+    std::mt19937 random(17);
+    std::uniform_real_distribution<float> coordinate(-10.0f, 10.0f);
+    GeometryGenerator::MeshData meshData;
+    meshData.Vertices.resize(vertexCount);
+    for (GeometryGenerator::Vertex& v : meshData.Vertices)
+    {
+        v.Position = XMFLOAT3(coordinate(random), coordinate(random), coordinate(random));
+        v.Normal = XMFLOAT3(coordinate(random), coordinate(random), coordinate(random));
+        v.Tangent = XMFLOAT3(coordinate(random), coordinate(random), coordinate(random));
+        v.TexCoord = XMFLOAT2(coordinate(random), coordinate(random));
+    }
+    return meshData;
+}
+
+GeometryGenerator::MeshData LoadSkull()
+{
+    GeometryGenerator::MeshData meshData;
+    std::shared_ptr<const MeshAsset> skull = MeshAssetCache::Instance().Load("Models/skull.txt", MeshVertexLayout::PosNormalUvTangent);
+    if (skull == nullptr)
+        return meshData;
+
+    struct SkullVertex
+    {
+        XMFLOAT3 Pos;
+        XMFLOAT3 Normal;
+        XMFLOAT2 Uv;
+        XMFLOAT3 Tangent;
+    };
+    const SkullVertex* vertices = skull->GetVertices<SkullVertex>();
+    for (UINT i = 0; i < skull->VertexCount; i++)
+        meshData.Vertices.push_back(GeometryGenerator::Vertex(vertices[i].Pos, vertices[i].Normal, vertices[i].Tangent, vertices[i].Uv));
+    meshData.Indices32 = skull->Indices;
+    return meshData;
+}
+
+// Per vertex kernels on AoS vertices, what passes did before streams.
+BoundingBox AosBounds(const Vertices& vertices)
+{
+    XMVECTOR vMin = XMLoadFloat3(&vertices[0].Position);
+    XMVECTOR vMax = vMin;
+    for (const GeometryGenerator::Vertex& v : vertices)
+    {
+        XMVECTOR p = XMLoadFloat3(&v.Position);
+        vMin = XMVectorMin(vMin, p);
+        vMax = XMVectorMax(vMax, p);
+    }
+    BoundingBox box;
+    XMStoreFloat3(&box.Center, 0.5f * (vMin + vMax));
+    XMStoreFloat3(&box.Extents, 0.5f * (vMax - vMin));
+    return box;
+}
+
+void AosTransformPoints(Vertices& vertices, FXMMATRIX m)
+{
+    for (GeometryGenerator::Vertex& v : vertices)
+        XMStoreFloat3(&v.Position, XMVector3Transform(XMLoadFloat3(&v.Position), m));
+}
+
+void AosNormalizeNormals(Vertices& vertices)
+{
+    for (GeometryGenerator::Vertex& v : vertices)
+        XMStoreFloat3(&v.Normal, XMVector3Normalize(XMLoadFloat3(&v.Normal)));
+}
+
+void AosTransform(Vertices& vertices, FXMMATRIX world)
+{
+    XMMATRIX normalMatrix = MathHelper::InverseTranspose(world);
+    for (GeometryGenerator::Vertex& v : vertices)
+    {
+        XMStoreFloat3(&v.Position, XMVector3Transform(XMLoadFloat3(&v.Position), world));
+        XMStoreFloat3(&v.Normal, XMVector3Normalize(XMVector3TransformNormal(XMLoadFloat3(&v.Normal), normalMatrix)));
+        XMStoreFloat3(&v.Tangent, XMVector3Normalize(XMVector3TransformNormal(XMLoadFloat3(&v.Tangent), world)));
+    }
+}
+
+XMMATRIX TestWorld()
+{
+    return XMMatrixScaling(2.0f, 0.5f, 3.0f) * XMMatrixRotationAxis(XMVector3Normalize(XMVectorSet(1.0f, 2.0f, -3.0f, 0.0f)), 0.9f) * XMMatrixTranslation(5.0f, -2.0f, 7.0f);
+}
+
+float MaxDistance(const XMFLOAT3& a, const XMFLOAT3& b, float maxDistance)
+{
+    return MathHelper::Max(maxDistance, XMVectorGetX(XMVector3Length(XMLoadFloat3(&a) - XMLoadFloat3(&b))));
+}
+}
+
+TEST(MeshStreamsRoundTrip)
+{
+    GeometryGenerator geoGen;
+    for (const GeometryGenerator::MeshData& meshData : { geoGen.CreateGeosphere(1.0f, 3), geoGen.CreateBox(1.0f, 2.0f, 3.0f, 1), CreateRandomMesh(7) })
+    {
+        MeshStreams streams(meshData);
+        CHECK(streams.VertexCount() == meshData.Vertices.size());
+        GeometryGenerator::MeshData back = streams.ToMeshData();
+        CHECK(back.Indices32 == meshData.Indices32);
+        CHECK(memcmp(back.Vertices.data(), meshData.Vertices.data(), meshData.Vertices.size() * sizeof(GeometryGenerator::Vertex)) == 0);
+        // Each stream starts at 16 byte boundary.
+        CHECK(((size_t)streams.Positions().X & 15) == 0 && ((size_t)streams.Normals().Y & 15) == 0 && ((size_t)streams.TexCoords().Y & 15) == 0);
+    }
+}
+
+TEST(MeshStreamsKernelsMatchAos)
+{
+    // Odd count, so last partial group is covered.
+    GeometryGenerator::MeshData meshData = CreateRandomMesh(1001);
+    MeshStreams streams(meshData);
+    BoundingBox aosBox = AosBounds(meshData.Vertices);
+    BoundingBox box = streams.ComputeBounds();
+    CHECK(memcmp(&aosBox, &box, sizeof(box)) == 0);
+
+    // Views of part of streams touch only that part.
+    ConstStream3 part = ConstStream3(streams.Positions()).Sub(10, 20);
+    BoundingBox aosPartBox = AosBounds(Vertices(meshData.Vertices.begin() + 10, meshData.Vertices.begin() + 30));
+    BoundingBox partBox = MeshStreams::ComputeBounds(part);
+    CHECK(memcmp(&aosPartBox, &partBox, sizeof(partBox)) == 0);
+
+    Vertices aos = meshData.Vertices;
+    AosTransform(aos, TestWorld());
+    streams.Transform(TestWorld());
+    float positionError = 0.0f;
+    float directionError = 0.0f;
+    for (UINT i = 0; i < streams.VertexCount(); i++)
+    {
+        GeometryGenerator::Vertex v = streams.GetVertex(i);
+        positionError = MaxDistance(v.Position, aos[i].Position, positionError);
+        directionError = MaxDistance(v.Normal, aos[i].Normal, directionError);
+        directionError = MaxDistance(v.Tangent, aos[i].Tangent, directionError);
+    }
+    CHECK(positionError < 1e-4f);
+    CHECK(directionError < 1e-6f);
+
+    GeometryGenerator::Vertex zero(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT2(0.0f, 0.0f));
+    streams.SetVertex(3, zero);
+    MeshStreams::Normalize(streams.Normals());
+    CHECK(streams.GetVertex(3).Normal.x == 0.0f && streams.GetVertex(3).Normal.y == 0.0f && streams.GetVertex(3).Normal.z == 0.0f);
+}
+
+BENCHMARK(MeshStreamsVsAos)
+{
+    std::vector<std::pair<const char*, GeometryGenerator::MeshData>> meshes;
+    meshes.emplace_back("skull", LoadSkull());
+    meshes.emplace_back("10M random", CreateRandomMesh(10000000));
+
+    XMMATRIX world = TestWorld();
+    std::printf("%-12s %9s %14s %14s %14s %14s\n", "mesh", "vertices", "bounds", "points", "normalize", "full");
+    for (auto& mesh : meshes)
+    {
+        const Vertices& source = mesh.second.Vertices;
+        if (source.empty())
+            continue;
+
+        UINT count = (UINT)source.size();
+        int iterations = count > 1000000 ? 1 : 100;
+        MeshStreams streams(mesh.second);
+        Vertices aos = source;
+        float sink = 0.0f;
+
+        double aosBoundsMs = MeasureMs([&]() { sink += AosBounds(aos).Extents.x; }, iterations);
+        double boundsMs = MeasureMs([&]() { sink += streams.ComputeBounds().Extents.x; }, iterations);
+        double aosPointsMs = MeasureMs([&]() { AosTransformPoints(aos, world); }, iterations);
+        double pointsMs = MeasureMs([&]() { MeshStreams::TransformPoints(streams.Positions(), world); }, iterations);
+        double aosNormalizeMs = MeasureMs([&]() { AosNormalizeNormals(aos); }, iterations);
+        double normalizeMs = MeasureMs([&]() { MeshStreams::Normalize(streams.Normals()); }, iterations);
+        double aosFullMs = MeasureMs([&]() { AosTransform(aos, world); }, iterations);
+        double fullMs = MeasureMs([&]() { streams.Transform(world); }, iterations);
+
+        auto report = [](double aosMs, double soaMs)
+        {
+            std::printf(" %6.3f/%6.3f", aosMs, soaMs);
+        };
+        std::printf("%-12s %9u", mesh.first, count);
+        report(aosBoundsMs, boundsMs);
+        report(aosPointsMs, pointsMs);
+        report(aosNormalizeMs, normalizeMs);
+        report(aosFullMs, fullMs);
+        std::printf("  ms AoS/SoA (%d)\n", sink > 0.0f ? 1 : 0);
+    }
+}
+}
+}
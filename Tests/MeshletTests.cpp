@@ -0,0 +1,209 @@
+#include "TestFramework.h"
+#include "../Core/MeshletBuilder.h"
+
+#include <algorithm>
+#include <array>
+#include <random>
+
+namespace DX12Samples
+{
+namespace Tests
+{
+using namespace DirectX;
+
+namespace
+{
+struct PosNormalVertex
+{
+    XMFLOAT3 Pos;
+    XMFLOAT3 Normal;
+};
+
+std::shared_ptr<const MeshAsset> GetSkull()
+{
+    return MeshAssetCache::Instance().Load("Models/skull.txt", MeshVertexLayout::PosNormal);
+}
+
+/**
+ * \brief Triangles rotated so the smallest index goes first and sorted, winding is kept.
+ */
+std::vector<std::array<UINT, 3>> CanonicalTriangles(const std::vector<UINT>& indices)
+{
+    std::vector<std::array<UINT, 3>> triangles(indices.size() / 3);
+    for (size_t t = 0; t < triangles.size(); t++)
+    {
+        const UINT* triangle = &indices[t * 3];
+        int first = (int)(std::min_element(triangle, triangle + 3) - triangle);
+        for (int i = 0; i < 3; i++)
+            triangles[t][i] = triangle[(first + i) % 3];
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+std::vector<XMFLOAT3> CreateCameraPositions(UINT count, float distance)
+{
+    std::mt19937 random(13);
+    std::normal_distribution<float> direction;
+    std::vector<XMFLOAT3> cameras(count);
+    for (XMFLOAT3& camera : cameras)
+        XMStoreFloat3(&camera, XMVector3Normalize(XMVectorSet(direction(random), direction(random), direction(random), 0.0f)) * distance);
+    return cameras;
+}
+
+/**
+ * \brief Per triangle backface test of all triangles, the work meshlet cones replace. Returns backfacing triangle count.
+ */
+UINT CountBackfacingTriangles(const MeshAsset& mesh, const XMFLOAT3& camera)
+{
+    const PosNormalVertex* vertices = mesh.GetVertices<PosNormalVertex>();
+    XMVECTOR eye = XMLoadFloat3(&camera);
+    UINT backfacing = 0;
+    for (size_t i = 0; i < mesh.Indices.size(); i += 3)
+    {
+        XMVECTOR p0 = XMLoadFloat3(&vertices[mesh.Indices[i]].Pos);
+        XMVECTOR p1 = XMLoadFloat3(&vertices[mesh.Indices[i + 1]].Pos);
+        XMVECTOR p2 = XMLoadFloat3(&vertices[mesh.Indices[i + 2]].Pos);
+        XMVECTOR normal = XMVector3Cross(p1 - p0, p2 - p0);
+        backfacing += XMVectorGetX(XMVector3Dot(normal, p0 - eye)) >= 0.0f ? 1 : 0;
+    }
+    return backfacing;
+}
+}
+
+TEST(MeshletsCoverSkullTriangles)
+{
+    std::shared_ptr<const MeshAsset> skull = GetSkull();
+    CHECK(skull != nullptr);
+    if (skull == nullptr)
+        return;
+
+    MeshletData meshlets = MeshletBuilder::Build(*skull);
+    CHECK(meshlets.Bounds.size() == meshlets.Meshlets.size());
+    bool withinLimits = true;
+    bool spheresContainVertices = true;
+    for (size_t m = 0; m < meshlets.Meshlets.size(); m++)
+    {
+        const Meshlet& meshlet = meshlets.Meshlets[m];
+        const MeshletBounds& bounds = meshlets.Bounds[m];
+        withinLimits = withinLimits && meshlet.VertexCount <= MeshletBuilder::MaxVertices && meshlet.PrimitiveCount <= MeshletBuilder::MaxPrimitives;
+        for (UINT i = 0; i < meshlet.VertexCount; i++)
+        {
+            XMVECTOR p = XMLoadFloat3(&skull->GetPosition(meshlets.VertexIndices[meshlet.VertexOffset + i]));
+            float distance = XMVectorGetX(XMVector3Length(p - XMLoadFloat3(&bounds.Center)));
+            spheresContainVertices = spheresContainVertices && distance <= bounds.Radius * 1.0001f + 1e-5f;
+        }
+    }
+    CHECK(withinLimits);
+    // Ray and frustum tests against spheres are conservative only if every vertex is inside.
+    CHECK(spheresContainVertices);
+    CHECK(CanonicalTriangles(meshlets.GetTriangleIndices()) == CanonicalTriangles(skull->Indices));
+}
+
+TEST(MeshletConesAreConservative)
+{
+    std::shared_ptr<const MeshAsset> skull = GetSkull();
+    if (skull == nullptr)
+        return;
+
+    MeshletData meshlets = MeshletBuilder::Build(*skull);
+    std::vector<UINT> indices = meshlets.GetTriangleIndices();
+    const PosNormalVertex* vertices = skull->GetVertices<PosNormalVertex>();
+    UINT culled = 0;
+    UINT frontfacingCulled = 0;
+    for (const XMFLOAT3& camera : CreateCameraPositions(64, 20.0f))
+    {
+        XMVECTOR eye = XMLoadFloat3(&camera);
+        for (size_t m = 0; m < meshlets.Meshlets.size(); m++)
+        {
+            if (!MeshletBuilder::IsBackfacing(meshlets.Bounds[m], camera))
+                continue;
+
+            culled++;
+            const Meshlet& meshlet = meshlets.Meshlets[m];
+            for (UINT p = meshlet.PrimitiveOffset; p < meshlet.PrimitiveOffset + meshlet.PrimitiveCount; p++)
+            {
+                XMVECTOR p0 = XMLoadFloat3(&vertices[indices[p * 3]].Pos);
+                XMVECTOR p1 = XMLoadFloat3(&vertices[indices[p * 3 + 1]].Pos);
+                XMVECTOR p2 = XMLoadFloat3(&vertices[indices[p * 3 + 2]].Pos);
+                XMVECTOR normal = XMVector3Normalize(XMVector3Cross(p1 - p0, p2 - p0));
+                XMVECTOR view = XMVector3Normalize(p0 - eye);
+                frontfacingCulled += XMVectorGetX(XMVector3Dot(normal, view)) < -1e-3f ? 1 : 0;
+            }
+        }
+    }
+    CHECK(culled > 0);
+    CHECK(frontfacingCulled == 0);
+}
+
+TEST(MeshletSerializeRoundTrip)
+{
+    std::shared_ptr<const MeshAsset> skull = GetSkull();
+    if (skull == nullptr)
+        return;
+
+    MeshletData meshlets = MeshletBuilder::Build(*skull);
+    std::vector<BYTE> blob = meshlets.Serialize();
+    MeshletData loaded;
+    CHECK(loaded.Deserialize(blob.data(), blob.size()));
+    CHECK(loaded.Serialize() == blob);
+
+    CHECK(!loaded.Deserialize(blob.data(), blob.size() - 1));
+    CHECK(loaded.Meshlets.empty() && loaded.PrimitiveIndices.empty());
+
+    // Local index past VertexCount of its meshlet would read vertex of next meshlet.
+    MeshletData corrupt = meshlets;
+    UINT i0, i1, i2;
+    MeshletData::UnpackPrimitive(corrupt.PrimitiveIndices[0], i0, i1, i2);
+    corrupt.PrimitiveIndices[0] = MeshletData::PackPrimitive(i0, i1, corrupt.Meshlets[0].VertexCount);
+    blob = corrupt.Serialize();
+    CHECK(!loaded.Deserialize(blob.data(), blob.size()));
+    CHECK(loaded.Meshlets.empty() && loaded.Bounds.empty() && loaded.VertexIndices.empty() && loaded.PrimitiveIndices.empty());
+
+    corrupt = meshlets;
+    corrupt.Meshlets.back().PrimitiveCount++;
+    blob = corrupt.Serialize();
+    CHECK(!loaded.Deserialize(blob.data(), blob.size()));
+
+    corrupt.Clear();
+    CHECK(corrupt.Meshlets.empty() && corrupt.Bounds.empty() && corrupt.VertexIndices.empty() && corrupt.PrimitiveIndices.empty());
+}
+
+BENCHMARK(MeshletCulling)
+{
+    std::shared_ptr<const MeshAsset> skull = GetSkull();
+    if (skull == nullptr)
+        return;
+
+    MeshletData meshlets;
+    double buildMs = MeasureMs([&]() { meshlets = MeshletBuilder::Build(*skull); });
+    std::vector<XMFLOAT3> cameras = CreateCameraPositions(64, 20.0f);
+
+    UINT triangleCount = (UINT)(skull->Indices.size() / 3);
+    UINT backfacingTriangles = 0;
+    UINT culledTriangles = 0;
+    for (const XMFLOAT3& camera : cameras)
+    {
+        backfacingTriangles += CountBackfacingTriangles(*skull, camera);
+        for (size_t m = 0; m < meshlets.Meshlets.size(); m++)
+            culledTriangles += MeshletBuilder::IsBackfacing(meshlets.Bounds[m], camera) ? meshlets.Meshlets[m].PrimitiveCount : 0;
+    }
+
+    UINT sink = 0;
+    UINT camera = 0;
+    double triangleMs = MeasureMs([&]() { sink += CountBackfacingTriangles(*skull, cameras[camera++ % cameras.size()]); }, 64);
+    double coneMs = MeasureMs([&]()
+    {
+        const XMFLOAT3& eye = cameras[camera++ % cameras.size()];
+        for (const MeshletBounds& bounds : meshlets.Bounds)
+            sink += MeshletBuilder::IsBackfacing(bounds, eye) ? 1 : 0;
+    }, 64);
+
+    std::printf("skull: %zu meshlets, %.1f triangles per meshlet, build %.1f ms\n", meshlets.Meshlets.size(),
+        (float)triangleCount / meshlets.Meshlets.size(), buildMs);
+    std::printf("  64 views: %.1f%% triangles backfacing, %.1f%% culled by meshlet cones\n",
+        100.0 * backfacingTriangles / (triangleCount * cameras.size()), 100.0 * culledTriangles / (triangleCount * cameras.size()));
+    std::printf("  per view: per triangle test %.1f us, meshlet cones %.1f us (%u)\n", triangleMs * 1000.0, coneMs * 1000.0, sink % 2);
+}
+}
+}
@@ -0,0 +1,105 @@
+#include "TestFramework.h"
+#include "TestAssets.h"
+#include "../Source/Scenes/SkinnedAnimation/SkinnedBounds.h"
+#include "../Source/Scenes/SkinnedAnimation/SkinnedCrowd.h"
+#include "../Source/Scenes/SkinnedAnimation/CpuSkinning.h"
+
+namespace DX12Samples
+{
+namespace Tests
+{
+using namespace DirectX;
+
+namespace
+{
+bool SameBox(const BoundingBox& a, const BoundingBox& b)
+{
+    return memcmp(&a.Center, &b.Center, sizeof(XMFLOAT3)) == 0 && memcmp(&a.Extents, &b.Extents, sizeof(XMFLOAT3)) == 0;
+}
+}
+
+TEST(SkinnedBoundsContainSkinnedVertices)
+{
+    const SkinnedAsset* soldier = GetSoldier();
+    CHECK(soldier != nullptr);
+    if (soldier == nullptr)
+        return;
+
+    SkinnedData* skinInfo = const_cast<SkinnedData*>(&soldier->SkinInfo);
+    SkinnedBounds skinnedBounds;
+    skinnedBounds.Build(*skinInfo, soldier->Vertices);
+
+    const UINT instanceCount = 64;
+    JobSystem jobs(3);
+    SkinnedCrowd crowd;
+    crowd.Init(skinInfo, instanceCount, "Take1", jobs.WorkerCount());
+    crowd.Update(1.0f / 60.0f, jobs);
+    std::vector<BoundingBox> bounds(instanceCount);
+    skinnedBounds.Compute(crowd.Palettes().data(), instanceCount, bounds.data(), jobs);
+
+    std::vector<XMFLOAT3> positions(soldier->Vertices.size());
+    UINT outside = 0;
+    UINT batchMismatches = 0;
+    for (UINT i = 0; i < instanceCount; i++)
+    {
+        BoundingBox single;
+        skinnedBounds.Compute(crowd.Palette(i), single);
+        if (!SameBox(single, bounds[i]))
+            batchMismatches++;
+
+        CpuSkinning::SkinPositions(soldier->Vertices.data(), (UINT)positions.size(), crowd.Palette(i), positions.data());
+        // Tiny slack for rounding of box corners.
+        const BoundingBox& box = bounds[i];
+        for (const XMFLOAT3& position : positions)
+        {
+            if (fabsf(position.x - box.Center.x) > box.Extents.x + 1e-3f || fabsf(position.y - box.Center.y) > box.Extents.y + 1e-3f ||
+                fabsf(position.z - box.Center.z) > box.Extents.z + 1e-3f)
+                outside++;
+        }
+    }
+    CHECK(batchMismatches == 0);
+    CHECK(outside == 0);
+}
+
+BENCHMARK(SkinnedBoundsCrowd)
+{
+    const SkinnedAsset* soldier = GetSoldier();
+    if (soldier == nullptr)
+        return;
+
+    SkinnedData* skinInfo = const_cast<SkinnedData*>(&soldier->SkinInfo);
+    SkinnedBounds skinnedBounds;
+    skinnedBounds.Build(*skinInfo, soldier->Vertices);
+
+    const UINT instanceCount = 10000;
+    JobSystem jobs;
+    SkinnedCrowd crowd;
+    crowd.Init(skinInfo, instanceCount, "Take1", jobs.WorkerCount());
+    crowd.Update(1.0f / 60.0f, jobs);
+    std::vector<BoundingBox> bounds(instanceCount);
+
+    const int iterations = 10;
+    double serialMs = MeasureMs([&]()
+    {
+        for (UINT i = 0; i < instanceCount; i++)
+            skinnedBounds.Compute(crowd.Palette(i), bounds[i]);
+    }, iterations);
+    double jobsMs = MeasureMs([&]() { skinnedBounds.Compute(crowd.Palettes().data(), instanceCount, bounds.data(), jobs); }, iterations);
+
+    // Exact bounds need whole mesh skinned, measured on a few instances and scaled.
+    std::vector<XMFLOAT3> positions(soldier->Vertices.size());
+    const UINT skinnedInstances = 20;
+    double skinMs = MeasureMs([&]()
+    {
+        for (UINT i = 0; i < skinnedInstances; i++)
+        {
+            CpuSkinning::SkinPositions(soldier->Vertices.data(), (UINT)positions.size(), crowd.Palette(i), positions.data());
+            BoundingBox::CreateFromPoints(bounds[i], positions.size(), positions.data(), sizeof(XMFLOAT3));
+        }
+    }, 3) * instanceCount / skinnedInstances;
+
+    std::printf("10000 soldiers, %u bone boxes: bone boxes %.2f ms, with jobs %.2f ms (%u workers), skinned vertices ~%.0f ms\n",
+        skinnedBounds.BoneCount(), serialMs, jobsMs, jobs.WorkerCount(), skinMs);
+}
+}
+}
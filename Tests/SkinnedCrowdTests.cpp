@@ -0,0 +1,80 @@
+#include "TestFramework.h"
+#include "TestAssets.h"
+#include "../Source/Scenes/SkinnedAnimation/SkinnedCrowd.h"
+
+#include <thread>
+
+namespace DX12Samples
+{
+namespace Tests
+{
+using namespace DirectX;
+
+namespace
+{
+void InitCrowd(SkinnedCrowd& crowd, const SkinnedAsset& soldier, UINT instanceCount, UINT workerCount)
+{
+    SkinnedData* skinInfo = const_cast<SkinnedData*>(&soldier.SkinInfo);
+    crowd.Init(skinInfo, instanceCount, "Take1", workerCount);
+    // Deterministic start times instead of random ones.
+    float clipEndTime = skinInfo->GetClipEndTime(skinInfo->FindClip("Take1"));
+    for (UINT i = 0; i < instanceCount; i++)
+        crowd.Instance(i).TimePos = fmodf(i * 0.137f, clipEndTime);
+}
+}
+
+TEST(SkinnedCrowdParallelMatchesSerial)
+{
+    const SkinnedAsset* soldier = GetSoldier();
+    CHECK(soldier != nullptr);
+    if (soldier == nullptr)
+        return;
+
+    const UINT instanceCount = 300;
+    JobSystem jobs(3);
+    SkinnedCrowd parallel;
+    SkinnedCrowd serial;
+    InitCrowd(parallel, *soldier, instanceCount, jobs.WorkerCount());
+    InitCrowd(serial, *soldier, instanceCount, 1);
+
+    for (UINT frame = 0; frame < 100; frame++)
+    {
+        parallel.Update(1.0f / 60.0f, jobs);
+        serial.Update(1.0f / 60.0f);
+    }
+    const std::vector<XMFLOAT3X4>& a = parallel.Palettes();
+    const std::vector<XMFLOAT3X4>& b = serial.Palettes();
+    CHECK(a.size() == b.size() && memcmp(a.data(), b.data(), a.size() * sizeof(XMFLOAT3X4)) == 0);
+}
+
+BENCHMARK(SkinnedCrowdScaling)
+{
+    const SkinnedAsset* soldier = GetSoldier();
+    if (soldier == nullptr)
+        return;
+
+    UINT maxThreads = MathHelper::Max(std::thread::hardware_concurrency(), 1u);
+    std::printf("soldier Take1 crowd update, ms per frame (hardware threads: %u)\n", maxThreads);
+    std::printf("%10s", "instances");
+    for (UINT threads = 1; threads <= maxThreads; threads *= 2)
+        std::printf("%10u", threads);
+    std::printf("\n");
+
+    const UINT instanceCounts[] = { 100, 1000, 10000 };
+    for (UINT instanceCount : instanceCounts)
+    {
+        std::printf("%10u", instanceCount);
+        for (UINT threads = 1; threads <= maxThreads; threads *= 2)
+        {
+            JobSystem jobs((int)threads - 1);
+            SkinnedCrowd crowd;
+            InitCrowd(crowd, *soldier, instanceCount, jobs.WorkerCount());
+            crowd.Update(1.0f / 60.0f, jobs);
+            double ms = MeasureMs([&]() { crowd.Update(1.0f / 60.0f, jobs); }, instanceCount >= 10000 ? 5 : 50);
+            std::printf("%10.3f", ms);
+        }
+        std::printf("\n");
+    }
+}
+}
+}
@@ -0,0 +1,195 @@
+#include "TestFramework.h"
+#include "TestAssets.h"
+#include "../Source/Scenes/SkinnedAnimation/SkinnedModelInstance.h"
+
+namespace DX12Samples
+{
+namespace Tests
+{
+using namespace DirectX;
+
+namespace
+{
+/**
+ * \brief Bone concatenation GetFinalTransforms used before bone order: hierarchy is walked in index order assuming
+ * parents go first, then 4x4 palette is transposed in separate pass.
+ */
+void ConcatenateReference(const SkinnedData& skinInfo, const std::vector<XMFLOAT4X4>& toParentTransforms, std::vector<XMFLOAT4X4>& finalTransforms)
+{
+    const std::vector<int>& hierarchy = skinInfo.GetBoneHierarchy();
+    const std::vector<XMFLOAT4X4>& offsets = skinInfo.GetBoneOffsets();
+    UINT numBones = skinInfo.BoneCount();
+
+    std::vector<XMFLOAT4X4> toRootTransforms(numBones);
+    toRootTransforms[0] = toParentTransforms[0];
+    for (UINT i = 1; i < numBones; i++)
+    {
+        XMMATRIX toParent = XMLoadFloat4x4(&toParentTransforms[i]);
+        XMMATRIX parentToRoot = XMLoadFloat4x4(&toRootTransforms[hierarchy[i]]);
+        XMStoreFloat4x4(&toRootTransforms[i], XMMatrixMultiply(toParent, parentToRoot));
+    }
+    finalTransforms.resize(numBones);
+    for (UINT i = 0; i < numBones; i++)
+        XMStoreFloat4x4(&finalTransforms[i], XMMatrixMultiply(XMLoadFloat4x4(&offsets[i]), XMLoadFloat4x4(&toRootTransforms[i])));
+    for (UINT i = 0; i < numBones; i++)
+        XMStoreFloat4x4(&finalTransforms[i], XMMatrixTranspose(XMLoadFloat4x4(&finalTransforms[i])));
+}
+}
+
+TEST(SetRejectsInvalidHierarchy)
+{
+    std::vector<XMFLOAT4X4> offsets(3, MathHelper::Identity4x4());
+    std::unordered_map<std::string, AnimationClip> animations;
+    SkinnedData skinInfo;
+
+    std::vector<int> cycle = { 1, 2, 0 };
+    std::vector<int> outOfRange = { -1, 5, 0 };
+    std::vector<int> selfParent = { -1, 1, 0 };
+    CHECK(!skinInfo.Set(cycle, offsets, animations));
+    CHECK(!skinInfo.Set(outOfRange, offsets, animations));
+    CHECK(!skinInfo.Set(selfParent, offsets, animations));
+
+    // Children may go before parents: 1 is root, 2 is its child and 0 is child of 2.
+    std::vector<int> unordered = { 2, -1, 1 };
+    CHECK(skinInfo.Set(unordered, offsets, animations));
+    const std::vector<UINT>& order = skinInfo.GetBoneOrder();
+    CHECK(order.size() == 3 && order[0] == 1 && order[1] == 2 && order[2] == 0);
+
+    std::vector<XMFLOAT4X4> toParent(3);
+    for (XMFLOAT4X4& transform : toParent)
+        XMStoreFloat4x4(&transform, XMMatrixTranslation(1.0f, 0.0f, 0.0f));
+    FrameArena arena(skinInfo.GetFinalTransformsScratchSize());
+    std::vector<XMFLOAT3X4> palette(3);
+    skinInfo.ConcatenateTransforms(toParent.data(), arena, palette.data());
+    CHECK(palette[1]._14 == 1.0f && palette[2]._14 == 2.0f && palette[0]._14 == 3.0f);
+}
+
+TEST(ConcatenateTransformsMatchesReference)
+{
+    const SkinnedAsset* soldier = GetSoldier();
+    if (soldier == nullptr)
+        return;
+
+    const SkinnedData& skinInfo = soldier->SkinInfo;
+    const AnimationClip& clip = skinInfo.GetClip(skinInfo.FindClip("Take1"));
+    UINT numBones = skinInfo.BoneCount();
+    std::vector<XMFLOAT4X4> toParent(numBones);
+    std::vector<XMFLOAT4X4> expected;
+    std::vector<XMFLOAT3X4> actual(numBones);
+    FrameArena arena(skinInfo.GetFinalTransformsScratchSize());
+
+    float maxError = 0.0f;
+    for (UINT frame = 0; frame < 100; frame++)
+    {
+        clip.Interpolate(fmodf(frame * 0.05f, clip.GetClipEndTime()), toParent);
+        ConcatenateReference(skinInfo, toParent, expected);
+        arena.Reset();
+        skinInfo.ConcatenateTransforms(toParent.data(), arena, actual.data());
+        // 3x4 palette is the first three rows of transposed 4x4 palette.
+        for (UINT bone = 0; bone < numBones; bone++)
+        {
+            for (int r = 0; r < 3; r++)
+            {
+                for (int c = 0; c < 4; c++)
+                    maxError = MathHelper::Max(maxError, fabsf(expected[bone](r, c) - actual[bone].m[r][c]));
+            }
+        }
+    }
+    CHECK(maxError <= 1e-5f);
+}
+
+BENCHMARK(ConcatenateTransforms)
+{
+    const SkinnedAsset* soldier = GetSoldier();
+    if (soldier == nullptr)
+        return;
+
+    const SkinnedData& skinInfo = soldier->SkinInfo;
+    const AnimationClip& clip = skinInfo.GetClip(skinInfo.FindClip("Take1"));
+    std::vector<XMFLOAT4X4> toParent(skinInfo.BoneCount());
+    clip.Interpolate(0.5f, toParent);
+    std::vector<XMFLOAT4X4> reference;
+    std::vector<XMFLOAT3X4> palette(skinInfo.BoneCount());
+    FrameArena arena(skinInfo.GetFinalTransformsScratchSize());
+
+    const int iterations = 20000;
+    double referenceMs = MeasureMs([&]() { ConcatenateReference(skinInfo, toParent, reference); }, iterations);
+    double concatenateMs = MeasureMs([&]()
+    {
+        arena.Reset();
+        skinInfo.ConcatenateTransforms(toParent.data(), arena, palette.data());
+    }, iterations);
+    std::printf("soldier, %u bones: 4x4 concatenation and transpose %.2f us, fused 3x4 %.2f us, palette %zu -> %zu bytes\n",
+        skinInfo.BoneCount(), referenceMs * 1000.0, concatenateMs * 1000.0,
+        skinInfo.BoneCount() * sizeof(XMFLOAT4X4), skinInfo.BoneCount() * sizeof(XMFLOAT3X4));
+}
+
+TEST(GetFinalTransformsDoesNotAllocate)
+{
+    const SkinnedAsset* soldier = GetSoldier();
+    CHECK(soldier != nullptr);
+    if (soldier == nullptr)
+        return;
+
+    const SkinnedData& skinInfo = soldier->SkinInfo;
+    SkinnedData::ClipHandle clip = skinInfo.FindClip("Take1");
+    std::vector<XMFLOAT3X4> palette(skinInfo.BoneCount());
+    FrameArena arena(skinInfo.GetFinalTransformsScratchSize());
+    UINT cursor = 0;
+
+    size_t allocations = HeapAllocationCount();
+    UINT arenaAllocations = arena.HeapAllocationCount();
+    for (UINT frame = 0; frame < 1000; frame++)
+    {
+        arena.Reset();
+        skinInfo.GetFinalTransforms(clip, fmodf(frame / 60.0f, skinInfo.GetClipEndTime(clip)), arena, palette.data(), cursor);
+    }
+    CHECK(HeapAllocationCount() == allocations);
+    CHECK(arena.HeapAllocationCount() == arenaAllocations);
+}
+
+TEST(SkinnedModelInstanceUpdateDoesNotAllocate)
+{
+    const SkinnedAsset* soldier = GetSoldier();
+    if (soldier == nullptr)
+        return;
+
+    SkinnedModelInstance instance;
+    instance.SkinnedInfo = const_cast<SkinnedData*>(&soldier->SkinInfo);
+    instance.FinalTransforms.resize(instance.SkinnedInfo->BoneCount());
+    instance.SetClip("Take1");
+    FrameArena arena(instance.SkinnedInfo->GetFinalTransformsScratchSize());
+
+    size_t allocations = HeapAllocationCount();
+    // Long enough to wrap clip time a few times.
+    for (UINT frame = 0; frame < 1000; frame++)
+    {
+        arena.Reset();
+        instance.UpdateSkinnedAnimation(1.0f / 60.0f, arena);
+    }
+    CHECK(HeapAllocationCount() == allocations);
+}
+
+TEST(InvalidClipKeepsPalette)
+{
+    const SkinnedAsset* soldier = GetSoldier();
+    if (soldier == nullptr)
+        return;
+
+    const SkinnedData& skinInfo = soldier->SkinInfo;
+    CHECK(skinInfo.FindClip("NoSuchClip") == SkinnedData::InvalidClip);
+    CHECK(skinInfo.GetClipEndTime(SkinnedData::InvalidClip) == 0.0f);
+    CHECK(skinInfo.GetClipStartTime("NoSuchClip") == 0.0f);
+
+    SkinnedModelInstance instance;
+    instance.SkinnedInfo = const_cast<SkinnedData*>(&skinInfo);
+    XMFLOAT3X4 identity;
+    XMStoreFloat3x4(&identity, XMMatrixIdentity());
+    instance.FinalTransforms.assign(skinInfo.BoneCount(), identity);
+    instance.SetClip("NoSuchClip");
+    FrameArena arena(skinInfo.GetFinalTransformsScratchSize());
+    instance.UpdateSkinnedAnimation(1.0f / 60.0f, arena);
+    CHECK(instance.FinalTransforms[0]._11 == 1.0f && instance.FinalTransforms[0]._14 == 0.0f);
+}
+}
+}
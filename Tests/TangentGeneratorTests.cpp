@@ -0,0 +1,107 @@
+#include "TestFramework.h"
+#include "../Core/JobSystem.h"
+#include "../Core/MeshAsset.h"
+#include "../Core/TangentGenerator.h"
+
+namespace DX12Samples
+{
+namespace Tests
+{
+using namespace DirectX;
+
+namespace
+{
+struct PosNormalUvVertex
+{
+    XMFLOAT3 Pos;
+    XMFLOAT3 Normal;
+    XMFLOAT2 Uv;
+};
+
+struct PosNormalUvTangentVertex
+{
+    XMFLOAT3 Pos;
+    XMFLOAT3 Normal;
+    XMFLOAT2 Uv;
+    XMFLOAT3 Tangent;
+};
+
+std::shared_ptr<const MeshAsset> GetSkull()
+{
+    return MeshAssetCache::Instance().Load("Models/skull.txt", MeshVertexLayout::PosNormalUv);
+}
+
+std::vector<XMFLOAT4> GenerateTangents(const TangentGenerator& generator, const MeshAsset& mesh)
+{
+    const PosNormalUvVertex* vertices = mesh.GetVertices<PosNormalUvVertex>();
+    const UINT stride = sizeof(PosNormalUvVertex);
+    std::vector<XMFLOAT4> tangents(mesh.VertexCount);
+    generator.Generate(mesh.Indices.data(), mesh.Indices.size(), mesh.VertexCount, &vertices->Pos, stride,
+        &vertices->Normal, stride, &vertices->Uv, stride, tangents.data());
+    return tangents;
+}
+
+bool SameTangents(const std::vector<XMFLOAT4>& a, const std::vector<XMFLOAT4>& b)
+{
+    return a.size() == b.size() && memcmp(a.data(), b.data(), a.size() * sizeof(XMFLOAT4)) == 0;
+}
+}
+
+TEST(SkullTangentsDontDependOnWorkers)
+{
+    std::shared_ptr<const MeshAsset> skull = GetSkull();
+    CHECK(skull != nullptr);
+    if (skull == nullptr)
+        return;
+
+    std::vector<XMFLOAT4> serial = GenerateTangents(TangentGenerator(), *skull);
+    const PosNormalUvVertex* vertices = skull->GetVertices<PosNormalUvVertex>();
+    bool orthonormal = true;
+    for (UINT i = 0; i < skull->VertexCount; i++)
+    {
+        XMVECTOR tangent = XMLoadFloat4(&serial[i]);
+        float length = XMVectorGetX(XMVector3Length(tangent));
+        float dot = XMVectorGetX(XMVector3Dot(tangent, XMVector3Normalize(XMLoadFloat3(&vertices[i].Normal))));
+        orthonormal = orthonormal && fabsf(length - 1.0f) < 1e-4f && fabsf(dot) < 1e-4f && fabsf(serial[i].w) == 1.0f;
+    }
+    CHECK(orthonormal);
+
+    // Each vertex gathers its own triangles in fixed order, so workers can't change rounding.
+    for (int threads : { 0, 1, 3, 7 })
+    {
+        JobSystem jobs(threads);
+        CHECK(SameTangents(GenerateTangents(TangentGenerator(jobs), *skull), serial));
+    }
+
+    // Cache generates tangents on its job system, they must be the same as serial ones.
+    std::shared_ptr<const MeshAsset> tangentSkull = MeshAssetCache::Instance().Load("Models/skull.txt", MeshVertexLayout::PosNormalUvTangent);
+    CHECK(tangentSkull != nullptr && tangentSkull->VertexCount == skull->VertexCount);
+    if (tangentSkull == nullptr)
+        return;
+    const PosNormalUvTangentVertex* tangentVertices = tangentSkull->GetVertices<PosNormalUvTangentVertex>();
+    bool sameAsSerial = true;
+    for (UINT i = 0; i < tangentSkull->VertexCount; i++)
+        sameAsSerial = sameAsSerial && memcmp(&tangentVertices[i].Tangent, &serial[i], sizeof(XMFLOAT3)) == 0;
+    CHECK(sameAsSerial);
+}
+
+BENCHMARK(SkullTangentGeneration)
+{
+    std::shared_ptr<const MeshAsset> skull = GetSkull();
+    if (skull == nullptr)
+        return;
+
+    std::vector<XMFLOAT4> tangents;
+    double serialMs = MeasureMs([&]() { tangents = GenerateTangents(TangentGenerator(), *skull); }, 10);
+    std::printf("skull.txt %u vertices, %zu triangles, hardware threads %u: serial %.2f ms\n", skull->VertexCount,
+        skull->Indices.size() / 3, std::thread::hardware_concurrency(), serialMs);
+    for (int threads : { 1, 3, 7 })
+    {
+        JobSystem jobs(threads);
+        TangentGenerator generator(jobs);
+        double parallelMs = MeasureMs([&]() { tangents = GenerateTangents(generator, *skull); }, 10);
+        std::printf("  %u workers: %.2f ms (%.2fx)\n", jobs.WorkerCount(), parallelMs, serialMs / parallelMs);
+    }
+}
+}
+}
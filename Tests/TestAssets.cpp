@@ -0,0 +1,22 @@
+#include "TestAssets.h"
+
+namespace DX12Samples
+{
+namespace Tests
+{
+const SkinnedAsset* GetSoldier()
+{
+    static std::unique_ptr<SkinnedAsset> soldier;
+    static bool loaded = false;
+    if (!loaded)
+    {
+        loaded = true;
+        soldier = std::make_unique<SkinnedAsset>();
+        M3dLoader loader;
+        if (!loader.LoadM3d("Models/soldier.m3d", soldier->Vertices, soldier->Indices, soldier->Subsets, soldier->Materials, soldier->SkinInfo))
+            soldier.reset();
+    }
+    return soldier.get();
+}
+}
+}
@@ -0,0 +1,27 @@
+//
+// Models shared by tests, loaded once per process.
+//
+
+#pragma once
+
+#include "../Core/M3dLoader.h"
+
+namespace DX12Samples
+{
+namespace Tests
+{
+struct SkinnedAsset
+{
+    std::vector<M3dLoader::SkinnedVertex> Vertices;
+    std::vector<USHORT> Indices;
+    std::vector<M3dLoader::Subset> Subsets;
+    std::vector<M3dLoader::M3dMaterial> Materials;
+    SkinnedData SkinInfo;
+};
+
+/**
+ * \brief Models/soldier.m3d, nullptr if it can't be loaded.
+ */
+const SkinnedAsset* GetSoldier();
+}
+}
@@ -0,0 +1,86 @@
+#include "TestFramework.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+std::atomic<size_t> HeapAllocations{ 0 };
+}
+
+// Count every heap allocation of the process, tests use it to prove steady state code paths don't allocate.
+void* operator new(size_t size)
+{
+    HeapAllocations++;
+    void* memory = std::malloc(size > 0 ? size : 1);
+    if (memory == nullptr)
+        throw std::bad_alloc();
+    return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+namespace DX12Samples
+{
+namespace Tests
+{
+TestRegistry& TestRegistry::Get()
+{
+    static TestRegistry registry;
+    return registry;
+}
+
+void TestRegistry::Add(const char* name, TestFunction function, bool benchmark)
+{
+    Entry entry;
+    entry.Name = name;
+    entry.Function = function;
+    entry.Benchmark = benchmark;
+    _entries.push_back(entry);
+}
+
+int TestRegistry::Run(const std::string& filter, bool runBenchmarks)
+{
+    int failed = 0;
+    int run = 0;
+    for (const Entry& entry : _entries)
+    {
+        if (entry.Benchmark && !runBenchmarks)
+            continue;
+        if (!filter.empty() && std::string(entry.Name).find(filter) == std::string::npos)
+            continue;
+
+        std::printf("[ RUN  ] %s\n", entry.Name);
+        std::fflush(stdout);
+        _currentFailures = 0;
+        entry.Function();
+        std::printf("[ %s ] %s\n", _currentFailures == 0 ? " OK " : "FAIL", entry.Name);
+        if (_currentFailures > 0)
+            failed++;
+        run++;
+    }
+    std::printf("%d of %d passed\n", run - failed, run);
+    return failed;
+}
+
+void TestRegistry::ReportFailure(const char* file, int line, const char* expression)
+{
+    std::printf("%s(%d): check failed: %s\n", file, line, expression);
+    _currentFailures++;
+}
+
+size_t HeapAllocationCount()
+{
+    return HeapAllocations.load();
+}
+}
+}
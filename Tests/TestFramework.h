@@ -0,0 +1,100 @@
+//
+// Minimal registry of headless tests and benchmarks.
+//
+
+#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace DX12Samples
+{
+namespace Tests
+{
+using TestFunction = void(*)();
+
+class TestRegistry
+{
+public:
+    static TestRegistry& Get();
+
+    void Add(const char* name, TestFunction function, bool benchmark);
+    /**
+     * \brief Run tests which name contains filter, benchmarks are run only if runBenchmarks is set. Returns number of failed tests.
+     */
+    int Run(const std::string& filter, bool runBenchmarks);
+    /**
+     * \brief Mark currently running test as failed and print failed expression.
+     */
+    void ReportFailure(const char* file, int line, const char* expression);
+
+private:
+    struct Entry
+    {
+        const char* Name;
+        TestFunction Function;
+        bool Benchmark;
+    };
+
+    std::vector<Entry> _entries;
+    int _currentFailures = 0;
+};
+
+struct TestRegistration
+{
+    TestRegistration(const char* name, TestFunction function, bool benchmark)
+    {
+        TestRegistry::Get().Add(name, function, benchmark);
+    }
+};
+
+/**
+ * \brief How many times global operator new was called since process start.
+ */
+size_t HeapAllocationCount();
+
+/**
+ * \brief Call func iterations times, repeat it a few times and return best time of single call in milliseconds.
+ */
+template<typename F>
+double MeasureMs(F&& func, int iterations = 1, int repeats = 3)
+{
+    double best = 1e30;
+    for (int r = 0; r < repeats; r++)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < iterations; i++)
+            func();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+        best = elapsed.count() / iterations < best ? elapsed.count() / iterations : best;
+    }
+    return best;
+}
+}
+}
+
+#define TEST_REGISTER(name, benchmark) \
+    static void name(); \
+    static DX12Samples::Tests::TestRegistration name##Registration(#name, &name, benchmark); \
+    static void name()
+
+/**
+ * \brief Define test, it runs on every launch of test executable.
+ */
+#define TEST(name) TEST_REGISTER(name, false)
+/**
+ * \brief Define benchmark, it runs only with --bench argument and prints its results.
+ */
+#define BENCHMARK(name) TEST_REGISTER(name, true)
+
+#define CHECK(expression) \
+    do \
+    { \
+        if (!(expression)) \
+            DX12Samples::Tests::TestRegistry::Get().ReportFailure(__FILE__, __LINE__, #expression); \
+    } while (false)
+
+#define CHECK_NEAR(a, b, tolerance) CHECK(std::fabs((double)(a) - (double)(b)) <= (double)(tolerance))
@@ -0,0 +1,132 @@
+#include "TestFramework.h"
+#include "../Core/M3dLoader.h"
+
+#include <fstream>
+#include <random>
+
+namespace DX12Samples
+{
+namespace Tests
+{
+using namespace DirectX;
+
+namespace
+{
+/**
+ * \brief Loop text models were read with before TextParser, kept as reference.
+ */
+bool LoadTextModelWithStream(const std::string& filename, std::vector<XMFLOAT3>& positions, std::vector<XMFLOAT3>& normals, std::vector<UINT>& indices)
+{
+    std::ifstream fin(filename);
+    if (!fin)
+        return false;
+
+    UINT vcount = 0;
+    UINT tcount = 0;
+    std::string ignore;
+    fin >> ignore >> vcount;
+    fin >> ignore >> tcount;
+    fin >> ignore >> ignore >> ignore >> ignore;
+
+    positions.resize(vcount);
+    normals.resize(vcount);
+    for (UINT i = 0; i < vcount; i++)
+    {
+        fin >> positions[i].x >> positions[i].y >> positions[i].z;
+        fin >> normals[i].x >> normals[i].y >> normals[i].z;
+    }
+    fin >> ignore >> ignore >> ignore;
+
+    indices.resize(3 * tcount);
+    for (UINT i = 0; i < tcount; i++)
+        fin >> indices[i * 3 + 0] >> indices[i * 3 + 1] >> indices[i * 3 + 2];
+    return (bool)fin;
+}
+
+template<typename T>
+bool SameRecords(const std::vector<T>& a, const std::vector<T>& b)
+{
+    return a.size() == b.size() && memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+}
+
+size_t FileSize(const std::string& filename)
+{
+    std::ifstream fin(filename, std::ios::binary | std::ios::ate);
+    return fin ? (size_t)fin.tellg() : 0;
+}
+}
+
+TEST(ParseFloatMatchesStream)
+{
+    // Random floats printed with different precisions and notations, plus tokens from real model files.
+    std::mt19937 random(3);
+    std::uniform_real_distribution<float> mantissa(-1.0f, 1.0f);
+    std::uniform_int_distribution<int> exponent(-30, 30);
+    std::vector<std::string> tokens = { "0", "-0", "1e-45", "3.4028235e38", "0.1", "123456789", "1.00000005", "-.5", "5." };
+    for (UINT i = 0; i < 100000; i++)
+    {
+        std::ostringstream outs;
+        outs.precision(1 + i % 12);
+        if (i % 3 == 0)
+            outs << std::scientific;
+        outs << mantissa(random) * powf(10.0f, (float)exponent(random));
+        tokens.push_back(outs.str());
+    }
+
+    UINT mismatches = 0;
+    for (const std::string& token : tokens)
+    {
+        float expected = 0.0f;
+        float actual = 0.0f;
+        std::istringstream(token) >> expected;
+        bool parsed = TextParser::ParseFloat(token.data(), token.data() + token.size(), actual);
+        if (!parsed || memcmp(&expected, &actual, sizeof(float)) != 0)
+            mismatches++;
+    }
+    CHECK(mismatches == 0);
+}
+
+TEST(LoadTextModelMatchesStream)
+{
+    for (const char* filename : { "Models/skull.txt", "Models/car.txt" })
+    {
+        std::vector<XMFLOAT3> expectedPositions, expectedNormals, positions, normals;
+        std::vector<UINT> expectedIndices, indices;
+        CHECK(LoadTextModelWithStream(filename, expectedPositions, expectedNormals, expectedIndices));
+
+        M3dLoader loader;
+        CHECK(loader.LoadTextModel(filename, positions, normals, indices));
+        CHECK(SameRecords(expectedPositions, positions));
+        CHECK(SameRecords(expectedNormals, normals));
+        CHECK(SameRecords(expectedIndices, indices));
+    }
+}
+
+BENCHMARK(TextParserThroughput)
+{
+    const char* skullFilename = "Models/skull.txt";
+    const char* soldierFilename = "Models/soldier.m3d";
+    std::vector<XMFLOAT3> positions, normals;
+    std::vector<UINT> indices;
+    M3dLoader loader;
+    const int iterations = 5;
+
+    double streamMs = MeasureMs([&]() { LoadTextModelWithStream(skullFilename, positions, normals, indices); }, iterations);
+    double parserMs = MeasureMs([&]() { loader.LoadTextModel(skullFilename, positions, normals, indices); }, iterations);
+    double skullMB = FileSize(skullFilename) / (1024.0 * 1024.0);
+    std::printf("skull.txt %.1f MB: std::ifstream %.0f MB/s, TextParser %.0f MB/s\n", skullMB, skullMB / streamMs * 1000.0, skullMB / parserMs * 1000.0);
+
+    // Binary file next to soldier.m3d would be loaded instead of text.
+    if (std::ifstream(M3dLoader::GetBinaryFilename(soldierFilename)).good())
+        return;
+    std::vector<M3dLoader::SkinnedVertex> vertices;
+    std::vector<USHORT> soldierIndices;
+    std::vector<M3dLoader::Subset> subsets;
+    std::vector<M3dLoader::M3dMaterial> mats;
+    SkinnedData skinInfo;
+    double soldierMs = MeasureMs([&]() { loader.LoadM3d(soldierFilename, vertices, soldierIndices, subsets, mats, skinInfo); }, iterations);
+    double soldierMB = FileSize(soldierFilename) / (1024.0 * 1024.0);
+    std::printf("soldier.m3d %.1f MB: TextParser %.0f MB/s including SkinnedData setup\n", soldierMB, soldierMB / soldierMs * 1000.0);
+}
+}
+}
@@ -0,0 +1,196 @@
+#include "TestFramework.h"
+#include "TestAssets.h"
+#include "../Core/VertexPacker.h"
+
+#include <random>
+
+namespace DX12Samples
+{
+namespace Tests
+{
+using namespace DirectX;
+
+namespace
+{
+struct PackedMeshSource
+{
+    std::string Name;
+    std::vector<M3dLoader::Vertex> Vertices;
+    size_t SourceStride;
+};
+
+PackedMeshSource FromMeshData(const char* name, const GeometryGenerator::MeshData& meshData)
+{
+    PackedMeshSource source;
+    source.Name = name;
+    source.SourceStride = sizeof(GeometryGenerator::Vertex);
+    for (const GeometryGenerator::Vertex& v : meshData.Vertices)
+    {
+        M3dLoader::Vertex vertex;
+        vertex.Pos = v.Position;
+        vertex.Normal = v.Normal;
+        vertex.Uv = v.TexCoord;
+        vertex.TangentU = XMFLOAT4(v.Tangent.x, v.Tangent.y, v.Tangent.z, 1.0f);
+        source.Vertices.push_back(vertex);
+    }
+    return source;
+}
+
+std::vector<PackedMeshSource> CreateSources()
+{
+    GeometryGenerator geoGen;
+    std::vector<PackedMeshSource> sources;
+    sources.push_back(FromMeshData("box", geoGen.CreateBox(1.0f, 1.0f, 1.0f, 3)));
+    sources.push_back(FromMeshData("geosphere 5", geoGen.CreateGeosphere(0.5f, 5)));
+    sources.push_back(FromMeshData("cylinder", geoGen.CreateCylinder(0.5f, 0.3f, 3.0f, 20, 20)));
+    sources.push_back(FromMeshData("grid 20x30", geoGen.CreateGrid(20.0f, 30.0f, 60, 40)));
+    // Far beyond half float range unless positions are scaled to bounds.
+    sources.push_back(FromMeshData("grid 200km", geoGen.CreateGrid(200000.0f, 200000.0f, 50, 50)));
+
+    const SkinnedAsset* soldier = GetSoldier();
+    if (soldier != nullptr)
+    {
+        PackedMeshSource source;
+        source.Name = "soldier";
+        source.SourceStride = sizeof(M3dLoader::Vertex);
+        std::mt19937 random(3);
+        for (const M3dLoader::SkinnedVertex& v : soldier->Vertices)
+        {
+            M3dLoader::Vertex vertex;
+            vertex.Pos = v.Pos;
+            vertex.Normal = v.Normal;
+            vertex.Uv = v.Uv;
+            // Skinned vertices have no bitangent sign, random ones cover both.
+            vertex.TangentU = XMFLOAT4(v.TangentU.x, v.TangentU.y, v.TangentU.z, random() % 2 == 0 ? 1.0f : -1.0f);
+            source.Vertices.push_back(vertex);
+        }
+        sources.push_back(source);
+    }
+    return sources;
+}
+
+struct RoundTripError
+{
+    // Largest position error relative to largest bounds extent.
+    float Position = 0.0f;
+    // Largest angle between source and decoded normal or tangent in degrees.
+    float DirectionDegrees = 0.0f;
+    // Largest texture coordinate error relative to Uv range.
+    float TexCoord = 0.0f;
+    UINT SignMismatches = 0;
+};
+
+/**
+ * \brief Angle between directions, 0 if source one is degenerate, e.g. tangent at geosphere poles.
+ */
+float AngleDegrees(const XMFLOAT3& decoded, const XMFLOAT3& source)
+{
+    XMVECTOR a = XMLoadFloat3(&decoded);
+    XMVECTOR b = XMLoadFloat3(&source);
+    if (XMVectorGetX(XMVector3LengthSq(b)) < 1e-12f)
+        return 0.0f;
+    float cosAngle = XMVectorGetX(XMVector3Dot(XMVector3Normalize(a), XMVector3Normalize(b)));
+    return XMConvertToDegrees(acosf(MathHelper::Clamp(cosAngle, -1.0f, 1.0f)));
+}
+
+RoundTripError MeasureRoundTrip(const std::vector<M3dLoader::Vertex>& vertices, const PackedMesh& packed)
+{
+    XMVECTOR positionMin = XMVectorReplicate(FLT_MAX);
+    XMVECTOR positionMax = XMVectorReplicate(-FLT_MAX);
+    for (const M3dLoader::Vertex& v : vertices)
+    {
+        positionMin = XMVectorMin(positionMin, XMLoadFloat3(&v.Pos));
+        positionMax = XMVectorMax(positionMax, XMLoadFloat3(&v.Pos));
+    }
+    XMFLOAT3 extent;
+    XMStoreFloat3(&extent, positionMax - positionMin);
+    float maxExtent = MathHelper::Max(extent.x, MathHelper::Max(extent.y, extent.z));
+    const XMFLOAT2& uvRange = packed.Quantization.TexCoordScale;
+
+    RoundTripError error;
+    for (size_t i = 0; i < vertices.size(); i++)
+    {
+        const M3dLoader::Vertex& source = vertices[i];
+        UnpackedVertex decoded = VertexPacker::Unpack(packed.Vertices[i], packed.Quantization, packed.Encoding);
+        float positionError = XMVectorGetX(XMVector3Length(XMLoadFloat3(&decoded.Position) - XMLoadFloat3(&source.Pos)));
+        error.Position = MathHelper::Max(error.Position, positionError / maxExtent);
+        error.DirectionDegrees = MathHelper::Max(error.DirectionDegrees, AngleDegrees(decoded.Normal, source.Normal));
+        XMFLOAT3 decodedTangent(decoded.Tangent.x, decoded.Tangent.y, decoded.Tangent.z);
+        XMFLOAT3 sourceTangent(source.TangentU.x, source.TangentU.y, source.TangentU.z);
+        error.DirectionDegrees = MathHelper::Max(error.DirectionDegrees, AngleDegrees(decodedTangent, sourceTangent));
+        if (uvRange.x > 0.0f)
+            error.TexCoord = MathHelper::Max(error.TexCoord, fabsf(decoded.TexCoord.x - source.Uv.x) / uvRange.x);
+        if (uvRange.y > 0.0f)
+            error.TexCoord = MathHelper::Max(error.TexCoord, fabsf(decoded.TexCoord.y - source.Uv.y) / uvRange.y);
+        error.SignMismatches += (decoded.Tangent.w > 0.0f) != (source.TangentU.w > 0.0f) ? 1 : 0;
+    }
+    return error;
+}
+}
+
+TEST(PackedVerticesRoundTrip)
+{
+    for (const PackedMeshSource& source : CreateSources())
+    {
+        RoundTripError unorm = MeasureRoundTrip(source.Vertices, VertexPacker::Pack(source.Vertices, PositionEncoding::Unorm16));
+        RoundTripError half = MeasureRoundTrip(source.Vertices, VertexPacker::Pack(source.Vertices, PositionEncoding::Float16));
+        // Half a step of 16 bit UNORM.
+        CHECK(unorm.Position <= 1.0f / 65535.0f);
+        // Half of half float step below 1, in units of half extent.
+        CHECK(half.Position <= 1.0f / 4096.0f);
+        CHECK(unorm.DirectionDegrees <= 0.05f && half.DirectionDegrees <= 0.05f);
+        CHECK(unorm.TexCoord <= 1.0f / 65535.0f);
+        CHECK(unorm.SignMismatches == 0 && half.SignMismatches == 0);
+    }
+}
+
+TEST(PackedVerticesFlatMesh)
+{
+    // Grid has no height, so y range is empty and must decode exactly.
+    GeometryGenerator geoGen;
+    GeometryGenerator::MeshData grid = geoGen.CreateGrid(10.0f, 10.0f, 4, 4);
+    for (PositionEncoding encoding : { PositionEncoding::Unorm16, PositionEncoding::Float16 })
+    {
+        PackedMesh packed = VertexPacker::Pack(grid, encoding);
+        bool flat = true;
+        for (const PackedVertex& vertex : packed.Vertices)
+            flat = flat && VertexPacker::Unpack(vertex, packed.Quantization, encoding).Position.y == 0.0f;
+        CHECK(flat);
+        CHECK(packed.VertexBufferByteSize() == grid.Vertices.size() * 20);
+        CHECK(packed.GetInputLayout().size() == 4);
+    }
+}
+
+TEST(OctahedralEncodingRoundTrip)
+{
+    // Without quantization mapping is exact up to float rounding.
+    std::mt19937 random(11);
+    std::normal_distribution<float> coordinate;
+    float maxDistance = 0.0f;
+    for (int i = 0; i < 10000; i++)
+    {
+        XMVECTOR v = XMVector3Normalize(XMVectorSet(coordinate(random), coordinate(random), coordinate(random), 0.0f));
+        XMFLOAT3 direction;
+        XMStoreFloat3(&direction, v);
+        XMFLOAT3 decoded = VertexPacker::DecodeOctahedral(VertexPacker::EncodeOctahedral(direction));
+        maxDistance = MathHelper::Max(maxDistance, XMVectorGetX(XMVector3Length(XMLoadFloat3(&decoded) - v)));
+    }
+    CHECK(maxDistance < 1e-5f);
+}
+
+BENCHMARK(PackedVertexSizes)
+{
+    std::printf("%-14s %8s %6s %6s %7s %12s %12s %9s\n", "mesh", "vertices", "bytes", "packed", "saved", "unorm pos", "half pos", "dir deg");
+    for (const PackedMeshSource& source : CreateSources())
+    {
+        PackedMesh unormMesh;
+        double packMs = MeasureMs([&]() { unormMesh = VertexPacker::Pack(source.Vertices, PositionEncoding::Unorm16); });
+        RoundTripError unorm = MeasureRoundTrip(source.Vertices, unormMesh);
+        RoundTripError half = MeasureRoundTrip(source.Vertices, VertexPacker::Pack(source.Vertices, PositionEncoding::Float16));
+        std::printf("%-14s %8zu %6zu %6zu %6.1f%% %12.2e %12.2e %9.4f  pack %.2f ms\n", source.Name.c_str(), source.Vertices.size(),
+            source.SourceStride, sizeof(PackedVertex), 100.0f * (1.0f - (float)sizeof(PackedVertex) / source.SourceStride),
+            unorm.Position, half.Position, unorm.DirectionDegrees, packMs);
+    }
+}
+}
+}